@@ -0,0 +1,189 @@
+// Lock microbenchmark
+//
+// Compares std::mutex with flow::detail::adaptive_mutex for 2, 4, 8, 16, 32 and 64 threads.
+// Every thread loops over: lock, a short critical section touching shared state, unlock, and
+// some private work. Two shapes are measured:
+//   short: ~20 ns inside the lock, ~100 ns outside (a queue push, the scheduler hot path)
+//   long:  ~1 us inside the lock, ~1 us outside (waiters end up parking)
+// For each run the benchmark reports throughput, fairness (slowest thread's share of the
+// operations relative to an even split) and the longest any thread waited for the lock.
+//
+// Only runs with at most as many threads as hardware threads measure contention: past that the
+// threads time-slice, a preempted lock holder stalls everyone, and fairness reflects the OS
+// scheduler's quantum rather than the lock. The benchmark says so on stderr when it happens.
+//
+// Results are written as long-format CSV:
+//   benchmark,lock,threads,metric,value,unit
+//
+// Usage: mutex_benchmarks [--csv FILE] [--quick]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <flow/execution.hpp>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct config {
+  std::chrono::milliseconds duration{300};
+  std::string               csv_path;
+};
+
+auto now_ns() noexcept -> std::uint64_t {
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                        std::chrono::steady_clock::now().time_since_epoch())
+                                        .count());
+}
+
+// Busy-wait for roughly `ns` nanoseconds
+void burn(std::uint64_t ns) noexcept {
+  auto deadline = now_ns() + ns;
+  while (now_ns() < deadline) {
+  }
+}
+
+class csv_writer {
+ public:
+  explicit csv_writer(std::ostream& out) : out_(out) {
+    out_ << "benchmark,lock,threads,metric,value,unit\n" << std::fixed << std::setprecision(3);
+  }
+
+  void row(std::string_view benchmark, std::string_view lock, std::size_t threads,
+           std::string_view metric, double value, std::string_view unit) {
+    out_ << benchmark << ',' << lock << ',' << threads << ',' << metric << ',' << value << ','
+         << unit << '\n'
+         << std::flush;
+  }
+
+ private:
+  std::ostream& out_;
+};
+
+struct shape {
+  std::string_view name;
+  std::uint64_t    inside_ns;
+  std::uint64_t    outside_ns;
+};
+
+template <class Mutex>
+void contend(csv_writer& csv, std::string_view lock_name, const shape& s, std::size_t threads,
+             std::chrono::milliseconds duration) {
+  Mutex                      m;
+  std::uint64_t              shared = 0;
+  std::atomic<bool>          go{false};
+  std::atomic<bool>          stop{false};
+  std::vector<std::uint64_t> ops(threads, 0);
+  std::vector<std::uint64_t> worst_wait(threads, 0);
+  std::vector<std::thread>   workers;
+  workers.reserve(threads);
+  for (std::size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      while (!go.load(std::memory_order_acquire)) {
+      }
+      std::uint64_t local = 0;
+      std::uint64_t worst = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        {
+          const std::uint64_t requested = now_ns();
+          std::scoped_lock    lock(m);
+          worst = std::max(worst, now_ns() - requested);
+          ++shared;
+          if (s.inside_ns > 0) {
+            burn(s.inside_ns);
+          }
+        }
+        burn(s.outside_ns);
+        ++local;
+      }
+      ops[t]        = local;
+      worst_wait[t] = worst;
+    });
+  }
+
+  const auto begin = std::chrono::steady_clock::now();
+  go.store(true, std::memory_order_release);
+  std::this_thread::sleep_for(duration);
+  stop.store(true, std::memory_order_relaxed);
+  for (auto& w : workers) {
+    w.join();
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin)
+                             .count();
+
+  std::uint64_t total   = 0;
+  std::uint64_t slowest = ops.front();
+  for (auto n : ops) {
+    total += n;
+    slowest = std::min(slowest, n);
+  }
+  const double even = static_cast<double>(total) / static_cast<double>(threads);
+  csv.row(s.name, lock_name, threads, "throughput", static_cast<double>(total) / seconds / 1e6,
+          "Mops/s");
+  csv.row(s.name, lock_name, threads, "fairness", even > 0 ? static_cast<double>(slowest) / even
+                                                           : 0.0,
+          "ratio");
+  csv.row(s.name, lock_name, threads, "max_wait",
+          static_cast<double>(*std::max_element(worst_wait.begin(), worst_wait.end())) / 1e3,
+          "us");
+}
+
+auto parse_args(int argc, char** argv) -> config {
+  config cfg;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg == "--csv" && i + 1 < argc) {
+      cfg.csv_path = argv[++i];
+    } else if (arg == "--quick") {
+      cfg.duration = std::chrono::milliseconds(50);
+    } else {
+      std::cerr << "usage: mutex_benchmarks [--csv FILE] [--quick]\n";
+      std::exit(arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+  }
+  return cfg;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  auto cfg = parse_args(argc, argv);
+
+  std::ofstream file;
+  if (!cfg.csv_path.empty()) {
+    file.open(cfg.csv_path);
+    if (!file) {
+      std::cerr << "cannot open " << cfg.csv_path << '\n';
+      return EXIT_FAILURE;
+    }
+  }
+  csv_writer csv(cfg.csv_path.empty() ? std::cout : file);
+
+  const std::size_t cores = std::thread::hardware_concurrency();
+  if (cores < 64) {
+    std::cerr << "mutex_benchmarks: " << cores
+              << " hardware threads; runs with more threads measure time slicing, not contention\n";
+  }
+
+  const shape shapes[] = {
+      {.name = "short", .inside_ns = 0, .outside_ns = 100},
+      {.name = "long", .inside_ns = 1000, .outside_ns = 1000},
+  };
+  for (const auto& s : shapes) {
+    for (std::size_t threads = 2; threads <= 64; threads *= 2) {
+      contend<std::mutex>(csv, "std::mutex", s, threads, cfg.duration);
+      contend<flow::detail::adaptive_mutex>(csv, "adaptive_mutex", s, threads, cfg.duration);
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,267 @@
+// Exception plumbing microbenchmark
+//
+// then, upon_*, let_* and bulk drop set_error(exception_ptr) from their completion signatures,
+// and their receivers drop the try/catch around the user function, when that function is
+// noexcept. Every pipeline below is built twice from the same opaque step function: once
+// declared noexcept, once not. For each pipeline the benchmark reports:
+//   ns_per_op:      connect + start + completion, single thread, best of several rounds
+//   op_state_bytes: sizeof the operation state
+//   signatures:     number of completion signatures the sender declares, which is what
+//                   consumers such as spawn_future and when_any size their storage by
+//
+// Results are written as long-format CSV:
+//   benchmark,variant,metric,value,unit
+//
+// Usage: noexcept_benchmarks [--csv FILE] [--quick]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <flow/execution.hpp>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace flow::execution;
+
+struct config {
+  std::size_t iterations{2'000'000};
+  std::size_t rounds{5};
+  std::size_t bulk_shape{1 << 16};
+  std::string csv_path;
+};
+
+class csv_writer {
+ public:
+  explicit csv_writer(std::ostream& out) : out_(out) {
+    out_ << "benchmark,variant,metric,value,unit\n" << std::fixed << std::setprecision(3);
+  }
+
+  void row(std::string_view benchmark, std::string_view variant, std::string_view metric,
+           double value, std::string_view unit) {
+    out_ << benchmark << ',' << variant << ',' << metric << ',' << value << ',' << unit << '\n'
+         << std::flush;
+  }
+
+ private:
+  std::ostream& out_;
+};
+
+// Never set: neither step function can be proven not to fail
+volatile bool fail = false;
+
+// Keeps the results observable
+volatile std::uint64_t checksum = 0;
+
+[[gnu::noinline]] auto step(std::uint64_t v) noexcept -> std::uint64_t {
+  if (fail) {
+    std::terminate();
+  }
+  return (v * 3) + 1;
+}
+
+[[gnu::noinline]] auto step_may_throw(std::uint64_t v) -> std::uint64_t {
+  if (fail) {
+    throw std::runtime_error("step");
+  }
+  return (v * 3) + 1;
+}
+
+// Pipelines built from a step function that is noexcept or not
+template <bool Noexcept>
+struct steps {
+  static auto call(std::uint64_t v) noexcept(Noexcept) -> std::uint64_t {
+    if constexpr (Noexcept) {
+      return step(v);
+    } else {
+      return step_may_throw(v);
+    }
+  }
+
+  static auto then_chain(std::uint64_t v) {
+    auto f = [](std::uint64_t x) noexcept(Noexcept) { return call(x); };
+    return just(v) | then(f) | then(f) | then(f) | then(f);
+  }
+
+  static auto let_chain(std::uint64_t v) {
+    return just(v) | let_value([](std::uint64_t x) noexcept(Noexcept) { return just(call(x)); });
+  }
+
+  static auto bulk_chain(std::vector<std::uint64_t>& data) {
+    return just() | bulk(seq, data.size(), [&data](std::size_t i) noexcept(Noexcept) {
+             data[i] = call(data[i]);
+           });
+  }
+};
+
+struct sink_receiver {
+  using receiver_concept = receiver_t;
+
+  std::uint64_t* sum;
+
+  template <class... Vs>
+  void set_value(Vs... vs) && noexcept {
+    ((*sum += static_cast<std::uint64_t>(vs)), ...);
+  }
+
+  template <class E>
+  void set_error(E&& /*unused*/) && noexcept {}
+
+  void set_stopped() && noexcept {}
+
+  [[nodiscard]] auto get_env() const noexcept {
+    return empty_env{};
+  }
+};
+
+template <class F>
+struct emplace_from {
+  F fun;
+
+  operator std::invoke_result_t<F>() && {  // NOLINT(google-explicit-constructor)
+    return std::move(fun)();
+  }
+};
+
+template <class F>
+emplace_from(F) -> emplace_from<F>;
+
+template <class Sigs>
+struct signature_count;
+
+template <class... Sigs>
+struct signature_count<completion_signatures<Sigs...>> {
+  static constexpr std::size_t value = sizeof...(Sigs);
+};
+
+template <class S>
+void report_shape(csv_writer& csv, std::string_view name, std::string_view variant) {
+  using sigs = decltype(std::declval<S>().get_completion_signatures(empty_env{}));
+  using op_t = decltype(std::declval<S>().connect(std::declval<sink_receiver>()));
+  csv.row(name, variant, "op_state_bytes", sizeof(op_t), "bytes");
+  csv.row(name, variant, "signatures", signature_count<sigs>::value, "count");
+}
+
+// Best time per unit of `rounds` runs of `body`, which does `units` units of work
+template <class Body>
+auto best_ns(std::size_t rounds, std::size_t units, Body body) -> double {
+  double best = 0;
+  for (std::size_t r = 0; r < rounds; ++r) {
+    const auto begin = std::chrono::steady_clock::now();
+    body();
+    const double ns =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin)
+            .count()
+        / static_cast<double>(units);
+    best = r == 0 ? ns : std::min(best, ns);
+  }
+  return best;
+}
+
+// Connects, starts and completes `make(i)` for every i
+template <class Make>
+void run_pipeline(csv_writer& csv, std::string_view name, std::string_view variant,
+                  const config& cfg, Make make) {
+  using sender_t = decltype(make(std::uint64_t{0}));
+  using op_t     = decltype(std::declval<sender_t>().connect(std::declval<sink_receiver>()));
+  report_shape<sender_t>(csv, name, variant);
+
+  std::uint64_t sum = 0;
+  const double  ns  = best_ns(cfg.rounds, cfg.iterations, [&] {
+    std::optional<op_t> op;
+    for (std::size_t i = 0; i < cfg.iterations; ++i) {
+      op.emplace(emplace_from{[&] { return make(i).connect(sink_receiver{&sum}); }});
+      op->start();
+    }
+  });
+  checksum = sum;
+  csv.row(name, variant, "ns_per_op", ns, "ns");
+}
+
+template <bool Noexcept>
+void run_bulk(csv_writer& csv, std::string_view variant, const config& cfg) {
+  std::vector<std::uint64_t> data(cfg.bulk_shape, 1);
+  report_shape<decltype(steps<Noexcept>::bulk_chain(data))>(csv, "bulk", variant);
+
+  const std::size_t passes = std::max<std::size_t>(1, cfg.iterations / cfg.bulk_shape * 4);
+  std::uint64_t     sum    = 0;
+  const double      ns     = best_ns(cfg.rounds, passes * cfg.bulk_shape, [&] {
+    for (std::size_t p = 0; p < passes; ++p) {
+      auto op = steps<Noexcept>::bulk_chain(data).connect(sink_receiver{&sum});
+      op.start();
+    }
+  });
+  checksum = sum + data.front();
+  csv.row("bulk", variant, "ns_per_element", ns, "ns");
+}
+
+template <bool Noexcept>
+auto variant_name() -> std::string_view {
+  return Noexcept ? "noexcept" : "may_throw";
+}
+
+// Variants alternate so that neither gets a warmer machine
+template <bool Noexcept>
+void run_then(csv_writer& csv, const config& cfg) {
+  run_pipeline(csv, "then_x4", variant_name<Noexcept>(), cfg,
+               [](std::uint64_t v) { return steps<Noexcept>::then_chain(v); });
+}
+
+template <bool Noexcept>
+void run_let(csv_writer& csv, const config& cfg) {
+  run_pipeline(csv, "let_value", variant_name<Noexcept>(), cfg,
+               [](std::uint64_t v) { return steps<Noexcept>::let_chain(v); });
+}
+
+auto parse_args(int argc, char** argv) -> config {
+  config cfg;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg == "--csv" && i + 1 < argc) {
+      cfg.csv_path = argv[++i];
+    } else if (arg == "--quick") {
+      cfg.iterations = 200'000;
+      cfg.rounds     = 2;
+      cfg.bulk_shape = 1 << 12;
+    } else {
+      std::cerr << "usage: noexcept_benchmarks [--csv FILE] [--quick]\n";
+      std::exit(arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+  }
+  return cfg;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  auto cfg = parse_args(argc, argv);
+
+  std::ofstream file;
+  if (!cfg.csv_path.empty()) {
+    file.open(cfg.csv_path);
+    if (!file) {
+      std::cerr << "cannot open " << cfg.csv_path << '\n';
+      return EXIT_FAILURE;
+    }
+  }
+  csv_writer csv(cfg.csv_path.empty() ? std::cout : file);
+
+  run_then<true>(csv, cfg);
+  run_then<false>(csv, cfg);
+  run_let<true>(csv, cfg);
+  run_let<false>(csv, cfg);
+  run_bulk<true>(csv, variant_name<true>(), cfg);
+  run_bulk<false>(csv, variant_name<false>(), cfg);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""Plot the CSV written by scheduler_benchmarks.
+
+Usage: plot_scheduler_benchmarks.py results.csv [output_dir]
+
+Writes wakeup_latency.png, throughput.png, steal.png and overload.png next to the CSV (or into output_dir).
+Requires matplotlib; prints a notice and exits cleanly when it is not installed.
+"""
+
+import csv
+import os
+import sys
+from collections import defaultdict
+
+
+def load(path):
+    with open(path, newline="") as f:
+        return list(csv.DictReader(f))
+
+
+def plot_wakeup_latency(plt, rows, out_dir):
+    series = defaultdict(list)
+    for row in rows:
+        if row["benchmark"] == "wakeup_latency":
+            series[(row["scheduler"], row["metric"])].append(
+                (int(row["threads"]), float(row["value"])))
+
+    fig, ax = plt.subplots(figsize=(8, 5))
+    for (scheduler, metric), points in sorted(series.items()):
+        points.sort()
+        ax.plot([p[0] for p in points], [p[1] for p in points], marker="o",
+                label=f"{scheduler} {metric}")
+    ax.set_xscale("log", base=2)
+    ax.set_yscale("log")
+    ax.set_xlabel("worker threads")
+    ax.set_ylabel("submit -> start latency (ns)")
+    ax.set_title("Wakeup latency")
+    ax.legend(fontsize="small")
+    fig.tight_layout()
+    fig.savefig(os.path.join(out_dir, "wakeup_latency.png"))
+
+
+def plot_throughput(plt, rows, out_dir):
+    series = defaultdict(list)
+    for row in rows:
+        if row["benchmark"] == "throughput":
+            series[(row["scheduler"], int(row["threads"]))].append(
+                (int(row["producers"]), float(row["value"])))
+
+    fig, ax = plt.subplots(figsize=(8, 5))
+    for (scheduler, threads), points in sorted(series.items()):
+        points.sort()
+        ax.plot([p[0] for p in points], [p[1] for p in points], marker="o",
+                label=f"{scheduler} ({threads} threads)")
+    ax.set_xscale("log", base=2)
+    ax.set_xlabel("producers")
+    ax.set_ylabel("tasks / second")
+    ax.set_title("Submission throughput")
+    ax.legend(fontsize="x-small", ncol=2)
+    fig.tight_layout()
+    fig.savefig(os.path.join(out_dir, "throughput.png"))
+
+
+def plot_steal(plt, rows, out_dir):
+    series = defaultdict(list)
+    for row in rows:
+        if row["benchmark"] == "steal" and row["unit"] == "ratio":
+            series[row["metric"]].append((int(row["threads"]), float(row["value"])))
+
+    fig, ax = plt.subplots(figsize=(8, 5))
+    for metric, points in sorted(series.items()):
+        points.sort()
+        ax.plot([p[0] for p in points], [p[1] for p in points], marker="o", label=metric)
+    ax.set_xscale("log", base=2)
+    ax.set_xlabel("worker threads")
+    ax.set_ylabel("ratio")
+    ax.set_title("work_stealing_scheduler under skewed load")
+    ax.legend(fontsize="small")
+    fig.tight_layout()
+    fig.savefig(os.path.join(out_dir, "steal.png"))
+
+
+def plot_overload(plt, rows, out_dir):
+    series = defaultdict(list)
+    for row in rows:
+        if row["benchmark"] == "overload" and row["metric"].startswith("goodput_at_"):
+            load = int(row["metric"][len("goodput_at_"):-1])
+            series[(row["scheduler"], int(row["threads"]))].append((load, float(row["value"])))
+
+    fig, ax = plt.subplots(figsize=(8, 5))
+    for (scheduler, threads), points in sorted(series.items()):
+        points.sort()
+        ax.plot([p[0] for p in points], [p[1] for p in points], marker="o",
+                label=f"{scheduler} ({threads} threads)")
+    ax.set_xscale("log", base=2)
+    ax.set_xlabel("offered load (x capacity)")
+    ax.set_ylabel("tasks finished within deadline / second")
+    ax.set_title("Goodput under overload")
+    ax.legend(fontsize="x-small", ncol=2)
+    fig.tight_layout()
+    fig.savefig(os.path.join(out_dir, "overload.png"))
+
+
+def main(argv):
+    if len(argv) < 2:
+        print(__doc__)
+        return 1
+
+    try:
+        import matplotlib
+        matplotlib.use("Agg")
+        import matplotlib.pyplot as plt
+    except ImportError:
+        print("matplotlib not installed, skipping plots")
+        return 0
+
+    rows = load(argv[1])
+    out_dir = argv[2] if len(argv) > 2 else os.path.dirname(os.path.abspath(argv[1]))
+    os.makedirs(out_dir, exist_ok=True)
+
+    plot_wakeup_latency(plt, rows, out_dir)
+    plot_throughput(plt, rows, out_dir)
+    plot_steal(plt, rows, out_dir)
+    plot_overload(plt, rows, out_dir)
+    print(f"plots written to {out_dir}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,431 @@
+// Scheduler benchmark matrix
+//
+// Measures, for every scheduler and for 1, 2, 4 ... hardware_concurrency worker threads:
+// 1. Wakeup latency (p50/p99/p999): one thread schedules a task and waits until the worker that
+//    runs it has started it; the latency is one way, submit -> task start on the worker
+// 2. Submission throughput: 1..N external producers submit independent tasks concurrently
+// 3. Steal efficiency (work_stealing_scheduler only): heavy-tailed task durations, reported
+//    as ideal makespan / observed makespan plus steal success rate and worker imbalance
+// 4. Goodput under overload (work_stealing_scheduler only): an open-loop producer offers 1x,
+//    2x and 4x the workers' capacity of tasks whose requester waits at most 1 ms, with and
+//    without a deadline in the environment (with_deadline), so with and without load shedding
+//
+// Results are written as long-format CSV:
+//   benchmark,scheduler,threads,producers,metric,value,unit
+// plot_scheduler_benchmarks.py turns the CSV into one PNG per benchmark.
+//
+// Usage: scheduler_benchmarks [--csv FILE] [--max-threads N] [--quick]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <flow/execution.hpp>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace flow::execution;
+
+namespace {
+
+struct config {
+  std::size_t max_threads      = std::max(1U, std::thread::hardware_concurrency());
+  std::size_t wakeup_rounds    = 20'000;
+  std::size_t throughput_tasks = 200'000;
+  std::size_t skew_tasks       = 20'000;
+  std::size_t overload_tasks   = 20'000;
+  std::string csv_path;
+};
+
+auto now_ns() noexcept -> std::uint64_t {
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                        std::chrono::steady_clock::now().time_since_epoch())
+                                        .count());
+}
+
+// Busy-wait for roughly `ns` nanoseconds to simulate CPU-bound work
+void burn(std::uint64_t ns) noexcept {
+  auto deadline = now_ns() + ns;
+  while (now_ns() < deadline) {
+  }
+}
+
+// 1, 2, 4 ... up to max, always including max itself
+auto thread_counts(std::size_t max) -> std::vector<std::size_t> {
+  std::vector<std::size_t> counts;
+  for (std::size_t n = 1; n < max; n *= 2) {
+    counts.push_back(n);
+  }
+  counts.push_back(max);
+  return counts;
+}
+
+// Receiver for fire-and-forget operations whose completion is observed through side effects
+struct sink_receiver {
+  using receiver_concept = receiver_t;
+
+  void set_value() && noexcept {}
+
+  template <class E>
+  void set_error(E&& /*unused*/) && noexcept {
+    std::cerr << "benchmark task failed\n";
+    std::abort();
+  }
+
+  void set_stopped() && noexcept {}
+};
+
+// Receiver that counts completions, including shed (stopped) ones
+struct counting_receiver {
+  using receiver_concept = receiver_t;
+
+  std::atomic<std::size_t>* done;
+
+  void set_value() && noexcept {
+    done->fetch_add(1, std::memory_order_relaxed);
+  }
+
+  template <class E>
+  void set_error(E&& /*unused*/) && noexcept {
+    std::cerr << "benchmark task failed\n";
+    std::abort();
+  }
+
+  void set_stopped() && noexcept {
+    done->fetch_add(1, std::memory_order_relaxed);
+  }
+};
+
+class csv_writer {
+ public:
+  explicit csv_writer(std::ostream& out) : out_(out) {
+    out_ << "benchmark,scheduler,threads,producers,metric,value,unit\n" << std::fixed
+         << std::setprecision(3);
+  }
+
+  void row(std::string_view benchmark, std::string_view scheduler, std::size_t threads,
+           std::size_t producers, std::string_view metric, double value, std::string_view unit) {
+    out_ << benchmark << ',' << scheduler << ',' << threads << ',' << producers << ',' << metric
+         << ',' << value << ',' << unit << '\n'
+         << std::flush;
+  }
+
+ private:
+  std::ostream& out_;
+};
+
+auto percentile(std::vector<std::uint64_t>& samples, double q) -> double {
+  auto index = static_cast<std::size_t>(q * static_cast<double>(samples.size() - 1));
+  std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(index),
+                   samples.end());
+  return static_cast<double>(samples[index]);
+}
+
+// ============================================================================
+// Wakeup latency
+// ============================================================================
+
+template <class Sched>
+void wakeup_latency(csv_writer& csv, std::string_view name, Sched sched, std::size_t threads,
+                    std::size_t rounds) {
+  std::vector<std::uint64_t> samples;
+  samples.reserve(rounds);
+
+  for (std::size_t i = 0; i < rounds + rounds / 10; ++i) {
+    std::atomic<bool> done{false};
+    std::uint64_t     submitted = 0;
+    std::uint64_t     started   = 0;
+
+    auto op = connect(schedule(sched) | then([&] {
+                        started = now_ns();
+                        done.store(true, std::memory_order_release);
+                      }),
+                      sink_receiver{});
+
+    submitted = now_ns();
+    op.start();
+    while (!done.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+
+    // The first tenth of the rounds warms up caches and task free lists
+    if (i >= rounds / 10) {
+      samples.push_back(started - submitted);
+    }
+  }
+
+  csv.row("wakeup_latency", name, threads, 1, "p50", percentile(samples, 0.50), "ns");
+  csv.row("wakeup_latency", name, threads, 1, "p99", percentile(samples, 0.99), "ns");
+  csv.row("wakeup_latency", name, threads, 1, "p999", percentile(samples, 0.999), "ns");
+}
+
+// ============================================================================
+// Submission throughput from external producers
+// ============================================================================
+
+template <class Sched>
+void throughput(csv_writer& csv, std::string_view name, Sched sched, std::size_t threads,
+                std::size_t producers, std::size_t total_tasks) {
+  const std::size_t        per_producer = total_tasks / producers;
+  std::atomic<std::size_t> completed{0};
+
+  auto make_op = [&] {
+    return connect(schedule(sched)
+                       | then([&completed] { completed.fetch_add(1, std::memory_order_relaxed); }),
+                   sink_receiver{});
+  };
+  using op_t = decltype(make_op());
+
+  // Operation states must outlive their tasks, so each producer owns preallocated storage
+  std::vector<std::vector<std::optional<op_t>>> ops(producers);
+  for (auto& slots : ops) {
+    slots = std::vector<std::optional<op_t>>(per_producer);
+  }
+
+  std::atomic<bool>        go{false};
+  std::atomic<std::size_t> ready{0};
+  std::vector<std::thread> workers;
+  workers.reserve(producers);
+  for (std::size_t p = 0; p < producers; ++p) {
+    workers.emplace_back([&, p] {
+      ready.fetch_add(1, std::memory_order_relaxed);
+      while (!go.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      for (auto& slot : ops[p]) {
+        slot.emplace(__emplace_from{make_op});
+        slot->start();
+      }
+    });
+  }
+
+  while (ready.load(std::memory_order_relaxed) != producers) {
+    std::this_thread::yield();
+  }
+
+  const auto expected = per_producer * producers;
+  const auto start    = now_ns();
+  go.store(true, std::memory_order_release);
+  while (completed.load(std::memory_order_relaxed) != expected) {
+    std::this_thread::yield();
+  }
+  const auto elapsed = now_ns() - start;
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  auto seconds = static_cast<double>(elapsed) / 1e9;
+  csv.row("throughput", name, threads, producers, "tasks_per_second",
+          static_cast<double>(expected) / seconds, "tasks/s");
+}
+
+// ============================================================================
+// Steal efficiency under skewed load
+// ============================================================================
+
+void steal_efficiency(csv_writer& csv, std::size_t threads, std::size_t tasks) {
+  work_stealing_scheduler ws(threads);
+  auto                    sched = ws.get_scheduler();
+
+  // Heavy-tailed durations: one task in 16 is 50x longer than the rest
+  auto duration_of = [](std::size_t i) -> std::uint64_t { return i % 16 == 0 ? 100'000 : 2'000; };
+
+  std::uint64_t total_work = 0;
+  for (std::size_t i = 0; i < tasks; ++i) {
+    total_work += duration_of(i);
+  }
+
+  std::atomic<std::size_t> completed{0};
+
+  auto make_op = [&](std::size_t i) {
+    return connect(schedule(sched) | then([&completed, ns = duration_of(i)] {
+                     burn(ns);
+                     completed.fetch_add(1, std::memory_order_relaxed);
+                   }),
+                   sink_receiver{});
+  };
+  using op_t = decltype(make_op(0));
+
+  std::vector<std::optional<op_t>> ops(tasks);
+
+  const auto start = now_ns();
+  for (std::size_t i = 0; i < tasks; ++i) {
+    ops[i].emplace(__emplace_from{[&make_op, i] { return make_op(i); }});
+    ops[i]->start();
+  }
+  while (completed.load(std::memory_order_relaxed) != tasks) {
+    std::this_thread::yield();
+  }
+  const auto elapsed = now_ns() - start;
+
+  std::uint64_t attempted = 0;
+  std::uint64_t succeeded = 0;
+  std::uint64_t busiest   = 0;
+  for (std::size_t i = 0; i < threads; ++i) {
+    auto stats = ws.get_stats(i);
+    attempted += stats.steals_attempted;
+    succeeded += stats.steals_succeeded;
+    busiest = std::max(busiest, stats.tasks_executed);
+  }
+
+  auto ideal      = static_cast<double>(total_work) / static_cast<double>(threads);
+  auto mean_tasks = static_cast<double>(tasks) / static_cast<double>(threads);
+  csv.row("steal", "work_stealing", threads, 1, "efficiency",
+          ideal / static_cast<double>(elapsed), "ratio");
+  csv.row("steal", "work_stealing", threads, 1, "steal_success_rate",
+          attempted == 0 ? 0.0 : static_cast<double>(succeeded) / static_cast<double>(attempted),
+          "ratio");
+  csv.row("steal", "work_stealing", threads, 1, "steals", static_cast<double>(succeeded),
+          "count");
+  csv.row("steal", "work_stealing", threads, 1, "imbalance",
+          static_cast<double>(busiest) / mean_tasks, "ratio");
+}
+
+// ============================================================================
+// Goodput under overload
+// ============================================================================
+
+// Tasks take 20 us; the producer submits them at `load` times what the workers can run and
+// each requester gives up 1 ms after submitting. Goodput counts tasks that finished before
+// their requester gave up. Without shedding the backlog grows until nearly every task is late;
+// with it, expired tasks are dropped and the workers keep finishing fresh ones on time.
+void overload_goodput(csv_writer& csv, std::size_t threads, std::size_t tasks, int load,
+                      bool shed) {
+  constexpr std::uint64_t work_ns  = 20'000;
+  constexpr auto          patience = std::chrono::milliseconds(1);
+
+  work_stealing_scheduler  ws(threads);
+  auto                     sched = ws.get_scheduler();
+  std::atomic<std::size_t> done{0};
+  std::atomic<std::size_t> on_time{0};
+
+  using time_point = get_deadline_t::time_point;
+
+  auto make_op = [&](time_point gives_up, time_point deadline) {
+    return connect(schedule(sched) | then([&on_time, gives_up] {
+                     burn(work_ns);
+                     if (std::chrono::steady_clock::now() <= gives_up) {
+                       on_time.fetch_add(1, std::memory_order_relaxed);
+                     }
+                   }) | with_deadline(deadline),
+                   counting_receiver{&done});
+  };
+  using op_t = decltype(make_op(time_point{}, time_point{}));
+
+  std::vector<std::optional<op_t>> ops(tasks);
+
+  const auto interval = work_ns / (threads * static_cast<std::uint64_t>(load));
+  const auto start    = now_ns();
+  for (std::size_t i = 0; i < tasks; ++i) {
+    while (now_ns() < start + (i * interval)) {
+    }
+    const auto gives_up = std::chrono::steady_clock::now() + patience;
+    const auto deadline = shed ? gives_up : time_point::max();
+    ops[i].emplace(__emplace_from{[&make_op, gives_up, deadline] {
+      return make_op(gives_up, deadline);
+    }});
+    ops[i]->start();
+  }
+  while (done.load(std::memory_order_relaxed) != tasks) {
+    std::this_thread::yield();
+  }
+  const auto elapsed = now_ns() - start;
+
+  std::uint64_t shed_tasks = 0;
+  for (std::size_t i = 0; i < threads; ++i) {
+    shed_tasks += ws.get_stats(i).tasks_shed;
+  }
+
+  const std::string_view name   = shed ? "work_stealing_shed" : "work_stealing";
+  const std::string      suffix = "_at_" + std::to_string(load) + "x";
+  csv.row("overload", name, threads, 1, "goodput" + suffix,
+          static_cast<double>(on_time.load()) * 1e9 / static_cast<double>(elapsed),
+          "tasks/s");
+  csv.row("overload", name, threads, 1, "shed" + suffix, static_cast<double>(shed_tasks),
+          "count");
+}
+
+auto parse_args(int argc, char** argv) -> config {
+  config cfg;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg == "--csv" && i + 1 < argc) {
+      cfg.csv_path = argv[++i];
+    } else if (arg == "--max-threads" && i + 1 < argc) {
+      cfg.max_threads = std::max<std::size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "--quick") {
+      cfg.wakeup_rounds    = 2'000;
+      cfg.throughput_tasks = 20'000;
+      cfg.skew_tasks       = 2'000;
+      cfg.overload_tasks   = 2'000;
+    } else {
+      std::cerr << "usage: scheduler_benchmarks [--csv FILE] [--max-threads N] [--quick]\n";
+      std::exit(arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+  }
+  return cfg;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  auto cfg = parse_args(argc, argv);
+
+  std::ofstream file;
+  if (!cfg.csv_path.empty()) {
+    file.open(cfg.csv_path);
+    if (!file) {
+      std::cerr << "cannot open " << cfg.csv_path << '\n';
+      return EXIT_FAILURE;
+    }
+  }
+  csv_writer csv(cfg.csv_path.empty() ? std::cout : file);
+
+  const auto counts = thread_counts(cfg.max_threads);
+
+  // run_loop is single-threaded by construction: one driver thread runs it
+  {
+    run_loop    loop;
+    std::thread driver([&loop] { loop.run(); });
+    wakeup_latency(csv, "run_loop", loop.get_scheduler(), 1, cfg.wakeup_rounds);
+    for (auto producers : counts) {
+      throughput(csv, "run_loop", loop.get_scheduler(), 1, producers, cfg.throughput_tasks);
+    }
+    loop.finish();
+    driver.join();
+  }
+
+  for (auto threads : counts) {
+    {
+      thread_pool pool(threads);
+      wakeup_latency(csv, "thread_pool", pool.get_scheduler(), threads, cfg.wakeup_rounds);
+      for (auto producers : counts) {
+        throughput(csv, "thread_pool", pool.get_scheduler(), threads, producers,
+                   cfg.throughput_tasks);
+      }
+    }
+    {
+      work_stealing_scheduler ws(threads);
+      wakeup_latency(csv, "work_stealing", ws.get_scheduler(), threads, cfg.wakeup_rounds);
+      for (auto producers : counts) {
+        throughput(csv, "work_stealing", ws.get_scheduler(), threads, producers,
+                   cfg.throughput_tasks);
+      }
+    }
+    steal_efficiency(csv, threads, cfg.skew_tasks);
+    for (int load : {1, 2, 4}) {
+      overload_goodput(csv, threads, cfg.overload_tasks, load, false);
+      overload_goodput(csv, threads, cfg.overload_tasks, load, true);
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,185 @@
+// STREAM-style memory bandwidth benchmark
+//
+// Runs the four STREAM kernels over three numa_vector<double> arrays with bulk_chunked(par)
+// on a work_stealing_scheduler, in three setups:
+//   topology_off:  floating workers; arrays filled by bulk_allocate, chunks go to any worker
+//   topology_on:   pinned workers; arrays filled by bulk_allocate, so every page is first
+//                  touched by the worker that runs its indices in the kernels
+//   serial_init:   pinned workers, but the arrays are filled by the main thread, so every page
+//                  sits on the main thread's node (the layout first-touch allocation avoids)
+// On a single-node machine the three match; the gap between topology_on and the others is the
+// cost of remote memory.
+//
+// Kernels (n elements, best of --reps runs, bytes counted as in STREAM):
+//   copy:  c[i] = a[i]              16 bytes per element
+//   scale: b[i] = s * c[i]          16 bytes per element
+//   add:   c[i] = a[i] + b[i]       24 bytes per element
+//   triad: a[i] = b[i] + s * c[i]   24 bytes per element
+//
+// Results are written as long-format CSV:
+//   benchmark,setup,threads,metric,value,unit
+//
+// Usage: stream_benchmarks [--csv FILE] [--threads N] [--elements N] [--reps N] [--quick]
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <flow/execution.hpp>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace {
+
+using namespace flow::execution;
+using flow::this_thread::sync_wait;
+
+struct config {
+  std::size_t threads{std::max(1U, std::thread::hardware_concurrency())};
+  std::size_t elements{std::size_t{1} << 24};  // 128 MiB per array
+  int         reps{10};
+  std::string csv_path;
+};
+
+class csv_writer {
+ public:
+  explicit csv_writer(std::ostream& out) : out_(out) {
+    out_ << "benchmark,setup,threads,metric,value,unit\n" << std::fixed << std::setprecision(3);
+  }
+
+  void row(std::string_view benchmark, std::string_view setup, std::size_t threads,
+           std::string_view metric, double value, std::string_view unit) {
+    out_ << benchmark << ',' << setup << ',' << threads << ',' << metric << ',' << value << ','
+         << unit << '\n'
+         << std::flush;
+  }
+
+ private:
+  std::ostream& out_;
+};
+
+constexpr double scalar = 3.0;
+
+struct arrays {
+  numa_vector<double> a;
+  numa_vector<double> b;
+  numa_vector<double> c;
+};
+
+template <class Sched>
+auto allocate_parallel(Sched sched, std::size_t n) -> arrays {
+  auto fill = [&](double value) {
+    auto init = [value](std::size_t /*unused*/) noexcept { return value; };
+    return std::get<0>(std::move(*sync_wait(bulk_allocate<double>(sched, n, init))));
+  };
+  return {fill(1.0), fill(2.0), fill(0.0)};
+}
+
+auto allocate_serial(std::size_t n) -> arrays {
+  arrays out{numa_vector<double>(n), numa_vector<double>(n), numa_vector<double>(n)};
+  std::fill(out.a.begin(), out.a.end(), 1.0);
+  std::fill(out.b.begin(), out.b.end(), 2.0);
+  std::fill(out.c.begin(), out.c.end(), 0.0);
+  return out;
+}
+
+// Best bandwidth in GB/s of `reps` parallel passes of kernel(begin, end)
+template <class Sched, class Kernel>
+auto best_gbps(Sched sched, std::size_t n, int reps, double bytes_per_element, Kernel kernel)
+    -> double {
+  double best = 0;
+  for (int r = 0; r < reps; ++r) {
+    const auto begin = std::chrono::steady_clock::now();
+    sync_wait(schedule(sched) | bulk_chunked(par, n, kernel));
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    best = std::max(best, bytes_per_element * static_cast<double>(n) / seconds / 1e9);
+  }
+  return best;
+}
+
+void run_setup(csv_writer& csv, std::string_view setup, const config& cfg, topology_mode mode,
+               bool serial_init) {
+  work_stealing_scheduler ws(cfg.threads, mode);
+  auto                    sched = ws.get_scheduler();
+  const std::size_t       n     = cfg.elements;
+
+  arrays  data = serial_init ? allocate_serial(n) : allocate_parallel(sched, n);
+  double* a    = data.a.data();
+  double* b    = data.b.data();
+  double* c    = data.c.data();
+
+  const auto report = [&](std::string_view kernel, double gbps) {
+    csv.row(kernel, setup, cfg.threads, "bandwidth", gbps, "GB/s");
+  };
+  report("copy", best_gbps(sched, n, cfg.reps, 16, [=](std::size_t lo, std::size_t hi) noexcept {
+           for (std::size_t i = lo; i < hi; ++i) {
+             c[i] = a[i];
+           }
+         }));
+  report("scale", best_gbps(sched, n, cfg.reps, 16, [=](std::size_t lo, std::size_t hi) noexcept {
+           for (std::size_t i = lo; i < hi; ++i) {
+             b[i] = scalar * c[i];
+           }
+         }));
+  report("add", best_gbps(sched, n, cfg.reps, 24, [=](std::size_t lo, std::size_t hi) noexcept {
+           for (std::size_t i = lo; i < hi; ++i) {
+             c[i] = a[i] + b[i];
+           }
+         }));
+  report("triad", best_gbps(sched, n, cfg.reps, 24, [=](std::size_t lo, std::size_t hi) noexcept {
+           for (std::size_t i = lo; i < hi; ++i) {
+             a[i] = b[i] + (scalar * c[i]);
+           }
+         }));
+}
+
+auto parse_args(int argc, char** argv) -> config {
+  config cfg;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg == "--csv" && i + 1 < argc) {
+      cfg.csv_path = argv[++i];
+    } else if (arg == "--threads" && i + 1 < argc) {
+      cfg.threads = std::max<std::size_t>(1, std::stoul(argv[++i]));
+    } else if (arg == "--elements" && i + 1 < argc) {
+      cfg.elements = std::max<std::size_t>(1, std::stoul(argv[++i]));
+    } else if (arg == "--reps" && i + 1 < argc) {
+      cfg.reps = std::max(1, std::stoi(argv[++i]));
+    } else if (arg == "--quick") {
+      cfg.elements = std::size_t{1} << 20;
+      cfg.reps     = 3;
+    } else {
+      std::cerr << "usage: stream_benchmarks [--csv FILE] [--threads N] [--elements N] "
+                   "[--reps N] [--quick]\n";
+      std::exit(arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+  }
+  return cfg;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  auto cfg = parse_args(argc, argv);
+
+  std::ofstream file;
+  if (!cfg.csv_path.empty()) {
+    file.open(cfg.csv_path);
+    if (!file) {
+      std::cerr << "cannot open " << cfg.csv_path << '\n';
+      return EXIT_FAILURE;
+    }
+  }
+  csv_writer csv(cfg.csv_path.empty() ? std::cout : file);
+
+  run_setup(csv, "topology_off", cfg, topology_mode::off, false);
+  run_setup(csv, "topology_on", cfg, topology_mode::on, false);
+  run_setup(csv, "serial_init", cfg, topology_mode::on, true);
+
+  return EXIT_SUCCESS;
+}
@@ -3,8 +3,12 @@
 // Global module fragment - include standard library headers here
 module;
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <bit>
 #include <cassert>
+#include <charconv>
 #include <chrono>
 #include <concepts>
 #include <condition_variable>
@@ -16,9 +20,15 @@ module;
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <ostream>
 #include <queue>
+#include <new>
 #include <random>
+#include <source_location>
+#include <stdexcept>
 #include <stop_token>
+#include <string>
+#include <string_view>
 #include <thread>
 #include <tuple>
 #include <type_traits>
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "parking_lot.hpp"
+
+namespace flow::detail {
+
+// Adaptive mutex
+//
+// A one-byte lock: bit 0 is "locked", bit 1 is "a thread is parked on this lock". Lock and
+// unlock are a single compare-and-swap when uncontended. A contended lock() spins with
+// exponential backoff while nobody is parked, then sets the parked bit and sleeps in the
+// parking lot under the lock's address. unlock() with the parked bit set wakes the oldest
+// sleeper and releases the lock, and the woken thread competes for it. A woken thread that
+// loses goes back to the head of the queue. Once the sleeper being woken has waited longer
+// than starve_after, or about once a millisecond per parking-lot bucket, unlock() hands the
+// lock over directly instead (it stays locked and the woken thread owns it), so threads
+// re-locking in a loop cannot starve the sleepers.
+
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+class adaptive_mutex {
+ public:
+  constexpr adaptive_mutex() noexcept = default;
+
+  adaptive_mutex(const adaptive_mutex&)                    = delete;
+  auto operator=(const adaptive_mutex&) -> adaptive_mutex& = delete;
+
+  void lock() noexcept {
+    std::uint8_t expected = 0;
+    if (!state_.compare_exchange_weak(expected, locked_bit, std::memory_order_acquire,
+                                      std::memory_order_relaxed)) {
+      lock_slow();
+    }
+  }
+
+  auto try_lock() noexcept -> bool {
+    std::uint8_t state = state_.load(std::memory_order_relaxed);
+    while ((state & locked_bit) == 0) {
+      if (state_.compare_exchange_weak(state, state | locked_bit, std::memory_order_acquire,
+                                       std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void unlock() noexcept {
+    std::uint8_t expected = locked_bit;
+    if (!state_.compare_exchange_strong(expected, 0, std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+      unlock_slow();
+    }
+  }
+
+ private:
+  static constexpr std::uint8_t  locked_bit    = 1;
+  static constexpr std::uint8_t  parked_bit    = 2;
+  static constexpr unsigned      spin_rounds   = 10;  // Pause 1, 2, 4 ... 32 times, then yield
+  static constexpr std::intptr_t handoff_token = 1;
+  static constexpr auto          starve_after  = std::chrono::milliseconds(1);
+
+  static void backoff(unsigned round) noexcept {
+    if (round < 6) {
+      for (unsigned i = 0; i < (1U << round); ++i) {
+        cpu_relax();
+      }
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  void lock_slow() noexcept {
+    unsigned round = 0;
+    bool     woken = false;
+    while (true) {
+      std::uint8_t state = state_.load(std::memory_order_relaxed);
+      if ((state & locked_bit) == 0) {
+        if (state_.compare_exchange_weak(state, state | locked_bit, std::memory_order_acquire,
+                                         std::memory_order_relaxed)) {
+          return;
+        }
+        continue;
+      }
+
+      // Spinning is only worth it while nobody sleeps: the lock will otherwise go to them
+      if ((state & parked_bit) == 0 && round < spin_rounds) {
+        backoff(round++);
+        continue;
+      }
+      if ((state & parked_bit) == 0
+          && !state_.compare_exchange_weak(state, state | parked_bit, std::memory_order_relaxed,
+                                           std::memory_order_relaxed)) {
+        continue;
+      }
+
+      auto result = parking_lot::park(
+          this,
+          [this] { return state_.load(std::memory_order_relaxed) == (locked_bit | parked_bit); },
+          [] {}, std::nullopt, woken);
+      if (result.unparked && result.token == handoff_token) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return;  // The unlocking thread handed the lock over
+      }
+      woken = woken || result.unparked;
+    }
+  }
+
+  void unlock_slow() noexcept {
+    std::uint8_t state = state_.load(std::memory_order_relaxed);
+    while (state == locked_bit) {
+      // The CAS in unlock() failed spuriously or the parked bit was just cleared
+      if (state_.compare_exchange_weak(state, 0, std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+        return;
+      }
+    }
+
+    parking_lot::unpark_one(this, [this](parking_lot::unpark_result result) -> std::intptr_t {
+      if (result.unparked && (result.be_fair || result.waited >= starve_after)) {
+        // Keep the lock held: it now belongs to the woken thread
+        if (!result.more_waiters) {
+          state_.store(locked_bit, std::memory_order_release);
+        }
+        return handoff_token;
+      }
+      state_.store(result.more_waiters ? parked_bit : 0, std::memory_order_release);
+      return 0;
+    });
+  }
+
+  std::atomic<std::uint8_t> state_{0};
+};
+
+// Condition variable for adaptive_mutex (or any lock): waiters park on the condition
+// variable's address, so it is as compact as the mutex
+class adaptive_condition_variable {
+ public:
+  constexpr adaptive_condition_variable() noexcept = default;
+
+  adaptive_condition_variable(const adaptive_condition_variable&) = delete;
+  auto operator=(const adaptive_condition_variable&) -> adaptive_condition_variable& = delete;
+
+  void notify_one() noexcept {
+    if (!has_waiters_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    parking_lot::unpark_one(&has_waiters_, [this](parking_lot::unpark_result result) {
+      has_waiters_.store(result.more_waiters, std::memory_order_relaxed);
+      return std::intptr_t{0};
+    });
+  }
+
+  void notify_all() noexcept {
+    if (!has_waiters_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    parking_lot::unpark_all(&has_waiters_,
+                            [this] { has_waiters_.store(false, std::memory_order_relaxed); });
+  }
+
+  template <class Lock>
+  void wait(Lock& lock) {
+    wait_impl(lock, std::nullopt);
+  }
+
+  template <class Lock, class Predicate>
+  void wait(Lock& lock, Predicate pred) {
+    while (!pred()) {
+      wait(lock);
+    }
+  }
+
+  template <class Lock, class Clock, class Duration>
+  auto wait_until(Lock& lock, const std::chrono::time_point<Clock, Duration>& deadline)
+      -> std::cv_status {
+    return wait_impl(lock, to_steady(deadline)) ? std::cv_status::no_timeout
+                                                : std::cv_status::timeout;
+  }
+
+  template <class Lock, class Clock, class Duration, class Predicate>
+  auto wait_until(Lock& lock, const std::chrono::time_point<Clock, Duration>& deadline,
+                  Predicate pred) -> bool {
+    while (!pred()) {
+      if (wait_until(lock, deadline) == std::cv_status::timeout) {
+        return pred();
+      }
+    }
+    return true;
+  }
+
+  template <class Lock, class Rep, class Period>
+  auto wait_for(Lock& lock, const std::chrono::duration<Rep, Period>& timeout) -> std::cv_status {
+    return wait_until(lock, std::chrono::steady_clock::now() + timeout);
+  }
+
+  template <class Lock, class Rep, class Period, class Predicate>
+  auto wait_for(Lock& lock, const std::chrono::duration<Rep, Period>& timeout, Predicate pred)
+      -> bool {
+    return wait_until(lock, std::chrono::steady_clock::now() + timeout, std::move(pred));
+  }
+
+ private:
+  template <class Clock, class Duration>
+  static auto to_steady(const std::chrono::time_point<Clock, Duration>& deadline)
+      -> std::chrono::steady_clock::time_point {
+    if constexpr (std::is_same_v<Clock, std::chrono::steady_clock>) {
+      return std::chrono::time_point_cast<std::chrono::steady_clock::duration>(deadline);
+    } else {
+      return std::chrono::steady_clock::now()
+             + std::chrono::duration_cast<std::chrono::steady_clock::duration>(deadline
+                                                                               - Clock::now());
+    }
+  }
+
+  // Queues the caller before releasing `lock`, so a notify after the release cannot be missed.
+  // False on timeout.
+  template <class Lock>
+  auto wait_impl(Lock& lock, std::optional<std::chrono::steady_clock::time_point> deadline)
+      -> bool {
+    auto result = parking_lot::park(
+        &has_waiters_,
+        [this] {
+          has_waiters_.store(true, std::memory_order_relaxed);
+          return true;
+        },
+        [&lock] { lock.unlock(); }, deadline);
+    lock.lock();
+    return result.unparked;
+  }
+
+  std::atomic<bool> has_waiters_{false};
+};
+
+}  // namespace flow::detail
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include "../execution/histogram.hpp"
+#include "adaptive_mutex.hpp"
+
+#if defined(FLOW_ENABLE_LOCK_PROFILING)
+#include <atomic>
+#include <chrono>
+#include <source_location>
+#endif
+
+namespace flow::detail {
+
+// Library-internal mutex
+//
+// Every lock inside flow goes through detail::mutex, constructed with the name of its lock
+// site. In a regular build it is a std::mutex that ignores the name. With
+// FLOW_ENABLE_ADAPTIVE_MUTEX defined it is an adaptive_mutex instead (one byte, spins briefly,
+// then parks in the parking lot); that stays opt-in until multi-core measurements show it
+// beats std::mutex without hurting fairness. With
+// FLOW_ENABLE_LOCK_PROFILING defined, each mutex is attributed to a lock site (name plus the
+// source location that constructed it). Every acquisition of a site is counted, and an
+// acquisition that finds the mutex held also records how long the caller waited into the
+// site's wait-time histogram. lock_profile_snapshot() and write_lock_profile() report them.
+//
+// Waiting on a detail::mutex goes through detail::condition_variable and detail::unique_lock,
+// which are the std types in a regular build and adaptive_condition_variable with
+// std::unique_lock<detail::mutex> in an adaptive one.
+
+#if defined(FLOW_ENABLE_ADAPTIVE_MUTEX)
+inline constexpr bool adaptive_mutex_enabled = true;
+using backing_mutex                          = adaptive_mutex;
+#else
+inline constexpr bool adaptive_mutex_enabled = false;
+using backing_mutex                          = std::mutex;
+#endif
+
+struct lock_site_snapshot {
+  std::string_view              name;
+  std::string_view              file;
+  std::string_view              function;
+  std::uint_least32_t           line{0};
+  std::uint64_t                 acquisitions{0};
+  std::uint64_t                 contended{0};
+  execution::histogram_snapshot wait;  // Wait time of contended acquisitions
+};
+
+#if defined(FLOW_ENABLE_LOCK_PROFILING)
+
+inline constexpr bool lock_profiling_enabled = true;
+
+// Counters shared by every mutex constructed at the same site
+struct lock_site {
+  lock_site(std::string_view site_name, const std::source_location& loc) noexcept
+      : name(site_name), location(loc) {}
+
+  const std::string_view       name;
+  const std::source_location   location;
+  std::atomic<std::uint64_t>   acquisitions{0};
+  std::atomic<std::uint64_t>   contended{0};
+  execution::latency_histogram wait;
+  lock_site*                   next{nullptr};
+};
+
+// Registry of lock sites; lookups and insertions never block. Sites are never freed, so
+// mutexes owned by static objects stay valid during shutdown.
+class lock_profiler {
+ public:
+  static auto global() noexcept -> lock_profiler& {
+    static lock_profiler profiler;
+    return profiler;
+  }
+
+  // Find or create the site for a mutex constructed at `loc`
+  auto site(std::string_view name, const std::source_location& loc) -> lock_site& {
+    auto* head = head_.load(std::memory_order_acquire);
+    if (auto* found = find(head, nullptr, name, loc)) {
+      return *found;
+    }
+
+    auto* node = new lock_site(name, loc);  // NOLINT(cppcoreguidelines-owning-memory)
+    while (true) {
+      node->next = head;
+      if (head_.compare_exchange_weak(head, node, std::memory_order_acq_rel,
+                                      std::memory_order_acquire)) {
+        return *node;
+      }
+      // Lost the race: only the nodes pushed since our last look can match
+      if (auto* found = find(head, node->next, name, loc)) {
+        delete node;  // NOLINT(cppcoreguidelines-owning-memory)
+        return *found;
+      }
+    }
+  }
+
+  [[nodiscard]] auto snapshot() const -> std::vector<lock_site_snapshot> {
+    std::vector<lock_site_snapshot> sites;
+    for (auto* s = head_.load(std::memory_order_acquire); s != nullptr; s = s->next) {
+      sites.push_back({.name         = s->name,
+                       .file         = s->location.file_name(),
+                       .function     = s->location.function_name(),
+                       .line         = s->location.line(),
+                       .acquisitions = s->acquisitions.load(std::memory_order_relaxed),
+                       .contended    = s->contended.load(std::memory_order_relaxed),
+                       .wait         = s->wait.snapshot()});
+    }
+    return sites;
+  }
+
+  void reset() noexcept {
+    for (auto* s = head_.load(std::memory_order_acquire); s != nullptr; s = s->next) {
+      s->acquisitions.store(0, std::memory_order_relaxed);
+      s->contended.store(0, std::memory_order_relaxed);
+      s->wait.reset();
+    }
+  }
+
+ private:
+  static auto find(lock_site* from, const lock_site* until, std::string_view name,
+                   const std::source_location& loc) noexcept -> lock_site* {
+    for (auto* s = from; s != until; s = s->next) {
+      if (s->location.line() == loc.line() && s->name == name
+          && std::string_view(s->location.file_name()) == loc.file_name()) {
+        return s;
+      }
+    }
+    return nullptr;
+  }
+
+  std::atomic<lock_site*> head_{nullptr};
+};
+
+class mutex {
+ public:
+  mutex(std::source_location loc = std::source_location::current())  // NOLINT
+      : site_(&lock_profiler::global().site({}, loc)) {}
+
+  explicit mutex(std::string_view     name,
+                 std::source_location loc = std::source_location::current())
+      : site_(&lock_profiler::global().site(name, loc)) {}
+
+  mutex(const mutex&)                    = delete;
+  auto operator=(const mutex&) -> mutex& = delete;
+
+  void lock() {
+    site_->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    if (mutex_.try_lock()) {
+      return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    mutex_.lock();
+    const auto waited = std::chrono::steady_clock::now() - start;
+    site_->contended.fetch_add(1, std::memory_order_relaxed);
+    site_->wait.record(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count()));
+  }
+
+  auto try_lock() -> bool {
+    if (!mutex_.try_lock()) {
+      return false;
+    }
+    site_->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  void unlock() {
+    mutex_.unlock();
+  }
+
+ private:
+  backing_mutex mutex_;
+  lock_site*    site_;
+};
+
+using unique_lock = std::unique_lock<mutex>;
+#if defined(FLOW_ENABLE_ADAPTIVE_MUTEX)
+using condition_variable = adaptive_condition_variable;
+#else
+using condition_variable = std::condition_variable_any;
+#endif
+
+inline auto lock_profile_snapshot() -> std::vector<lock_site_snapshot> {
+  return lock_profiler::global().snapshot();
+}
+
+inline void lock_profile_reset() noexcept {
+  lock_profiler::global().reset();
+}
+
+#else
+
+inline constexpr bool lock_profiling_enabled = false;
+
+class mutex : public backing_mutex {
+ public:
+  constexpr mutex() noexcept = default;
+
+  constexpr explicit mutex(std::string_view /*name*/) noexcept {}
+};
+
+#if defined(FLOW_ENABLE_ADAPTIVE_MUTEX)
+using unique_lock        = std::unique_lock<mutex>;
+using condition_variable = adaptive_condition_variable;
+#else
+using unique_lock        = std::unique_lock<std::mutex>;
+using condition_variable = std::condition_variable;
+#endif
+
+inline auto lock_profile_snapshot() -> std::vector<lock_site_snapshot> {
+  return {};
+}
+
+inline void lock_profile_reset() noexcept {}
+
+#endif
+
+// Text report of every lock site, most contended first
+inline void write_lock_profile(std::ostream& out) {
+  if (!lock_profiling_enabled) {
+    out << "lock profiling disabled (build with FLOW_ENABLE_LOCK_PROFILING)\n";
+    return;
+  }
+
+  auto sites = lock_profile_snapshot();
+  std::ranges::sort(sites, [](const auto& a, const auto& b) {
+    return a.wait.sum_ns != b.wait.sum_ns ? a.wait.sum_ns > b.wait.sum_ns
+                                          : a.contended > b.contended;
+  });
+
+  out << "site acquisitions contended wait_total_ns wait_p50_ns wait_p99_ns wait_max_ns "
+         "location\n";
+  for (const auto& s : sites) {
+    out << (s.name.empty() ? std::string_view("<unnamed>") : s.name) << ' ' << s.acquisitions
+        << ' ' << s.contended << ' ' << s.wait.sum_ns << ' ' << s.wait.percentile(0.5) << ' '
+        << s.wait.percentile(0.99) << ' ' << s.wait.max_ns << ' ' << s.file << ':' << s.line
+        << '\n';
+  }
+}
+
+}  // namespace flow::detail
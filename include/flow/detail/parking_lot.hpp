@@ -0,0 +1,256 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace flow::detail {
+
+// Parking lot
+//
+// A process-wide table of wait queues keyed by address, in the style of WebKit's ParkingLot:
+// a lock word needs no queue of its own, only a "someone is parked" bit, because the queue for
+// its address lives here. Addresses hash onto a fixed array of buckets; each bucket has a small
+// lock and a FIFO of parked threads, every thread parking on its own thread-local slot. All
+// decisions that must be atomic with the queue (validate on park, the callback on unpark) run
+// under the bucket lock, which is what lets a lock word stay one byte.
+namespace parking_lot {
+
+struct unpark_result {
+  bool unparked{false};      // A thread was removed from the queue
+  bool more_waiters{false};  // Threads are still parked on the address
+  bool be_fair{false};       // Time for a fair handoff: about once a millisecond per bucket
+  // How long the woken thread has been waiting, its earlier waits on the address included
+  std::chrono::steady_clock::duration waited{};
+};
+
+struct park_result {
+  bool          unparked{false};  // False when validation failed or the deadline passed
+  std::intptr_t token{0};         // Value returned by the unparker's callback
+};
+
+namespace _detail {
+
+// Per-thread parking slot
+struct thread_data {
+  std::mutex              mutex;
+  std::condition_variable cv;
+  bool                    parked{false};  // Guarded by `mutex`
+  const void*             address{nullptr};
+  std::intptr_t           token{0};
+  thread_data*            next{nullptr};
+  // Start of the wait, kept when the thread requeues
+  std::chrono::steady_clock::time_point since{};
+};
+
+inline auto this_thread_data() -> thread_data& {
+  thread_local thread_data data;
+  return data;
+}
+
+struct alignas(64) bucket {
+  std::mutex                            mutex;
+  thread_data*                          head{nullptr};
+  thread_data*                          tail{nullptr};
+  std::chrono::steady_clock::time_point next_fair{};
+  std::uint32_t                         seed{0x9E3779B9U};
+
+  // Removes the first thread parked on `address`; `more` tells whether another one is left
+  auto dequeue(const void* address, bool& more) noexcept -> thread_data* {
+    more              = false;
+    thread_data* prev = nullptr;
+    thread_data* t    = head;
+    while (t != nullptr && t->address != address) {
+      prev = t;
+      t    = t->next;
+    }
+    if (t == nullptr) {
+      return nullptr;
+    }
+    (prev != nullptr ? prev->next : head) = t->next;
+    if (tail == t) {
+      tail = prev;
+    }
+    for (thread_data* u = t->next; u != nullptr; u = u->next) {
+      if (u->address == address) {
+        more = true;
+        break;
+      }
+    }
+    return t;
+  }
+
+  auto remove(thread_data* target) noexcept -> bool {
+    thread_data* prev = nullptr;
+    for (thread_data* t = head; t != nullptr; prev = t, t = t->next) {
+      if (t == target) {
+        (prev != nullptr ? prev->next : head) = t->next;
+        if (tail == t) {
+          tail = prev;
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void enqueue(thread_data* t) noexcept {
+    t->next                               = nullptr;
+    (tail != nullptr ? tail->next : head) = t;
+    tail                                  = t;
+  }
+
+  void enqueue_front(thread_data* t) noexcept {
+    t->next = head;
+    head    = t;
+    if (tail == nullptr) {
+      tail = t;
+    }
+  }
+
+  // Fair handoffs at random intervals below a millisecond
+  auto fair_now() noexcept -> bool {
+    const auto now = std::chrono::steady_clock::now();
+    if (now < next_fair) {
+      return false;
+    }
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    next_fair = now + std::chrono::microseconds(seed % 1000);
+    return true;
+  }
+};
+
+inline constexpr std::size_t bucket_count = 256;
+
+inline auto bucket_for(const void* address) noexcept -> bucket& {
+  static bucket table[bucket_count];
+  const auto    h = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(address))
+                 * 0x9E3779B97F4A7C15ULL;
+  return table[h >> 56];
+}
+
+inline void wake(thread_data* t, std::intptr_t token) noexcept {
+  std::scoped_lock lock(t->mutex);
+  t->token  = token;
+  t->parked = false;
+  t->cv.notify_one();
+}
+
+}  // namespace _detail
+
+// Parks the calling thread on `address` if `validate()` holds; `validate` runs under the
+// bucket lock and `before_sleep` right after the thread is queued, outside it. Returns once
+// unparked, or with `unparked == false` if validation failed or `deadline` passed. A thread
+// that was unparked but has to wait again passes `requeue`: it goes back to the head of the
+// queue and keeps the start of its wait, which unparkers see as unpark_result::waited.
+template <class Validate, class BeforeSleep>
+auto park(const void* address, Validate&& validate, BeforeSleep&& before_sleep,
+          std::optional<std::chrono::steady_clock::time_point> deadline = std::nullopt,
+          bool requeue = false) -> park_result {
+  auto& me = _detail::this_thread_data();
+  auto& b  = _detail::bucket_for(address);
+  {
+    std::scoped_lock lock(b.mutex);
+    if (!validate()) {
+      return {};
+    }
+    me.address = address;
+    me.token   = 0;
+    {
+      std::scoped_lock self(me.mutex);
+      me.parked = true;
+    }
+    if (requeue) {
+      b.enqueue_front(&me);
+    } else {
+      me.since = std::chrono::steady_clock::now();
+      b.enqueue(&me);
+    }
+  }
+  before_sleep();
+
+  std::unique_lock self(me.mutex);
+  if (!deadline) {
+    me.cv.wait(self, [&] { return !me.parked; });
+    return {.unparked = true, .token = me.token};
+  }
+  if (me.cv.wait_until(self, *deadline, [&] { return !me.parked; })) {
+    return {.unparked = true, .token = me.token};
+  }
+
+  // Timed out: leave the queue, unless an unparker already took us out of it
+  self.unlock();
+  {
+    std::scoped_lock lock(b.mutex);
+    if (b.remove(&me)) {
+      std::scoped_lock relock(me.mutex);
+      me.parked = false;
+      return {};
+    }
+  }
+  self.lock();
+  me.cv.wait(self, [&] { return !me.parked; });
+  return {.unparked = true, .token = me.token};
+}
+
+// Unparks the oldest thread parked on `address`. `callback(unpark_result)` runs under the
+// bucket lock, before the thread wakes, and returns the token the thread receives.
+template <class Callback>
+void unpark_one(const void* address, Callback&& callback) {
+  auto&                 b      = _detail::bucket_for(address);
+  _detail::thread_data* target = nullptr;
+  std::intptr_t         token  = 0;
+  {
+    std::scoped_lock lock(b.mutex);
+    bool             more = false;
+    target                = b.dequeue(address, more);
+    unpark_result result{.unparked = target != nullptr, .more_waiters = more};
+    if (target != nullptr) {
+      result.be_fair = b.fair_now();
+      result.waited  = std::chrono::steady_clock::now() - target->since;
+    }
+    token = callback(result);
+  }
+  if (target != nullptr) {
+    _detail::wake(target, token);
+  }
+}
+
+// Unparks every thread parked on `address`; `callback()` runs under the bucket lock first
+template <class Callback>
+auto unpark_all(const void* address, Callback&& callback) -> std::size_t {
+  auto&                 b     = _detail::bucket_for(address);
+  _detail::thread_data* list  = nullptr;
+  _detail::thread_data* last  = nullptr;
+  std::size_t           count = 0;
+  {
+    std::scoped_lock lock(b.mutex);
+    bool             more = true;
+    while (more) {
+      auto* t = b.dequeue(address, more);
+      if (t == nullptr) {
+        break;
+      }
+      t->next                               = nullptr;
+      (last != nullptr ? last->next : list) = t;
+      last                                  = t;
+      ++count;
+    }
+    callback();
+  }
+  while (list != nullptr) {
+    auto* next = list->next;
+    _detail::wake(list, 0);
+    list = next;
+  }
+  return count;
+}
+
+}  // namespace parking_lot
+
+}  // namespace flow::detail
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define FLOW_DETAIL_STREAMING_X86 1
+#include <immintrin.h>
+#endif
+
+namespace flow::detail {
+
+// Non-temporal (streaming) stores for bulk_copy and bulk_fill
+//
+// A streaming store writes a whole cache line straight to memory: it skips the read for
+// ownership a regular store does and does not evict the cache's working set, which is what a
+// copy or fill much larger than the cache wants. The AVX2 and AVX-512 kernels are compiled
+// with target attributes and picked at run time from what the CPU reports, so the library
+// needs no -mavx flags. Elsewhere (other architectures, MSVC) only the memcpy path exists.
+//
+// The kernels store whole aligned vectors and write the unaligned head and tail with memcpy.
+// Streaming stores are weakly ordered, so each call ends with a store fence: once it returns,
+// a release operation publishes the data like any other store.
+namespace streaming {
+
+enum class isa : std::uint8_t { none, avx2, avx512 };
+
+inline auto detect() noexcept -> isa {
+#if defined(FLOW_DETAIL_STREAMING_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return isa::avx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return isa::avx2;
+  }
+#endif
+  return isa::none;
+}
+
+// Widest kernel this CPU runs, detected once
+inline auto best() noexcept -> isa {
+  static const isa level = detect();
+  return level;
+}
+
+// Bytes from `p` to the next multiple of `align`, at most `bytes`
+inline auto head_bytes(const void* p, std::size_t align, std::size_t bytes) noexcept
+    -> std::size_t {
+  const auto addr = reinterpret_cast<std::uintptr_t>(p);
+  const auto gap  = static_cast<std::size_t>((align - (addr % align)) % align);
+  return gap < bytes ? gap : bytes;
+}
+
+#if defined(FLOW_DETAIL_STREAMING_X86)
+
+// `dst` is 32-byte aligned, `bytes` a multiple of 32
+__attribute__((target("avx2"))) inline void copy_avx2(unsigned char* dst, const unsigned char* src,
+                                                      std::size_t bytes) noexcept {
+  for (; bytes >= 128; bytes -= 128, dst += 128, src += 128) {
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+    const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 64));
+    const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 96));
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), a);
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 32), b);
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 64), c);
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 96), d);
+  }
+  for (; bytes >= 32; bytes -= 32, dst += 32, src += 32) {
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst),
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)));
+  }
+}
+
+// `dst` is 64-byte aligned, `bytes` a multiple of 64
+__attribute__((target("avx512f"))) inline void copy_avx512(unsigned char*       dst,
+                                                           const unsigned char* src,
+                                                           std::size_t          bytes) noexcept {
+  for (; bytes >= 256; bytes -= 256, dst += 256, src += 256) {
+    const __m512i a = _mm512_loadu_si512(src);
+    const __m512i b = _mm512_loadu_si512(src + 64);
+    const __m512i c = _mm512_loadu_si512(src + 128);
+    const __m512i d = _mm512_loadu_si512(src + 192);
+    _mm512_stream_si512(reinterpret_cast<__m512i*>(dst), a);
+    _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + 64), b);
+    _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + 128), c);
+    _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + 192), d);
+  }
+  for (; bytes >= 64; bytes -= 64, dst += 64, src += 64) {
+    _mm512_stream_si512(reinterpret_cast<__m512i*>(dst), _mm512_loadu_si512(src));
+  }
+}
+
+// `dst` is 32-byte aligned, `bytes` a multiple of 32
+__attribute__((target("avx2"))) inline void fill_avx2(unsigned char*       dst,
+                                                      const unsigned char* pattern,
+                                                      std::size_t          bytes) noexcept {
+  // Byte k of `pattern` belongs at addresses congruent to k modulo 64
+  const std::size_t half   = (reinterpret_cast<std::uintptr_t>(dst) % 64) / 32;
+  const auto*       lanes  = reinterpret_cast<const __m256i*>(pattern);
+  const __m256i     first  = _mm256_loadu_si256(lanes + half);
+  const __m256i     second = _mm256_loadu_si256(lanes + (1 - half));
+  for (; bytes >= 64; bytes -= 64, dst += 64) {
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), first);
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 32), second);
+  }
+  if (bytes != 0) {
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), first);
+  }
+}
+
+// `dst` is 64-byte aligned, `bytes` a multiple of 64
+__attribute__((target("avx512f"))) inline void fill_avx512(unsigned char*       dst,
+                                                           const unsigned char* pattern,
+                                                           std::size_t          bytes) noexcept {
+  const __m512i v = _mm512_loadu_si512(pattern);
+  for (; bytes >= 256; bytes -= 256, dst += 256) {
+    _mm512_stream_si512(reinterpret_cast<__m512i*>(dst), v);
+    _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + 64), v);
+    _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + 128), v);
+    _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + 192), v);
+  }
+  for (; bytes >= 64; bytes -= 64, dst += 64) {
+    _mm512_stream_si512(reinterpret_cast<__m512i*>(dst), v);
+  }
+}
+
+#endif
+
+inline auto vector_bytes(isa level) noexcept -> std::size_t {
+  return level == isa::avx512 ? 64 : 32;
+}
+
+// memcpy(dst, src, bytes) with streaming stores of `level`; the ranges must not overlap
+inline void copy(isa level, void* dst, const void* src, std::size_t bytes) noexcept {
+  auto*       d = static_cast<unsigned char*>(dst);
+  const auto* s = static_cast<const unsigned char*>(src);
+#if defined(FLOW_DETAIL_STREAMING_X86)
+  if (level != isa::none) {
+    const std::size_t width = vector_bytes(level);
+    const std::size_t head  = head_bytes(d, width, bytes);
+    std::memcpy(d, s, head);
+    d += head;
+    s += head;
+    bytes -= head;
+    const std::size_t body = bytes - (bytes % width);
+    if (level == isa::avx512) {
+      copy_avx512(d, s, body);
+    } else {
+      copy_avx2(d, s, body);
+    }
+    _mm_sfence();
+    d += body;
+    s += body;
+    bytes -= body;
+  }
+#else
+  static_cast<void>(level);
+#endif
+  std::memcpy(d, s, bytes);
+}
+
+// Writes `bytes` at `dst` from a 64-byte `pattern` whose byte k belongs at every address
+// congruent to k modulo 64, with streaming stores of `level`
+inline void fill(isa level, void* dst, const unsigned char* pattern, std::size_t bytes) noexcept {
+  auto* d = static_cast<unsigned char*>(dst);
+#if defined(FLOW_DETAIL_STREAMING_X86)
+  if (level != isa::none) {
+    const std::size_t width = vector_bytes(level);
+    const std::size_t head  = head_bytes(d, width, bytes);
+    std::memcpy(d, pattern + (reinterpret_cast<std::uintptr_t>(d) % 64), head);
+    d += head;
+    bytes -= head;
+    const std::size_t body = bytes - (bytes % width);
+    if (level == isa::avx512) {
+      fill_avx512(d, pattern, body);
+    } else {
+      fill_avx2(d, pattern, body);
+    }
+    _mm_sfence();
+    d += body;
+    bytes -= body;
+  }
+#else
+  static_cast<void>(level);
+#endif
+  // Tail (or everything without streaming stores), at most 64 bytes at a time
+  while (bytes != 0) {
+    const std::size_t phase = reinterpret_cast<std::uintptr_t>(d) % 64;
+    const std::size_t n     = bytes < 64 - phase ? bytes : 64 - phase;
+    std::memcpy(d, pattern + phase, n);
+    d += n;
+    bytes -= n;
+  }
+}
+
+}  // namespace streaming
+
+}  // namespace flow::detail
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace flow::detail {
+
+// CPU and NUMA node topology, for schedulers that pin their workers
+//
+// Nodes and their CPUs come from sysfs (/sys/devices/system/node); a machine or kernel without
+// it is treated as a single node. Pinning uses pthread_setaffinity_np and is a no-op on other
+// platforms, so topology mode degrades to plain threads there.
+namespace topology {
+
+// Parses a sysfs list such as "0-3,8,10-11"
+inline auto parse_list(const std::string& text) -> std::vector<int> {
+  std::vector<int> out;
+  std::size_t      pos = 0;
+  while (pos < text.size()) {
+    const std::size_t comma = std::min(text.find(',', pos), text.size());
+    const std::string item  = text.substr(pos, comma - pos);
+    const std::size_t dash  = item.find('-');
+    try {
+      const int first = std::stoi(item);
+      const int last  = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+      for (int i = first; i <= last; ++i) {
+        out.push_back(i);
+      }
+    } catch (...) {
+      // Not a number (an empty item): skip it
+    }
+    pos = comma + 1;
+  }
+  return out;
+}
+
+inline auto read_list(const std::string& path) -> std::vector<int> {
+  std::ifstream in(path);
+  std::string   text;
+  if (!in || !std::getline(in, text)) {
+    return {};
+  }
+  return parse_list(text);
+}
+
+// CPUs the calling process may run on
+inline auto allowed_cpus() -> std::vector<int> {
+  std::vector<int> cpus;
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+#endif
+  return cpus;
+}
+
+// Allowed CPUs ordered by NUMA node, then by number: consecutive workers pinned in this order
+// share a node, and workers spread over the nodes in blocks
+inline auto cpus_by_node() -> std::vector<int> {
+  std::vector<int> allowed = allowed_cpus();
+  std::vector<int> ordered;
+  for (int node : read_list("/sys/devices/system/node/possible")) {
+    for (int cpu : read_list("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist")) {
+      if (std::ranges::find(allowed, cpu) != allowed.end()) {
+        ordered.push_back(cpu);
+      }
+    }
+  }
+  // CPUs sysfs did not place on a node go last
+  for (int cpu : allowed) {
+    if (std::ranges::find(ordered, cpu) == ordered.end()) {
+      ordered.push_back(cpu);
+    }
+  }
+  return ordered;
+}
+
+// Pins the calling thread to `cpu`; false where pinning is unsupported or refused
+inline auto pin_current_thread(int cpu) noexcept -> bool {
+#if defined(__linux__)
+  if (cpu < 0 || cpu >= CPU_SETSIZE) {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  static_cast<void>(cpu);
+  return false;
+#endif
+}
+
+}  // namespace topology
+
+}  // namespace flow::detail
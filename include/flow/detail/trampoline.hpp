@@ -0,0 +1,49 @@
+#pragma once
+
+namespace flow::detail {
+
+// Thread-local trampoline for hand-offs that re-enter
+//
+// Handing a resource (a permit, a pooled object) to a parked waiter runs the waiter's
+// continuation inline. A continuation that finishes synchronously gives the resource back, and
+// that hands it to the next waiter from inside the first hand-off. trampoline<Node, Fn> keeps
+// such a chain off the stack: deliver() calls `(node->*Fn)(node)` unless a delivery of the same
+// Node type is already running on this thread, in which case the node is queued and delivered
+// once the running one returns. A queued node's `next` link must be free, which holds once the
+// node has been unlinked from its wait list.
+template <class Node, auto Fn>
+class trampoline {
+ public:
+  static void deliver(Node* node) noexcept {
+    auto& q    = pending();
+    node->next = nullptr;
+    (q.tail != nullptr ? q.tail->next : q.head) = node;
+    q.tail                                      = node;
+    if (q.draining) {
+      return;
+    }
+    q.draining = true;
+    while (Node* next = q.head) {
+      q.head = next->next;
+      if (q.head == nullptr) {
+        q.tail = nullptr;
+      }
+      (next->*Fn)(next);
+    }
+    q.draining = false;
+  }
+
+ private:
+  struct queue {
+    Node* head{nullptr};
+    Node* tail{nullptr};
+    bool  draining{false};
+  };
+
+  static auto pending() noexcept -> queue& {
+    thread_local queue q;
+    return q;
+  }
+};
+
+}  // namespace flow::detail
@@ -0,0 +1,35 @@
+#pragma once
+
+namespace flow::detail {
+
+// Intrusive waiter stack
+//
+// Operations that wait for a one-shot event (a latch releasing, a barrier phase ending, a
+// singleflight result being published) embed a waiter node and push it onto a lock-free
+// stack. The thread that fires the event exchanges the head out and resumes the detached
+// nodes with resume_all(). A sentinel node whose address marks "already fired" lets a late
+// push resume itself instead of linking.
+
+// Intrusive node of a waiting operation
+struct waiter {
+  void (*resume)(waiter*) noexcept;
+  waiter* next{nullptr};
+};
+
+// Resumes a detached stack of waiters, oldest first
+inline void resume_all(waiter* head) noexcept {
+  waiter* fifo = nullptr;
+  while (head != nullptr) {
+    waiter* next = head->next;
+    head->next   = fifo;
+    fifo         = head;
+    head         = next;
+  }
+  while (fifo != nullptr) {
+    waiter* next = fifo->next;
+    fifo->resume(fifo);
+    fifo = next;
+  }
+}
+
+}  // namespace flow::detail
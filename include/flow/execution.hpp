@@ -12,13 +12,26 @@
 //   - scheduler.hpp: Scheduler concepts and factories
 //   - try_scheduler.hpp: Non-blocking scheduler support (P3669)
 
-#include "execution/adaptors.hpp"          // Sender adaptors
-#include "execution/algorithms.hpp"        // Sender algorithms
-#include "execution/async_scope.hpp"       // Async scope support (P3149)
-#include "execution/execution_policy.hpp"  // Execution policies
-#include "execution/factories.hpp"         // Sender factories (just, just_error, etc.)
-#include "execution/schedulers.hpp"        // Standard scheduler implementations
-#include "execution/stop_token.hpp"        // Stop token support
-#include "execution/sync_wait.hpp"         // Synchronization utilities
-#include "execution/try_scheduler.hpp"     // Non-blocking scheduler support (P3669)
-#include "execution/type_list.hpp"         // Type list utilities
+#include "detail/mutex.hpp"                 // Internal mutex and lock profiling report
+#include "execution/adaptors.hpp"           // Sender adaptors
+#include "execution/admission_control.hpp"  // Queue-delay admission control (CoDel)
+#include "execution/algorithms.hpp"         // Sender algorithms
+#include "execution/async_barrier.hpp"      // Asynchronous latch and barrier
+#include "execution/async_pool.hpp"         // Asynchronous object pool with RAII leases
+#include "execution/async_scope.hpp"        // Async scope support (P3149)
+#include "execution/batcher.hpp"            // Micro-batching of single-item requests
+#include "execution/edf_scheduler.hpp"      // Earliest-deadline-first scheduler
+#include "execution/execution_policy.hpp"   // Execution policies
+#include "execution/factories.hpp"          // Sender factories (just, just_error, etc.)
+#include "execution/numa_vector.hpp"        // mmap-backed arrays placed by first touch in bulk
+#include "execution/rcu.hpp"                // Read-copy-update cells reclaimed by the scheduler
+#include "execution/schedulers.hpp"         // Standard scheduler implementations
+#include "execution/singleflight.hpp"       // Request coalescing with an optional result cache
+#include "execution/stop_token.hpp"         // Stop token support
+#include "execution/sync_wait.hpp"          // Synchronization utilities
+#include "execution/throttle.hpp"           // Concurrency and rate limiting adaptors
+#include "execution/tiling.hpp"             // Multi-dimensional tiled bulk shapes
+#include "execution/timer_scheduler.hpp"    // Timed scheduling (schedule_after, schedule_at)
+#include "execution/trace.hpp"              // Scheduler task lifecycle tracing
+#include "execution/try_scheduler.hpp"      // Non-blocking scheduler support (P3669)
+#include "execution/type_list.hpp"          // Type list utilities
@@ -1,6 +1,8 @@
 #pragma once
 
 // This file aggregates all sender adaptor implementations
+#include "deadline.hpp"
+#include "instrument.hpp"
 #include "let.hpp"
 #include "then.hpp"
 #include "transfer.hpp"
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace flow::execution {
+
+// Queue-delay based admission control (CoDel)
+//
+// A full queue is a late overload signal: by the time 1024 tasks are queued, each of them has
+// waited for all the others. CoDel looks at how long tasks wait instead. Workers report the
+// sojourn time (enqueue to dequeue) of every task they take; the controller keeps the minimum
+// over each interval. A minimum above the target means even the luckiest task of the interval
+// waited too long, so the delay is standing rather than a burst being worked off, and the
+// scheduler is declared overloaded:
+//
+//   thread_pool pool(8, codel_options{.target = 5ms, .interval = 100ms});
+//   try_schedule(pool.get_scheduler())  // set_error(would_block_t) while overloaded
+//
+// While overloaded, try_schedule() fails fast and, with reject_schedule, schedule() completes
+// with set_error(std::make_exception_ptr(overloaded_t{})) instead of queuing; receivers written
+// against the exception_ptr channel schedule() already declares keep working. The state
+// clears as soon as a task is dequeued within the target (the backlog has drained), or after
+// an interval without any dequeue. Reporting a sample is a few relaxed atomic operations;
+// admitting is one load.
+
+struct codel_options {
+  std::chrono::nanoseconds target{std::chrono::milliseconds(5)};     // Acceptable standing delay
+  std::chrono::nanoseconds interval{std::chrono::milliseconds(100)};  // Window of the minimum
+  bool                     reject_schedule{false};  // schedule() fails with overloaded_t too
+};
+
+// Error sent (as an exception_ptr) by schedule() of an overloaded scheduler when
+// reject_schedule is set; a std::runtime_error so that handlers catching std::exception see it
+struct overloaded_t : std::runtime_error {
+  overloaded_t() : std::runtime_error("scheduler overloaded") {}
+};
+
+struct codel_stats {
+  bool                     overloaded{false};  // Currently refusing new work
+  std::chrono::nanoseconds min_sojourn{0};     // Minimum sojourn of the last full interval
+  std::uint64_t            episodes{0};        // Times the controller became overloaded
+  std::uint64_t            rejected{0};        // try_schedule/schedule calls refused
+};
+
+class codel_controller {
+ public:
+  using clock      = std::chrono::steady_clock;
+  using time_point = clock::time_point;
+
+  explicit codel_controller(codel_options options) noexcept
+      : target_(options.target.count()),
+        interval_(options.interval.count()),
+        reject_schedule_(options.reject_schedule),
+        window_end_(ns(clock::now()) + interval_) {}
+
+  codel_controller(const codel_controller&)                    = delete;
+  auto operator=(const codel_controller&) -> codel_controller& = delete;
+
+  // A worker took a task that was queued at `enqueued`
+  void on_dequeue(time_point enqueued) noexcept {
+    const std::int64_t now     = ns(clock::now());
+    const std::int64_t sojourn = std::max<std::int64_t>(0, now - ns(enqueued));
+    last_dequeue_.store(now, std::memory_order_relaxed);
+
+    if (sojourn < target_ && overloaded_.load(std::memory_order_relaxed)) {
+      overloaded_.store(false, std::memory_order_relaxed);  // The backlog has drained
+    }
+
+    std::int64_t min = window_min_.load(std::memory_order_relaxed);
+    while (sojourn < min
+           && !window_min_.compare_exchange_weak(min, sojourn, std::memory_order_relaxed)) {
+    }
+
+    std::int64_t end = window_end_.load(std::memory_order_relaxed);
+    if (now >= end
+        && window_end_.compare_exchange_strong(end, now + interval_, std::memory_order_relaxed)) {
+      const std::int64_t window_min = window_min_.exchange(no_sample, std::memory_order_relaxed);
+      last_min_.store(window_min, std::memory_order_relaxed);
+      if (window_min > target_ && !overloaded_.exchange(true, std::memory_order_relaxed)) {
+        episodes_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Whether new work may be queued; counts a refusal when it may not
+  auto admit() noexcept -> bool {
+    if (!overloaded_.load(std::memory_order_relaxed)) {
+      return true;
+    }
+    // Nothing dequeued for a whole interval: the workers are idle or stuck, either way the
+    // samples that caused the overload are stale
+    if (ns(clock::now()) - last_dequeue_.load(std::memory_order_relaxed) > interval_) {
+      overloaded_.store(false, std::memory_order_relaxed);
+      return true;
+    }
+    rejected_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  [[nodiscard]] auto rejects_schedule() const noexcept -> bool {
+    return reject_schedule_;
+  }
+
+  [[nodiscard]] auto stats() const noexcept -> codel_stats {
+    const std::int64_t min = last_min_.load(std::memory_order_relaxed);
+    return {.overloaded  = overloaded_.load(std::memory_order_relaxed),
+            .min_sojourn = std::chrono::nanoseconds(min == no_sample ? 0 : min),
+            .episodes    = episodes_.load(std::memory_order_relaxed),
+            .rejected    = rejected_.load(std::memory_order_relaxed)};
+  }
+
+ private:
+  static constexpr std::int64_t no_sample = std::numeric_limits<std::int64_t>::max();
+
+  static auto ns(time_point t) noexcept -> std::int64_t {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+  }
+
+  const std::int64_t target_;
+  const std::int64_t interval_;
+  const bool         reject_schedule_;
+
+  alignas(64) std::atomic<bool> overloaded_{false};
+  std::atomic<std::int64_t>     window_end_;
+  std::atomic<std::int64_t>     window_min_{no_sample};
+  std::atomic<std::int64_t>     last_min_{no_sample};
+  std::atomic<std::int64_t>     last_dequeue_{0};
+  std::atomic<std::uint64_t>    episodes_{0};
+  std::atomic<std::uint64_t>    rejected_{0};
+};
+
+}  // namespace flow::execution
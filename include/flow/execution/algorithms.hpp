@@ -2,6 +2,10 @@
 
 // This file aggregates all sender algorithm implementations
 #include "bulk.hpp"
+#include "bulk_copy.hpp"
+#include "bulk_search.hpp"
+#include "bulk_with_state.hpp"
+#include "range_algorithms.hpp"
 #include "retry.hpp"
 #include "when_all.hpp"
 #include "when_any.hpp"
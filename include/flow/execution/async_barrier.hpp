@@ -0,0 +1,344 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "../detail/waiter_stack.hpp"
+#include "completion_signatures.hpp"
+#include "env.hpp"
+#include "operation_state.hpp"
+#include "queries.hpp"
+#include "receiver.hpp"
+#include "scheduler.hpp"
+#include "sender.hpp"
+#include "type_list.hpp"
+#include "utils.hpp"
+
+namespace flow::execution {
+
+// Asynchronous latch and barrier
+//
+// async_latch and async_barrier are the sender counterparts of std::latch and std::barrier:
+// waiting is a sender instead of a blocked thread, so phases of a bulk-synchronous computation
+// can be chained without going through sync_wait between them.
+//
+//   schedule(sched) | then(step) | let_value([&] { return barrier.arrive_and_wait(sched); })
+//
+// A waiting operation is an intrusive node (nothing is allocated) pushed onto a lock-free
+// stack. The arrival that completes the latch or phase detaches the whole stack and resumes
+// the waiters in arrival order. A waiter resumes on the scheduler passed to arrive_and_wait()
+// or wait(), else on the get_scheduler() of its receiver's environment, else inline on the
+// releasing thread. The releasing thread starts the schedule operation each waiter connected
+// when it started, so a barrier with 64 participants costs 64 enqueues on that thread; it does
+// not run the waiters' continuations itself.
+//
+// Waiting operations are not cancellable: an arrival cannot be taken back. The schedule that
+// resumes a waiter sees its receiver's environment, so a scheduler that honours the waiter's
+// stop token or deadline (with_deadline) may still complete it with set_stopped.
+
+namespace _async_barrier_detail {
+
+using detail::resume_all;
+using detail::waiter;
+
+// Scheduler marker: resume on the receiver's scheduler if its environment has one, else inline
+struct inline_resume {};
+
+template <class Rcvr>
+auto resume_scheduler_of(const Rcvr& rcvr) noexcept {
+  if constexpr (requires { get_scheduler(get_env(rcvr)); }) {
+    return get_scheduler(get_env(rcvr));
+  } else {
+    return inline_resume{};
+  }
+}
+
+template <class Sched, class Rcvr>
+struct resume_op {
+  using type = decltype(std::declval<Sched&>().schedule().connect(std::declval<Rcvr>()));
+};
+
+template <class Rcvr>
+struct resume_op<inline_resume, Rcvr> {
+  struct type {};
+};
+
+// Operation of wait()/arrive_and_wait(): `Owner::await(waiter*, arrivals)` links the node,
+// counts the arrivals and resumes the node once the owner is released
+template <class Owner, class Sched, class Rcvr>
+class _wait_operation : waiter {
+  struct resume_receiver {
+    using receiver_concept = receiver_t;
+
+    _wait_operation* self_;
+
+    void set_value() && noexcept {
+      std::move(self_->receiver_).set_value();
+    }
+
+    template <class E>
+    void set_error(E&& e) && noexcept {
+      std::move(self_->receiver_).set_error(std::forward<E>(e));
+    }
+
+    void set_stopped() && noexcept {
+      std::move(self_->receiver_).set_stopped();
+    }
+
+    auto get_env() const noexcept {
+      return flow::execution::get_env(self_->receiver_);
+    }
+  };
+
+  static constexpr bool inline_v = std::same_as<Sched, inline_resume>;
+
+  using resume_op_t = typename resume_op<Sched, resume_receiver>::type;
+
+ public:
+  using operation_state_concept = operation_state_t;
+
+  template <class R>
+  _wait_operation(Owner* owner, std::ptrdiff_t arrivals, Sched sched, R&& r)
+      : waiter{.resume = &on_release},
+        owner_(owner),
+        arrivals_(arrivals),
+        sched_(std::move(sched)),
+        receiver_(std::forward<R>(r)) {}
+
+  _wait_operation(const _wait_operation&)                    = delete;
+  auto operator=(const _wait_operation&) -> _wait_operation& = delete;
+
+  void start() & noexcept {
+    if constexpr (!inline_v) {
+      // Connected up front so that the release path cannot fail
+      try {
+        resume_op_.emplace(
+            __emplace_from{[this] { return sched_.schedule().connect(resume_receiver{this}); }});
+      } catch (...) {
+        std::move(receiver_).set_error(std::current_exception());
+        return;
+      }
+    }
+    owner_->await(this, arrivals_);
+  }
+
+ private:
+  static void on_release(waiter* w) noexcept {
+    auto* self = static_cast<_wait_operation*>(w);
+    if constexpr (inline_v) {
+      std::move(self->receiver_).set_value();
+    } else {
+      self->resume_op_->start();
+    }
+  }
+
+  Owner*                      owner_;
+  std::ptrdiff_t              arrivals_;
+  [[no_unique_address]] Sched sched_;
+  Rcvr                        receiver_;
+  std::optional<resume_op_t>  resume_op_;
+};
+
+template <class Owner, class Sched>
+struct _wait_sender {
+  using sender_concept = sender_t;
+  using value_types    = type_list<>;
+
+  Owner*                      owner_;
+  std::ptrdiff_t              arrivals_;
+  [[no_unique_address]] Sched sched_;
+
+  template <class Env>
+  auto get_completion_signatures(Env&& /*unused*/) const noexcept {
+    return completion_signatures<set_value_t(), set_error_t(std::exception_ptr),
+                                 set_stopped_t()>{};
+  }
+
+  template <receiver R>
+  auto connect(R&& r) const {
+    if constexpr (std::same_as<Sched, inline_resume>) {
+      auto sched = resume_scheduler_of(r);
+      return _wait_operation<Owner, decltype(sched), __decay_t<R>>{owner_, arrivals_, sched,
+                                                                   std::forward<R>(r)};
+    } else {
+      return _wait_operation<Owner, Sched, __decay_t<R>>{owner_, arrivals_, sched_,
+                                                         std::forward<R>(r)};
+    }
+  }
+};
+
+}  // namespace _async_barrier_detail
+
+// Single-use countdown: waiters complete once the count reaches zero
+class async_latch {
+  using waiter = _async_barrier_detail::waiter;
+
+ public:
+  explicit async_latch(std::ptrdiff_t expected) noexcept : count_(expected) {
+    if (expected <= 0) {
+      waiters_.store(&released_, std::memory_order_relaxed);
+    }
+  }
+
+  async_latch(const async_latch&)                    = delete;
+  auto operator=(const async_latch&) -> async_latch& = delete;
+
+  // No wait may be pending
+  ~async_latch() = default;
+
+  void count_down(std::ptrdiff_t n = 1) noexcept {
+    if (count_.fetch_sub(n, std::memory_order_acq_rel) == n) {
+      _async_barrier_detail::resume_all(waiters_.exchange(&released_, std::memory_order_acq_rel));
+    }
+  }
+
+  [[nodiscard]] auto try_wait() const noexcept -> bool {
+    return waiters_.load(std::memory_order_acquire) == &released_;
+  }
+
+  // Completes once the count has reached zero
+  [[nodiscard]] auto wait() noexcept {
+    return _async_barrier_detail::_wait_sender<async_latch, _async_barrier_detail::inline_resume>{
+        this, 0, {}};
+  }
+
+  template <scheduler Sched>
+  [[nodiscard]] auto wait(Sched sched) noexcept {
+    return _async_barrier_detail::_wait_sender<async_latch, Sched>{this, 0, std::move(sched)};
+  }
+
+  // count_down(n) when started, then wait()
+  [[nodiscard]] auto arrive_and_wait(std::ptrdiff_t n = 1) noexcept {
+    return _async_barrier_detail::_wait_sender<async_latch, _async_barrier_detail::inline_resume>{
+        this, n, {}};
+  }
+
+  template <scheduler Sched>
+  [[nodiscard]] auto arrive_and_wait(Sched sched, std::ptrdiff_t n = 1) noexcept {
+    return _async_barrier_detail::_wait_sender<async_latch, Sched>{this, n, std::move(sched)};
+  }
+
+ private:
+  template <class, class, class>
+  friend class _async_barrier_detail::_wait_operation;
+
+  void await(waiter* w, std::ptrdiff_t arrivals) noexcept {
+    waiter* head = waiters_.load(std::memory_order_acquire);
+    do {
+      if (head == &released_) {
+        w->resume(w);
+        return;
+      }
+      w->next = head;
+    } while (!waiters_.compare_exchange_weak(head, w, std::memory_order_acq_rel,
+                                             std::memory_order_acquire));
+    // Linked before counting, so the arrival that releases the latch also resumes us
+    if (arrivals > 0) {
+      count_down(arrivals);
+    }
+  }
+
+  std::atomic<std::ptrdiff_t> count_;
+  std::atomic<waiter*>        waiters_{nullptr};
+  waiter                      released_{};  // Address marks the released latch
+};
+
+namespace _async_barrier_detail {
+
+// Default phase-completion step
+struct no_completion {
+  void operator()() const noexcept {}
+};
+
+}  // namespace _async_barrier_detail
+
+// Reusable phase barrier for a fixed set of participants. When the last participant of a
+// phase arrives, it runs `completion()` and then releases every waiter of that phase.
+template <class CompletionFn = _async_barrier_detail::no_completion>
+class async_barrier {
+  static_assert(std::is_nothrow_invocable_v<CompletionFn&>,
+                "the phase-completion function must be noexcept");
+
+  using waiter = _async_barrier_detail::waiter;
+
+ public:
+  explicit async_barrier(std::ptrdiff_t expected, CompletionFn completion = {})
+      : expected_(expected), count_(expected), completion_(std::move(completion)) {}
+
+  async_barrier(const async_barrier&)                    = delete;
+  auto operator=(const async_barrier&) -> async_barrier& = delete;
+
+  // No wait may be pending
+  ~async_barrier() = default;
+
+  // Arrives at the current phase and completes when the phase does. Each participant arrives
+  // once per phase.
+  [[nodiscard]] auto arrive_and_wait() noexcept {
+    return _async_barrier_detail::_wait_sender<async_barrier,
+                                               _async_barrier_detail::inline_resume>{this, 1, {}};
+  }
+
+  template <scheduler Sched>
+  [[nodiscard]] auto arrive_and_wait(Sched sched) noexcept {
+    return _async_barrier_detail::_wait_sender<async_barrier, Sched>{this, 1, std::move(sched)};
+  }
+
+  // Arrives without waiting for the phase to complete
+  void arrive() noexcept {
+    arrive_one();
+  }
+
+  // Arrives and leaves: later phases expect one participant fewer
+  void arrive_and_drop() noexcept {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    arrive_one();
+  }
+
+  // Number of completed phases
+  [[nodiscard]] auto phase() const noexcept -> std::uint64_t {
+    return phase_.load(std::memory_order_acquire);
+  }
+
+ private:
+  template <class, class, class>
+  friend class _async_barrier_detail::_wait_operation;
+
+  void await(waiter* w, std::ptrdiff_t /*arrivals*/) noexcept {
+    waiter* head = waiters_.load(std::memory_order_relaxed);
+    do {
+      w->next = head;
+    } while (!waiters_.compare_exchange_weak(head, w, std::memory_order_release,
+                                             std::memory_order_relaxed));
+    // Linked before arriving, so the arrival that completes the phase also resumes us
+    arrive_one();
+  }
+
+  void arrive_one() noexcept {
+    if (count_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+
+    // Nobody can arrive for the next phase until the count is reset, so the stack holds
+    // exactly this phase's waiters
+    completion_();
+    waiter* waiters = waiters_.exchange(nullptr, std::memory_order_acquire);
+    expected_ -= dropped_.exchange(0, std::memory_order_relaxed);
+    count_.store(expected_, std::memory_order_relaxed);
+    phase_.fetch_add(1, std::memory_order_release);
+    _async_barrier_detail::resume_all(waiters);
+  }
+
+  std::ptrdiff_t                          expected_;  // Owned by the completing arrival
+  alignas(64) std::atomic<std::ptrdiff_t> count_;
+  alignas(64) std::atomic<waiter*>        waiters_{nullptr};
+  std::atomic<std::ptrdiff_t>             dropped_{0};
+  std::atomic<std::uint64_t>              phase_{0};
+  [[no_unique_address]] CompletionFn      completion_;
+};
+
+}  // namespace flow::execution
@@ -0,0 +1,458 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../detail/mutex.hpp"
+#include "../detail/trampoline.hpp"
+#include "completion_signatures.hpp"
+#include "env.hpp"
+#include "operation_state.hpp"
+#include "receiver.hpp"
+#include "sender.hpp"
+#include "stop_token.hpp"
+#include "type_list.hpp"
+#include "utils.hpp"
+
+namespace flow::execution {
+
+// Asynchronous object pool
+//
+// async_pool<T> owns a fixed set of objects (connections, buffers, parsers) and lends them out
+// as RAII leases. acquire() is a sender that completes with a lease as soon as an object is
+// free; destroying the lease returns the object.
+//
+// Free objects are kept in per-thread caches: a released object goes to the cache of the
+// releasing thread and the next acquire on that thread takes it back, so a worker keeps
+// reusing the same warm objects. An acquire whose cache is empty steals from the others.
+// When the pool is exhausted the acquire operation parks on an intrusive FIFO of waiters
+// (the operation state is the node, nothing is allocated) and the next release hands its
+// object directly to the oldest waiter, which completes on the releasing thread.
+
+struct async_pool_stats {
+  std::size_t   size{0};       // Objects owned by the pool
+  std::size_t   available{0};  // Objects sitting in caches
+  std::size_t   waiting{0};    // Parked acquire operations
+  std::uint64_t acquired{0};   // Leases handed out
+  std::uint64_t waited{0};     // Acquires that had to park
+  std::uint64_t handoffs{0};   // Releases that went straight to a waiter
+  std::uint64_t steals{0};     // Acquires served from another thread's cache
+  std::uint64_t cancelled{0};  // Parked acquires completed with set_stopped
+};
+
+namespace _async_pool_detail {
+
+// Small dense index per thread, used to pick the thread's home cache
+inline auto thread_index() noexcept -> std::size_t {
+  static std::atomic<std::size_t> next_index{0};
+  thread_local const std::size_t  index = next_index.fetch_add(1, std::memory_order_relaxed);
+  return index;
+}
+
+inline auto default_cache_count() noexcept -> std::size_t {
+  return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+}  // namespace _async_pool_detail
+
+template <class T>
+class async_pool {
+  struct entry {
+    template <class... Args>
+    explicit entry(Args&&... args) : value(std::forward<Args>(args)...) {}
+
+    T      value;
+    entry* next{nullptr};
+  };
+
+  struct alignas(64) cache {
+    mutable detail::mutex mutex{"async_pool::cache"};
+    entry*                head{nullptr};
+    std::size_t           size{0};
+  };
+
+  // Intrusive node of a parked acquire; `complete` is called once `handed` holds its object
+  struct waiter {
+    void (*complete)(waiter*) noexcept;
+    waiter* prev{nullptr};
+    waiter* next{nullptr};
+    entry*  handed{nullptr};
+    bool    linked{false};
+  };
+
+ public:
+  class lease;
+
+  explicit async_pool(std::size_t caches = _async_pool_detail::default_cache_count())
+      : caches_(std::max<std::size_t>(1, caches)) {}
+
+  // Pool of `count` objects, each created by calling `factory()`
+  template <class Factory>
+    requires std::is_invocable_r_v<T, Factory&>
+  async_pool(std::size_t count, Factory factory,
+             std::size_t caches = _async_pool_detail::default_cache_count())
+      : async_pool(caches) {
+    for (std::size_t i = 0; i < count; ++i) {
+      add(factory());
+    }
+  }
+
+  async_pool(const async_pool&)                    = delete;
+  auto operator=(const async_pool&) -> async_pool& = delete;
+
+  // Every lease must have been returned and no acquire may be pending
+  ~async_pool() = default;
+
+  // Adds an object to the pool; a parked acquire receives it immediately
+  template <class... Args>
+  void add(Args&&... args) {
+    entry* e = nullptr;
+    {
+      std::scoped_lock lock(entries_mutex_);
+      e = entries_.emplace_back(std::make_unique<entry>(std::forward<Args>(args)...)).get();
+    }
+    release(e);
+  }
+
+  // Sender completing with a lease once an object is free. Completes with set_stopped if the
+  // receiver's stop token is triggered while the operation is parked.
+  [[nodiscard]] auto acquire() noexcept {
+    return _acquire_sender{this};
+  }
+
+  // Takes a free object without waiting
+  [[nodiscard]] auto try_acquire() -> std::optional<lease> {
+    if (entry* e = take(true)) {
+      acquired_.fetch_add(1, std::memory_order_relaxed);
+      return lease(this, e);
+    }
+    return std::nullopt;
+  }
+
+  [[nodiscard]] auto size() const -> std::size_t {
+    std::scoped_lock lock(entries_mutex_);
+    return entries_.size();
+  }
+
+  [[nodiscard]] auto stats() const -> async_pool_stats {
+    async_pool_stats s{.size      = size(),
+                       .waiting   = waiting_.load(std::memory_order_relaxed),
+                       .acquired  = acquired_.load(std::memory_order_relaxed),
+                       .waited    = waited_.load(std::memory_order_relaxed),
+                       .handoffs  = handoffs_.load(std::memory_order_relaxed),
+                       .steals    = steals_.load(std::memory_order_relaxed),
+                       .cancelled = cancelled_.load(std::memory_order_relaxed)};
+    for (auto& c : caches_) {
+      std::scoped_lock lock(c.mutex);
+      s.available += c.size;
+    }
+    return s;
+  }
+
+  // RAII handle to a pooled object; returns it to the pool on destruction
+  class lease {
+   public:
+    lease() noexcept = default;
+
+    lease(lease&& other) noexcept
+        : pool_(std::exchange(other.pool_, nullptr)),
+          entry_(std::exchange(other.entry_, nullptr)) {}
+
+    auto operator=(lease&& other) noexcept -> lease& {
+      if (this != &other) {
+        reset();
+        pool_  = std::exchange(other.pool_, nullptr);
+        entry_ = std::exchange(other.entry_, nullptr);
+      }
+      return *this;
+    }
+
+    lease(const lease&)                    = delete;
+    auto operator=(const lease&) -> lease& = delete;
+
+    ~lease() {
+      reset();
+    }
+
+    // Returns the object early
+    void reset() noexcept {
+      if (entry_ != nullptr) {
+        std::exchange(pool_, nullptr)->release(std::exchange(entry_, nullptr));
+      }
+    }
+
+    [[nodiscard]] auto get() const noexcept -> T& {
+      return entry_->value;
+    }
+
+    auto operator*() const noexcept -> T& {
+      return entry_->value;
+    }
+
+    auto operator->() const noexcept -> T* {
+      return &entry_->value;
+    }
+
+    explicit operator bool() const noexcept {
+      return entry_ != nullptr;
+    }
+
+   private:
+    friend class async_pool;
+
+    lease(async_pool* pool, entry* e) noexcept : pool_(pool), entry_(e) {}
+
+    async_pool* pool_{nullptr};
+    entry*      entry_{nullptr};
+  };
+
+ private:
+  template <class Rcvr>
+  struct _acquire_operation : waiter {
+    using operation_state_concept = operation_state_t;
+
+    struct on_stop_requested {
+      _acquire_operation* self;
+
+      void operator()() const noexcept {
+        if (self->pool_->unpark(self)) {
+          self->pool_->cancelled_.fetch_add(1, std::memory_order_relaxed);
+          self->arrive();
+        }
+      }
+    };
+
+    using stop_token_t       = stop_token_of_t<decltype(get_env(std::declval<const Rcvr&>()))>;
+    using on_stop_callback_t = stop_callback_for_t<stop_token_t, on_stop_requested>;
+
+    template <class R>
+    _acquire_operation(async_pool* pool, R&& r)
+        : waiter{.complete = &on_handoff}, pool_(pool), receiver_(std::forward<R>(r)) {}
+
+    _acquire_operation(const _acquire_operation&)                    = delete;
+    auto operator=(const _acquire_operation&) -> _acquire_operation& = delete;
+
+    void start() & noexcept {
+      if (entry* e = pool_->take(false)) {
+        complete_with(e);
+        return;
+      }
+
+      auto token = get_stop_token(get_env(receiver_));
+      if (token.stop_requested()) {
+        std::move(receiver_).set_stopped();
+        return;
+      }
+
+      // Park, then look again: an object released before we were linked is handed over now
+      pool_->waited_.fetch_add(1, std::memory_order_relaxed);
+      pool_->park(this);
+      pool_->dispatch();
+
+      // Completion needs both the handoff (or cancellation) and the end of start()
+      on_stop_.emplace(std::move(token), on_stop_requested{this});
+      arrive();
+    }
+
+   private:
+    static void on_handoff(waiter* w) noexcept {
+      auto* self   = static_cast<_acquire_operation*>(w);
+      self->entry_ = w->handed;
+      self->arrive();
+    }
+
+    void arrive() noexcept {
+      if (pending_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+      }
+      on_stop_.reset();
+      if (entry_ != nullptr) {
+        complete_with(entry_);
+      } else {
+        std::move(receiver_).set_stopped();
+      }
+    }
+
+    void complete_with(entry* e) noexcept {
+      pool_->acquired_.fetch_add(1, std::memory_order_relaxed);
+      std::move(receiver_).set_value(lease(pool_, e));
+    }
+
+    async_pool*                       pool_;
+    Rcvr                              receiver_;
+    entry*                            entry_{nullptr};
+    std::atomic<int>                  pending_{2};
+    std::optional<on_stop_callback_t> on_stop_;
+  };
+
+  struct _acquire_sender {
+    using sender_concept = sender_t;
+    using value_types    = type_list<lease>;
+
+    async_pool* pool_;
+
+    template <class Env>
+    auto get_completion_signatures(Env&& /*unused*/) const noexcept {
+      return completion_signatures<set_value_t(lease), set_stopped_t()>{};
+    }
+
+    template <receiver R>
+    auto connect(R&& r) const {
+      return _acquire_operation<__decay_t<R>>{pool_, std::forward<R>(r)};
+    }
+  };
+
+  auto home() noexcept -> cache& {
+    return caches_[_async_pool_detail::thread_index() % caches_.size()];
+  }
+
+  static auto pop(cache& c) noexcept -> entry* {
+    entry* e = c.head;
+    if (e != nullptr) {
+      c.head = e->next;
+      --c.size;
+    }
+    return e;
+  }
+
+  // Home cache first, then steal. The fast path only steals from caches it can lock without
+  // waiting; an exhaustive take locks every cache.
+  auto take(bool exhaustive) noexcept -> entry* {
+    cache& own = home();
+    {
+      std::scoped_lock lock(own.mutex);
+      if (entry* e = pop(own)) {
+        return e;
+      }
+    }
+
+    const std::size_t start = static_cast<std::size_t>(&own - caches_.data());
+    for (std::size_t i = 1; i < caches_.size(); ++i) {
+      cache& victim = caches_[(start + i) % caches_.size()];
+      if (exhaustive) {
+        victim.mutex.lock();
+      } else if (!victim.mutex.try_lock()) {
+        continue;
+      }
+      entry* e = pop(victim);
+      victim.mutex.unlock();
+      if (e != nullptr) {
+        steals_.fetch_add(1, std::memory_order_relaxed);
+        return e;
+      }
+    }
+    return nullptr;
+  }
+
+  void put(entry* e) noexcept {
+    cache&           own = home();
+    std::scoped_lock lock(own.mutex);
+    e->next  = own.head;
+    own.head = e;
+    ++own.size;
+  }
+
+  void park(waiter* w) noexcept {
+    std::scoped_lock lock(waiters_mutex_);
+    w->prev   = tail_;
+    w->next   = nullptr;
+    w->linked = true;
+    (tail_ != nullptr ? tail_->next : head_) = w;
+    tail_                                    = w;
+    waiting_.fetch_add(1, std::memory_order_seq_cst);
+  }
+
+  // Removes a parked waiter; false if a release already claimed it
+  auto unpark(waiter* w) noexcept -> bool {
+    std::scoped_lock lock(waiters_mutex_);
+    if (!w->linked) {
+      return false;
+    }
+    unlink(w);
+    return true;
+  }
+
+  auto pop_waiter() noexcept -> waiter* {
+    std::scoped_lock lock(waiters_mutex_);
+    waiter*          w = head_;
+    if (w != nullptr) {
+      unlink(w);
+    }
+    return w;
+  }
+
+  void unlink(waiter* w) noexcept {
+    (w->prev != nullptr ? w->prev->next : head_) = w->next;
+    (w->next != nullptr ? w->next->prev : tail_) = w->prev;
+    w->linked                                    = false;
+    waiting_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void release(entry* e) noexcept {
+    if (waiting_.load(std::memory_order_acquire) > 0) {
+      if (waiter* w = pop_waiter()) {
+        hand_off(w, e);
+        return;
+      }
+    }
+
+    put(e);
+    // Pairs with the increment in park(): either we see the waiter or its dispatch sees `e`
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting_.load(std::memory_order_relaxed) > 0) {
+      dispatch();
+    }
+  }
+
+  // Moves cached objects to parked waiters until one side runs out
+  void dispatch() noexcept {
+    while (waiting_.load(std::memory_order_seq_cst) > 0) {
+      entry* e = take(true);
+      if (e == nullptr) {
+        return;
+      }
+      waiter* w = pop_waiter();
+      if (w == nullptr) {
+        put(e);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        continue;
+      }
+      hand_off(w, e);
+    }
+  }
+
+  // The waiter's receiver runs inline and may drop its lease right away, releasing the object
+  // to the next waiter: go through the trampoline so that such a chain does not nest
+  void hand_off(waiter* w, entry* e) noexcept {
+    handoffs_.fetch_add(1, std::memory_order_relaxed);
+    w->handed = e;
+    detail::trampoline<waiter, &waiter::complete>::deliver(w);
+  }
+
+  std::vector<cache> caches_;
+
+  mutable detail::mutex               entries_mutex_{"async_pool::entries"};
+  std::vector<std::unique_ptr<entry>> entries_;
+
+  detail::mutex            waiters_mutex_{"async_pool::waiters"};
+  waiter*                  head_{nullptr};
+  waiter*                  tail_{nullptr};
+  std::atomic<std::size_t> waiting_{0};
+
+  std::atomic<std::uint64_t> acquired_{0};
+  std::atomic<std::uint64_t> waited_{0};
+  std::atomic<std::uint64_t> handoffs_{0};
+  std::atomic<std::uint64_t> steals_{0};
+  std::atomic<std::uint64_t> cancelled_{0};
+};
+
+}  // namespace flow::execution
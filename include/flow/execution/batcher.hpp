@@ -0,0 +1,538 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "completion_signatures.hpp"
+#include "env.hpp"
+#include "operation_state.hpp"
+#include "receiver.hpp"
+#include "scheduler.hpp"
+#include "sender.hpp"
+#include "stop_token.hpp"
+#include "timer_scheduler.hpp"
+#include "type_list.hpp"
+#include "utils.hpp"
+
+namespace flow::execution {
+
+// Micro-batching
+//
+// batcher<T, R> coalesces single-item requests into batches:
+//
+//   batcher<record, status> writes(pool.get_scheduler(), timer.get_scheduler(),
+//                                  {.max_items = 128, .max_delay = 200us},
+//                                  [&](std::span<record> batch) { return store.write(batch); });
+//
+//   writes.submit(rec) | then([](status s) { ... });
+//
+// A submitted operation is an intrusive node (holding its item and result slot) pushed onto a
+// lock-free stack, so submitting allocates nothing. A batch is flushed once it holds
+// `max_items` items or `max_delay` after its first item was submitted, whichever comes first;
+// the timer for that delay is part of the first item's operation state. A flushed batch
+// allocates its operation and moves its items into a vector (the two allocations per batch),
+// starts the batch sender returned by the batch function on the given scheduler, and fans its
+// results out to the items in submission order. The batch sender must send a sized range with
+// one result per item; an error or set_stopped from it completes every item of the batch the
+// same way.
+//
+// Batches may run concurrently, so the batch function must be safe to call from several
+// threads. Submitted operations are not cancellable, and the batcher must outlive them.
+
+struct batcher_options {
+  std::size_t               max_items{64};    // Flush once a batch holds this many items
+  std::chrono::microseconds max_delay{1000};  // Flush this long after a batch's first item
+};
+
+struct batcher_stats {
+  std::uint64_t batches{0};  // Batches started
+  std::uint64_t items{0};    // Items carried by those batches
+  std::uint64_t full{0};     // Batches flushed because they reached max_items
+  std::uint64_t timed{0};    // Batches flushed because max_delay expired
+  std::size_t   pending{0};  // Items waiting for their batch to be flushed
+};
+
+namespace _batcher_detail {
+
+enum class outcome : unsigned char { value, error, stopped };
+
+// Intrusive node of a submitted item; `complete` is called once the result slot is filled
+template <class T, class R>
+struct item_node {
+  void (*complete)(item_node*) noexcept;
+  item_node*         next{nullptr};
+  T                  item;
+  outcome            result_kind{outcome::stopped};
+  std::optional<R>   result;
+  std::exception_ptr error;
+};
+
+// Type-erased "start one batch" step holding the scheduler and the batch function
+template <class T, class R>
+struct launcher {
+  launcher()                                   = default;
+  launcher(const launcher&)                    = delete;
+  auto operator=(const launcher&) -> launcher& = delete;
+  virtual ~launcher()                          = default;
+
+  // `fifo` is a list of `count` detached items, oldest first
+  virtual void launch(item_node<T, R>* fifo, std::size_t count) noexcept = 0;
+};
+
+// One flushed batch: schedules onto `Sched`, runs the batch sender and fans its results out.
+// Deletes itself once every item has been completed.
+template <class T, class R, class Sched, class BatchFn>
+class _batch_operation {
+  using node = item_node<T, R>;
+
+  struct result_receiver {
+    using receiver_concept = receiver_t;
+
+    _batch_operation* self_;
+
+    template <class Results>
+    void set_value(Results&& results) && noexcept {
+      self_->deliver(std::forward<Results>(results));
+    }
+
+    template <class E>
+    void set_error(E&& e) && noexcept {
+      if constexpr (std::same_as<__decay_t<E>, std::exception_ptr>) {
+        self_->fail(std::forward<E>(e));
+      } else {
+        self_->fail(std::make_exception_ptr(std::forward<E>(e)));
+      }
+    }
+
+    void set_stopped() && noexcept {
+      self_->fail(nullptr);
+    }
+  };
+
+  struct start_receiver {
+    using receiver_concept = receiver_t;
+
+    _batch_operation* self_;
+
+    void set_value() && noexcept {
+      self_->run();
+    }
+
+    template <class E>
+    void set_error(E&& e) && noexcept {
+      result_receiver{self_}.set_error(std::forward<E>(e));
+    }
+
+    void set_stopped() && noexcept {
+      self_->fail(nullptr);
+    }
+  };
+
+  using batch_sender_t = std::invoke_result_t<const BatchFn&, std::span<T>>;
+  using schedule_op_t =
+      decltype(std::declval<Sched&>().schedule().connect(std::declval<start_receiver>()));
+  using batch_op_t =
+      decltype(std::declval<batch_sender_t>().connect(std::declval<result_receiver>()));
+
+ public:
+  _batch_operation(const Sched& sched, const BatchFn& fn, node* fifo, std::size_t count)
+      : sched_(sched), fn_(&fn), waiters_(fifo), count_(count) {
+    items_.reserve(count);
+    for (; fifo != nullptr; fifo = fifo->next) {
+      items_.push_back(std::move(fifo->item));
+    }
+  }
+
+  _batch_operation(const _batch_operation&)                    = delete;
+  auto operator=(const _batch_operation&) -> _batch_operation& = delete;
+
+  void start() noexcept {
+    try {
+      schedule_op_.emplace(
+          __emplace_from{[this] { return sched_.schedule().connect(start_receiver{this}); }});
+    } catch (...) {
+      fail(std::current_exception());
+      return;
+    }
+    schedule_op_->start();
+  }
+
+ private:
+  void run() noexcept {
+    try {
+      batch_op_.emplace(__emplace_from{[this] {
+        return std::invoke(*fn_, std::span<T>(items_)).connect(result_receiver{this});
+      }});
+    } catch (...) {
+      fail(std::current_exception());
+      return;
+    }
+    batch_op_->start();
+  }
+
+  template <class Results>
+  void deliver(Results&& results) noexcept {
+    if (static_cast<std::size_t>(std::ranges::size(results)) != count_) {
+      fail(std::make_exception_ptr(
+          std::length_error("batcher: the batch sent a different number of results")));
+      return;
+    }
+    try {
+      auto it = std::ranges::begin(results);
+      for (node* waiter = waiters_; waiter != nullptr; waiter = waiter->next) {
+        if constexpr (std::is_rvalue_reference_v<Results&&>) {
+          waiter->result.emplace(std::move(*it));
+        } else {
+          waiter->result.emplace(*it);
+        }
+        waiter->result_kind = outcome::value;
+        ++it;
+      }
+    } catch (...) {
+      // Items whose result could not be stored complete with the exception
+      auto error = std::current_exception();
+      for (node* waiter = waiters_; waiter != nullptr; waiter = waiter->next) {
+        if (waiter->result_kind != outcome::value) {
+          waiter->result_kind = outcome::error;
+          waiter->error       = error;
+        }
+      }
+    }
+    complete_all();
+  }
+
+  void fail(std::exception_ptr error) noexcept {
+    for (node* waiter = waiters_; waiter != nullptr; waiter = waiter->next) {
+      waiter->result_kind = error ? outcome::error : outcome::stopped;
+      waiter->error       = error;
+    }
+    complete_all();
+  }
+
+  void complete_all() noexcept {
+    // The waiters' operations may be destroyed as soon as they complete
+    node* waiter = waiters_;
+    delete this;
+    while (waiter != nullptr) {
+      node* next = waiter->next;
+      waiter->complete(waiter);
+      waiter = next;
+    }
+  }
+
+  [[no_unique_address]] Sched  sched_;
+  const BatchFn*               fn_;
+  node*                        waiters_;  // The batch's items, oldest first
+  std::size_t                  count_;
+  std::vector<T>               items_;
+  std::optional<schedule_op_t> schedule_op_;
+  std::optional<batch_op_t>    batch_op_;
+};
+
+template <class T, class R, class Sched, class BatchFn>
+struct batch_launcher final : launcher<T, R> {
+  batch_launcher(Sched s, BatchFn f) : sched(std::move(s)), fn(std::move(f)) {}
+
+  void launch(item_node<T, R>* fifo, std::size_t count) noexcept override {
+    _batch_operation<T, R, Sched, BatchFn>* batch = nullptr;
+    try {
+      batch = new _batch_operation<T, R, Sched, BatchFn>(sched, fn, fifo, count);
+    } catch (...) {
+      auto error = std::current_exception();
+      while (fifo != nullptr) {
+        auto* next        = fifo->next;
+        fifo->result_kind = outcome::error;
+        fifo->error       = error;
+        fifo->complete(fifo);
+        fifo = next;
+      }
+      return;
+    }
+    batch->start();
+  }
+
+  [[no_unique_address]] Sched sched;
+  BatchFn                     fn;
+};
+
+template <class T, class R, class Rcvr>
+class _submit_operation;
+
+template <class T, class R>
+struct _submit_sender;
+
+}  // namespace _batcher_detail
+
+template <class T, class R>
+class batcher {
+  using node = _batcher_detail::item_node<T, R>;
+
+ public:
+  using timer_handle = timer_scheduler::timer_scheduler_handle;
+
+  // `fn(std::span<T>)` returns the sender that processes one batch; it is started on `sched`
+  template <scheduler Sched, class BatchFn>
+    requires std::invocable<const BatchFn&, std::span<T>>
+             && sender<std::invoke_result_t<const BatchFn&, std::span<T>>>
+  batcher(Sched sched, timer_handle timer, batcher_options options, BatchFn fn)
+      : launcher_(std::make_unique<_batcher_detail::batch_launcher<T, R, Sched, BatchFn>>(
+            std::move(sched), std::move(fn))),
+        timer_(timer),
+        max_items_(options.max_items > 0 ? options.max_items : 1),
+        max_delay_(std::chrono::duration_cast<timer_scheduler::duration>(options.max_delay)) {}
+
+  batcher(const batcher&)                    = delete;
+  auto operator=(const batcher&) -> batcher& = delete;
+
+  // No submitted operation may be pending
+  ~batcher() = default;
+
+  // Sends this item's result once its batch has run
+  [[nodiscard]] auto submit(T item) {
+    return _batcher_detail::_submit_sender<T, R>{this, std::move(item)};
+  }
+
+  // Starts a batch with whatever is pending now
+  void flush() noexcept {
+    take_batch(nullptr);
+  }
+
+  [[nodiscard]] auto stats() const noexcept -> batcher_stats {
+    batcher_stats s;
+    s.batches = batches_.load(std::memory_order_relaxed);
+    s.items   = items_.load(std::memory_order_relaxed);
+    s.full    = full_.load(std::memory_order_relaxed);
+    s.timed   = timed_.load(std::memory_order_relaxed);
+    s.pending = static_cast<std::size_t>(
+        std::max<std::ptrdiff_t>(0, size_.load(std::memory_order_relaxed)));
+    return s;
+  }
+
+ private:
+  template <class, class, class>
+  friend class _batcher_detail::_submit_operation;
+
+  // Links `n`; returns the generation of the batch it opened, or nullopt if it joined one
+  auto push(node* n) noexcept -> std::optional<std::uint64_t> {
+    node* head = head_.load(std::memory_order_relaxed);
+    do {
+      n->next = head;
+    } while (!head_.compare_exchange_weak(head, n, std::memory_order_acq_rel,
+                                          std::memory_order_relaxed));
+    std::optional<std::uint64_t> opened;
+    if (head == nullptr) {
+      opened = generation_.load(std::memory_order_acquire);
+    }
+    if (size_.fetch_add(1, std::memory_order_acq_rel) + 1
+        >= static_cast<std::ptrdiff_t>(max_items_)) {
+      take_batch(&full_);
+    }
+    return opened;
+  }
+
+  // Timer of the batch opened in `generation`: flushes it unless it was flushed already
+  void expire(std::uint64_t generation) noexcept {
+    if (generation_.load(std::memory_order_acquire) == generation) {
+      take_batch(&timed_);
+    }
+  }
+
+  // Detaches everything pending and launches it in batches of at most max_items
+  void take_batch(std::atomic<std::uint64_t>* reason) noexcept {
+    // Retire the generation before detaching: a push that finds the list empty afterwards
+    // must read the generation its own timer will flush
+    generation_.fetch_add(1, std::memory_order_acq_rel);
+    node* list = head_.exchange(nullptr, std::memory_order_acq_rel);
+    if (list == nullptr) {
+      return;
+    }
+
+    node*          fifo  = nullptr;
+    std::ptrdiff_t count = 0;
+    while (list != nullptr) {
+      node* next = list->next;
+      list->next = fifo;
+      fifo       = list;
+      list       = next;
+      ++count;
+    }
+    size_.fetch_sub(count, std::memory_order_acq_rel);
+    if (reason != nullptr) {
+      reason->fetch_add(1, std::memory_order_relaxed);
+    }
+
+    while (fifo != nullptr) {
+      node*       first = fifo;
+      node*       last  = fifo;
+      std::size_t taken = 1;
+      while (taken < max_items_ && last->next != nullptr) {
+        last = last->next;
+        ++taken;
+      }
+      fifo       = last->next;
+      last->next = nullptr;
+      batches_.fetch_add(1, std::memory_order_relaxed);
+      items_.fetch_add(taken, std::memory_order_relaxed);
+      launcher_->launch(first, taken);
+    }
+  }
+
+  std::unique_ptr<_batcher_detail::launcher<T, R>> launcher_;
+  timer_handle                                     timer_;
+  const std::size_t                                max_items_;
+  const timer_scheduler::duration                  max_delay_;
+  alignas(64) std::atomic<node*>                   head_{nullptr};
+  alignas(64) std::atomic<std::ptrdiff_t>          size_{0};
+  std::atomic<std::uint64_t>                       generation_{0};
+  std::atomic<std::uint64_t>                       batches_{0};
+  std::atomic<std::uint64_t>                       items_{0};
+  std::atomic<std::uint64_t>                       full_{0};
+  std::atomic<std::uint64_t>                       timed_{0};
+};
+
+namespace _batcher_detail {
+
+// Operation of batcher::submit(): the node waits for its batch; the operation that opens a
+// batch also runs that batch's max_delay timer
+template <class T, class R, class Rcvr>
+class _submit_operation : item_node<T, R> {
+  using node = item_node<T, R>;
+
+  struct timer_receiver {
+    using receiver_concept = receiver_t;
+
+    _submit_operation* self_;
+    inplace_stop_token token_;
+
+    void set_value() && noexcept {
+      self_->batcher_->expire(self_->generation_);
+      self_->arrive();
+    }
+
+    void set_error(std::exception_ptr /*unused*/) && noexcept {
+      self_->batcher_->expire(self_->generation_);
+      self_->arrive();
+    }
+
+    void set_stopped() && noexcept {
+      self_->arrive();
+    }
+
+    [[nodiscard]] auto get_env() const noexcept {
+      return make_env_with_stop_token(token_, empty_env{});
+    }
+  };
+
+  using timer_op_t = decltype(std::declval<timer_scheduler::timer_scheduler_handle&>()
+                                  .schedule_after(timer_scheduler::duration{})
+                                  .connect(std::declval<timer_receiver>()));
+
+ public:
+  using operation_state_concept = operation_state_t;
+
+  template <class R2>
+  _submit_operation(batcher<T, R>* owner, T&& item, R2&& r)
+      : node{.complete    = &on_complete,
+             .next        = nullptr,
+             .item        = std::move(item),
+             .result_kind = outcome::stopped,
+             .result      = std::nullopt,
+             .error       = nullptr},
+        batcher_(owner),
+        receiver_(std::forward<R2>(r)) {}
+
+  _submit_operation(const _submit_operation&)                    = delete;
+  auto operator=(const _submit_operation&) -> _submit_operation& = delete;
+
+  void start() & noexcept {
+    // Completion needs the result, the end of start() and, if armed, the timer
+    if (auto opened = batcher_->push(this)) {
+      generation_ = *opened;
+      try {
+        timer_.emplace(__emplace_from{[this] {
+          return batcher_->timer_.schedule_after(batcher_->max_delay_)
+              .connect(timer_receiver{this, timer_stop_.get_token()});
+        }});
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        timer_->start();
+      } catch (...) {
+        batcher_->expire(generation_);
+      }
+    }
+    arrive();
+  }
+
+ private:
+  static void on_complete(node* n) noexcept {
+    auto* self = static_cast<_submit_operation*>(n);
+    self->timer_stop_.request_stop();
+    self->arrive();
+  }
+
+  void arrive() noexcept {
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    switch (this->result_kind) {
+      case outcome::value:
+        std::move(receiver_).set_value(std::move(*this->result));
+        break;
+      case outcome::error:
+        std::move(receiver_).set_error(std::move(this->error));
+        break;
+      case outcome::stopped:
+        std::move(receiver_).set_stopped();
+        break;
+    }
+  }
+
+  batcher<T, R>*            batcher_;
+  Rcvr                      receiver_;
+  std::uint64_t             generation_{0};
+  std::atomic<int>          pending_{2};
+  inplace_stop_source       timer_stop_;
+  std::optional<timer_op_t> timer_;
+};
+
+template <class T, class R>
+struct _submit_sender {
+  using sender_concept = sender_t;
+  using value_types    = type_list<R>;
+
+  batcher<T, R>* batcher_;
+  T              item_;
+
+  template <class Env>
+  auto get_completion_signatures(Env&& /*unused*/) const noexcept {
+    return completion_signatures<set_value_t(R), set_error_t(std::exception_ptr),
+                                 set_stopped_t()>{};
+  }
+
+  template <receiver Rcvr>
+  auto connect(Rcvr&& r) && {
+    return _submit_operation<T, R, __decay_t<Rcvr>>{batcher_, std::move(item_),
+                                                    std::forward<Rcvr>(r)};
+  }
+
+  template <receiver Rcvr>
+  auto connect(Rcvr&& r) & {
+    return _submit_operation<T, R, __decay_t<Rcvr>>{batcher_, T(item_), std::forward<Rcvr>(r)};
+  }
+};
+
+}  // namespace _batcher_detail
+
+}  // namespace flow::execution
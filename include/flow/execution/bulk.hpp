@@ -1,14 +1,50 @@
 #pragma once
 
 #include <exception>
+#include <type_traits>
 #include <utility>
 
+#include "completion_signatures.hpp"
 #include "execution_policy.hpp"
+#include "instrument.hpp"
+#include "parallel_bulk.hpp"
 #include "sender.hpp"
+#include "tiling.hpp"
+#include "type_list.hpp"
 
 namespace flow::execution {
 
 // [exec.bulk], bulk execution with chunking support
+//
+// bulk_chunked and bulk take the parallel bulk path (parallel_bulk.hpp) under par/par_unseq
+// when the predecessor completes on a scheduler that reports get_parallelism(): the body then
+// runs on several agents of that scheduler at once and must be safe to call concurrently.
+// A noexcept body adds no set_error(exception_ptr) to the predecessor's completions and runs
+// without exception handlers.
+//
+// bulk and bulk_chunked also accept multi-dimensional shapes (tiling.hpp). They run as a
+// bulk_chunked over tile numbers in space-filling-curve order, with a body that calls the
+// function per index (bulk) or per tile (bulk_chunked).
+
+namespace _bulk_detail {
+
+// Whether F cannot throw when called with `Idx...` and the sender's values as lvalues
+template <class F, class Values, class... Idx>
+inline constexpr bool nothrow_call = false;
+
+template <class F, class... Ts, class... Idx>
+inline constexpr bool nothrow_call<F, type_list<Ts...>, Idx...> =
+    std::is_nothrow_invocable_v<F&, Idx..., Ts&...>;
+
+// The parallel path also moves the values into state shared by its agents
+template <class Values>
+inline constexpr bool nothrow_values = false;
+
+template <class... Ts>
+inline constexpr bool nothrow_values<type_list<Ts...>> =
+    (std::is_nothrow_move_constructible_v<Ts> && ...);
+
+}  // namespace _bulk_detail
 
 // bulk_chunked: basis operation that processes iterations in chunks
 template <sender S, class Policy, class Shape, class F>
@@ -22,63 +58,73 @@ struct _bulk_chunked_sender {
   F      fun_;
 
   template <class Env>
-  auto get_completion_signatures(Env&& env) const {
-    // Forward the completion signatures from the predecessor sender
-    return std::move(sender_).get_completion_signatures(std::forward<Env>(env));
+  auto get_completion_signatures(Env&& /*unused*/) const {
+    // The predecessor's completions, plus set_error(exception_ptr) if the body may throw and
+    // set_stopped() if the parallel path can be cancelled
+    constexpr bool nothrow = _bulk_detail::nothrow_call<F, value_types, Shape, Shape>
+                             && _bulk_detail::nothrow_values<value_types>;
+    return _parallel_bulk_detail::bulk_signatures_t<S, Env, Policy, !nothrow>{};
   }
 
   template <receiver R>
   auto connect(R&& r) && {
-    return std::move(sender_).connect(_bulk_chunked_receiver<Policy, Shape, F, R>{
-        std::move(policy_), shape_, std::move(fun_), std::forward<R>(r)});
+    auto sched = _parallel_bulk_detail::bulk_scheduler_of(sender_);
+    return std::move(sender_).connect(_bulk_chunked_receiver<Policy, Shape, F, R, decltype(sched)>{
+        std::move(policy_), shape_, std::move(fun_), std::forward<R>(r), sched});
   }
 
   template <receiver R>
   auto connect(R&& r) & {
-    return sender_.connect(
-        _bulk_chunked_receiver<Policy, Shape, F, R>{policy_, shape_, fun_, std::forward<R>(r)});
+    auto sched = _parallel_bulk_detail::bulk_scheduler_of(sender_);
+    return sender_.connect(_bulk_chunked_receiver<Policy, Shape, F, R, decltype(sched)>{
+        policy_, shape_, fun_, std::forward<R>(r), sched});
+  }
+
+  template <class Sndr = S>
+    requires requires(const Sndr& s) { get_completion_scheduler<set_value_t>(s); }
+  [[nodiscard]] auto query(get_completion_scheduler_t<set_value_t> /*unused*/) const noexcept {
+    return get_completion_scheduler<set_value_t>(sender_);
   }
 
  private:
-  template <class Pol, class Sh, class Fn, class Rcvr>
+  template <class Pol, class Sh, class Fn, class Rcvr, class Sched>
   struct _bulk_chunked_receiver {
     using receiver_concept = receiver_t;
 
-    Pol  policy_;
-    Sh   shape_;
-    Fn   fun_;
-    Rcvr receiver_;
+    Pol   policy_;
+    Sh    shape_;
+    Fn    fun_;
+    Rcvr  receiver_;
+    Sched sched_;
 
     template <class... Args>
     void set_value(Args&&... args) && noexcept {
-      try {
-        // Call function with begin/end range only if shape > 0
-        // Default implementation processes entire range as one chunk
-        if (shape_ > 0) {
-          if constexpr (sizeof...(Args) > 0) {
-            fun_(static_cast<Sh>(0), shape_, args...);
-          } else {
-            fun_(static_cast<Sh>(0), shape_);
-          }
-        }
-        if constexpr (sizeof...(Args) > 0) {
-          std::move(receiver_).set_value(std::forward<Args>(args)...);
-        } else {
-          std::move(receiver_).set_value();
-        }
-      } catch (...) {
-        std::move(receiver_).set_error(std::current_exception());
-      }
+      _instrument_detail::mark_stage(receiver_, "bulk_chunked", stage_completion::value);
+      // Each agent gets a [begin, end) chunk; a sequential run is a single chunk
+      _parallel_bulk_detail::run(
+          sched_, _parallel_bulk_detail::agents_for<Pol>(sched_),
+          shape_ > 0 ? static_cast<std::size_t>(shape_) : 0,
+          [fun = std::move(fun_)](std::size_t begin, std::size_t end, auto&... values) mutable
+          noexcept(std::is_nothrow_invocable_v<Fn&, Sh, Sh, decltype(values)...>) {
+            fun(static_cast<Sh>(begin), static_cast<Sh>(end), values...);
+          },
+          std::move(receiver_), std::forward<Args>(args)...);
     }
 
     template <class E>
     void set_error(E&& e) && noexcept {
+      _instrument_detail::mark_stage(receiver_, "bulk_chunked", stage_completion::error);
       std::move(receiver_).set_error(std::forward<E>(e));
     }
 
     void set_stopped() && noexcept {
+      _instrument_detail::mark_stage(receiver_, "bulk_chunked", stage_completion::stopped);
       std::move(receiver_).set_stopped();
     }
+
+    auto get_env() const noexcept {
+      return flow::execution::get_env(receiver_);
+    }
   };
 };
 
@@ -94,9 +140,12 @@ struct _bulk_unchunked_sender {
   F      fun_;
 
   template <class Env>
-  auto get_completion_signatures(Env&& env) const {
-    // Forward the completion signatures from the predecessor sender
-    return std::move(sender_).get_completion_signatures(std::forward<Env>(env));
+  auto get_completion_signatures(Env&& /*unused*/) const {
+    // The predecessor's completions, plus set_error(exception_ptr) if the body may throw. It
+    // always runs inline, so it never adds set_stopped().
+    return __concat_completion_signatures_t<
+        __completion_signatures_of_t<S, Env, set_value_t, set_error_t, set_stopped_t>,
+        __exception_signatures_t<!_bulk_detail::nothrow_call<F, value_types, Shape>>>{};
   }
 
   template <receiver R>
@@ -123,33 +172,43 @@ struct _bulk_unchunked_sender {
 
     template <class... Args>
     void set_value(Args&&... args) && noexcept {
-      try {
-        // Call function for each iteration
-        for (Sh i = 0; i < shape_; ++i) {
-          if constexpr (sizeof...(Args) > 0) {
-            fun_(i, args...);
-          } else {
-            fun_(i);
-          }
+      _instrument_detail::mark_stage(receiver_, "bulk_unchunked", stage_completion::value);
+      if constexpr (std::is_nothrow_invocable_v<Fn&, Sh, std::remove_reference_t<Args>&...>) {
+        run_all(args...);
+      } else {
+        try {
+          run_all(args...);
+        } catch (...) {
+          std::move(receiver_).set_error(std::current_exception());
+          return;
         }
-        if constexpr (sizeof...(Args) > 0) {
-          std::move(receiver_).set_value(std::forward<Args>(args)...);
-        } else {
-          std::move(receiver_).set_value();
-        }
-      } catch (...) {
-        std::move(receiver_).set_error(std::current_exception());
       }
+      std::move(receiver_).set_value(std::forward<Args>(args)...);
     }
 
     template <class E>
     void set_error(E&& e) && noexcept {
+      _instrument_detail::mark_stage(receiver_, "bulk_unchunked", stage_completion::error);
       std::move(receiver_).set_error(std::forward<E>(e));
     }
 
     void set_stopped() && noexcept {
+      _instrument_detail::mark_stage(receiver_, "bulk_unchunked", stage_completion::stopped);
       std::move(receiver_).set_stopped();
     }
+
+    auto get_env() const noexcept {
+      return flow::execution::get_env(receiver_);
+    }
+
+   private:
+    // Call function for each iteration
+    template <class... Values>
+    void run_all(Values&... values) noexcept(std::is_nothrow_invocable_v<Fn&, Sh, Values&...>) {
+      for (Sh i = 0; i < shape_; ++i) {
+        fun_(i, values...);
+      }
+    }
   };
 };
 
@@ -165,64 +224,75 @@ struct _bulk_sender {
   F      fun_;
 
   template <class Env>
-  auto get_completion_signatures(Env&& env) const {
-    // Forward the completion signatures from the predecessor sender
-    return std::move(sender_).get_completion_signatures(std::forward<Env>(env));
+  auto get_completion_signatures(Env&& /*unused*/) const {
+    // The predecessor's completions, plus set_error(exception_ptr) if the body may throw and
+    // set_stopped() if the parallel path can be cancelled
+    constexpr bool nothrow = _bulk_detail::nothrow_call<F, value_types, Shape>
+                             && _bulk_detail::nothrow_values<value_types>;
+    return _parallel_bulk_detail::bulk_signatures_t<S, Env, Policy, !nothrow>{};
   }
 
   template <receiver R>
   auto connect(R&& r) && {
-    return std::move(sender_).connect(_bulk_receiver<Policy, Shape, F, R>{
-        std::move(policy_), shape_, std::move(fun_), std::forward<R>(r)});
+    auto sched = _parallel_bulk_detail::bulk_scheduler_of(sender_);
+    return std::move(sender_).connect(_bulk_receiver<Policy, Shape, F, R, decltype(sched)>{
+        std::move(policy_), shape_, std::move(fun_), std::forward<R>(r), sched});
   }
 
   template <receiver R>
   auto connect(R&& r) & {
-    return sender_.connect(
-        _bulk_receiver<Policy, Shape, F, R>{policy_, shape_, fun_, std::forward<R>(r)});
+    auto sched = _parallel_bulk_detail::bulk_scheduler_of(sender_);
+    return sender_.connect(_bulk_receiver<Policy, Shape, F, R, decltype(sched)>{
+        policy_, shape_, fun_, std::forward<R>(r), sched});
+  }
+
+  template <class Sndr = S>
+    requires requires(const Sndr& s) { get_completion_scheduler<set_value_t>(s); }
+  [[nodiscard]] auto query(get_completion_scheduler_t<set_value_t> /*unused*/) const noexcept {
+    return get_completion_scheduler<set_value_t>(sender_);
   }
 
  private:
-  template <class Pol, class Sh, class Fn, class Rcvr>
+  template <class Pol, class Sh, class Fn, class Rcvr, class Sched>
   struct _bulk_receiver {
     using receiver_concept = receiver_t;
 
-    Pol  policy_;
-    Sh   shape_;
-    Fn   fun_;
-    Rcvr receiver_;
+    Pol   policy_;
+    Sh    shape_;
+    Fn    fun_;
+    Rcvr  receiver_;
+    Sched sched_;
 
     template <class... Args>
     void set_value(Args&&... args) && noexcept {
-      try {
-        // Implement bulk in terms of bulk_chunked by iterating within the chunk
-        Sh begin = 0;
-        Sh end   = shape_;
-        while (begin != end) {
-          if constexpr (sizeof...(Args) > 0) {
-            fun_(begin++, args...);
-          } else {
-            fun_(begin++);
-          }
-        }
-        if constexpr (sizeof...(Args) > 0) {
-          std::move(receiver_).set_value(std::forward<Args>(args)...);
-        } else {
-          std::move(receiver_).set_value();
-        }
-      } catch (...) {
-        std::move(receiver_).set_error(std::current_exception());
-      }
+      _instrument_detail::mark_stage(receiver_, "bulk", stage_completion::value);
+      // Implement bulk in terms of bulk_chunked by iterating within the chunk
+      _parallel_bulk_detail::run(
+          sched_, _parallel_bulk_detail::agents_for<Pol>(sched_),
+          shape_ > 0 ? static_cast<std::size_t>(shape_) : 0,
+          [fun = std::move(fun_)](std::size_t begin, std::size_t end, auto&... values) mutable
+          noexcept(std::is_nothrow_invocable_v<Fn&, Sh, decltype(values)...>) {
+            for (auto i = static_cast<Sh>(begin); i != static_cast<Sh>(end); ++i) {
+              fun(i, values...);
+            }
+          },
+          std::move(receiver_), std::forward<Args>(args)...);
     }
 
     template <class E>
     void set_error(E&& e) && noexcept {
+      _instrument_detail::mark_stage(receiver_, "bulk", stage_completion::error);
       std::move(receiver_).set_error(std::forward<E>(e));
     }
 
     void set_stopped() && noexcept {
+      _instrument_detail::mark_stage(receiver_, "bulk", stage_completion::stopped);
       std::move(receiver_).set_stopped();
     }
+
+    auto get_env() const noexcept {
+      return flow::execution::get_env(receiver_);
+    }
   };
 };
 
@@ -240,8 +310,19 @@ struct bulk_chunked_t {
   template <sender S, class Policy, class Shape, class F>
     requires is_execution_policy_v<Policy>
   constexpr auto operator()(S&& s, Policy&& policy, Shape shape, F&& f) const {
-    return _bulk_chunked_sender<__decay_t<S>, __decay_t<Policy>, Shape, __decay_t<F>>{
-        std::forward<S>(s), std::forward<Policy>(policy), shape, std::forward<F>(f)};
+    if constexpr (_tiling_detail::multi_dim<Shape>) {
+      // One call per tile
+      using traits = _tiling_detail::shape_traits<Shape>;
+      using body   = _tiling_detail::per_tile<traits::rank, __decay_t<F>>;
+      body fun{_tiling_detail::tile_grid<traits::rank>(traits::to_tiled(shape)),
+               std::forward<F>(f)};
+      const std::size_t tiles = fun.grid_.count();
+      return _bulk_chunked_sender<__decay_t<S>, __decay_t<Policy>, std::size_t, body>{
+          std::forward<S>(s), std::forward<Policy>(policy), tiles, std::move(fun)};
+    } else {
+      return _bulk_chunked_sender<__decay_t<S>, __decay_t<Policy>, Shape, __decay_t<F>>{
+          std::forward<S>(s), std::forward<Policy>(policy), shape, std::forward<F>(f)};
+    }
   }
 
   // Curried version for pipe syntax
@@ -274,8 +355,19 @@ struct bulk_t {
   template <sender S, class Policy, class Shape, class F>
     requires is_execution_policy_v<Policy>
   constexpr auto operator()(S&& s, Policy&& policy, Shape shape, F&& f) const {
-    return _bulk_sender<__decay_t<S>, __decay_t<Policy>, Shape, __decay_t<F>>{
-        std::forward<S>(s), std::forward<Policy>(policy), shape, std::forward<F>(f)};
+    if constexpr (_tiling_detail::multi_dim<Shape>) {
+      // Tiles are the chunks; the body walks the indices of each
+      using traits = _tiling_detail::shape_traits<Shape>;
+      using body   = _tiling_detail::per_index<traits::rank, __decay_t<F>>;
+      body fun{_tiling_detail::tile_grid<traits::rank>(traits::to_tiled(shape)),
+               std::forward<F>(f)};
+      const std::size_t tiles = fun.grid_.count();
+      return _bulk_chunked_sender<__decay_t<S>, __decay_t<Policy>, std::size_t, body>{
+          std::forward<S>(s), std::forward<Policy>(policy), tiles, std::move(fun)};
+    } else {
+      return _bulk_sender<__decay_t<S>, __decay_t<Policy>, Shape, __decay_t<F>>{
+          std::forward<S>(s), std::forward<Policy>(policy), shape, std::forward<F>(f)};
+    }
   }
 
   // Curried version for pipe syntax
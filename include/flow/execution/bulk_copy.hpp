@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "../detail/streaming_store.hpp"
+#include "bulk.hpp"
+#include "execution_policy.hpp"
+#include "sender.hpp"
+
+namespace flow::execution {
+
+// [exec.bulk.copy], bulk_copy / bulk_fill
+//
+//   schedule(sched) | bulk_copy(par, src, dst)
+//   schedule(sched) | bulk_fill(par, dst, 0.0)
+//
+// Copy a contiguous range into another, or set every element of one to a value, as a
+// bulk_chunked over the destination's pages: chunk boundaries fall on page boundaries of the
+// destination, so no two agents write the same page, and a first pass over fresh memory places
+// each page with the agent that writes it (numa_vector.hpp). Both complete with the
+// predecessor's values and never throw. The ranges are referenced, not copied, and must stay
+// alive until the sender completes, so they must be lvalues or borrowed ranges such as spans:
+// a temporary container is rejected. bulk_copy's ranges must not overlap, and it copies
+// min(size(src), size(dst)) elements.
+//
+// Copies and fills of at least streaming_threshold bytes use streaming stores when the CPU
+// has AVX2 or AVX-512 (detail/streaming_store.hpp): the destination bypasses the cache
+// instead of evicting everything else from it. Smaller ones take the plain memcpy/fill path,
+// where the destination is likely still cached for whoever reads it next. A store_mode
+// argument forces either path. bulk_fill streams only element types whose size divides 64.
+
+// How bulk_copy and bulk_fill write the destination
+enum class store_mode : std::uint8_t {
+  automatic,  // Streaming stores from streaming_threshold bytes up, where the CPU has them
+  cached,     // Always regular stores
+  streaming,  // Streaming stores at any size, where the CPU has them
+};
+
+// Destination size from which store_mode::automatic streams: past a typical per-core share
+// of the last-level cache, the destination would not stay cached anyway
+inline constexpr std::size_t streaming_threshold = std::size_t{4} << 20;
+
+namespace _bulk_copy_detail {
+
+inline constexpr std::size_t page_bytes = 4096;
+
+// `count` elements of `size` bytes at `base`, split at the page boundaries of their address
+// range: block k holds the elements from element(k) up to element(k + 1)
+class page_blocks {
+ public:
+  page_blocks(const void* base, std::size_t count, std::size_t size) noexcept
+      : base_(reinterpret_cast<std::uintptr_t>(base)), count_(count), size_(size) {
+    if (count_ != 0) {
+      const std::uintptr_t first = base_ - (base_ % page_bytes);
+      blocks_ = (base_ + (count_ * size_) - first + page_bytes - 1) / page_bytes;
+    }
+  }
+
+  [[nodiscard]] auto count() const noexcept -> std::size_t {
+    return blocks_;
+  }
+
+  // First element starting at or past page boundary k
+  [[nodiscard]] auto element(std::size_t k) const noexcept -> std::size_t {
+    if (k == 0) {
+      return 0;
+    }
+    if (k >= blocks_) {
+      return count_;
+    }
+    const std::uintptr_t boundary = base_ - (base_ % page_bytes) + (k * page_bytes);
+    return std::min(count_, (boundary - base_ + size_ - 1) / size_);
+  }
+
+ private:
+  std::uintptr_t base_;
+  std::size_t    count_;
+  std::size_t    size_;
+  std::size_t    blocks_{0};
+};
+
+// Kernel that writes `bytes` bytes in `mode`
+inline auto kernel_for(store_mode mode, std::size_t bytes) noexcept -> detail::streaming::isa {
+  if (mode == store_mode::cached
+      || (mode == store_mode::automatic && bytes < streaming_threshold)) {
+    return detail::streaming::isa::none;
+  }
+  return detail::streaming::best();
+}
+
+template <class Src, class Dst>
+concept copyable_ranges =
+    std::ranges::borrowed_range<Src> && std::ranges::borrowed_range<Dst>
+    && std::ranges::contiguous_range<Src> && std::ranges::sized_range<Src>
+    && std::ranges::contiguous_range<Dst> && std::ranges::sized_range<Dst>
+    && std::same_as<std::ranges::range_value_t<Src>, std::ranges::range_value_t<Dst>>
+    && std::is_trivially_copyable_v<std::ranges::range_value_t<Dst>>
+    && !std::is_const_v<std::remove_reference_t<std::ranges::range_reference_t<Dst>>>;
+
+template <class Dst, class V>
+concept fillable_range =
+    std::ranges::borrowed_range<Dst> && std::ranges::contiguous_range<Dst>
+    && std::ranges::sized_range<Dst>
+    && std::is_trivially_copyable_v<std::ranges::range_value_t<Dst>>
+    && !std::is_const_v<std::remove_reference_t<std::ranges::range_reference_t<Dst>>>
+    && std::convertible_to<V, std::ranges::range_value_t<Dst>>;
+
+template <class T>
+class copy_body {
+ public:
+  copy_body(const T* src, T* dst, std::size_t count, store_mode mode) noexcept
+      : src_(src),
+        dst_(dst),
+        blocks_(dst, count, sizeof(T)),
+        kernel_(kernel_for(mode, count * sizeof(T))) {}
+
+  [[nodiscard]] auto blocks() const noexcept -> std::size_t {
+    return blocks_.count();
+  }
+
+  template <class... Values>
+  void operator()(std::size_t begin, std::size_t end, Values&... /*unused*/) const noexcept {
+    const std::size_t first = blocks_.element(begin);
+    const std::size_t bytes = (blocks_.element(end) - first) * sizeof(T);
+    if (kernel_ == detail::streaming::isa::none) {
+      std::memcpy(dst_ + first, src_ + first, bytes);
+    } else {
+      detail::streaming::copy(kernel_, dst_ + first, src_ + first, bytes);
+    }
+  }
+
+ private:
+  const T*               src_;
+  T*                     dst_;
+  page_blocks            blocks_;
+  detail::streaming::isa kernel_;
+};
+
+template <class T>
+class fill_body {
+ public:
+  fill_body(T* dst, std::size_t count, const T& value, store_mode mode) noexcept
+      : dst_(dst),
+        value_(value),
+        blocks_(dst, count, sizeof(T)),
+        kernel_(kernel_for(mode, count * sizeof(T))) {
+    // The pattern repeats the value every sizeof(T) bytes from a 64-byte boundary, so it only
+    // lines up with elements whose size divides 64 and which start on a multiple of it
+    if (64 % sizeof(T) != 0 || reinterpret_cast<std::uintptr_t>(dst) % sizeof(T) != 0) {
+      kernel_ = detail::streaming::isa::none;
+    }
+    if (kernel_ != detail::streaming::isa::none) {
+      for (std::size_t offset = 0; offset < 64; offset += sizeof(T)) {
+        std::memcpy(pattern_ + offset, &value_, sizeof(T));
+      }
+    }
+  }
+
+  [[nodiscard]] auto blocks() const noexcept -> std::size_t {
+    return blocks_.count();
+  }
+
+  template <class... Values>
+  void operator()(std::size_t begin, std::size_t end, Values&... /*unused*/) const noexcept {
+    const std::size_t first = blocks_.element(begin);
+    const std::size_t last  = blocks_.element(end);
+    if (kernel_ == detail::streaming::isa::none) {
+      std::fill(dst_ + first, dst_ + last, value_);
+    } else {
+      detail::streaming::fill(kernel_, dst_ + first, pattern_, (last - first) * sizeof(T));
+    }
+  }
+
+ private:
+  T*                     dst_;
+  T                      value_;
+  page_blocks            blocks_;
+  detail::streaming::isa kernel_;
+  unsigned char          pattern_[64]{};  // value_ repeated, for the streaming kernels
+};
+
+}  // namespace _bulk_copy_detail
+
+struct bulk_copy_t {
+  template <sender S, class Policy, class Src, class Dst>
+    requires is_execution_policy_v<Policy> && _bulk_copy_detail::copyable_ranges<Src, Dst>
+  auto operator()(S&& s, Policy&& policy, Src&& src, Dst&& dst,
+                  store_mode mode = store_mode::automatic) const {
+    auto              body   = make_body(src, dst, mode);
+    const std::size_t blocks = body.blocks();
+    return bulk_chunked(std::forward<S>(s), std::forward<Policy>(policy), blocks, std::move(body));
+  }
+
+  // Curried version for pipe syntax
+  template <class Policy, class Src, class Dst>
+    requires is_execution_policy_v<Policy> && _bulk_copy_detail::copyable_ranges<Src, Dst>
+  auto operator()(Policy&& policy, Src&& src, Dst&& dst,
+                  store_mode mode = store_mode::automatic) const {
+    auto              body   = make_body(src, dst, mode);
+    const std::size_t blocks = body.blocks();
+    return bulk_chunked(std::forward<Policy>(policy), blocks, std::move(body));
+  }
+
+ private:
+  template <class Src, class Dst>
+  static auto make_body(Src& src, Dst& dst, store_mode mode) noexcept {
+    using T = std::ranges::range_value_t<Dst>;
+    const auto count = std::min<std::size_t>(std::ranges::size(src), std::ranges::size(dst));
+    return _bulk_copy_detail::copy_body<T>(std::ranges::data(src), std::ranges::data(dst), count,
+                                           mode);
+  }
+};
+
+struct bulk_fill_t {
+  template <sender S, class Policy, class Dst, class V>
+    requires is_execution_policy_v<Policy> && _bulk_copy_detail::fillable_range<Dst, V>
+  auto operator()(S&& s, Policy&& policy, Dst&& dst, V&& value,
+                  store_mode mode = store_mode::automatic) const {
+    auto              body   = make_body(dst, std::forward<V>(value), mode);
+    const std::size_t blocks = body.blocks();
+    return bulk_chunked(std::forward<S>(s), std::forward<Policy>(policy), blocks, std::move(body));
+  }
+
+  // Curried version for pipe syntax
+  template <class Policy, class Dst, class V>
+    requires is_execution_policy_v<Policy> && _bulk_copy_detail::fillable_range<Dst, V>
+  auto operator()(Policy&& policy, Dst&& dst, V&& value,
+                  store_mode mode = store_mode::automatic) const {
+    auto              body   = make_body(dst, std::forward<V>(value), mode);
+    const std::size_t blocks = body.blocks();
+    return bulk_chunked(std::forward<Policy>(policy), blocks, std::move(body));
+  }
+
+ private:
+  template <class Dst, class V>
+  static auto make_body(Dst& dst, V&& value, store_mode mode) {
+    using T = std::ranges::range_value_t<Dst>;
+    return _bulk_copy_detail::fill_body<T>(std::ranges::data(dst), std::ranges::size(dst),
+                                           T(std::forward<V>(value)), mode);
+  }
+};
+
+inline constexpr bulk_copy_t bulk_copy{};
+inline constexpr bulk_fill_t bulk_fill{};
+
+}  // namespace flow::execution
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "bulk.hpp"
+#include "completion_signatures.hpp"
+#include "execution_policy.hpp"
+#include "instrument.hpp"
+#include "parallel_bulk.hpp"
+#include "sender.hpp"
+
+namespace flow::execution {
+
+// [exec.bulk.search], bulk_find_if / bulk_any_of
+//
+//   schedule(sched) | bulk_find_if(par, n, [&](std::size_t i) { return keys[i] == key; })
+//   schedule(sched) | bulk_any_of(par, n, [&](std::size_t i) { return bad(rows[i]); })
+//
+// Searches [0, shape) with pred(i, values...) on the parallel bulk path (parallel_bulk.hpp).
+// A match cancels every chunk that has not started yet; chunks already running stop at the
+// next index. bulk_find_if completes with the lowest matching index (std::nullopt if there
+// is none) and bulk_any_of with whether any index matched. Like the other bulk algorithms
+// they complete with set_stopped when the receiver's stop token is triggered between chunks.
+// A noexcept predicate adds no set_error(exception_ptr) to the predecessor's completions.
+
+namespace _bulk_search_detail {
+
+// Chunks are claimed in increasing order, so once an index matches every chunk not yet
+// claimed lies above it and can be skipped; running chunks only scan below the best match.
+template <class Shape, class Pred>
+class find_if_body {
+ public:
+  find_if_body(Pred pred, std::size_t shape)
+      : pred_(std::move(pred)), best_(shape), shape_(shape) {}
+
+  find_if_body(find_if_body&& other) noexcept(std::is_nothrow_move_constructible_v<Pred>)
+      : pred_(std::move(other.pred_)),
+        best_(other.best_.load(std::memory_order_relaxed)),
+        shape_(other.shape_) {}
+
+  template <class... Values>
+  auto operator()(std::size_t begin, std::size_t end, Values&... values) noexcept(
+      std::is_nothrow_invocable_v<Pred&, Shape, Values&...>) -> bool {
+    for (auto i = begin; i != end && i < best_.load(std::memory_order_relaxed); ++i) {
+      if (pred_(static_cast<Shape>(i), values...)) {
+        auto best = best_.load(std::memory_order_relaxed);
+        while (i < best && !best_.compare_exchange_weak(best, i, std::memory_order_relaxed)) {
+        }
+        return false;
+      }
+    }
+    return true;
+  }
+
+  [[nodiscard]] auto result() const noexcept -> std::optional<Shape> {
+    auto best = best_.load(std::memory_order_relaxed);
+    return best < shape_ ? std::optional<Shape>(static_cast<Shape>(best)) : std::nullopt;
+  }
+
+ private:
+  Pred                     pred_;
+  std::atomic<std::size_t> best_;
+  std::size_t              shape_;
+};
+
+template <class Shape, class Pred>
+class any_of_body {
+ public:
+  any_of_body(Pred pred, std::size_t /*shape*/) : pred_(std::move(pred)) {}
+
+  any_of_body(any_of_body&& other) noexcept(std::is_nothrow_move_constructible_v<Pred>)
+      : pred_(std::move(other.pred_)), found_(other.found_.load(std::memory_order_relaxed)) {}
+
+  template <class... Values>
+  auto operator()(std::size_t begin, std::size_t end, Values&... values) noexcept(
+      std::is_nothrow_invocable_v<Pred&, Shape, Values&...>) -> bool {
+    for (auto i = begin; i != end && !found_.load(std::memory_order_relaxed); ++i) {
+      if (pred_(static_cast<Shape>(i), values...)) {
+        found_.store(true, std::memory_order_relaxed);
+        return false;
+      }
+    }
+    return true;
+  }
+
+  [[nodiscard]] auto result() const noexcept -> bool {
+    return found_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  Pred              pred_;
+  std::atomic<bool> found_{false};
+};
+
+// Shared sender for both searches; `Body` supplies the scan and the result type
+template <template <class, class> class Body, sender S, class Policy, class Shape, class F>
+struct _bulk_search_sender {
+  using body_type      = Body<Shape, F>;
+  using result_type    = decltype(std::declval<const body_type&>().result());
+  using sender_concept = sender_t;
+  using value_types    = type_list<result_type>;
+
+  S      sender_;
+  Policy policy_;
+  Shape  shape_;
+  F      fun_;
+
+  template <class Env>
+  auto get_completion_signatures(Env&& /*unused*/) const noexcept {
+    // The result replaces the predecessor's values; its errors and stopped pass through, plus
+    // set_error(exception_ptr) if the predicate may throw
+    constexpr bool nothrow =
+        _bulk_detail::nothrow_call<F, typename S::value_types, Shape>
+        && _bulk_detail::nothrow_values<typename S::value_types>;
+    return __concat_completion_signatures_t<
+        completion_signatures<set_value_t(result_type), set_stopped_t()>,
+        __completion_signatures_of_t<S, Env, set_error_t, set_stopped_t>,
+        __exception_signatures_t<!nothrow>>{};
+  }
+
+  template <receiver R>
+  auto connect(R&& r) && {
+    auto sched = _parallel_bulk_detail::bulk_scheduler_of(sender_);
+    return std::move(sender_).connect(_bulk_search_receiver<__decay_t<R>, decltype(sched)>{
+        shape_, std::move(fun_), std::forward<R>(r), sched});
+  }
+
+  template <receiver R>
+  auto connect(R&& r) & {
+    auto sched = _parallel_bulk_detail::bulk_scheduler_of(sender_);
+    return sender_.connect(
+        _bulk_search_receiver<__decay_t<R>, decltype(sched)>{shape_, fun_, std::forward<R>(r),
+                                                             sched});
+  }
+
+  template <class Sndr = S>
+    requires requires(const Sndr& s) { get_completion_scheduler<set_value_t>(s); }
+  [[nodiscard]] auto query(get_completion_scheduler_t<set_value_t> /*unused*/) const noexcept {
+    return get_completion_scheduler<set_value_t>(sender_);
+  }
+
+ private:
+  template <class Rcvr, class Sched>
+  struct _bulk_search_receiver {
+    using receiver_concept = receiver_t;
+
+    Shape shape_;
+    F     fun_;
+    Rcvr  receiver_;
+    Sched sched_;
+
+    template <class... Args>
+    void set_value(Args&&... args) && noexcept {
+      _instrument_detail::mark_stage(receiver_, "bulk_search", stage_completion::value);
+      const auto shape = shape_ > 0 ? static_cast<std::size_t>(shape_) : 0;
+      _parallel_bulk_detail::run(sched_, _parallel_bulk_detail::agents_for<Policy>(sched_), shape,
+                                 body_type(std::move(fun_), shape), std::move(receiver_),
+                                 std::forward<Args>(args)...);
+    }
+
+    template <class E>
+    void set_error(E&& e) && noexcept {
+      _instrument_detail::mark_stage(receiver_, "bulk_search", stage_completion::error);
+      std::move(receiver_).set_error(std::forward<E>(e));
+    }
+
+    void set_stopped() && noexcept {
+      _instrument_detail::mark_stage(receiver_, "bulk_search", stage_completion::stopped);
+      std::move(receiver_).set_stopped();
+    }
+
+    auto get_env() const noexcept {
+      return flow::execution::get_env(receiver_);
+    }
+  };
+};
+
+template <template <class, class> class Body, class Policy, class Shape, class F>
+struct _pipeable_bulk_search;
+
+template <template <class, class> class Body>
+struct bulk_search_t {
+  template <sender S, class Policy, class Shape, class F>
+    requires is_execution_policy_v<Policy>
+  constexpr auto operator()(S&& s, Policy&& policy, Shape shape, F&& f) const {
+    return _bulk_search_sender<Body, __decay_t<S>, __decay_t<Policy>, Shape, __decay_t<F>>{
+        std::forward<S>(s), std::forward<Policy>(policy), shape, std::forward<F>(f)};
+  }
+
+  // Curried version for pipe syntax
+  template <class Policy, class Shape, class F>
+    requires is_execution_policy_v<Policy>
+  constexpr auto operator()(Policy&& policy, Shape shape, F&& f) const {
+    return _pipeable_bulk_search<Body, __decay_t<Policy>, Shape, __decay_t<F>>{
+        std::forward<Policy>(policy), shape, std::forward<F>(f)};
+  }
+};
+
+template <template <class, class> class Body, class Policy, class Shape, class F>
+struct _pipeable_bulk_search {
+  Policy policy_;
+  Shape  shape_;
+  F      fun_;
+
+  template <sender S>
+  friend auto operator|(S&& s, const _pipeable_bulk_search& p) {
+    return bulk_search_t<Body>{}(std::forward<S>(s), p.policy_, p.shape_, p.fun_);
+  }
+};
+
+}  // namespace _bulk_search_detail
+
+using bulk_find_if_t = _bulk_search_detail::bulk_search_t<_bulk_search_detail::find_if_body>;
+using bulk_any_of_t  = _bulk_search_detail::bulk_search_t<_bulk_search_detail::any_of_body>;
+
+inline constexpr bulk_find_if_t bulk_find_if{};
+inline constexpr bulk_any_of_t  bulk_any_of{};
+
+}  // namespace flow::execution
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "execution_policy.hpp"
+#include "instrument.hpp"
+#include "parallel_bulk.hpp"
+#include "sender.hpp"
+#include "utils.hpp"
+
+namespace flow::execution {
+
+// [exec.bulk.state], bulk with per-agent scratch state
+//
+//   schedule(sched)
+//   | bulk_with_state(par, frames.size(),
+//                     [] { return decoder_scratch{}; },
+//                     [&](std::size_t i, decoder_scratch& scratch) { decode(frames[i], scratch); })
+//
+// Like bulk, but every agent of the parallel bulk path (parallel_bulk.hpp) lazily builds its
+// own state with init() before running its first chunk, and each call receives a reference to
+// it as fn(i, state, values...). States live in separate cache lines and are never shared, so
+// the body needs no locking. The optional combine(state) runs once per constructed state, in
+// agent order, after the last index and before the predecessor's values are forwarded.
+
+namespace _bulk_state_detail {
+
+// Default combine step: leave the states alone
+struct no_combine {
+  template <class State>
+  void operator()(State& /*unused*/) const noexcept {}
+};
+
+template <class Shape, class Init, class F, class Combine>
+class state_body {
+  using state_type = __decay_t<std::invoke_result_t<Init&>>;
+
+  struct alignas(64) slot {
+    std::optional<state_type> state;
+  };
+
+ public:
+  state_body(Init init, F fun, Combine combine, std::size_t agents)
+      : init_(std::move(init)),
+        fun_(std::move(fun)),
+        combine_(std::move(combine)),
+        slots_(std::make_unique<slot[]>(agents)),
+        agents_(agents) {}
+
+  template <class... Values>
+  void operator()(_parallel_bulk_detail::agent_index agent, std::size_t begin, std::size_t end,
+                  Values&... values) {
+    auto& state = slots_[agent.value].state;
+    if (!state) {
+      state.emplace(__emplace_from{[this] { return std::invoke(init_); }});
+    }
+    for (auto i = begin; i != end; ++i) {
+      std::invoke(fun_, static_cast<Shape>(i), *state, values...);
+    }
+  }
+
+  void finish() {
+    for (std::size_t i = 0; i < agents_; ++i) {
+      if (slots_[i].state) {
+        std::invoke(combine_, *slots_[i].state);
+      }
+    }
+  }
+
+ private:
+  Init                    init_;
+  F                       fun_;
+  Combine                 combine_;
+  std::unique_ptr<slot[]> slots_;
+  std::size_t             agents_;
+};
+
+template <sender S, class Policy, class Shape, class Init, class F, class Combine>
+struct _bulk_with_state_sender {
+  using sender_concept = sender_t;
+  using value_types    = typename S::value_types;
+
+  S       sender_;
+  Policy  policy_;
+  Shape   shape_;
+  Init    init_;
+  F       fun_;
+  Combine combine_;
+
+  template <class Env>
+  auto get_completion_signatures(Env&& /*unused*/) const {
+    return _parallel_bulk_detail::bulk_signatures_t<S, Env, Policy, true>{};
+  }
+
+  template <receiver R>
+  auto connect(R&& r) && {
+    auto sched = _parallel_bulk_detail::bulk_scheduler_of(sender_);
+    return std::move(sender_).connect(_bulk_with_state_receiver<__decay_t<R>, decltype(sched)>{
+        shape_, std::move(init_), std::move(fun_), std::move(combine_), std::forward<R>(r),
+        sched});
+  }
+
+  template <receiver R>
+  auto connect(R&& r) & {
+    auto sched = _parallel_bulk_detail::bulk_scheduler_of(sender_);
+    return sender_.connect(_bulk_with_state_receiver<__decay_t<R>, decltype(sched)>{
+        shape_, init_, fun_, combine_, std::forward<R>(r), sched});
+  }
+
+  template <class Sndr = S>
+    requires requires(const Sndr& s) { get_completion_scheduler<set_value_t>(s); }
+  [[nodiscard]] auto query(get_completion_scheduler_t<set_value_t> /*unused*/) const noexcept {
+    return get_completion_scheduler<set_value_t>(sender_);
+  }
+
+ private:
+  template <class Rcvr, class Sched>
+  struct _bulk_with_state_receiver {
+    using receiver_concept = receiver_t;
+
+    Shape   shape_;
+    Init    init_;
+    F       fun_;
+    Combine combine_;
+    Rcvr    receiver_;
+    Sched   sched_;
+
+    template <class... Args>
+    void set_value(Args&&... args) && noexcept {
+      _instrument_detail::mark_stage(receiver_, "bulk_with_state", stage_completion::value);
+      using body_t = state_body<Shape, Init, F, Combine>;
+
+      const auto agents = _parallel_bulk_detail::agents_for<Policy>(sched_);
+      std::optional<body_t> body;
+      try {
+        body.emplace(std::move(init_), std::move(fun_), std::move(combine_), agents);
+      } catch (...) {
+        std::move(receiver_).set_error(std::current_exception());
+        return;
+      }
+      _parallel_bulk_detail::run(sched_, agents, shape_ > 0 ? static_cast<std::size_t>(shape_) : 0,
+                                 std::move(*body), std::move(receiver_),
+                                 std::forward<Args>(args)...);
+    }
+
+    template <class E>
+    void set_error(E&& e) && noexcept {
+      _instrument_detail::mark_stage(receiver_, "bulk_with_state", stage_completion::error);
+      std::move(receiver_).set_error(std::forward<E>(e));
+    }
+
+    void set_stopped() && noexcept {
+      _instrument_detail::mark_stage(receiver_, "bulk_with_state", stage_completion::stopped);
+      std::move(receiver_).set_stopped();
+    }
+
+    auto get_env() const noexcept {
+      return flow::execution::get_env(receiver_);
+    }
+  };
+};
+
+}  // namespace _bulk_state_detail
+
+// Pipeable version forward declaration
+template <class Policy, class Shape, class Init, class F, class Combine>
+struct _pipeable_bulk_with_state;
+
+struct bulk_with_state_t {
+  template <sender S, class Policy, class Shape, class Init, class F,
+            class Combine = _bulk_state_detail::no_combine>
+    requires is_execution_policy_v<Policy> && std::invocable<__decay_t<Init>&>
+  constexpr auto operator()(S&& s, Policy&& policy, Shape shape, Init&& init, F&& f,
+                            Combine&& combine = {}) const {
+    return _bulk_state_detail::_bulk_with_state_sender<__decay_t<S>, __decay_t<Policy>, Shape,
+                                                       __decay_t<Init>, __decay_t<F>,
+                                                       __decay_t<Combine>>{
+        std::forward<S>(s), std::forward<Policy>(policy), shape, std::forward<Init>(init),
+        std::forward<F>(f), std::forward<Combine>(combine)};
+  }
+
+  // Curried version for pipe syntax
+  template <class Policy, class Shape, class Init, class F,
+            class Combine = _bulk_state_detail::no_combine>
+    requires is_execution_policy_v<Policy> && std::invocable<__decay_t<Init>&>
+  constexpr auto operator()(Policy&& policy, Shape shape, Init&& init, F&& f,
+                            Combine&& combine = {}) const {
+    return _pipeable_bulk_with_state<__decay_t<Policy>, Shape, __decay_t<Init>, __decay_t<F>,
+                                     __decay_t<Combine>>{
+        std::forward<Policy>(policy), shape, std::forward<Init>(init), std::forward<F>(f),
+        std::forward<Combine>(combine)};
+  }
+};
+
+inline constexpr bulk_with_state_t bulk_with_state{};
+
+template <class Policy, class Shape, class Init, class F, class Combine>
+struct _pipeable_bulk_with_state {
+  Policy  policy_;
+  Shape   shape_;
+  Init    init_;
+  F       fun_;
+  Combine combine_;
+
+  template <sender S>
+  friend auto operator|(S&& s, const _pipeable_bulk_with_state& p) {
+    return bulk_with_state_t{}(std::forward<S>(s), p.policy_, p.shape_, p.init_, p.fun_,
+                               p.combine_);
+  }
+};
+
+}  // namespace flow::execution
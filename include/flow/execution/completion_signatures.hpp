@@ -1,8 +1,13 @@
 #pragma once
 
+#include <concepts>
+#include <exception>
+#include <type_traits>
 #include <utility>
 
 #include "env.hpp"
+#include "receiver.hpp"
+#include "utils.hpp"
 
 namespace flow::execution {
 
@@ -26,4 +31,77 @@ struct get_completion_signatures_t {
 
 inline constexpr get_completion_signatures_t get_completion_signatures{};
 
+// Building blocks for adaptors that compute their signatures from their predecessor's
+namespace _sigs_detail {
+
+template <class Sig, class... Tags>
+inline constexpr bool _has_tag = false;
+
+template <class Tag, class... As, class... Tags>
+inline constexpr bool _has_tag<Tag(As...), Tags...> = (std::same_as<Tag, Tags> || ...);
+
+template <class Result, class... Sigs>
+struct _merge {
+  using type = Result;
+};
+
+template <class... Rs, class Sig, class... Sigs>
+struct _merge<completion_signatures<Rs...>, Sig, Sigs...>
+    : _merge<std::conditional_t<(std::same_as<Rs, Sig> || ...), completion_signatures<Rs...>,
+                                completion_signatures<Rs..., Sig>>,
+             Sigs...> {};
+
+template <class Result, class... Lists>
+struct _concat {
+  using type = Result;
+};
+
+template <class Result, class... Sigs, class... Lists>
+struct _concat<Result, completion_signatures<Sigs...>, Lists...>
+    : _concat<typename _merge<Result, Sigs...>::type, Lists...> {};
+
+template <class Sigs, class... Tags>
+struct _filter;
+
+template <class... Sigs, class... Tags>
+struct _filter<completion_signatures<Sigs...>, Tags...>
+    : _concat<completion_signatures<>,
+              std::conditional_t<_has_tag<Sigs, Tags...>, completion_signatures<Sigs>,
+                                 completion_signatures<>>...> {};
+
+template <class Sndr, class Env>
+struct _sigs_of {
+  using type = completion_signatures<set_error_t(std::exception_ptr), set_stopped_t()>;
+};
+
+template <class Sndr, class Env>
+  requires requires(const Sndr& sndr, Env&& env) {
+    sndr.get_completion_signatures(std::forward<Env>(env));
+  }
+struct _sigs_of<Sndr, Env> {
+  using type = __decay_t<decltype(std::declval<const Sndr&>().get_completion_signatures(
+      std::declval<Env>()))>;
+};
+
+}  // namespace _sigs_detail
+
+// Union of signature lists, in order of first appearance
+template <class... Lists>
+using __concat_completion_signatures_t =
+    typename _sigs_detail::_concat<completion_signatures<>, Lists...>::type;
+
+// The completions of `Sndr` in `Env` on the channels `Tags...`. A sender that cannot report
+// its signatures is assumed to complete with set_error(std::exception_ptr) and set_stopped().
+template <class Sndr, class Env, class... Tags>
+using __completion_signatures_of_t =
+    typename _sigs_detail::_filter<typename _sigs_detail::_sigs_of<__remove_cvref_t<Sndr>,
+                                                                    Env>::type,
+                                   Tags...>::type;
+
+// set_error(std::exception_ptr) for an adaptor whose function may throw, nothing otherwise
+template <bool MayThrow>
+using __exception_signatures_t =
+    std::conditional_t<MayThrow, completion_signatures<set_error_t(std::exception_ptr)>,
+                       completion_signatures<>>;
+
 }  // namespace flow::execution
@@ -3,21 +3,29 @@
 #include <atomic>
 #include <cstdint>
 #include <exception>
+#include <memory>
 #include <stop_token>
 
 #include "completion_signatures.hpp"
 #include "receiver.hpp"
 #include "sender.hpp"
+#include "spawn_slab.hpp"
 
 namespace flow::execution {
 
 // [exec.simple.counting.scope], simple_counting_scope
+//
+// Constructed with spawn_slab_options, the scope owns a slab of operation-state slots that
+// spawn() uses before falling back to the allocator (spawn_slab.hpp).
 class simple_counting_scope {
  public:
   class token;
 
   simple_counting_scope() noexcept = default;
 
+  explicit simple_counting_scope(spawn_slab_options options)
+      : slab_(std::make_unique<spawn_slab>(options)), spawn_slots_(&slab_->pool()) {}
+
   ~simple_counting_scope() {
     // Safe to destroy if: never used, properly closed, or properly joined
     auto state = state_.load(std::memory_order_acquire);
@@ -46,27 +54,37 @@ class simple_counting_scope {
     }
   }
 
+  // A started join parks here until the last association is released
+  struct join_waiter {
+    void (*complete_)(join_waiter*) noexcept;
+  };
+
   template <receiver Rcvr>
-  struct join_operation {
+  struct join_operation : join_waiter {
     using operation_state_concept = operation_state_t;
     simple_counting_scope* scope_;
     Rcvr                   rcvr_;
 
+    join_operation(simple_counting_scope* scope, Rcvr rcvr)
+        : join_waiter{&finish}, scope_(scope), rcvr_(std::move(rcvr)) {}
+
+    join_operation(const join_operation&)            = delete;
+    join_operation& operator=(const join_operation&) = delete;
+
     void start() noexcept {
-      // Transition to joining state
-      auto old_state = scope_->state_.exchange(state_joining, std::memory_order_acq_rel);
-      (void)old_state;  // Suppress unused warning
+      scope_->state_.exchange(state_joining, std::memory_order_acq_rel);
 
-      // Check count
-      if (scope_->count_.load(std::memory_order_acquire) == 0) {
-        scope_->state_.store(state_joined, std::memory_order_release);
-        std::move(rcvr_).set_value();
-      } else {
-        // Store receiver for later completion
-        // In real implementation, this would need synchronization
-        std::move(rcvr_).set_value();
+      // Publish before looking at the count: either this load sees zero or the last
+      // disassociation sees the waiter (both may, and complete_join() picks one)
+      scope_->join_waiter_.store(this, std::memory_order_seq_cst);
+      if (scope_->count_.load(std::memory_order_seq_cst) == 0) {
+        scope_->complete_join();
       }
     }
+
+    static void finish(join_waiter* waiter) noexcept {
+      std::move(static_cast<join_operation*>(waiter)->rcvr_).set_value();
+    }
   };
 
   struct join_sender {
@@ -80,7 +98,7 @@ class simple_counting_scope {
 
     template <receiver Rcvr>
     auto connect(Rcvr&& rcvr) {
-      return join_operation<Rcvr>{scope_, std::forward<Rcvr>(rcvr)};
+      return join_operation<__decay_t<Rcvr>>{scope_, std::forward<Rcvr>(rcvr)};
     }
   };
 
@@ -96,8 +114,11 @@ class simple_counting_scope {
   static constexpr uint64_t state_joining           = 4;
   static constexpr uint64_t state_joined            = 5;
 
-  std::atomic<uint64_t> state_{state_unused};
-  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t>          state_{state_unused};
+  std::atomic<uint64_t>          count_{0};
+  std::atomic<join_waiter*>      join_waiter_{nullptr};
+  std::unique_ptr<spawn_slab>    slab_;
+  _spawn_slab_detail::slot_pool* spawn_slots_{nullptr};
 
   bool try_associate_impl() noexcept {
     auto state = state_.load(std::memory_order_acquire);
@@ -118,18 +139,26 @@ class simple_counting_scope {
   }
 
   void disassociate_impl() noexcept {
-    auto old_count = count_.fetch_sub(1, std::memory_order_acq_rel);
+    auto old_count = count_.fetch_sub(1, std::memory_order_seq_cst);
     if (old_count == 1) {
       // Last association released, may need to complete join
-      auto state = state_.load(std::memory_order_acquire);
-      if (state == state_joining) {
-        state_.store(state_joined, std::memory_order_release);
-        // Signal waiting join operation
-      }
+      complete_join();
+    }
+  }
+
+  void complete_join() noexcept {
+    if (auto* waiter = join_waiter_.exchange(nullptr, std::memory_order_seq_cst)) {
+      state_.store(state_joined, std::memory_order_release);
+      waiter->complete_(waiter);
     }
   }
 
   friend class token;
+
+ protected:
+  // For scopes that keep their slab inline
+  explicit simple_counting_scope(_spawn_slab_detail::slot_pool& slots) noexcept
+      : spawn_slots_(&slots) {}
 };
 
 class simple_counting_scope::token {
@@ -152,6 +181,11 @@ class simple_counting_scope::token {
     return std::forward<Sndr>(sndr);
   }
 
+  // Slots spawn() places operation states in; nullptr when the scope has no slab
+  auto spawn_slots() const noexcept -> _spawn_slab_detail::slot_pool* {
+    return scope_->spawn_slots_;
+  }
+
  private:
   simple_counting_scope* scope_;
 };
@@ -160,6 +194,17 @@ inline simple_counting_scope::token simple_counting_scope::get_token() noexcept
   return token{*this};
 }
 
+// simple_counting_scope with `Slots` spawn slots of `SlotSize` bytes stored in the scope itself,
+// so spawning into it never allocates while a slot is free and the operation fits one
+template <std::size_t Slots, std::size_t SlotSize = 256>
+class bounded_counting_scope
+    : private inline_spawn_slab<Slots, SlotSize>,  // Constructed before the scope base
+      public simple_counting_scope {
+ public:
+  bounded_counting_scope() noexcept
+      : simple_counting_scope(inline_spawn_slab<Slots, SlotSize>::pool()) {}
+};
+
 // [exec.counting.scope], counting_scope
 class counting_scope {
  public:
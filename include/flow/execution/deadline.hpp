@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "env.hpp"
+#include "queries.hpp"
+#include "receiver.hpp"
+#include "sender.hpp"
+
+namespace flow::execution {
+
+// [exec.adaptors.with_deadline], attach a deadline to a sender's environment
+//
+//   handle(req) | with_deadline(clock::now() + 50ms)
+//
+// Every operation inside `handle(req)` sees the deadline through get_deadline(get_env(r)); the
+// adaptors forward their receiver's environment, so it reaches the schedulers the work runs on
+// the same way a stop token does. A nested with_deadline can only tighten an outer deadline.
+// Schedulers that shed load (work_stealing_scheduler) complete work that is still queued when
+// its deadline passes with set_stopped instead of running it.
+
+namespace _deadline_detail {
+
+template <class Rcvr>
+struct _deadline_receiver {
+  using receiver_concept = receiver_t;
+
+  Rcvr                       receiver_;
+  get_deadline_t::time_point deadline_;
+
+  template <class... Args>
+  void set_value(Args&&... args) && noexcept {
+    std::move(receiver_).set_value(std::forward<Args>(args)...);
+  }
+
+  template <class E>
+  void set_error(E&& e) && noexcept {
+    std::move(receiver_).set_error(std::forward<E>(e));
+  }
+
+  void set_stopped() && noexcept {
+    std::move(receiver_).set_stopped();
+  }
+
+  auto get_env() const noexcept {
+    auto env = flow::execution::get_env(receiver_);
+    return make_env_with_deadline(std::min(deadline_, get_deadline(env)), std::move(env));
+  }
+};
+
+}  // namespace _deadline_detail
+
+template <sender S>
+struct _with_deadline_sender {
+  using sender_concept = sender_t;
+  using value_types    = typename S::value_types;
+
+  S                          sender_;
+  get_deadline_t::time_point deadline_;
+
+  template <class Env>
+  auto get_completion_signatures(Env&& env) const {
+    return sender_.get_completion_signatures(std::forward<Env>(env));
+  }
+
+  template <receiver R>
+  auto connect(R&& r) && {
+    return std::move(sender_).connect(
+        _deadline_detail::_deadline_receiver<__decay_t<R>>{std::forward<R>(r), deadline_});
+  }
+
+  template <receiver R>
+  auto connect(R&& r) & {
+    return sender_.connect(
+        _deadline_detail::_deadline_receiver<__decay_t<R>>{std::forward<R>(r), deadline_});
+  }
+};
+
+struct _pipeable_with_deadline {
+  get_deadline_t::time_point deadline_;
+
+  template <sender S>
+  friend auto operator|(S&& s, const _pipeable_with_deadline& p) {
+    return _with_deadline_sender<__decay_t<S>>{std::forward<S>(s), p.deadline_};
+  }
+};
+
+struct with_deadline_t {
+  template <sender S>
+  constexpr auto operator()(S&& s, get_deadline_t::time_point deadline) const {
+    return _with_deadline_sender<__decay_t<S>>{std::forward<S>(s), deadline};
+  }
+
+  // Curried call for pipe syntax
+  constexpr auto operator()(get_deadline_t::time_point deadline) const {
+    return _pipeable_with_deadline{deadline};
+  }
+};
+
+inline constexpr with_deadline_t with_deadline{};
+
+}  // namespace flow::execution
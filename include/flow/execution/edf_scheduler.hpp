@@ -0,0 +1,431 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../detail/mutex.hpp"
+#include "completion_signatures.hpp"
+#include "env.hpp"
+#include "histogram.hpp"
+#include "operation_state.hpp"
+#include "queries.hpp"
+#include "receiver.hpp"
+#include "scheduler.hpp"
+#include "sender.hpp"
+#include "stop_token.hpp"
+#include "trace.hpp"
+#include "type_list.hpp"
+
+namespace flow::execution {
+
+// Earliest-deadline-first scheduler
+//
+// edf_scheduler runs the operation with the earliest deadline first:
+//
+//   edf_scheduler edf(4);
+//   auto sched = edf.get_scheduler();
+//   schedule_by(sched, clock::now() + 2ms) | then(handle_request)
+//   read_request() | transfer(sched.at(deadline)) | then(handle_request)
+//
+// Each worker owns a binary min-heap of pending operations ordered by (deadline, submission
+// order); the operation state is the heap node, so scheduling allocates nothing beyond heap
+// growth. Workers publish the deadline at the top of their heap in an atomic. Before taking its
+// own top a worker scans the published deadlines and, if a peer's is earlier, steals that
+// peer's top instead, so across the pool the earliest pending operation runs next (up to the
+// races of the scan). Work scheduled from a worker goes to that worker's heap, other work is
+// spread round robin. schedule() without a deadline queues behind every deadline, in FIFO order.
+//
+// An operation that starts after its deadline counts as a deadline miss, and how late it
+// started is recorded in a histogram (stats()). An operation whose stop token fired while it
+// was queued completes with set_stopped instead of running.
+
+struct edf_scheduler_stats {
+  std::uint64_t      executed{0};         // Operations completed by the workers
+  std::uint64_t      deadline_misses{0};  // Operations that started after their deadline
+  std::uint64_t      steals{0};           // Operations taken from a peer's heap
+  histogram_snapshot lateness;            // Start time minus deadline of the missed ones
+};
+
+struct schedule_by_t;
+
+class edf_scheduler {
+ public:
+  using clock      = std::chrono::steady_clock;
+  using time_point = clock::time_point;
+  using duration   = clock::duration;
+
+  // Deadline of work scheduled without one: after every real deadline
+  static constexpr time_point no_deadline = time_point::max() - duration{1};
+
+ private:
+  // Intrusive heap node of a queued operation; `run(node)` completes it
+  struct edf_node {
+    void (*run)(edf_node*) noexcept;
+    time_point    deadline{no_deadline};
+    std::uint64_t sequence{0};
+  };
+
+  // Published deadline of an empty heap
+  static constexpr duration::rep empty_heap = time_point::max().time_since_epoch().count();
+
+  struct alignas(64) worker {
+    detail::mutex              mutex{"edf_scheduler::worker"};
+    std::vector<edf_node*>     heap;
+    std::uint64_t              next_sequence{0};
+    std::atomic<duration::rep> earliest{empty_heap};  // Deadline at the top of `heap`
+    std::atomic<std::uint64_t> executed{0};
+    std::atomic<std::uint64_t> misses{0};
+    std::atomic<std::uint64_t> steals{0};
+  };
+
+ public:
+  explicit edf_scheduler(std::size_t num_threads = std::thread::hardware_concurrency()) {
+    if (num_threads == 0) {
+      throw std::invalid_argument("Number of threads must be greater than 0");
+    }
+    workers_.reserve(num_threads);
+    for (std::size_t i = 0; i < num_threads; ++i) {
+      workers_.push_back(std::make_unique<worker>());
+      workers_.back()->heap.reserve(initial_heap_capacity);
+    }
+    threads_.reserve(num_threads);
+    for (std::size_t i = 0; i < num_threads; ++i) {
+      threads_.emplace_back([this, i] { run(i); });
+    }
+  }
+
+  // Queued operations still run: the workers drain every heap before they exit
+  ~edf_scheduler() {
+    {
+      std::scoped_lock lock(sleep_mutex_);
+      stop_.store(true, std::memory_order_relaxed);
+    }
+    sleep_cv_.notify_all();
+    for (auto& t : threads_) {
+      t.join();
+    }
+  }
+
+  edf_scheduler(const edf_scheduler&)                    = delete;
+  auto operator=(const edf_scheduler&) -> edf_scheduler& = delete;
+
+  class edf_scheduler_handle {
+   public:
+    using scheduler_concept = scheduler_t;
+
+    explicit edf_scheduler_handle(edf_scheduler* sched,
+                                  time_point     deadline = no_deadline) noexcept
+        : sched_(sched), deadline_(deadline) {}
+
+    // Runs after the operations with earlier deadlines; without one (get_scheduler()), after
+    // all of them
+    [[nodiscard]] auto schedule() const noexcept {
+      return _edf_sender{sched_, deadline_};
+    }
+
+    [[nodiscard]] auto schedule_by(time_point deadline) const noexcept {
+      return _edf_sender{sched_, deadline};
+    }
+
+    // Scheduler whose schedule() uses `deadline`, for adaptors that take a scheduler
+    [[nodiscard]] auto at(time_point deadline) const noexcept -> edf_scheduler_handle {
+      return edf_scheduler_handle{sched_, deadline};
+    }
+
+    [[nodiscard]] auto deadline() const noexcept -> time_point {
+      return deadline_;
+    }
+
+    [[nodiscard]] static auto now() noexcept -> time_point {
+      return clock::now();
+    }
+
+    [[nodiscard]] static auto query(get_forward_progress_guarantee_t /*unused*/) noexcept {
+      return forward_progress_guarantee::parallel;
+    }
+
+    [[nodiscard]] auto query(get_parallelism_t /*unused*/) const noexcept -> std::size_t {
+      return sched_->workers_.size();
+    }
+
+    auto operator==(const edf_scheduler_handle& other) const noexcept -> bool = default;
+
+   private:
+    edf_scheduler* sched_;
+    time_point     deadline_;
+  };
+
+  auto get_scheduler() noexcept -> edf_scheduler_handle {
+    return edf_scheduler_handle{this};
+  }
+
+  [[nodiscard]] auto stats() const -> edf_scheduler_stats {
+    edf_scheduler_stats s;
+    for (const auto& w : workers_) {
+      s.executed        += w->executed.load(std::memory_order_relaxed);
+      s.deadline_misses += w->misses.load(std::memory_order_relaxed);
+      s.steals          += w->steals.load(std::memory_order_relaxed);
+    }
+    s.lateness = lateness_.snapshot();
+    return s;
+  }
+
+ private:
+  template <class Rcvr>
+  class _edf_operation : edf_node {
+   public:
+    using operation_state_concept = operation_state_t;
+
+    template <class R>
+    _edf_operation(edf_scheduler* sched, time_point deadline, R&& r)
+        : edf_node{.run = &on_run, .deadline = deadline},
+          sched_(sched),
+          receiver_(std::forward<R>(r)) {}
+
+    _edf_operation(const _edf_operation&)                    = delete;
+    auto operator=(const _edf_operation&) -> _edf_operation& = delete;
+
+    void start() & noexcept {
+      try {
+        sched_->submit(this);
+      } catch (...) {
+        std::move(receiver_).set_error(std::current_exception());
+      }
+    }
+
+   private:
+    static void on_run(edf_node* node) noexcept {
+      auto* self = static_cast<_edf_operation*>(node);
+      if (get_stop_token(get_env(self->receiver_)).stop_requested()) {
+        std::move(self->receiver_).set_stopped();
+      } else {
+        std::move(self->receiver_).set_value();
+      }
+    }
+
+    edf_scheduler* sched_;
+    Rcvr           receiver_;
+  };
+
+  struct _edf_sender {
+    using sender_concept = sender_t;
+    using value_types    = type_list<>;  // schedule() sends no values
+
+    edf_scheduler* sched_;
+    time_point     deadline_;
+
+    template <class Env>
+    auto get_completion_signatures(Env&& /*unused*/) const noexcept {
+      return completion_signatures<set_value_t(), set_error_t(std::exception_ptr),
+                                   set_stopped_t()>{};
+    }
+
+    template <receiver R>
+    auto connect(R&& r) const {
+      return _edf_operation<__decay_t<R>>{sched_, deadline_, std::forward<R>(r)};
+    }
+
+    [[nodiscard]] auto query(get_completion_scheduler_t<set_value_t> /*unused*/) const noexcept {
+      return edf_scheduler_handle{sched_, deadline_};
+    }
+  };
+
+  // Worker the calling thread belongs to, if it is one of ours
+  struct worker_identity {
+    const edf_scheduler* owner{nullptr};
+    std::size_t          index{0};
+  };
+
+  static auto this_worker() noexcept -> worker_identity& {
+    thread_local worker_identity identity;
+    return identity;
+  }
+
+  void submit(edf_node* node) {
+    const auto& self   = this_worker();
+    std::size_t target = self.owner == this
+                           ? self.index
+                           : next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+    worker& w = *workers_[target];
+    {
+      std::scoped_lock lock(w.mutex);
+      node->sequence = w.next_sequence++;
+      w.heap.push_back(node);
+      sift_up(w.heap, w.heap.size() - 1);
+      // Sequentially consistent so that a worker going to sleep either sees this heap's
+      // deadline or is seen in sleepers_ below
+      w.earliest.store(w.heap.front()->deadline.time_since_epoch().count(),
+                       std::memory_order_seq_cst);
+    }
+    FLOW_TRACE_EVENT(enqueue, edf_scheduler, reinterpret_cast<std::uintptr_t>(node));
+
+    if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+      { std::scoped_lock lock(sleep_mutex_); }
+      sleep_cv_.notify_one();
+    }
+  }
+
+  // Top of `w`'s heap, or nullptr when it is empty
+  static auto pop(worker& w) -> edf_node* {
+    std::scoped_lock lock(w.mutex);
+    if (w.heap.empty()) {
+      return nullptr;
+    }
+    edf_node* node = w.heap.front();
+    w.heap.front() = w.heap.back();
+    w.heap.pop_back();
+    if (!w.heap.empty()) {
+      sift_down(w.heap, 0);
+    }
+    w.earliest.store(w.heap.empty() ? empty_heap
+                                    : w.heap.front()->deadline.time_since_epoch().count(),
+                     std::memory_order_relaxed);
+    return node;
+  }
+
+  // The earliest operation this worker can see: a peer's top if its deadline is earlier than
+  // ours, else our own
+  auto take(std::size_t self) -> edf_node* {
+    worker&       me     = *workers_[self];
+    duration::rep best   = me.earliest.load(std::memory_order_relaxed);
+    std::size_t   victim = self;
+    for (std::size_t i = 0; i < workers_.size(); ++i) {
+      const duration::rep deadline = workers_[i]->earliest.load(std::memory_order_relaxed);
+      if (i != self && deadline < best) {
+        best   = deadline;
+        victim = i;
+      }
+    }
+    if (victim != self) {
+      if (edf_node* node = pop(*workers_[victim])) {
+        me.steals.fetch_add(1, std::memory_order_relaxed);
+        FLOW_TRACE_EVENT(steal, edf_scheduler, reinterpret_cast<std::uintptr_t>(node));
+        return node;
+      }
+    }
+    return pop(me);
+  }
+
+  auto has_work() const noexcept -> bool {
+    for (const auto& w : workers_) {
+      if (w->earliest.load(std::memory_order_seq_cst) != empty_heap) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void execute(worker& w, edf_node* node) noexcept {
+    if (node->deadline != no_deadline) {
+      const time_point now = clock::now();
+      if (now > node->deadline) {
+        w.misses.fetch_add(1, std::memory_order_relaxed);
+        lateness_.record(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - node->deadline).count()));
+      }
+    }
+    // Counted before running so that observers woken by the operation see it
+    w.executed.fetch_add(1, std::memory_order_relaxed);
+    FLOW_TRACE_EVENT(start, edf_scheduler, reinterpret_cast<std::uintptr_t>(node));
+    node->run(node);
+    FLOW_TRACE_EVENT(finish, edf_scheduler, reinterpret_cast<std::uintptr_t>(node));
+  }
+
+  void run(std::size_t self) {
+    FLOW_TRACE_THREAD_NAME("edf_scheduler worker " + std::to_string(self));
+    this_worker() = {.owner = this, .index = self};
+
+    worker& me = *workers_[self];
+    while (true) {
+      if (edf_node* node = take(self)) {
+        execute(me, node);
+        continue;
+      }
+
+      detail::unique_lock lock(sleep_mutex_);
+      sleepers_.fetch_add(1, std::memory_order_seq_cst);
+      const bool idle = !has_work();
+      if (idle && stop_.load(std::memory_order_relaxed)) {
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        break;
+      }
+      if (idle) {
+        FLOW_TRACE_EVENT(park, edf_scheduler, self);
+        sleep_cv_.wait(lock);
+        FLOW_TRACE_EVENT(unpark, edf_scheduler, self);
+      }
+      sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    this_worker() = {};
+  }
+
+  static auto earlier(const edf_node* a, const edf_node* b) noexcept -> bool {
+    return a->deadline < b->deadline || (a->deadline == b->deadline && a->sequence < b->sequence);
+  }
+
+  static void sift_up(std::vector<edf_node*>& heap, std::size_t index) noexcept {
+    edf_node* node = heap[index];
+    while (index > 0) {
+      const std::size_t parent = (index - 1) / 2;
+      if (!earlier(node, heap[parent])) {
+        break;
+      }
+      heap[index] = heap[parent];
+      index       = parent;
+    }
+    heap[index] = node;
+  }
+
+  static void sift_down(std::vector<edf_node*>& heap, std::size_t index) noexcept {
+    edf_node*         node = heap[index];
+    const std::size_t size = heap.size();
+    while (true) {
+      std::size_t child = (2 * index) + 1;
+      if (child >= size) {
+        break;
+      }
+      if (child + 1 < size && earlier(heap[child + 1], heap[child])) {
+        ++child;
+      }
+      if (!earlier(heap[child], node)) {
+        break;
+      }
+      heap[index] = heap[child];
+      index       = child;
+    }
+    heap[index] = node;
+  }
+
+  static constexpr std::size_t initial_heap_capacity = 256;
+
+  std::vector<std::unique_ptr<worker>> workers_;
+  std::vector<std::thread>             threads_;
+  std::atomic<std::size_t>             next_worker_{0};
+  latency_histogram                    lateness_;
+
+  detail::mutex              sleep_mutex_{"edf_scheduler::sleep"};
+  detail::condition_variable sleep_cv_;
+  std::atomic<int>           sleepers_{0};
+  std::atomic<bool>          stop_{false};
+};
+
+struct schedule_by_t {
+  template <class Sched, class TimePoint>
+    requires requires(const Sched& sched, TimePoint t) { sched.schedule_by(t); }
+  auto operator()(const Sched& sched, TimePoint deadline) const noexcept {
+    return sched.schedule_by(deadline);
+  }
+};
+
+inline constexpr schedule_by_t schedule_by{};
+
+}  // namespace flow::execution
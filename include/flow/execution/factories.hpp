@@ -1,6 +1,7 @@
 #pragma once
 
 #include <tuple>
+#include <type_traits>
 #include <utility>
 
 #include "completion_signatures.hpp"
@@ -46,15 +47,19 @@ struct _just_sender {
     return completion_signatures<set_value_t(Vs...)>{};
   }
 
+  // Noexcept when the values and the receiver can be stored without throwing, so that a
+  // let adaptor returning just(...) needs no exception handler
   template <class R>
     requires receiver<R>
-  auto connect(R&& r) && {
+  auto connect(R&& r) && noexcept(
+      std::is_nothrow_constructible_v<_just_operation<R, Vs...>, std::tuple<Vs...>, R>) {
     return _just_operation<R, Vs...>{std::move(values_), std::forward<R>(r)};
   }
 
   template <class R>
     requires receiver<R>
-  auto connect(R&& r) & {
+  auto connect(R&& r) & noexcept(
+      std::is_nothrow_constructible_v<_just_operation<R, Vs...>, const std::tuple<Vs...>&, R>) {
     return _just_operation<R, Vs...>{values_, std::forward<R>(r)};
   }
 
@@ -66,10 +71,14 @@ struct _just_sender {
     std::tuple<Ts...> values_;
     R                 receiver_;
 
-    _just_operation(std::tuple<Ts...>&& vals, R&& r)
+    _just_operation(std::tuple<Ts...>&& vals, R&& r) noexcept(
+        std::is_nothrow_move_constructible_v<std::tuple<Ts...>>
+        && std::is_nothrow_constructible_v<R, R&&>)
         : values_(std::move(vals)), receiver_(std::move(r)) {}
 
-    _just_operation(const std::tuple<Ts...>& vals, R&& r)
+    _just_operation(const std::tuple<Ts...>& vals, R&& r) noexcept(
+        std::is_nothrow_copy_constructible_v<std::tuple<Ts...>>
+        && std::is_nothrow_constructible_v<R, R&&>)
         : values_(vals), receiver_(std::move(r)) {}
 
     void start() & noexcept {
@@ -114,13 +123,15 @@ struct _just_error_sender {
 
   template <class R>
     requires receiver<R>
-  auto connect(R&& r) && {
+  auto connect(R&& r) && noexcept(
+      std::is_nothrow_constructible_v<_just_error_operation<R, E>, E, R>) {
     return _just_error_operation<R, E>{std::move(error_), std::forward<R>(r)};
   }
 
   template <class R>
     requires receiver<R>
-  auto connect(R&& r) & {
+  auto connect(R&& r) & noexcept(
+      std::is_nothrow_constructible_v<_just_error_operation<R, E>, E&, R>) {
     return _just_error_operation<R, E>{error_, std::forward<R>(r)};
   }
 
@@ -132,7 +143,9 @@ struct _just_error_sender {
     Err error_;
     R   receiver_;
 
-    _just_error_operation(Err&& e, R&& r) : error_(std::move(e)), receiver_(std::move(r)) {}
+    _just_error_operation(Err&& e, R&& r) noexcept(
+        std::is_nothrow_move_constructible_v<Err> && std::is_nothrow_constructible_v<R, R&&>)
+        : error_(std::move(e)), receiver_(std::move(r)) {}
 
     void start() & noexcept {
       std::move(receiver_).set_error(std::move(error_));
@@ -161,13 +174,13 @@ struct _just_stopped_sender {
 
   template <class R>
     requires receiver<R>
-  auto connect(R&& r) && {
+  auto connect(R&& r) && noexcept(std::is_nothrow_constructible_v<_just_stopped_operation<R>, R>) {
     return _just_stopped_operation<R>{std::forward<R>(r)};
   }
 
   template <class R>
     requires receiver<R>
-  auto connect(R&& r) & {
+  auto connect(R&& r) & noexcept(std::is_nothrow_constructible_v<_just_stopped_operation<R>, R>) {
     return _just_stopped_operation<R>{std::forward<R>(r)};
   }
 
@@ -178,7 +191,8 @@ struct _just_stopped_sender {
 
     R receiver_;
 
-    explicit _just_stopped_operation(R&& r) : receiver_(std::move(r)) {}
+    explicit _just_stopped_operation(R&& r) noexcept(std::is_nothrow_constructible_v<R, R&&>)
+        : receiver_(std::move(r)) {}
 
     void start() & noexcept {
       std::move(receiver_).set_stopped();
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace flow::execution {
+
+// Latency histograms shared by the instrumentation facilities (instrument.hpp, lock profiling)
+
+struct histogram_snapshot {
+  std::uint64_t              count{0};
+  std::uint64_t              sum_ns{0};
+  std::uint64_t              max_ns{0};
+  std::vector<std::uint64_t> buckets;
+
+  [[nodiscard]] auto mean() const noexcept -> double {
+    return count == 0 ? 0.0 : static_cast<double>(sum_ns) / static_cast<double>(count);
+  }
+
+  // Upper bound of the bucket holding the q-quantile, q in [0, 1]
+  [[nodiscard]] auto percentile(double q) const noexcept -> std::uint64_t;
+};
+
+// Log-linear latency histogram: 8 sub-buckets per power of two (~12% relative error)
+class latency_histogram {
+ public:
+  static constexpr std::size_t sub_bucket_bits = 3;
+  static constexpr std::size_t sub_buckets     = std::size_t{1} << sub_bucket_bits;
+  static constexpr std::size_t max_exponent    = 47;  // ~39 hours in nanoseconds
+  static constexpr std::size_t bucket_count =
+      sub_buckets + (max_exponent - sub_bucket_bits + 1) * sub_buckets;
+  static constexpr std::size_t shard_count = 8;
+
+  static constexpr auto bucket_index(std::uint64_t ns) noexcept -> std::size_t {
+    if (ns < sub_buckets) {
+      return static_cast<std::size_t>(ns);
+    }
+    auto exponent = static_cast<std::size_t>(std::bit_width(ns)) - 1;
+    if (exponent > max_exponent) {
+      return bucket_count - 1;
+    }
+    auto sub = static_cast<std::size_t>(ns >> (exponent - sub_bucket_bits)) & (sub_buckets - 1);
+    return sub_buckets + (exponent - sub_bucket_bits) * sub_buckets + sub;
+  }
+
+  // Largest value that maps to the given bucket
+  static constexpr auto bucket_upper_bound(std::size_t index) noexcept -> std::uint64_t {
+    if (index < sub_buckets) {
+      return index;
+    }
+    auto exponent = (index - sub_buckets) / sub_buckets + sub_bucket_bits;
+    auto sub      = (index - sub_buckets) % sub_buckets;
+    auto width    = std::uint64_t{1} << (exponent - sub_bucket_bits);
+    return ((sub_buckets + sub) * width) + width - 1;
+  }
+
+  void record(std::uint64_t ns) noexcept {
+    auto& s = shards_[shard_of_this_thread()];
+    s.buckets[bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+    s.count.fetch_add(1, std::memory_order_relaxed);
+    s.sum.fetch_add(ns, std::memory_order_relaxed);
+    auto prev = s.max.load(std::memory_order_relaxed);
+    while (prev < ns && !s.max.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+    }
+  }
+
+  [[nodiscard]] auto snapshot() const -> histogram_snapshot {
+    histogram_snapshot snap;
+    snap.buckets.assign(bucket_count, 0);
+    for (const auto& s : shards_) {
+      for (std::size_t i = 0; i < bucket_count; ++i) {
+        snap.buckets[i] += s.buckets[i].load(std::memory_order_relaxed);
+      }
+      snap.count  += s.count.load(std::memory_order_relaxed);
+      snap.sum_ns += s.sum.load(std::memory_order_relaxed);
+      snap.max_ns  = std::max(snap.max_ns, s.max.load(std::memory_order_relaxed));
+    }
+    return snap;
+  }
+
+  void reset() noexcept {
+    for (auto& s : shards_) {
+      for (auto& b : s.buckets) {
+        b.store(0, std::memory_order_relaxed);
+      }
+      s.count.store(0, std::memory_order_relaxed);
+      s.sum.store(0, std::memory_order_relaxed);
+      s.max.store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  struct alignas(64) shard {
+    std::array<std::atomic<std::uint64_t>, bucket_count> buckets{};
+    std::atomic<std::uint64_t>                           count{0};
+    std::atomic<std::uint64_t>                           sum{0};
+    std::atomic<std::uint64_t>                           max{0};
+  };
+
+  static auto shard_of_this_thread() noexcept -> std::size_t {
+    static std::atomic<std::size_t> next_shard{0};
+    thread_local const std::size_t  shard =
+        next_shard.fetch_add(1, std::memory_order_relaxed) % shard_count;
+    return shard;
+  }
+
+  std::array<shard, shard_count> shards_{};
+};
+
+inline auto histogram_snapshot::percentile(double q) const noexcept -> std::uint64_t {
+  if (count == 0) {
+    return 0;
+  }
+  q         = std::clamp(q, 0.0, 1.0);
+  auto rank = static_cast<std::uint64_t>(q * static_cast<double>(count) + 0.5);
+  rank      = std::clamp<std::uint64_t>(rank, 1, count);
+
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      return std::min(latency_histogram::bucket_upper_bound(i), max_ns);
+    }
+  }
+  return max_ns;
+}
+
+}  // namespace flow::execution
@@ -0,0 +1,575 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "env.hpp"
+#include "histogram.hpp"
+#include "operation_state.hpp"
+#include "receiver.hpp"
+#include "sender.hpp"
+#include "utils.hpp"
+
+namespace flow::execution {
+
+// Per-stage timing instrumentation
+//
+// instrument("name") wraps a sender and records, for every run, the time from start() to each
+// completion into the histogram of the matching channel (value, error or stopped). Histograms
+// live in a named instrument_registry. Recording is lock-free: every histogram is split into
+// per-thread shards of relaxed atomic counters, merged only when a snapshot is taken.
+//
+// instrument_stages("name") is the environment-driven variant: it publishes a stage_tracer
+// through the receiver environment, and every adaptor in the chain (then, upon_*, let_*, bulk*,
+// transfer) marks the point where a completion reaches it. The time between two consecutive
+// marks is attributed to the earlier stage, so a stage's histogram is the latency it added to
+// the pipeline. Adaptors only look for the tracer when the environment type provides it, so
+// chains without it compile to exactly what they were before. Operations that run concurrently
+// with each other (when_all and when_any children, parallel bulk helpers) get an environment
+// without the tracer: its marks assume a single sequential chain.
+
+enum class stage_completion : std::uint8_t { value, error, stopped };
+
+// Metrics for one named stage
+struct stage_metrics {
+  explicit stage_metrics(std::string_view stage_name) : name(stage_name) {}
+
+  void record(stage_completion kind, std::uint64_t ns) noexcept {
+    switch (kind) {
+      case stage_completion::value:
+        value.record(ns);
+        break;
+      case stage_completion::error:
+        error.record(ns);
+        break;
+      case stage_completion::stopped:
+        stopped.record(ns);
+        break;
+    }
+  }
+
+  const std::string          name;
+  std::atomic<std::uint64_t> started{0};
+  latency_histogram          value;
+  latency_histogram          error;
+  latency_histogram          stopped;
+  stage_metrics*             next{nullptr};
+};
+
+struct stage_snapshot {
+  std::string        name;
+  std::uint64_t      started{0};
+  histogram_snapshot value;
+  histogram_snapshot error;
+  histogram_snapshot stopped;
+};
+
+// Registry of named stages; lookups and insertions never block
+class instrument_registry {
+ public:
+  instrument_registry() = default;
+
+  instrument_registry(const instrument_registry&)                    = delete;
+  auto operator=(const instrument_registry&) -> instrument_registry& = delete;
+
+  ~instrument_registry() {
+    auto* s = head_.load(std::memory_order_acquire);
+    while (s != nullptr) {
+      auto* next = s->next;
+      delete s;  // NOLINT(cppcoreguidelines-owning-memory)
+      s = next;
+    }
+  }
+
+  // Process-wide registry used when none is given explicitly
+  static auto global() noexcept -> instrument_registry& {
+    static instrument_registry registry;
+    return registry;
+  }
+
+  // Find or create the stage with the given name
+  auto stage(std::string_view name) -> stage_metrics& {
+    auto* head = head_.load(std::memory_order_acquire);
+    if (auto* found = find(head, nullptr, name)) {
+      return *found;
+    }
+
+    auto node = std::make_unique<stage_metrics>(name);
+    while (true) {
+      node->next = head;
+      if (head_.compare_exchange_weak(head, node.get(), std::memory_order_acq_rel,
+                                      std::memory_order_acquire)) {
+        return *node.release();
+      }
+      // Lost the race: only the nodes pushed since our last look can hold the name
+      if (auto* found = find(head, node->next, name)) {
+        return *found;
+      }
+    }
+  }
+
+  [[nodiscard]] auto snapshot() const -> std::vector<stage_snapshot> {
+    std::vector<stage_snapshot> stages;
+    for (auto* s = head_.load(std::memory_order_acquire); s != nullptr; s = s->next) {
+      stages.push_back(snapshot_of(*s));
+    }
+    std::ranges::sort(stages, {}, &stage_snapshot::name);
+    return stages;
+  }
+
+  [[nodiscard]] auto snapshot(std::string_view name) const -> std::optional<stage_snapshot> {
+    if (auto* s = find(head_.load(std::memory_order_acquire), nullptr, name)) {
+      return snapshot_of(*s);
+    }
+    return std::nullopt;
+  }
+
+  // Zero every stage; stages themselves stay registered
+  void reset() noexcept {
+    for (auto* s = head_.load(std::memory_order_acquire); s != nullptr; s = s->next) {
+      s->started.store(0, std::memory_order_relaxed);
+      s->value.reset();
+      s->error.reset();
+      s->stopped.reset();
+    }
+  }
+
+ private:
+  static auto find(stage_metrics* from, const stage_metrics* until, std::string_view name) noexcept
+      -> stage_metrics* {
+    for (auto* s = from; s != until; s = s->next) {
+      if (s->name == name) {
+        return s;
+      }
+    }
+    return nullptr;
+  }
+
+  static auto snapshot_of(const stage_metrics& s) -> stage_snapshot {
+    return {.name    = s.name,
+            .started = s.started.load(std::memory_order_relaxed),
+            .value   = s.value.snapshot(),
+            .error   = s.error.snapshot(),
+            .stopped = s.stopped.snapshot()};
+  }
+
+  std::atomic<stage_metrics*> head_{nullptr};
+};
+
+namespace _instrument_detail {
+
+inline auto now_ns() noexcept -> std::uint64_t {
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                        std::chrono::steady_clock::now().time_since_epoch())
+                                        .count());
+}
+
+}  // namespace _instrument_detail
+
+// Stage attribution state for one instrumented operation. Marks are sequenced by the
+// completions of the chain they belong to, so no synchronization is needed here.
+class stage_tracer {
+ public:
+  explicit stage_tracer(std::string_view prefix,
+                        instrument_registry& registry = instrument_registry::global())
+      : registry_(&registry), prefix_(prefix) {}
+
+  stage_tracer(const stage_tracer&)                    = delete;
+  auto operator=(const stage_tracer&) -> stage_tracer& = delete;
+
+  // The wrapped sender is being started
+  void begin() {
+    index_   = 0;
+    current_ = nullptr;
+    enter("source", _instrument_detail::now_ns());
+  }
+
+  // A completion of kind `kind` has reached `adaptor`
+  void mark(std::string_view adaptor, stage_completion kind) {
+    const auto now = _instrument_detail::now_ns();
+    close(kind, now);
+    enter(adaptor, now);
+  }
+
+  // The chain has delivered its final completion
+  void end(stage_completion kind) {
+    close(kind, _instrument_detail::now_ns());
+    current_ = nullptr;
+  }
+
+ private:
+  void close(stage_completion kind, std::uint64_t now) noexcept {
+    if (current_ != nullptr) {
+      current_->record(kind, now - since_);
+    }
+  }
+
+  void enter(std::string_view adaptor, std::uint64_t now) {
+    // "<prefix>/<position>:<adaptor>", built without allocating
+    std::array<char, 128> buf{};
+    auto*                 out  = buf.data();
+    auto*                 last = buf.data() + buf.size();
+    auto                  put  = [&](std::string_view s) {
+      auto n = std::min(s.size(), static_cast<std::size_t>(last - out));
+      out    = std::copy_n(s.data(), n, out);
+    };
+    put(prefix_);
+    put("/");
+    out = std::to_chars(out, last, index_++).ptr;
+    put(":");
+    put(adaptor);
+
+    try {
+      current_ = &registry_->stage({buf.data(), static_cast<std::size_t>(out - buf.data())});
+      current_->started.fetch_add(1, std::memory_order_relaxed);
+    } catch (...) {
+      current_ = nullptr;  // Out of memory: drop this stage's measurement
+    }
+    since_ = now;
+  }
+
+  instrument_registry* registry_;
+  std::string          prefix_;
+  stage_metrics*       current_{nullptr};
+  std::uint64_t        since_{0};
+  std::size_t          index_{0};
+};
+
+// Query for the stage tracer carried by a receiver environment
+struct get_stage_tracer_t {
+  template <class Env>
+  auto operator()(const Env& env) const noexcept -> stage_tracer* {
+    if constexpr (requires { query(env, get_stage_tracer_t{}); }) {
+      return query(env, get_stage_tracer_t{});
+    } else {
+      return nullptr;
+    }
+  }
+};
+
+inline constexpr get_stage_tracer_t get_stage_tracer{};
+
+namespace _instrument_detail {
+
+template <class Rcvr>
+concept _has_stage_tracer =
+    requires(const Rcvr& r) { query(flow::execution::get_env(r), get_stage_tracer_t{}); };
+
+// Called by adaptors when a completion reaches them; free when no tracer can be present
+template <class Rcvr>
+void mark_stage(const Rcvr& rcvr, std::string_view adaptor, stage_completion kind) noexcept {
+  if constexpr (_has_stage_tracer<Rcvr>) {
+    if (auto* tracer = get_stage_tracer(flow::execution::get_env(rcvr))) {
+      try {
+        tracer->mark(adaptor, kind);
+      } catch (...) {
+        // Instrumentation must never change the outcome of the pipeline
+      }
+    }
+  }
+}
+
+// Environment that adds a stage tracer and forwards every other query
+template <class BaseEnv>
+struct _stage_tracer_env {
+  stage_tracer* tracer;
+  BaseEnv       base_env;
+
+  template <class Query>
+    requires std::same_as<Query, get_stage_tracer_t>
+  friend auto query(const _stage_tracer_env& self, Query /*unused*/) noexcept -> stage_tracer* {
+    return self.tracer;
+  }
+
+  template <class Query>
+    requires(!std::same_as<Query, get_stage_tracer_t>)
+            && requires(const BaseEnv& env, Query q) { query(env, q); }
+  friend auto query(const _stage_tracer_env& self,
+                    Query                    q) noexcept(noexcept(query(self.base_env, q)))
+      -> decltype(query(self.base_env, q)) {
+    return query(self.base_env, q);
+  }
+};
+
+// Environment that forwards every query except get_stage_tracer
+template <class BaseEnv>
+struct _untraced_env {
+  BaseEnv base_env;
+
+  template <class Query>
+    requires(!std::same_as<Query, get_stage_tracer_t>)
+            && requires(const BaseEnv& env, Query q) { query(env, q); }
+  friend auto query(const _untraced_env& self,
+                    Query                q) noexcept(noexcept(query(self.base_env, q)))
+      -> decltype(query(self.base_env, q)) {
+    return query(self.base_env, q);
+  }
+};
+
+// Environment for an operation that runs concurrently with its siblings: `env` without the
+// stage tracer, or `env` itself when it has none
+template <class Env>
+auto concurrent_env(Env&& env) {
+  if constexpr (requires { query(env, get_stage_tracer_t{}); }) {
+    return _untraced_env<__decay_t<Env>>{std::forward<Env>(env)};
+  } else {
+    return __decay_t<Env>(std::forward<Env>(env));
+  }
+}
+
+}  // namespace _instrument_detail
+
+// [exec.adaptors.instrument], start-to-completion timing of a sender
+template <sender S>
+struct _instrument_sender {
+  using sender_concept = sender_t;
+  using value_types    = typename S::value_types;
+
+  S              sender_;
+  stage_metrics* stage_;
+
+  template <class Env>
+  auto get_completion_signatures(Env&& env) const {
+    return sender_.get_completion_signatures(std::forward<Env>(env));
+  }
+
+  template <receiver R>
+  auto connect(R&& r) && {
+    return _instrument_operation<S, __remove_cvref_t<R>>{std::move(sender_), stage_,
+                                                         std::forward<R>(r)};
+  }
+
+  template <receiver R>
+  auto connect(R&& r) & {
+    return _instrument_operation<S&, __remove_cvref_t<R>>{sender_, stage_, std::forward<R>(r)};
+  }
+
+ private:
+  template <class Sndr, class Rcvr>
+  struct _instrument_operation {
+    using operation_state_concept = operation_state_t;
+
+    struct _receiver {
+      using receiver_concept = receiver_t;
+
+      _instrument_operation* op_;
+
+      template <class... Args>
+      void set_value(Args&&... args) && noexcept {
+        op_->finish(stage_completion::value);
+        std::move(op_->receiver_).set_value(std::forward<Args>(args)...);
+      }
+
+      template <class E>
+      void set_error(E&& e) && noexcept {
+        op_->finish(stage_completion::error);
+        std::move(op_->receiver_).set_error(std::forward<E>(e));
+      }
+
+      void set_stopped() && noexcept {
+        op_->finish(stage_completion::stopped);
+        std::move(op_->receiver_).set_stopped();
+      }
+
+      auto get_env() const noexcept
+          -> decltype(flow::execution::get_env(std::declval<const Rcvr&>())) {
+        return flow::execution::get_env(op_->receiver_);
+      }
+    };
+
+    using inner_op_t = decltype(std::declval<Sndr>().connect(std::declval<_receiver>()));
+
+    template <class R>
+    _instrument_operation(Sndr sndr, stage_metrics* stage, R&& r)
+        : receiver_(std::forward<R>(r)),
+          stage_(stage),
+          inner_(std::forward<Sndr>(sndr).connect(_receiver{this})) {}
+
+    _instrument_operation(const _instrument_operation&)                    = delete;
+    auto operator=(const _instrument_operation&) -> _instrument_operation& = delete;
+
+    void start() & noexcept {
+      stage_->started.fetch_add(1, std::memory_order_relaxed);
+      start_ns_ = _instrument_detail::now_ns();
+      inner_.start();
+    }
+
+    void finish(stage_completion kind) noexcept {
+      stage_->record(kind, _instrument_detail::now_ns() - start_ns_);
+    }
+
+    Rcvr           receiver_;
+    stage_metrics* stage_;
+    std::uint64_t  start_ns_{0};
+    inner_op_t     inner_;
+  };
+};
+
+// [exec.adaptors.instrument_stages], per-adaptor attribution through the environment
+template <sender S>
+struct _instrument_stages_sender {
+  using sender_concept = sender_t;
+  using value_types    = typename S::value_types;
+
+  S                    sender_;
+  std::string          prefix_;
+  instrument_registry* registry_;
+
+  template <class Env>
+  auto get_completion_signatures(Env&& env) const {
+    return sender_.get_completion_signatures(std::forward<Env>(env));
+  }
+
+  template <receiver R>
+  auto connect(R&& r) && {
+    return _stages_operation<S, __remove_cvref_t<R>>{std::move(sender_), prefix_, *registry_,
+                                                     std::forward<R>(r)};
+  }
+
+  template <receiver R>
+  auto connect(R&& r) & {
+    return _stages_operation<S&, __remove_cvref_t<R>>{sender_, prefix_, *registry_,
+                                                      std::forward<R>(r)};
+  }
+
+ private:
+  template <class Sndr, class Rcvr>
+  struct _stages_operation {
+    using operation_state_concept = operation_state_t;
+
+    struct _receiver {
+      using receiver_concept = receiver_t;
+
+      _stages_operation* op_;
+
+      template <class... Args>
+      void set_value(Args&&... args) && noexcept {
+        op_->finish(stage_completion::value);
+        std::move(op_->receiver_).set_value(std::forward<Args>(args)...);
+      }
+
+      template <class E>
+      void set_error(E&& e) && noexcept {
+        op_->finish(stage_completion::error);
+        std::move(op_->receiver_).set_error(std::forward<E>(e));
+      }
+
+      void set_stopped() && noexcept {
+        op_->finish(stage_completion::stopped);
+        std::move(op_->receiver_).set_stopped();
+      }
+
+      // Return type spelled out: adaptors may ask for it while this operation is incomplete
+      using base_env_t = decltype(flow::execution::get_env(std::declval<const Rcvr&>()));
+
+      auto get_env() const noexcept -> _instrument_detail::_stage_tracer_env<base_env_t> {
+        return _instrument_detail::_stage_tracer_env<base_env_t>{
+            &op_->tracer_, flow::execution::get_env(op_->receiver_)};
+      }
+    };
+
+    using inner_op_t = decltype(std::declval<Sndr>().connect(std::declval<_receiver>()));
+
+    template <class R>
+    _stages_operation(Sndr sndr, std::string_view prefix, instrument_registry& registry, R&& r)
+        : receiver_(std::forward<R>(r)),
+          tracer_(prefix, registry),
+          inner_(std::forward<Sndr>(sndr).connect(_receiver{this})) {}
+
+    _stages_operation(const _stages_operation&)                    = delete;
+    auto operator=(const _stages_operation&) -> _stages_operation& = delete;
+
+    void start() & noexcept {
+      try {
+        tracer_.begin();
+      } catch (...) {
+        // Instrumentation must never change the outcome of the pipeline
+      }
+      inner_.start();
+    }
+
+    void finish(stage_completion kind) noexcept {
+      tracer_.end(kind);
+    }
+
+    Rcvr         receiver_;
+    stage_tracer tracer_;
+    inner_op_t   inner_;
+  };
+};
+
+// Forward declarations for pipeable support
+struct _pipeable_instrument;
+struct _pipeable_instrument_stages;
+
+struct instrument_t {
+  template <sender S>
+  auto operator()(S&& s, std::string_view name,
+                  instrument_registry& registry = instrument_registry::global()) const {
+    return _instrument_sender<__decay_t<S>>{std::forward<S>(s), &registry.stage(name)};
+  }
+
+  auto operator()(std::string_view name,
+                  instrument_registry& registry = instrument_registry::global()) const
+      -> _pipeable_instrument;
+};
+
+struct instrument_stages_t {
+  template <sender S>
+  auto operator()(S&& s, std::string_view prefix,
+                  instrument_registry& registry = instrument_registry::global()) const {
+    return _instrument_stages_sender<__decay_t<S>>{std::forward<S>(s), std::string(prefix),
+                                                   &registry};
+  }
+
+  auto operator()(std::string_view prefix,
+                  instrument_registry& registry = instrument_registry::global()) const
+      -> _pipeable_instrument_stages;
+};
+
+inline constexpr instrument_t        instrument{};
+inline constexpr instrument_stages_t instrument_stages{};
+
+struct _pipeable_instrument {
+  stage_metrics* stage_;
+
+  template <sender S>
+  friend auto operator|(S&& s, const _pipeable_instrument& p) {
+    return _instrument_sender<__decay_t<S>>{std::forward<S>(s), p.stage_};
+  }
+};
+
+struct _pipeable_instrument_stages {
+  std::string          prefix_;
+  instrument_registry* registry_;
+
+  template <sender S>
+  friend auto operator|(S&& s, const _pipeable_instrument_stages& p) {
+    return instrument_stages_t{}(std::forward<S>(s), p.prefix_, *p.registry_);
+  }
+};
+
+inline auto instrument_t::operator()(std::string_view name, instrument_registry& registry) const
+    -> _pipeable_instrument {
+  return _pipeable_instrument{&registry.stage(name)};
+}
+
+inline auto instrument_stages_t::operator()(std::string_view     prefix,
+                                            instrument_registry& registry) const
+    -> _pipeable_instrument_stages {
+  return _pipeable_instrument_stages{std::string(prefix), &registry};
+}
+
+}  // namespace flow::execution
@@ -1,30 +1,81 @@
 #pragma once
 
+#include <cstddef>
 #include <exception>
 #include <functional>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+#include <variant>
 
 #include "completion_signatures.hpp"
+#include "instrument.hpp"
 #include "sender.hpp"
 #include "type_list.hpp"
+#include "utils.hpp"
 
 namespace flow::execution {
 
-// Helper for let_value return type deduction
+// let_value / let_error / let_stopped
+//
+// connect() returns one operation state that owns everything the adaptor needs: the upstream
+// operation, storage for the completion that triggers the function (a variant over the
+// possible argument tuples), and storage for the operation of the sender the function returns
+// (a variant over the possible inner operation types). The inner sender is connected into
+// that storage and started in place, so it may complete asynchronously after the upstream
+// completion has returned, without any heap allocation. The function receives the stored
+// values as rvalues, or as lvalues when it only accepts references; either way they stay
+// alive until the inner operation completes.
 namespace _let_detail {
 
+// Spelled out so that nested receivers can declare get_env() before the operation is complete
+template <class Rcvr>
+using env_of_t = decltype(get_env(std::declval<const Rcvr&>()));
+
+// Invokes `f` with stored arguments: moved out if `f` accepts rvalues, by reference otherwise
+template <class F, class... Ts>
+inline constexpr bool _invoke_by_ref = !std::is_invocable_v<F, Ts...>;
+
+template <class F, class... Ts>
+auto invoke_stored(F&& f, std::tuple<Ts...>& args) -> decltype(auto) {
+  return std::apply(
+      [&f](Ts&... vs) -> decltype(auto) {
+        if constexpr (_invoke_by_ref<F, Ts...>) {
+          return std::invoke(std::forward<F>(f), vs...);
+        } else {
+          return std::invoke(std::forward<F>(f), std::move(vs)...);
+        }
+      },
+      args);
+}
+
+// Sender returned by F for one argument list
+template <class F, class ArgList>
+struct _inner_sender;
+
+template <class F, class... Ts>
+struct _inner_sender<F, type_list<Ts...>> {
+  using type = __decay_t<decltype(invoke_stored(std::declval<F>(),
+                                                std::declval<std::tuple<Ts...>&>()))>;
+};
+
+template <class F, class ArgList>
+using inner_sender_t = typename _inner_sender<F, ArgList>::type;
+
+template <class TypeList>
+struct _decay_list;
+
+template <class... Ts>
+struct _decay_list<type_list<Ts...>> {
+  using type = type_list<__decay_t<Ts>...>;
+};
+
 // Extract the value_types from the sender returned by F
 template <class S, class F>
 struct _deduce_let_value_result {
-  using sender_values = typename S::value_types;
-  // F is invoked with the unpacked values from sender_values
-  // and returns a new sender
-  template <class... Ts>
-  static auto invoke_with(type_list<Ts...>) -> std::invoke_result_t<F, Ts...>;
-
-  using result_sender = decltype(invoke_with(sender_values{}));
-  using type          = typename result_sender::value_types;
+  using type = typename inner_sender_t<F, typename _decay_list<typename S::value_types>::type>::
+      value_types;
 };
 
 template <class S, class F>
@@ -42,6 +93,348 @@ struct _type_list_to_set_value<type_list<Ts...>> {
 template <class TypeList>
 using type_list_to_set_value_t = typename _type_list_to_set_value<TypeList>::type;
 
+template <class List, class T>
+struct _push_unique;
+
+template <class... Ts, class T>
+struct _push_unique<type_list<Ts...>, T> {
+  using type = std::conditional_t<(std::same_as<Ts, T> || ...), type_list<Ts...>,
+                                  type_list<Ts..., T>>;
+};
+
+template <class T, class List>
+struct _index_of;
+
+template <class T, class... Ts>
+struct _index_of<T, type_list<T, Ts...>> : std::integral_constant<std::size_t, 0> {};
+
+template <class T, class U, class... Ts>
+struct _index_of<T, type_list<U, Ts...>>
+    : std::integral_constant<std::size_t, 1 + _index_of<T, type_list<Ts...>>::value> {};
+
+// Error types let_error stores as themselves: exception_ptr (which every other error can be
+// converted to) plus the errors the upstream sender declares and F accepts
+template <class F, class List, class... Sigs>
+struct _collect_errors {
+  using type = List;
+};
+
+template <class F, class List, class E, class... Sigs>
+struct _collect_errors<F, List, set_error_t(E), Sigs...>
+    : _collect_errors<F,
+                      std::conditional_t<std::is_invocable_v<F, __decay_t<E>>
+                                             || std::is_invocable_v<F, __decay_t<E>&>,
+                                         typename _push_unique<List, __decay_t<E>>::type, List>,
+                      Sigs...> {};
+
+template <class F, class List, class Sig, class... Sigs>
+struct _collect_errors<F, List, Sig, Sigs...> : _collect_errors<F, List, Sigs...> {};
+
+template <class F, class Sigs>
+struct _errors_of_sigs {
+  using type = type_list<std::exception_ptr>;
+};
+
+template <class F, class... Sigs>
+struct _errors_of_sigs<F, completion_signatures<Sigs...>>
+    : _collect_errors<F, type_list<std::exception_ptr>, Sigs...> {};
+
+template <class S, class F, class Env>
+struct _error_types {
+  using type = type_list<std::exception_ptr>;
+};
+
+template <class S, class F, class Env>
+  requires sender_in<const S&, Env>
+struct _error_types<S, F, Env>
+    : _errors_of_sigs<F, __decay_t<decltype(std::declval<const S&>().get_completion_signatures(
+                             std::declval<Env>()))>> {};
+
+template <class List>
+struct _single_arg_lists;
+
+template <class... Es>
+struct _single_arg_lists<type_list<Es...>> {
+  using type = type_list<type_list<Es>...>;
+};
+
+// Per-channel description: the stage name and the argument lists the channel can deliver
+template <class Channel>
+struct _channel;
+
+template <>
+struct _channel<set_value_t> {
+  static constexpr std::string_view name = "let_value";
+
+  template <class S, class F, class Env>
+  using arg_lists = type_list<typename _decay_list<typename S::value_types>::type>;
+
+  // Predecessor completions that bypass F
+  template <class S, class Env>
+  using forwarded = __completion_signatures_of_t<S, Env, set_error_t, set_stopped_t>;
+};
+
+template <>
+struct _channel<set_error_t> {
+  static constexpr std::string_view name = "let_error";
+
+  template <class S, class F, class Env>
+  using arg_lists = typename _single_arg_lists<typename _error_types<S, F, Env>::type>::type;
+
+  template <class S, class Env>
+  using forwarded = __completion_signatures_of_t<S, Env, set_value_t, set_stopped_t>;
+};
+
+template <>
+struct _channel<set_stopped_t> {
+  static constexpr std::string_view name = "let_stopped";
+
+  template <class S, class F, class Env>
+  using arg_lists = type_list<type_list<>>;
+
+  template <class S, class Env>
+  using forwarded = __completion_signatures_of_t<S, Env, set_value_t, set_error_t>;
+};
+
+template <class Tag>
+inline constexpr stage_completion completion_kind = std::same_as<Tag, set_value_t>
+                                                        ? stage_completion::value
+                                                    : std::same_as<Tag, set_error_t>
+                                                        ? stage_completion::error
+                                                        : stage_completion::stopped;
+
+template <class Tag, class Rcvr, class... Args>
+void forward_completion(Rcvr& rcvr, Args&&... args) noexcept {
+  if constexpr (std::same_as<Tag, set_value_t>) {
+    std::move(rcvr).set_value(std::forward<Args>(args)...);
+  } else if constexpr (std::same_as<Tag, set_error_t>) {
+    std::move(rcvr).set_error(std::forward<Args>(args)...);
+  } else {
+    std::move(rcvr).set_stopped();
+  }
+}
+
+// Receiver of the inner operation: forwards to the downstream receiver held by the let
+// operation, so the inner operation stays the size of one pointer plus its own state
+template <class Rcvr>
+struct _inner_receiver {
+  using receiver_concept = receiver_t;
+
+  Rcvr* receiver_;
+
+  template <class... Args>
+  void set_value(Args&&... args) && noexcept {
+    std::move(*receiver_).set_value(std::forward<Args>(args)...);
+  }
+
+  template <class E>
+  void set_error(E&& e) && noexcept {
+    std::move(*receiver_).set_error(std::forward<E>(e));
+  }
+
+  void set_stopped() && noexcept {
+    std::move(*receiver_).set_stopped();
+  }
+
+  auto get_env() const noexcept -> env_of_t<Rcvr> {
+    return flow::execution::get_env(*receiver_);
+  }
+};
+
+// Stands in for the downstream receiver where only its environment is known
+template <class Env>
+struct _env_receiver {
+  using receiver_concept = receiver_t;
+
+  template <class... Args>
+  void set_value(Args&&... /*unused*/) && noexcept {}
+
+  template <class E>
+  void set_error(E&& /*unused*/) && noexcept {}
+
+  void set_stopped() && noexcept {}
+
+  auto get_env() const noexcept -> Env;
+};
+
+// Whether storing the arguments, invoking F on them and connecting the sender it returns
+// cannot throw. The let operation then starts F's sender without an exception handler.
+template <class F, class ArgList, class Rcvr>
+inline constexpr bool _nothrow_start = false;
+
+template <class F, class... Ts, class Rcvr>
+inline constexpr bool _nothrow_start<F, type_list<Ts...>, Rcvr> =
+    (std::is_nothrow_move_constructible_v<Ts> && ...)
+    && (_invoke_by_ref<F, Ts...> ? std::is_nothrow_invocable_v<F, Ts&...>
+                                 : std::is_nothrow_invocable_v<F, Ts...>)
+    && noexcept(std::declval<inner_sender_t<F, type_list<Ts...>>>().connect(
+        std::declval<_inner_receiver<Rcvr>>()));
+
+template <class F, class ArgLists, class Rcvr>
+inline constexpr bool _nothrow_starts = false;
+
+template <class F, class... ArgLists, class Rcvr>
+inline constexpr bool _nothrow_starts<F, type_list<ArgLists...>, Rcvr> =
+    (_nothrow_start<F, ArgLists, Rcvr> && ...);
+
+template <class F, class Env, class ArgLists>
+struct _inner_signatures;
+
+template <class F, class Env, class... ArgLists>
+struct _inner_signatures<F, Env, type_list<ArgLists...>> {
+  using type = __concat_completion_signatures_t<__completion_signatures_of_t<
+      inner_sender_t<F, ArgLists>, Env, set_error_t, set_stopped_t>...>;
+};
+
+// Completions of a let adaptor: `ValueSig`, what the predecessor sends on the other channels,
+// the errors and stopped of every sender F may return, and set_error(exception_ptr) unless
+// starting F's sender cannot throw
+template <class Channel, class S, class F, class Env, class ValueSig>
+struct _let_signatures {
+  using arg_lists = typename _channel<Channel>::template arg_lists<S, F, Env>;
+  using type      = __concat_completion_signatures_t<
+      completion_signatures<ValueSig>, typename _channel<Channel>::template forwarded<S, Env>,
+      typename _inner_signatures<F, Env, arg_lists>::type,
+      __exception_signatures_t<!_nothrow_starts<F, arg_lists, _env_receiver<__decay_t<Env>>>>>;
+};
+
+template <class Channel, class S, class F, class Env, class ValueSig>
+using let_signatures_t = typename _let_signatures<Channel, S, F, Env, ValueSig>::type;
+
+// Receiver of the upstream operation: hands every completion to the let operation
+template <class Op, class Rcvr>
+struct _upstream_receiver {
+  using receiver_concept = receiver_t;
+
+  Op* op_;
+
+  template <class... Args>
+  void set_value(Args&&... args) && noexcept {
+    op_->template complete<set_value_t>(std::forward<Args>(args)...);
+  }
+
+  template <class E>
+  void set_error(E&& e) && noexcept {
+    op_->template complete<set_error_t>(std::forward<E>(e));
+  }
+
+  void set_stopped() && noexcept {
+    op_->template complete<set_stopped_t>();
+  }
+
+  auto get_env() const noexcept -> env_of_t<Rcvr> {
+    return flow::execution::get_env(op_->receiver_);
+  }
+};
+
+template <class ArgLists>
+struct _args_variant;
+
+template <class... ArgLists>
+struct _args_variant<type_list<ArgLists...>> {
+  template <class List>
+  struct _tuple;
+
+  template <class... Ts>
+  struct _tuple<type_list<Ts...>> {
+    using type = std::tuple<Ts...>;
+  };
+
+  using type = std::variant<std::monostate, typename _tuple<ArgLists>::type...>;
+};
+
+template <class F, class Rcvr, class ArgLists>
+struct _ops_variant;
+
+template <class F, class Rcvr, class... ArgLists>
+struct _ops_variant<F, Rcvr, type_list<ArgLists...>> {
+  using type = std::variant<std::monostate,
+                            decltype(std::declval<inner_sender_t<F, ArgLists>>().connect(
+                                std::declval<_inner_receiver<Rcvr>>()))...>;
+};
+
+template <class Channel, class Sndr, class Fn, class Rcvr>
+class _let_operation {
+ public:
+  using operation_state_concept = operation_state_t;
+
+  template <class Sndr2, class Fn2, class Rcvr2>
+  _let_operation(Sndr2&& sndr, Fn2&& fn, Rcvr2&& rcvr)
+      : receiver_(std::forward<Rcvr2>(rcvr)),
+        fun_(std::forward<Fn2>(fn)),
+        upstream_(
+            std::forward<Sndr2>(sndr).connect(_upstream_receiver<_let_operation, Rcvr>{this})) {}
+
+  _let_operation(const _let_operation&)                    = delete;
+  auto operator=(const _let_operation&) -> _let_operation& = delete;
+
+  void start() & noexcept {
+    upstream_.start();
+  }
+
+ private:
+  friend struct _upstream_receiver<_let_operation, Rcvr>;
+
+  using arg_lists =
+      typename _channel<Channel>::template arg_lists<__remove_cvref_t<Sndr>, Fn, env_of_t<Rcvr>>;
+  using upstream_op_t = decltype(std::declval<Sndr>().connect(
+      std::declval<_upstream_receiver<_let_operation, Rcvr>>()));
+
+  template <class Tag, class... Args>
+  void complete(Args&&... args) noexcept {
+    _instrument_detail::mark_stage(receiver_, _channel<Channel>::name, completion_kind<Tag>);
+    if constexpr (!std::same_as<Tag, Channel>) {
+      forward_completion<Tag>(receiver_, std::forward<Args>(args)...);
+    } else if constexpr (_nothrow_starts<Fn, arg_lists, Rcvr>
+                         && (std::is_nothrow_constructible_v<__decay_t<Args>, Args> && ...)) {
+      start_channel<Tag>(std::forward<Args>(args)...);
+    } else {
+      try {
+        start_channel<Tag>(std::forward<Args>(args)...);
+      } catch (...) {
+        std::move(receiver_).set_error(std::current_exception());
+      }
+    }
+  }
+
+  template <class Tag, class... Args>
+  void start_channel(Args&&... args) {
+    if constexpr (std::same_as<Tag, set_error_t>) {
+      let_error(std::forward<Args>(args)...);
+    } else {
+      start_inner<0>(std::forward<Args>(args)...);
+    }
+  }
+
+  // Errors F was not declared to take arrive as exception_ptr
+  template <class E>
+  void let_error(E&& e) {
+    using list = typename _error_types<__remove_cvref_t<Sndr>, Fn, env_of_t<Rcvr>>::type;
+    if constexpr (std::is_same_v<typename _push_unique<list, __decay_t<E>>::type, list>) {
+      start_inner<_index_of<__decay_t<E>, list>::value>(std::forward<E>(e));
+    } else {
+      start_inner<_index_of<std::exception_ptr, list>::value>(
+          std::make_exception_ptr(std::forward<E>(e)));
+    }
+  }
+
+  // Stores the arguments in alternative I, then connects and starts F's sender in place
+  template <std::size_t I, class... Args>
+  void start_inner(Args&&... args) {
+    auto& stored = args_.template emplace<I + 1>(std::forward<Args>(args)...);
+    auto& op     = inner_.template emplace<I + 1>(__emplace_from{[&] {
+      return invoke_stored(std::move(fun_), stored).connect(_inner_receiver<Rcvr>{&receiver_});
+    }});
+    op.start();
+  }
+
+  Rcvr                                             receiver_;
+  Fn                                               fun_;
+  typename _args_variant<arg_lists>::type          args_;    // Values F is invoked with
+  typename _ops_variant<Fn, Rcvr, arg_lists>::type inner_;   // Operation of F's sender
+  upstream_op_t                                    upstream_;
+};
+
 }  // namespace _let_detail
 
 // [exec.adaptors.let_value], let_value adaptor
@@ -58,48 +451,20 @@ struct _let_value_sender {
   auto get_completion_signatures(Env&& /*unused*/) const {
     // Convert value_types (type_list) to proper set_value_t signature
     using set_value_sig = _let_detail::type_list_to_set_value_t<value_types>;
-    return completion_signatures<set_value_sig, set_error_t(std::exception_ptr), set_stopped_t()>{};
+    return _let_detail::let_signatures_t<set_value_t, S, F, Env, set_value_sig>{};
   }
 
   template <receiver R>
   auto connect(R&& r) && {
-    return std::move(sender_).connect(
-        _let_value_receiver<F, R>{std::move(fun_), std::forward<R>(r)});
+    return _let_detail::_let_operation<set_value_t, S, F, __decay_t<R>>{
+        std::move(sender_), std::move(fun_), std::forward<R>(r)};
   }
 
   template <receiver R>
   auto connect(R&& r) & {
-    return sender_.connect(_let_value_receiver<F, R>{fun_, std::forward<R>(r)});
+    return _let_detail::_let_operation<set_value_t, S&, F, __decay_t<R>>{
+        sender_, fun_, std::forward<R>(r)};
   }
-
- private:
-  template <class Fn, class Rcvr>
-  struct _let_value_receiver {
-    using receiver_concept = receiver_t;
-
-    Fn   fun_;
-    Rcvr receiver_;
-
-    template <class... Args>
-    void set_value(Args&&... args) && noexcept {
-      try {
-        auto next_sender = std::invoke(std::move(fun_), std::forward<Args>(args)...);
-        auto op          = std::move(next_sender).connect(std::move(receiver_));
-        op.start();
-      } catch (...) {
-        std::move(receiver_).set_error(std::current_exception());
-      }
-    }
-
-    template <class E>
-    void set_error(E&& e) && noexcept {
-      std::move(receiver_).set_error(std::forward<E>(e));
-    }
-
-    void set_stopped() && noexcept {
-      std::move(receiver_).set_stopped();
-    }
-  };
 };
 
 // [exec.adaptors.let_error], let_error adaptor
@@ -117,48 +482,20 @@ struct _let_error_sender {
   auto get_completion_signatures(Env&& /*unused*/) const {
     // Convert value_types (type_list) to proper set_value_t signature
     using set_value_sig = _let_detail::type_list_to_set_value_t<value_types>;
-    return completion_signatures<set_value_sig, set_error_t(std::exception_ptr), set_stopped_t()>{};
+    return _let_detail::let_signatures_t<set_error_t, S, F, Env, set_value_sig>{};
   }
 
   template <receiver R>
   auto connect(R&& r) && {
-    return std::move(sender_).connect(
-        _let_error_receiver<F, R>{std::move(fun_), std::forward<R>(r)});
+    return _let_detail::_let_operation<set_error_t, S, F, __decay_t<R>>{
+        std::move(sender_), std::move(fun_), std::forward<R>(r)};
   }
 
   template <receiver R>
   auto connect(R&& r) & {
-    return sender_.connect(_let_error_receiver<F, R>{fun_, std::forward<R>(r)});
+    return _let_detail::_let_operation<set_error_t, S&, F, __decay_t<R>>{
+        sender_, fun_, std::forward<R>(r)};
   }
-
- private:
-  template <class Fn, class Rcvr>
-  struct _let_error_receiver {
-    using receiver_concept = receiver_t;
-
-    Fn   fun_;
-    Rcvr receiver_;
-
-    template <class... Args>
-    void set_value(Args&&... args) && noexcept {
-      std::move(receiver_).set_value(std::forward<Args>(args)...);
-    }
-
-    template <class E>
-    void set_error(E&& e) && noexcept {
-      try {
-        auto next_sender = std::invoke(std::move(fun_), std::forward<E>(e));
-        auto op          = std::move(next_sender).connect(std::move(receiver_));
-        op.start();
-      } catch (...) {
-        std::move(receiver_).set_error(std::current_exception());
-      }
-    }
-
-    void set_stopped() && noexcept {
-      std::move(receiver_).set_stopped();
-    }
-  };
 };
 
 // [exec.adaptors.let_stopped], let_stopped adaptor
@@ -176,48 +513,20 @@ struct _let_stopped_sender {
   auto get_completion_signatures(Env&& /*unused*/) const {
     // Convert value_types (type_list) to proper set_value_t signature
     using set_value_sig = _let_detail::type_list_to_set_value_t<value_types>;
-    return completion_signatures<set_value_sig, set_error_t(std::exception_ptr), set_stopped_t()>{};
+    return _let_detail::let_signatures_t<set_stopped_t, S, F, Env, set_value_sig>{};
   }
 
   template <receiver R>
   auto connect(R&& r) && {
-    return std::move(sender_).connect(
-        _let_stopped_receiver<F, R>{std::move(fun_), std::forward<R>(r)});
+    return _let_detail::_let_operation<set_stopped_t, S, F, __decay_t<R>>{
+        std::move(sender_), std::move(fun_), std::forward<R>(r)};
   }
 
   template <receiver R>
   auto connect(R&& r) & {
-    return sender_.connect(_let_stopped_receiver<F, R>{fun_, std::forward<R>(r)});
+    return _let_detail::_let_operation<set_stopped_t, S&, F, __decay_t<R>>{
+        sender_, fun_, std::forward<R>(r)};
   }
-
- private:
-  template <class Fn, class Rcvr>
-  struct _let_stopped_receiver {
-    using receiver_concept = receiver_t;
-
-    Fn   fun_;
-    Rcvr receiver_;
-
-    template <class... Args>
-    void set_value(Args&&... args) && noexcept {
-      std::move(receiver_).set_value(std::forward<Args>(args)...);
-    }
-
-    template <class E>
-    void set_error(E&& e) && noexcept {
-      std::move(receiver_).set_error(std::forward<E>(e));
-    }
-
-    void set_stopped() && noexcept {
-      try {
-        auto next_sender = std::invoke(std::move(fun_));
-        auto op          = std::move(next_sender).connect(std::move(receiver_));
-        op.start();
-      } catch (...) {
-        std::move(receiver_).set_error(std::current_exception());
-      }
-    }
-  };
 };
 
 // Forward declarations for pipeable support
@@ -3,12 +3,12 @@
 #include <exception>
 #include <functional>
 #include <memory>
-#include <mutex>
 #include <optional>
 #include <type_traits>
 #include <utility>
 #include <variant>
 
+#include "../detail/mutex.hpp"
 #include "counting_scope.hpp"
 #include "env.hpp"
 #include "receiver.hpp"
@@ -29,7 +29,7 @@ namespace __let_async_scope {
 template <class... Errors>
 struct scope_state {
   counting_scope                          scope;
-  std::mutex                              error_mutex;
+  detail::mutex                           error_mutex{"let_async_scope"};
   std::variant<std::monostate, Errors...> stored_error;
   bool                                    has_error{false};
 
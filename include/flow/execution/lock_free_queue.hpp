@@ -4,25 +4,55 @@
 #include <atomic>
 #include <cstddef>
 #include <memory>
+#include <new>
 #include <optional>
+#include <type_traits>
 #include <utility>
 
 namespace flow::execution {
 
+// Capacity argument of a lock_free_bounded_queue whose capacity is chosen at run time
+inline constexpr std::size_t dynamic_queue_capacity = 0;
+
 // Lock-free bounded MPMC (Multiple Producer Multiple Consumer) queue
 // Uses a fixed-size ring buffer to avoid allocations - truly non-blocking
 // Suitable for try_schedule non-blocking operations
+// With Capacity == dynamic_queue_capacity the ring is allocated once by the constructor
 template <typename T, std::size_t Capacity = 1024>
 class lock_free_bounded_queue {
+  // A slot is claimed before its element is constructed and released before the element is
+  // moved out; a throw in between would leave the ring stuck
+  static_assert(std::is_nothrow_move_constructible_v<T>,
+                "lock_free_bounded_queue elements must be nothrow move constructible");
+
  public:
-  lock_free_bounded_queue() : head_(0), tail_(0) {
+  lock_free_bounded_queue()
+    requires(Capacity != dynamic_queue_capacity)
+      : head_(0), tail_(0) {
     // Initialize all slots as empty
     for (std::size_t i = 0; i < Capacity; ++i) {
       slots_[i].version.store(i, std::memory_order_relaxed);
     }
   }
 
-  ~lock_free_bounded_queue() = default;
+  explicit lock_free_bounded_queue(std::size_t capacity)
+    requires(Capacity == dynamic_queue_capacity)
+      : head_(0),
+        tail_(0),
+        capacity_(capacity > 0 ? capacity : 1),
+        slots_(std::make_unique<slot[]>(capacity_)) {
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      slots_[i].version.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // Destroys the elements still queued
+  ~lock_free_bounded_queue() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      while (try_pop()) {
+      }
+    }
+  }
 
   lock_free_bounded_queue(const lock_free_bounded_queue&)                    = delete;
   auto operator=(const lock_free_bounded_queue&) -> lock_free_bounded_queue& = delete;
@@ -30,10 +60,17 @@ class lock_free_bounded_queue {
   // Try to push an item. Returns false if queue is full
   // This is signal-safe and truly non-blocking - no allocations
   auto try_push(T&& value) noexcept -> bool {
+    return try_emplace(std::move(value));
+  }
+
+  // Constructs T(args...) in a free slot. Returns false, leaving args untouched, if queue is full
+  template <class... Args>
+    requires std::is_nothrow_constructible_v<T, Args...>
+  auto try_emplace(Args&&... args) noexcept -> bool {
     std::size_t tail = tail_.load(std::memory_order_relaxed);
 
     for (;;) {
-      slot&       s       = slots_[tail % Capacity];
+      slot&       s       = slots_[tail % capacity()];
       std::size_t version = s.version.load(std::memory_order_acquire);
 
       // Check if this slot is ready for writing
@@ -44,9 +81,7 @@ class lock_free_bounded_queue {
         // Slot is available, try to claim it
         if (tail_.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
           // We claimed the slot, now write the data
-          // Note: T's move constructor might throw (e.g., std::function)
-          // This is caught by the caller
-          new (s.storage.data()) T(std::move(value));
+          ::new (static_cast<void*>(s.storage.data())) T(std::forward<Args>(args)...);
           s.version.store(tail + 1, std::memory_order_release);
           return true;
         }
@@ -65,7 +100,7 @@ class lock_free_bounded_queue {
     std::size_t head = head_.load(std::memory_order_relaxed);
 
     for (;;) {
-      slot&       s       = slots_[head % Capacity];
+      slot&       s       = slots_[head % capacity()];
       std::size_t version = s.version.load(std::memory_order_acquire);
 
       // Check if this slot has data to read
@@ -77,10 +112,10 @@ class lock_free_bounded_queue {
         if (head_.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) {
           // We claimed the slot, read the data
           // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-init-variables)
-          T* const ptr   = reinterpret_cast<T*>(s.storage.data());
-          T        value = std::move(*ptr);
+          T* const         ptr = std::launder(reinterpret_cast<T*>(s.storage.data()));
+          std::optional<T> value(std::move(*ptr));
           ptr->~T();
-          s.version.store(head + Capacity, std::memory_order_release);
+          s.version.store(head + capacity(), std::memory_order_release);
           return value;
         }
       } else if (diff < 0) {
@@ -93,6 +128,21 @@ class lock_free_bounded_queue {
     }
   }
 
+  [[nodiscard]] auto capacity() const noexcept -> std::size_t {
+    if constexpr (Capacity == dynamic_queue_capacity) {
+      return capacity_;
+    } else {
+      return Capacity;
+    }
+  }
+
+  // Number of queued items (may not be accurate due to concurrent access)
+  auto size() const noexcept -> std::size_t {
+    std::size_t head = head_.load(std::memory_order_acquire);
+    std::size_t tail = tail_.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+  }
+
   // Check if queue is empty (may not be accurate due to concurrent access)
   auto empty() const noexcept -> bool {
     std::size_t head = head_.load(std::memory_order_acquire);
@@ -104,7 +154,7 @@ class lock_free_bounded_queue {
   auto full() const noexcept -> bool {
     std::size_t head = head_.load(std::memory_order_acquire);
     std::size_t tail = tail_.load(std::memory_order_acquire);
-    return (tail - head) >= Capacity;
+    return (tail - head) >= capacity();
   }
 
  private:
@@ -113,9 +163,18 @@ class lock_free_bounded_queue {
     alignas(T) std::array<unsigned char, sizeof(T)> storage{};
   };
 
+  struct no_capacity {};
+
+  using capacity_type = std::conditional_t<Capacity == dynamic_queue_capacity, const std::size_t,
+                                           no_capacity>;
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
+  using slots_type = std::conditional_t<Capacity == dynamic_queue_capacity,
+                                        std::unique_ptr<slot[]>, std::array<slot, Capacity>>;
+
   alignas(64) std::atomic<std::size_t> head_;  // Consumer side (cache line aligned)
   alignas(64) std::atomic<std::size_t> tail_;  // Producer side (cache line aligned)
-  std::array<slot, Capacity> slots_;
+  [[no_unique_address]] capacity_type capacity_{};
+  slots_type                          slots_;
 };
 
 }  // namespace flow::execution
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "bulk.hpp"
+#include "execution_policy.hpp"
+#include "scheduler.hpp"
+#include "then.hpp"
+
+namespace flow::execution {
+
+// NUMA-aware first-touch allocation for bulk data
+//
+// Linux places an anonymous page on the node of the CPU that first writes it. An array filled
+// by one thread therefore lands on that thread's node, and on a multi-socket machine every
+// bulk agent on another socket then reads remote memory. numa_vector<T> maps its storage with
+// mmap and leaves it untouched; bulk_allocate<T>(sched, n) fills it through a parallel bulk
+// pass on `sched`, so each page is first touched by the agent that writes its indices:
+//
+//   work_stealing_scheduler ws(32, topology_mode::on);
+//   auto [a] = *sync_wait(bulk_allocate<double>(ws.get_scheduler(), n));
+//
+//   schedule(ws.get_scheduler())
+//     | bulk_chunked(par, n, [&](std::size_t b, std::size_t e) { /* a[b..e) stays local */ })
+//
+// That only pays off when later passes run each index on the same worker as the first touch,
+// which a work_stealing_scheduler in topology mode guarantees for any bulk over the same shape
+// on the same scheduler (parallel_bulk.hpp); elsewhere placement follows whichever agent
+// claimed each chunk. A page straddling two blocks goes to whichever agent wrote it first.
+// Off Linux the storage is an ordinary page-aligned allocation zeroed by the constructing
+// thread, so placement is left to the allocator.
+
+// Fixed-size array of trivially copyable T in page-aligned memory mapped on construction and
+// unmapped on destruction; elements start zeroed and on Linux no page is placed before it is
+// written
+template <class T>
+  requires std::is_trivially_copyable_v<T>
+class numa_vector {
+ public:
+  using value_type = T;
+
+  numa_vector() noexcept = default;
+
+  explicit numa_vector(std::size_t count) : size_(count) {
+    if (count == 0) {
+      return;
+    }
+    if (count > max_size()) {
+      throw std::length_error("numa_vector: count exceeds max_size()");
+    }
+    const auto page = page_size();
+    bytes_          = ((count * sizeof(T)) + page - 1) / page * page;
+#if defined(__linux__)
+    void* memory = ::mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                          -1, 0);
+    if (memory == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+#else
+    void* memory = ::operator new(bytes_, std::align_val_t{page});
+    std::memset(memory, 0, bytes_);
+#endif
+    data_ = static_cast<T*>(memory);
+  }
+
+  numa_vector(numa_vector&& other) noexcept
+      : data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)),
+        bytes_(std::exchange(other.bytes_, 0)) {}
+
+  auto operator=(numa_vector&& other) noexcept -> numa_vector& {
+    if (this != &other) {
+      release();
+      data_  = std::exchange(other.data_, nullptr);
+      size_  = std::exchange(other.size_, 0);
+      bytes_ = std::exchange(other.bytes_, 0);
+    }
+    return *this;
+  }
+
+  numa_vector(const numa_vector&)                    = delete;
+  auto operator=(const numa_vector&) -> numa_vector& = delete;
+
+  ~numa_vector() {
+    release();
+  }
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t {
+    return size_;
+  }
+
+  // Leaves room to round the byte count up to a whole page without overflowing
+  [[nodiscard]] static constexpr auto max_size() noexcept -> std::size_t {
+    return static_cast<std::size_t>(std::numeric_limits<std::ptrdiff_t>::max()) / sizeof(T);
+  }
+
+  [[nodiscard]] auto empty() const noexcept -> bool {
+    return size_ == 0;
+  }
+
+  [[nodiscard]] auto data() noexcept -> T* {
+    return data_;
+  }
+
+  [[nodiscard]] auto data() const noexcept -> const T* {
+    return data_;
+  }
+
+  auto operator[](std::size_t i) noexcept -> T& {
+    return data_[i];
+  }
+
+  auto operator[](std::size_t i) const noexcept -> const T& {
+    return data_[i];
+  }
+
+  [[nodiscard]] auto begin() noexcept -> T* {
+    return data_;
+  }
+
+  [[nodiscard]] auto end() noexcept -> T* {
+    return data_ + size_;
+  }
+
+  [[nodiscard]] auto begin() const noexcept -> const T* {
+    return data_;
+  }
+
+  [[nodiscard]] auto end() const noexcept -> const T* {
+    return data_ + size_;
+  }
+
+  operator std::span<T>() noexcept {  // NOLINT(google-explicit-constructor)
+    return {data_, size_};
+  }
+
+  operator std::span<const T>() const noexcept {  // NOLINT(google-explicit-constructor)
+    return {data_, size_};
+  }
+
+ private:
+  static auto page_size() noexcept -> std::size_t {
+#if defined(__linux__)
+    return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#else
+    return 4096;
+#endif
+  }
+
+  void release() noexcept {
+    if (data_ == nullptr) {
+      return;
+    }
+#if defined(__linux__)
+    ::munmap(data_, bytes_);
+#else
+    ::operator delete(data_, std::align_val_t{page_size()});
+#endif
+  }
+
+  T*          data_{nullptr};
+  std::size_t size_{0};
+  std::size_t bytes_{0};
+};
+
+template <class T>
+struct bulk_allocate_t {
+  // Sender of a numa_vector<T> of `count` elements where element i is init(i), each written by
+  // the bulk agent of `sched` that owns index i. `init` is called concurrently.
+  template <scheduler Sched, class F>
+    requires std::is_invocable_r_v<T, const F&, std::size_t>
+  auto operator()(Sched sched, std::size_t count, F init) const {
+    return schedule(sched) | then([count] { return numa_vector<T>(count); })
+           | bulk_chunked(par, count,
+                          [init = std::move(init)](std::size_t begin, std::size_t end,
+                                                   numa_vector<T>& v) noexcept(
+                              std::is_nothrow_invocable_v<const F&, std::size_t>) {
+                            for (std::size_t i = begin; i < end; ++i) {
+                              v[i] = init(i);
+                            }
+                          });
+  }
+
+  // Value-initialized elements; the pages are still written, which is what places them
+  template <scheduler Sched>
+  auto operator()(Sched sched, std::size_t count) const {
+    return (*this)(std::move(sched), count, [](std::size_t /*unused*/) noexcept { return T{}; });
+  }
+};
+
+template <class T>
+inline constexpr bulk_allocate_t<T> bulk_allocate{};
+
+}  // namespace flow::execution
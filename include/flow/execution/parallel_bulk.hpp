@@ -0,0 +1,522 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "completion_signatures.hpp"
+#include "env.hpp"
+#include "instrument.hpp"
+#include "queries.hpp"
+#include "receiver.hpp"
+#include "scheduler.hpp"
+#include "stop_token.hpp"
+#include "utils.hpp"
+
+namespace flow::execution {
+
+// [exec.bulk.parallel], parallel bulk path
+//
+// A bulk algorithm running under a parallel policy whose predecessor completes on a scheduler
+// that reports get_parallelism() splits its index space into chunks and runs them on that
+// scheduler. The thread that delivered the predecessor's values claims chunks itself; helper
+// agents are started with schedule(sched) and claim chunks from a shared counter until none
+// are left, so a saturated pool degrades to the delivering thread doing all the work. The last
+// participant to finish completes the downstream receiver.
+//
+// Everything else (sequenced policies, predecessors without a completion scheduler, a single
+// chunk) runs the body over the whole range on the delivering thread.
+//
+// Participants check a shared cancellation flag and the receiver's stop token before claiming
+// each chunk. An exception, a stop request or a body that asks for an early exit makes the
+// remaining chunks be skipped; the run then completes with the first exception, with
+// set_stopped, or normally.
+//
+// A body is called as body(begin, end, values...). It may return bool, false meaning "skip
+// every chunk not yet started" (such bodies are also run chunk by chunk when sequential), and
+// it may provide result(), whose value the run completes with instead of the predecessor's
+// values, and finish(), run once after the last chunk (an exception completes with set_error).
+// A body invocable as body(agent_index, begin, end, values...) is also told which participant
+// runs the chunk: the delivering thread is agent 0, helpers count up from 1, and every index
+// stays below the `agents` passed to run().
+//
+// A body whose call is noexcept runs without exception handlers, and the shared state of a
+// parallel run then has no room for an exception either.
+//
+// Allocations: the inline path allocates nothing. A parallel run allocates its shared state
+// (body, receiver and values, which must outlive the delivering call) and the array of helper
+// operations: two allocations per run whatever the shape. If either fails, the run falls back
+// to the inline path. The helpers' schedule() operations allocate whatever
+// the scheduler allocates per task.
+//
+// Fixed placement: when the scheduler answers get_agent_scheduler() (a work_stealing_scheduler
+// in topology mode), chunks are not claimed from a shared counter. The index space is split
+// into one contiguous block per agent, agent k's block always runs on the scheduler returned
+// for k, and the delivering thread only starts the agents. The split depends on nothing but
+// the shape and the parallelism, so every pass over the same range touches an index from the
+// same worker, which is what first-touch NUMA placement (numa_vector.hpp) relies on. Nothing
+// rebalances an uneven body in this mode. An agent that cannot be scheduled runs its block on
+// the thread that learns of it. An early exit skips the rest of its block and the blocks
+// above it, but not the blocks below, so every chunk below the exit point still runs.
+
+namespace _parallel_bulk_detail {
+
+// Scheduler marker for bulk algorithms without a parallel bulk path
+struct no_scheduler {};
+
+template <class Sched>
+concept parallel_scheduler = scheduler<Sched> && requires(const Sched& sched) {
+  { get_parallelism(sched) } -> std::convertible_to<std::size_t>;
+};
+
+// Schedulers that can run an agent on a fixed worker
+template <class Sched>
+concept placing_scheduler =
+    parallel_scheduler<Sched> && requires(const Sched& sched, std::size_t agent) {
+      { get_agent_scheduler(sched, agent) } -> std::same_as<std::optional<Sched>>;
+    };
+
+template <class Sched>
+auto has_fixed_placement(const Sched& sched) noexcept -> bool {
+  if constexpr (placing_scheduler<Sched>) {
+    return get_agent_scheduler(sched, 0).has_value();
+  } else {
+    return false;
+  }
+}
+
+// The scheduler a bulk algorithm over `sndr` runs on
+template <class S>
+auto bulk_scheduler_of(const S& sndr) noexcept {
+  if constexpr (requires {
+                  { get_completion_scheduler<set_value_t>(sndr) } -> parallel_scheduler;
+                }) {
+    return get_completion_scheduler<set_value_t>(sndr);
+  } else {
+    return no_scheduler{};
+  }
+}
+
+template <class S>
+using bulk_scheduler_t = decltype(bulk_scheduler_of(std::declval<const S&>()));
+
+// Whether a bulk algorithm over `S` under `Policy` may take the parallel path, and so
+// complete with set_stopped on a stop request
+template <class S, class Policy>
+inline constexpr bool may_run_parallel =
+    Policy::is_par && !std::same_as<bulk_scheduler_t<S>, no_scheduler>;
+
+// The predecessor's completions, plus set_error(exception_ptr) if the body may throw and
+// set_stopped() if the parallel path is reachable
+template <class S, class Env, class Policy, bool MayThrow>
+using bulk_signatures_t = __concat_completion_signatures_t<
+    __completion_signatures_of_t<S, Env, set_value_t, set_error_t, set_stopped_t>,
+    __exception_signatures_t<MayThrow>,
+    std::conditional_t<may_run_parallel<S, Policy>, completion_signatures<set_stopped_t()>,
+                       completion_signatures<>>>;
+
+template <class Sched>
+auto parallelism_of(const Sched& sched) noexcept -> std::size_t {
+  if constexpr (std::same_as<Sched, no_scheduler>) {
+    return 1;
+  } else {
+    return std::max<std::size_t>(1, get_parallelism(sched));
+  }
+}
+
+// Agents the bulk may use: one unless the policy allows parallel execution
+template <class Policy, class Sched>
+auto agents_for(const Sched& sched) noexcept -> std::size_t {
+  if constexpr (Policy::is_par) {
+    return parallelism_of(sched);
+  } else {
+    return 1;
+  }
+}
+
+// A few chunks per agent so that uneven chunks balance out
+inline constexpr std::size_t chunks_per_agent = 4;
+
+// Indices per chunk when `shape` indices are split across `agents`
+inline auto grain_for(std::size_t shape, std::size_t agents) noexcept -> std::size_t {
+  const std::size_t chunks = agents * chunks_per_agent;
+  return std::max<std::size_t>(1, (shape + chunks - 1) / chunks);
+}
+
+// Indices [first, second) of the block agent `agent` owns when `shape` indices are split into
+// `agents` fixed blocks; block sizes differ by at most one
+inline auto fixed_block(std::size_t shape, std::size_t agents, std::size_t agent) noexcept
+    -> std::pair<std::size_t, std::size_t> {
+  const std::size_t base  = shape / agents;
+  const std::size_t extra = shape % agents;
+  const std::size_t begin = (agent * base) + std::min(agent, extra);
+  return {begin, begin + base + (agent < extra ? 1 : 0)};
+}
+
+// Participant running a chunk, for bodies that keep per-agent state
+struct agent_index {
+  std::size_t value;
+};
+
+template <class Body, class... Values>
+concept agent_body = std::invocable<Body&, agent_index, std::size_t, std::size_t, Values&...>;
+
+template <class Body, class... Values>
+inline constexpr bool nothrow_body =
+    agent_body<Body, Values...>
+        ? std::is_nothrow_invocable_v<Body&, agent_index, std::size_t, std::size_t, Values&...>
+        : std::is_nothrow_invocable_v<Body&, std::size_t, std::size_t, Values&...>;
+
+template <class Body, class... Values>
+auto call_body(Body& body, std::size_t agent, std::size_t begin, std::size_t end,
+               Values&... values) noexcept(nothrow_body<Body, Values...>) {
+  if constexpr (agent_body<Body, Values...>) {
+    return body(agent_index{agent}, begin, end, values...);
+  } else {
+    return body(begin, end, values...);
+  }
+}
+
+template <class Body, class... Values>
+inline constexpr bool interruptible =
+    std::same_as<decltype(call_body(std::declval<Body&>(), 0, 0, 0, std::declval<Values&>()...)),
+                 bool>;
+
+// Runs one chunk; false if the body asked for an early exit
+template <class Body, class... Values>
+auto run_chunk(Body& body, std::size_t agent, std::size_t begin, std::size_t end,
+               Values&... values) noexcept(nothrow_body<Body, Values...>) -> bool {
+  if constexpr (interruptible<Body, Values...>) {
+    return call_body(body, agent, begin, end, values...);
+  } else {
+    call_body(body, agent, begin, end, values...);
+    return true;
+  }
+}
+
+// Completes `rcvr` with the body's result, or with the predecessor's values
+template <class Body, class Rcvr, class... Values>
+void set_result(Body& body, Rcvr&& rcvr, Values&&... values) noexcept {
+  if constexpr (requires { body.finish(); }) {
+    try {
+      body.finish();
+    } catch (...) {
+      std::forward<Rcvr>(rcvr).set_error(std::current_exception());
+      return;
+    }
+  }
+  if constexpr (requires { body.result(); }) {
+    std::forward<Rcvr>(rcvr).set_value(body.result());
+  } else {
+    std::forward<Rcvr>(rcvr).set_value(std::forward<Values>(values)...);
+  }
+}
+
+// Shared state of one parallel run. Owns the body, the downstream receiver and the values
+// sent by the predecessor; deletes itself after completing the receiver.
+template <class Sched, class Body, class Rcvr, class... Values>
+class region {
+  struct helper_receiver {
+    using receiver_concept = receiver_t;
+
+    region*     self_;
+    std::size_t agent_;
+
+    void set_value() && noexcept {
+      self_->participate(agent_);
+    }
+
+    // A helper that could not be scheduled leaves its chunks to the other participants, or
+    // runs its fixed block right here
+    template <class E>
+    void set_error(E&& /*unused*/) && noexcept {
+      self_->abandon(agent_);
+    }
+
+    void set_stopped() && noexcept {
+      self_->abandon(agent_);
+    }
+
+    // Helpers are scheduled on behalf of the downstream receiver: its deadline and stop token
+    // apply to them too. They run concurrently, so the stage tracer does not.
+    auto get_env() const noexcept {
+      return _instrument_detail::concurrent_env(flow::execution::get_env(*self_->receiver_));
+    }
+  };
+
+  using helper_op_t =
+      decltype(std::declval<Sched&>().schedule().connect(std::declval<helper_receiver>()));
+
+  static constexpr bool nothrow = nothrow_body<Body, Values...>;
+
+  struct no_error {};
+  using error_storage = std::conditional_t<nothrow, no_error, std::exception_ptr>;
+
+ public:
+  // `blocks` > 0 gives every agent a fixed block instead of shared chunks
+  region(std::size_t shape, std::size_t grain, std::size_t helpers, std::size_t blocks)
+      : shape_(shape),
+        grain_(grain),
+        chunks_((shape + grain - 1) / grain),
+        blocks_(blocks),
+        helpers_(std::make_unique<std::optional<helper_op_t>[]>(helpers)) {}
+
+  region(const region&)                    = delete;
+  auto operator=(const region&) -> region& = delete;
+
+  // Runs `body` over [0, shape) on the calling thread and up to `agents - 1` helpers; the
+  // receiver is completed by whichever participant finishes last. Returns false, leaving
+  // `body`, `rcvr` and `args` untouched, when the shared state cannot be allocated.
+  template <class B, class R, class... Args>
+  static auto launch(const Sched& sched, std::size_t shape, std::size_t agents, B&& body, R&& rcvr,
+                     Args&&... args) noexcept -> bool {
+    const std::size_t grain  = grain_for(shape, agents);
+    const std::size_t chunks = (shape + grain - 1) / grain;
+    // With fixed placement every block gets a helper on its own worker
+    const std::size_t blocks  = has_fixed_placement(sched) ? std::min(agents, shape) : 0;
+    const std::size_t helpers = blocks > 0 ? blocks : std::min(agents, chunks) - 1;
+
+    std::unique_ptr<region> self;
+    try {
+      self = std::make_unique<region>(shape, grain, helpers, blocks);
+    } catch (...) {
+      return false;
+    }
+    // Only values that may throw on the way into the shared state can add an exception_ptr
+    // error; a noexcept body over nothrow-movable values declares none
+    if constexpr (std::is_nothrow_constructible_v<std::tuple<Values...>, Args...>) {
+      self->values_.emplace(std::forward<Args>(args)...);
+    } else {
+      try {
+        self->values_.emplace(std::forward<Args>(args)...);
+      } catch (...) {
+        std::forward<R>(rcvr).set_error(std::current_exception());
+        return true;
+      }
+    }
+    self->body_.emplace(std::forward<B>(body));
+    self->receiver_.emplace(std::forward<R>(rcvr));
+
+    // Connect every helper before starting any, so the active count is final
+    std::size_t connected = 0;
+    try {
+      for (; connected < helpers; ++connected) {
+        self->helpers_[connected].emplace(__emplace_from{[&] {
+          if constexpr (placing_scheduler<Sched>) {
+            if (blocks > 0) {
+              return get_agent_scheduler(sched, connected)
+                  ->schedule()
+                  .connect(helper_receiver{self.get(), connected});
+            }
+          }
+          return sched.schedule().connect(helper_receiver{self.get(), connected + 1});
+        }});
+      }
+    } catch (...) {
+      // Run with the helpers that could be connected
+    }
+
+    region* r = self.release();
+    if (blocks > 0) {
+      // The blocks whose helper could not be connected run here
+      r->active_.store(blocks, std::memory_order_relaxed);
+      for (std::size_t i = 0; i < connected; ++i) {
+        r->helpers_[i]->start();
+      }
+      for (std::size_t agent = connected; agent < blocks; ++agent) {
+        r->participate(agent);
+      }
+      return true;
+    }
+    r->active_.store(connected + 1, std::memory_order_relaxed);
+    for (std::size_t i = 0; i < connected; ++i) {
+      r->helpers_[i]->start();
+    }
+    r->participate(0);
+    return true;
+  }
+
+ private:
+  void participate(std::size_t agent) noexcept {
+    auto token = get_stop_token(get_env(*receiver_));
+    // A fixed block is still run grain by grain, so cancellation is noticed as often
+    auto [next, last] = blocks_ > 0 ? fixed_block(shape_, blocks_, agent)
+                                    : std::pair<std::size_t, std::size_t>{0, 0};
+    while (!cancelled_.load(std::memory_order_relaxed)) {
+      if (token.stop_requested()) {
+        stopped_.store(true, std::memory_order_relaxed);
+        cancelled_.store(true, std::memory_order_relaxed);
+        break;
+      }
+      std::size_t begin = next;
+      std::size_t end   = last;
+      if (blocks_ > 0) {
+        // Blocks from the lowest one that exited early up lie above its exit point
+        if (begin >= last || agent >= exit_block_.load(std::memory_order_relaxed)) {
+          break;
+        }
+        end  = std::min(last, begin + grain_);
+        next = end;
+      } else {
+        const std::size_t chunk = next_chunk_.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= chunks_) {
+          break;
+        }
+        begin = chunk * grain_;
+        end   = std::min(shape_, begin + grain_);
+      }
+      if constexpr (nothrow) {
+        execute_chunk(agent, begin, end);
+      } else {
+        try {
+          execute_chunk(agent, begin, end);
+        } catch (...) {
+          if (!failed_.exchange(true, std::memory_order_relaxed)) {
+            error_ = std::current_exception();
+          }
+          cancelled_.store(true, std::memory_order_relaxed);
+        }
+      }
+    }
+    arrive();
+  }
+
+  void execute_chunk(std::size_t agent, std::size_t begin, std::size_t end) noexcept(nothrow) {
+    if (!std::apply(
+            [&](auto&... values) noexcept(nothrow) {
+              return run_chunk(*body_, agent, begin, end, values...);
+            },
+            *values_)) {
+      early_exit(agent);
+    }
+  }
+
+  // The body asked to skip the chunks not yet started. Shared chunks are claimed in increasing
+  // order, so those all lie above; with fixed blocks only the rest of this block and the blocks
+  // above it do, and the blocks below still run to their end.
+  void early_exit(std::size_t agent) noexcept {
+    if (blocks_ == 0) {
+      cancelled_.store(true, std::memory_order_relaxed);
+      return;
+    }
+    std::size_t lowest = exit_block_.load(std::memory_order_relaxed);
+    while (agent < lowest
+           && !exit_block_.compare_exchange_weak(lowest, agent, std::memory_order_relaxed)) {
+    }
+  }
+
+  // A helper that was not run
+  void abandon(std::size_t agent) noexcept {
+    if (blocks_ > 0) {
+      participate(agent);
+    } else {
+      arrive();
+    }
+  }
+
+  void arrive() noexcept {
+    if (active_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+
+    std::unique_ptr<region> self(this);
+    if constexpr (!nothrow) {
+      if (failed_.load(std::memory_order_relaxed)) {
+        std::move(*receiver_).set_error(std::move(error_));
+        return;
+      }
+    }
+    if (stopped_.load(std::memory_order_relaxed)) {
+      std::move(*receiver_).set_stopped();
+    } else {
+      std::apply(
+          [this](auto&... values) {
+            set_result(*body_, std::move(*receiver_), std::move(values)...);
+          },
+          *values_);
+    }
+  }
+
+  const std::size_t                             shape_;
+  const std::size_t                             grain_;
+  const std::size_t                             chunks_;
+  const std::size_t                             blocks_;  // 0 unless placement is fixed
+  std::unique_ptr<std::optional<helper_op_t>[]> helpers_;
+  std::optional<std::tuple<Values...>>          values_;
+  std::optional<Body>                           body_;
+  std::optional<Rcvr>                           receiver_;
+  alignas(64) std::atomic<std::size_t>          next_chunk_{0};
+  alignas(64) std::atomic<std::size_t>          active_{0};
+  std::atomic<bool>                             cancelled_{false};
+  std::atomic<std::size_t>                      exit_block_{static_cast<std::size_t>(-1)};
+  std::atomic<bool>                             failed_{false};
+  std::atomic<bool>                             stopped_{false};
+  [[no_unique_address]] error_storage           error_;
+};
+
+// Runs `body` over [0, shape) on the calling thread; false if a stop request cut it short
+template <class Body, class Rcvr, class... Values>
+auto run_inline(Body& body, std::size_t shape, const Rcvr& rcvr, Values&... values) noexcept(
+    nothrow_body<Body, Values...>) -> bool {
+  if constexpr (interruptible<Body, Values...>) {
+    // Chunk by chunk, so that a stop request or an early exit skips the rest
+    auto              token = get_stop_token(get_env(rcvr));
+    const std::size_t grain = grain_for(shape, 1);
+    for (std::size_t begin = 0; begin < shape; begin += grain) {
+      if (token.stop_requested()) {
+        return false;
+      }
+      if (!call_body(body, 0, begin, std::min(shape, begin + grain), values...)) {
+        break;
+      }
+    }
+  } else if (shape > 0) {
+    call_body(body, 0, 0, shape, values...);
+  }
+  return true;
+}
+
+// Runs `body(begin, end, args...)` over [0, shape) and completes `rcvr` (see above).
+// `agents` > 1 takes the parallel bulk path.
+template <class Sched, class Body, class Rcvr, class... Args>
+void run(const Sched& sched, std::size_t agents, std::size_t shape, Body&& body, Rcvr&& rcvr,
+         Args&&... args) noexcept {
+  if constexpr (!std::same_as<Sched, no_scheduler>) {
+    if (agents > 1 && shape > 1) {
+      using region_t = region<Sched, __decay_t<Body>, __decay_t<Rcvr>, __decay_t<Args>...>;
+      if (region_t::launch(sched, shape, agents, std::forward<Body>(body), std::forward<Rcvr>(rcvr),
+                           std::forward<Args>(args)...)) {
+        return;
+      }
+    }
+  }
+
+  if constexpr (nothrow_body<std::remove_reference_t<Body>, std::remove_reference_t<Args>...>) {
+    if (!run_inline(body, shape, rcvr, args...)) {
+      std::forward<Rcvr>(rcvr).set_stopped();
+      return;
+    }
+  } else {
+    try {
+      if (!run_inline(body, shape, rcvr, args...)) {
+        std::forward<Rcvr>(rcvr).set_stopped();
+        return;
+      }
+    } catch (...) {
+      std::forward<Rcvr>(rcvr).set_error(std::current_exception());
+      return;
+    }
+  }
+  set_result(body, std::forward<Rcvr>(rcvr), std::forward<Args>(args)...);
+}
+
+}  // namespace _parallel_bulk_detail
+
+}  // namespace flow::execution
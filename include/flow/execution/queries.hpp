@@ -1,5 +1,10 @@
 #pragma once
 
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
 #include <utility>
 
 namespace flow::execution {
@@ -57,6 +62,117 @@ struct get_forward_progress_guarantee_t {
   }
 };
 
+// Number of execution agents a scheduler can run at once; bulk algorithms split their index
+// space across that many agents (parallel_bulk.hpp)
+struct get_parallelism_t {
+  template <class T>
+  constexpr auto operator()(const T& t) const
+      noexcept(noexcept(t.query(std::declval<get_parallelism_t>())))
+          -> decltype(t.query(std::declval<get_parallelism_t>())) {
+    return t.query(get_parallelism_t{});
+  }
+};
+
+// Scheduler whose work runs on one fixed agent of a scheduler (one pinned worker), as
+// std::optional: empty unless the scheduler currently gives its agents fixed placement. The
+// parallel bulk path uses it to run every pass over the same index range on the same agent
+// (parallel_bulk.hpp); agents past get_parallelism() wrap around.
+struct get_agent_scheduler_t {
+  template <class T>
+  constexpr auto operator()(const T& t, std::size_t agent) const
+      noexcept(noexcept(t.query(std::declval<get_agent_scheduler_t>(), agent)))
+          -> decltype(t.query(std::declval<get_agent_scheduler_t>(), agent)) {
+    return t.query(get_agent_scheduler_t{}, agent);
+  }
+};
+
+// Allocator for memory an operation allocates on behalf of its receiver (spawn's operation
+// state, for one). Environments answer it through a `query(env, get_allocator_t)` overload;
+// without one the answer is std::allocator<std::byte>.
+struct get_allocator_t {
+  template <class Env>
+  auto operator()(const Env& env) const noexcept -> decltype(auto) {
+    if constexpr (requires { query(env, get_allocator_t{}); }) {
+      return query(env, get_allocator_t{});
+    } else {
+      return std::allocator<std::byte>{};
+    }
+  }
+};
+
+// Environment that answers get_allocator with `allocator` and forwards other queries to `base`
+template <class Allocator, class BaseEnv>
+struct env_with_allocator {
+  Allocator allocator;
+  BaseEnv   base_env;
+
+  template <class Query>
+    requires std::same_as<Query, get_allocator_t>
+  friend auto query(const env_with_allocator& self, Query /*unused*/) noexcept -> Allocator {
+    return self.allocator;
+  }
+
+  template <class Query>
+    requires(!std::same_as<Query, get_allocator_t>)
+            && requires(const BaseEnv& env, Query q) { query(env, q); }
+  friend auto query(const env_with_allocator& self,
+                    Query                     q) noexcept(noexcept(query(self.base_env, q)))
+      -> decltype(query(self.base_env, q)) {
+    return query(self.base_env, q);
+  }
+};
+
+template <class Allocator, class BaseEnv>
+auto make_env_with_allocator(Allocator allocator, BaseEnv&& base) {
+  return env_with_allocator<Allocator, std::decay_t<BaseEnv>>{std::move(allocator),
+                                                              std::forward<BaseEnv>(base)};
+}
+
+// Point after which the requester no longer wants an operation's result. Environments answer
+// it through a `query(env, get_deadline_t)` overload; without one there is no deadline
+// (time_point::max()). Schedulers that shed load complete work dequeued after its deadline with
+// set_stopped instead of running it (with_deadline in deadline.hpp sets one).
+struct get_deadline_t {
+  using time_point = std::chrono::steady_clock::time_point;
+
+  template <class Env>
+  auto operator()(const Env& env) const noexcept -> time_point {
+    if constexpr (requires { query(env, get_deadline_t{}); }) {
+      return query(env, get_deadline_t{});
+    } else {
+      return time_point::max();
+    }
+  }
+};
+
+// Environment that answers get_deadline with `deadline` and forwards other queries to `base`
+template <class BaseEnv>
+struct env_with_deadline {
+  get_deadline_t::time_point deadline;
+  BaseEnv                    base_env;
+
+  template <class Query>
+    requires std::same_as<Query, get_deadline_t>
+  friend auto query(const env_with_deadline& self, Query /*unused*/) noexcept
+      -> get_deadline_t::time_point {
+    return self.deadline;
+  }
+
+  template <class Query>
+    requires(!std::same_as<Query, get_deadline_t>)
+            && requires(const BaseEnv& env, Query q) { query(env, q); }
+  friend auto query(const env_with_deadline& self,
+                    Query                    q) noexcept(noexcept(query(self.base_env, q)))
+      -> decltype(query(self.base_env, q)) {
+    return query(self.base_env, q);
+  }
+};
+
+template <class BaseEnv>
+auto make_env_with_deadline(get_deadline_t::time_point deadline, BaseEnv&& base) {
+  return env_with_deadline<std::decay_t<BaseEnv>>{deadline, std::forward<BaseEnv>(base)};
+}
+
 template <class CPO>
 struct get_completion_scheduler_t {
   template <class T>
@@ -71,6 +187,10 @@ inline constexpr get_domain_t                     get_domain{};
 inline constexpr get_scheduler_t                  get_scheduler{};
 inline constexpr get_delegatee_scheduler_t        get_delegatee_scheduler{};
 inline constexpr get_forward_progress_guarantee_t get_forward_progress_guarantee{};
+inline constexpr get_parallelism_t                get_parallelism{};
+inline constexpr get_agent_scheduler_t            get_agent_scheduler{};
+inline constexpr get_allocator_t                  get_allocator{};
+inline constexpr get_deadline_t                   get_deadline{};
 
 template <class CPO>
 inline constexpr get_completion_scheduler_t<CPO> get_completion_scheduler{};
@@ -0,0 +1,394 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "execution_policy.hpp"
+#include "instrument.hpp"
+#include "parallel_bulk.hpp"
+#include "sender.hpp"
+
+namespace flow::execution {
+
+// [exec.range.algorithms], for_each / for_each_n / transform over ranges
+//
+//   schedule(sched) | for_each(par, values, [](double& v) { v = std::sqrt(v); })
+//   schedule(sched) | transform(par, in, out.begin(), [](int v) { return v * 2; })
+//
+// The algorithms run on the parallel bulk path (parallel_bulk.hpp) of their predecessor's
+// completion scheduler. Random-access ranges are chunked by index. Other forward ranges are
+// walked once to record the iterator at the start of every block, and the blocks are then
+// processed in parallel. Like bulk, the predecessor's values are passed to every call after
+// the element and are forwarded downstream unchanged.
+
+namespace _range_detail {
+
+// Advances a cursor: an iterator, or an input/output iterator pair moving in lockstep
+template <class It>
+void step(It& it, std::size_t n) {
+  std::ranges::advance(it, static_cast<std::iter_difference_t<It>>(n));
+}
+
+template <class In, class Out>
+void step(std::pair<In, Out>& cursor, std::size_t n) {
+  step(cursor.first, n);
+  step(cursor.second, n);
+}
+
+template <class Cursor>
+inline constexpr bool random_access_cursor = std::random_access_iterator<Cursor>;
+
+template <class In, class Out>
+inline constexpr bool random_access_cursor<std::pair<In, Out>> =
+    std::random_access_iterator<In> && std::random_access_iterator<Out>;
+
+// Runs `op(cursor)` for `count` consecutive positions starting at `first`. With a
+// random-access cursor, or a single agent that walks the whole range in one chunk, the chunks
+// index directly from `first`; otherwise one pass records the start of every block in a
+// vector (the one allocation of a parallel run over a forward range, besides the bulk's
+// shared state) and the bulk runs over blocks.
+template <class Sched, class Cursor, class Op, class Rcvr, class... Args>
+void run_over(const Sched& sched, std::size_t agents, Cursor first, std::size_t count, Op op,
+              Rcvr&& rcvr, Args&&... args) noexcept {
+  if (random_access_cursor<Cursor> || agents <= 1) {
+    _parallel_bulk_detail::run(
+        sched, agents, count,
+        [first, op = std::move(op)](std::size_t begin, std::size_t end, auto&... values) mutable {
+          Cursor cursor = first;
+          step(cursor, begin);
+          for (std::size_t i = begin; i != end; ++i, step(cursor, 1)) {
+            op(cursor, values...);
+          }
+        },
+        std::forward<Rcvr>(rcvr), std::forward<Args>(args)...);
+  } else {
+    const std::size_t   block = _parallel_bulk_detail::grain_for(count, agents);
+    std::vector<Cursor> starts;
+    try {
+      starts.reserve((count + block - 1) / block);
+      Cursor cursor = first;
+      for (std::size_t i = 0; i < count; i += block) {
+        starts.push_back(cursor);
+        if (i + block < count) {
+          step(cursor, block);
+        }
+      }
+    } catch (...) {
+      std::forward<Rcvr>(rcvr).set_error(std::current_exception());
+      return;
+    }
+
+    const std::size_t blocks = starts.size();
+    _parallel_bulk_detail::run(
+        sched, agents, blocks,
+        [starts = std::move(starts), block, count, op = std::move(op)](
+            std::size_t begin, std::size_t end, auto&... values) mutable {
+          for (std::size_t b = begin; b != end; ++b) {
+            Cursor            cursor = starts[b];
+            const std::size_t length = std::min(block, count - (b * block));
+            for (std::size_t i = 0; i != length; ++i, step(cursor, 1)) {
+              op(cursor, values...);
+            }
+          }
+        },
+        std::forward<Rcvr>(rcvr), std::forward<Args>(args)...);
+  }
+}
+
+template <class Out>
+auto output_iterator_of(Out&& out) {
+  if constexpr (std::ranges::range<Out>) {
+    return std::ranges::begin(out);
+  } else {
+    return std::forward<Out>(out);
+  }
+}
+
+template <class Out>
+using output_iterator_t = decltype(output_iterator_of(std::declval<Out>()));
+
+}  // namespace _range_detail
+
+// for_each: f(element, values...) for every element of the range
+template <sender S, class Policy, std::ranges::view View, class F>
+struct _for_each_sender {
+  using sender_concept = sender_t;
+  using value_types    = typename S::value_types;
+
+  S      sender_;
+  Policy policy_;
+  View   view_;
+  F      fun_;
+
+  template <class Env>
+  auto get_completion_signatures(Env&& /*unused*/) const {
+    return _parallel_bulk_detail::bulk_signatures_t<S, Env, Policy, true>{};
+  }
+
+  template <receiver R>
+  auto connect(R&& r) && {
+    auto sched = _parallel_bulk_detail::bulk_scheduler_of(sender_);
+    return std::move(sender_).connect(_for_each_receiver<__decay_t<R>, decltype(sched)>{
+        std::move(view_), std::move(fun_), std::forward<R>(r), sched});
+  }
+
+  // An rvalue range is held in a move-only owning_view, so only the rvalue connect applies
+  template <receiver R>
+    requires std::copy_constructible<View>
+  auto connect(R&& r) & {
+    auto sched = _parallel_bulk_detail::bulk_scheduler_of(sender_);
+    return sender_.connect(
+        _for_each_receiver<__decay_t<R>, decltype(sched)>{view_, fun_, std::forward<R>(r), sched});
+  }
+
+  template <class Sndr = S>
+    requires requires(const Sndr& s) { get_completion_scheduler<set_value_t>(s); }
+  [[nodiscard]] auto query(get_completion_scheduler_t<set_value_t> /*unused*/) const noexcept {
+    return get_completion_scheduler<set_value_t>(sender_);
+  }
+
+ private:
+  template <class Rcvr, class Sched>
+  struct _for_each_receiver {
+    using receiver_concept = receiver_t;
+
+    View  view_;
+    F     fun_;
+    Rcvr  receiver_;
+    Sched sched_;
+
+    template <class... Args>
+    void set_value(Args&&... args) && noexcept {
+      _instrument_detail::mark_stage(receiver_, "for_each", stage_completion::value);
+      auto count = static_cast<std::size_t>(std::ranges::distance(view_));
+      _range_detail::run_over(
+          sched_, _parallel_bulk_detail::agents_for<Policy>(sched_), std::ranges::begin(view_),
+          count,
+          [fun = std::move(fun_)](auto& it, auto&... values) mutable {
+            std::invoke(fun, *it, values...);
+          },
+          std::move(receiver_), std::forward<Args>(args)...);
+    }
+
+    template <class E>
+    void set_error(E&& e) && noexcept {
+      _instrument_detail::mark_stage(receiver_, "for_each", stage_completion::error);
+      std::move(receiver_).set_error(std::forward<E>(e));
+    }
+
+    void set_stopped() && noexcept {
+      _instrument_detail::mark_stage(receiver_, "for_each", stage_completion::stopped);
+      std::move(receiver_).set_stopped();
+    }
+
+    auto get_env() const noexcept {
+      return flow::execution::get_env(receiver_);
+    }
+  };
+};
+
+// transform: *out++ = f(element, values...) for every element of the input range
+template <sender S, class Policy, std::ranges::view View, class Out, class F>
+struct _transform_sender {
+  using sender_concept = sender_t;
+  using value_types    = typename S::value_types;
+
+  S      sender_;
+  Policy policy_;
+  View   view_;
+  Out    out_;
+  F      fun_;
+
+  template <class Env>
+  auto get_completion_signatures(Env&& /*unused*/) const {
+    return _parallel_bulk_detail::bulk_signatures_t<S, Env, Policy, true>{};
+  }
+
+  template <receiver R>
+  auto connect(R&& r) && {
+    auto sched = _parallel_bulk_detail::bulk_scheduler_of(sender_);
+    return std::move(sender_).connect(_transform_receiver<__decay_t<R>, decltype(sched)>{
+        std::move(view_), std::move(out_), std::move(fun_), std::forward<R>(r), sched});
+  }
+
+  template <receiver R>
+    requires std::copy_constructible<View>
+  auto connect(R&& r) & {
+    auto sched = _parallel_bulk_detail::bulk_scheduler_of(sender_);
+    return sender_.connect(_transform_receiver<__decay_t<R>, decltype(sched)>{
+        view_, out_, fun_, std::forward<R>(r), sched});
+  }
+
+  template <class Sndr = S>
+    requires requires(const Sndr& s) { get_completion_scheduler<set_value_t>(s); }
+  [[nodiscard]] auto query(get_completion_scheduler_t<set_value_t> /*unused*/) const noexcept {
+    return get_completion_scheduler<set_value_t>(sender_);
+  }
+
+ private:
+  template <class Rcvr, class Sched>
+  struct _transform_receiver {
+    using receiver_concept = receiver_t;
+
+    View  view_;
+    Out   out_;
+    F     fun_;
+    Rcvr  receiver_;
+    Sched sched_;
+
+    template <class... Args>
+    void set_value(Args&&... args) && noexcept {
+      _instrument_detail::mark_stage(receiver_, "transform", stage_completion::value);
+      auto count = static_cast<std::size_t>(std::ranges::distance(view_));
+      _range_detail::run_over(
+          sched_, _parallel_bulk_detail::agents_for<Policy>(sched_),
+          std::pair{std::ranges::begin(view_), out_}, count,
+          [fun = std::move(fun_)](auto& cursor, auto&... values) mutable {
+            *cursor.second = std::invoke(fun, *cursor.first, values...);
+          },
+          std::move(receiver_), std::forward<Args>(args)...);
+    }
+
+    template <class E>
+    void set_error(E&& e) && noexcept {
+      _instrument_detail::mark_stage(receiver_, "transform", stage_completion::error);
+      std::move(receiver_).set_error(std::forward<E>(e));
+    }
+
+    void set_stopped() && noexcept {
+      _instrument_detail::mark_stage(receiver_, "transform", stage_completion::stopped);
+      std::move(receiver_).set_stopped();
+    }
+
+    auto get_env() const noexcept {
+      return flow::execution::get_env(receiver_);
+    }
+  };
+};
+
+// Pipeable version forward declarations
+template <class Policy, class View, class F>
+struct _pipeable_for_each;
+
+template <class Policy, class View, class Out, class F>
+struct _pipeable_transform;
+
+struct for_each_t {
+  template <sender S, class Policy, std::ranges::forward_range R, class F>
+    requires is_execution_policy_v<Policy> && std::ranges::viewable_range<R>
+  constexpr auto operator()(S&& s, Policy&& policy, R&& range, F&& f) const {
+    return _for_each_sender<__decay_t<S>, __decay_t<Policy>, std::views::all_t<R>, __decay_t<F>>{
+        std::forward<S>(s), std::forward<Policy>(policy), std::views::all(std::forward<R>(range)),
+        std::forward<F>(f)};
+  }
+
+  // Curried version for pipe syntax
+  template <class Policy, std::ranges::forward_range R, class F>
+    requires is_execution_policy_v<Policy> && std::ranges::viewable_range<R>
+  constexpr auto operator()(Policy&& policy, R&& range, F&& f) const {
+    return _pipeable_for_each<__decay_t<Policy>, std::views::all_t<R>, __decay_t<F>>{
+        std::forward<Policy>(policy), std::views::all(std::forward<R>(range)), std::forward<F>(f)};
+  }
+};
+
+// for_each_n: for_each over the `n` elements starting at `first`
+struct for_each_n_t {
+  template <sender S, class Policy, std::forward_iterator It, class F>
+    requires is_execution_policy_v<Policy>
+  constexpr auto operator()(S&& s, Policy&& policy, It first, std::iter_difference_t<It> n,
+                            F&& f) const {
+    return for_each_t{}(std::forward<S>(s), std::forward<Policy>(policy),
+                        std::views::counted(first, n), std::forward<F>(f));
+  }
+
+  // Curried version for pipe syntax
+  template <class Policy, std::forward_iterator It, class F>
+    requires is_execution_policy_v<Policy>
+  constexpr auto operator()(Policy&& policy, It first, std::iter_difference_t<It> n,
+                            F&& f) const {
+    return for_each_t{}(std::forward<Policy>(policy), std::views::counted(first, n),
+                        std::forward<F>(f));
+  }
+};
+
+// transform: `out` is an iterator or a range to write to, with room for every input element.
+// Writing in parallel needs a forward iterator (back_inserter and friends are not accepted).
+struct transform_t {
+  template <sender S, class Policy, std::ranges::forward_range R, class Out, class F>
+    requires is_execution_policy_v<Policy> && std::ranges::viewable_range<R>
+             && std::forward_iterator<_range_detail::output_iterator_t<Out>>
+  constexpr auto operator()(S&& s, Policy&& policy, R&& in, Out&& out, F&& f) const {
+    return _transform_sender<__decay_t<S>, __decay_t<Policy>, std::views::all_t<R>,
+                             _range_detail::output_iterator_t<Out>, __decay_t<F>>{
+        std::forward<S>(s), std::forward<Policy>(policy), std::views::all(std::forward<R>(in)),
+        _range_detail::output_iterator_of(std::forward<Out>(out)), std::forward<F>(f)};
+  }
+
+  // Curried version for pipe syntax
+  template <class Policy, std::ranges::forward_range R, class Out, class F>
+    requires is_execution_policy_v<Policy> && std::ranges::viewable_range<R>
+             && std::forward_iterator<_range_detail::output_iterator_t<Out>>
+  constexpr auto operator()(Policy&& policy, R&& in, Out&& out, F&& f) const {
+    return _pipeable_transform<__decay_t<Policy>, std::views::all_t<R>,
+                               _range_detail::output_iterator_t<Out>, __decay_t<F>>{
+        std::forward<Policy>(policy), std::views::all(std::forward<R>(in)),
+        _range_detail::output_iterator_of(std::forward<Out>(out)), std::forward<F>(f)};
+  }
+};
+
+inline constexpr for_each_t   for_each{};
+inline constexpr for_each_n_t for_each_n{};
+inline constexpr transform_t  transform{};
+
+// Pipeable versions
+template <class Policy, class View, class F>
+struct _pipeable_for_each {
+  Policy policy_;
+  View   view_;
+  F      fun_;
+
+  template <sender S>
+    requires std::copy_constructible<View>
+  friend auto operator|(S&& s, const _pipeable_for_each& p) {
+    return _for_each_sender<__decay_t<S>, Policy, View, F>{std::forward<S>(s), p.policy_, p.view_,
+                                                            p.fun_};
+  }
+
+  // A temporary range lives in a move-only owning_view and has to be moved into the sender
+  template <sender S>
+  friend auto operator|(S&& s, _pipeable_for_each&& p) {
+    return _for_each_sender<__decay_t<S>, Policy, View, F>{
+        std::forward<S>(s), std::move(p.policy_), std::move(p.view_), std::move(p.fun_)};
+  }
+};
+
+template <class Policy, class View, class Out, class F>
+struct _pipeable_transform {
+  Policy policy_;
+  View   view_;
+  Out    out_;
+  F      fun_;
+
+  template <sender S>
+    requires std::copy_constructible<View>
+  friend auto operator|(S&& s, const _pipeable_transform& p) {
+    return _transform_sender<__decay_t<S>, Policy, View, Out, F>{std::forward<S>(s), p.policy_,
+                                                                  p.view_, p.out_, p.fun_};
+  }
+
+  template <sender S>
+  friend auto operator|(S&& s, _pipeable_transform&& p) {
+    return _transform_sender<__decay_t<S>, Policy, View, Out, F>{
+        std::forward<S>(s), std::move(p.policy_), std::move(p.view_), std::move(p.out_),
+        std::move(p.fun_)};
+  }
+};
+
+}  // namespace flow::execution
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "../detail/mutex.hpp"
+
+namespace flow::execution {
+
+// Read-copy-update for read-mostly shared state
+//
+// An rcu_cell<T> holds the current version of a value (a routing table, a config snapshot).
+// Reading it is one acquire load of a pointer, which is a plain load on x86 and never writes
+// a shared cache line, unlike copying a shared_ptr. Updating publishes a new version and
+// retires the old one, which is freed once no reader can still hold it:
+//
+//   work_stealing_scheduler ws(8);
+//   rcu_cell<routes>        table(ws.get_rcu_domain(), load_routes());
+//
+//   schedule(ws.get_scheduler()) | then([&] { return table.read().lookup(key); })
+//   table.update([&](routes& r) { r.add(entry); });  // Copy, modify, publish
+//
+// Reclamation is quiescent-state based (QSBR). The scheduler's workers are the readers of the
+// domain: each worker reports a quiescent state between two tasks, so a reference returned by
+// read() stays valid until the task that called it returns, and must not be kept longer. An
+// update takes a new grace period number; once every worker has reported a quiescent state
+// (or is parked) after it, the versions retired before it are unreachable, and the domain
+// frees them from a background task on the scheduler rather than on the updating thread. A
+// worker stuck in a long task delays reclamation, never reads.
+//
+// Only tasks running on the domain's scheduler may call read(); other threads may update.
+
+// Header of an object waiting for a grace period; rcu_cell versions embed one, so retiring
+// never allocates
+struct rcu_retired {
+  rcu_retired*  next{nullptr};
+  std::uint64_t grace_period{0};
+  void (*destroy)(rcu_retired*) noexcept {nullptr};
+};
+
+// Quiescent state tracking for a fixed set of reader threads (a scheduler's workers)
+class rcu_domain {
+ public:
+  // Called when retired objects became reclaimable; expected to arrange for reclaim() to run
+  using reclaim_hook = void (*)(void* context) noexcept;
+
+  rcu_domain(std::size_t readers, reclaim_hook hook, void* context)
+      : readers_(std::make_unique<reader_slot[]>(readers)),
+        reader_count_(readers),
+        hook_(hook),
+        context_(context) {}
+
+  rcu_domain(const rcu_domain&)                    = delete;
+  auto operator=(const rcu_domain&) -> rcu_domain& = delete;
+
+  // Readers are gone by now: everything still retired is unreachable
+  ~rcu_domain() {
+    free_list(std::exchange(retired_head_, nullptr));
+  }
+
+  // Reader `reader` holds no reference obtained before this point. Between tasks this is one
+  // load of the grace period counter and one of the reader's own slot.
+  void quiescent(std::size_t reader) noexcept {
+    const std::uint64_t current = grace_period_.load(std::memory_order_acquire);
+    auto&               slot    = readers_[reader].seen;
+    if (slot.load(std::memory_order_relaxed) == current) {
+      return;
+    }
+    slot.store(current, std::memory_order_release);
+    maybe_reclaim();
+  }
+
+  // Reader `reader` stops reading (parks); grace periods no longer wait for it
+  void offline(std::size_t reader) noexcept {
+    readers_[reader].seen.store(offline_mark, std::memory_order_release);
+    maybe_reclaim();
+  }
+
+  // Reader `reader` resumes reading
+  void online(std::size_t reader) noexcept {
+    readers_[reader].seen.store(grace_period_.load(std::memory_order_acquire),
+                                std::memory_order_relaxed);
+    // Orders the store before the reads that follow against an updater scanning the slots
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+  // Free `r` once every reader has passed a quiescent state. The caller has already made `r`
+  // unreachable for new reads.
+  void retire(rcu_retired* r) noexcept {
+    {
+      std::scoped_lock lock(mutex_);
+      r->next         = nullptr;
+      r->grace_period = grace_period_.fetch_add(1, std::memory_order_acq_rel) + 1;
+      if (retired_tail_ != nullptr) {
+        retired_tail_->next = r;
+      } else {
+        retired_head_ = r;
+        oldest_.store(r->grace_period, std::memory_order_release);
+      }
+      retired_tail_ = r;
+      ++pending_;
+    }
+    maybe_reclaim();
+  }
+
+  // Free every retired object whose grace period has elapsed
+  void reclaim() noexcept {
+    reclaim_requested_.store(false, std::memory_order_seq_cst);
+    const std::uint64_t safe = completed_grace_period();
+
+    rcu_retired* ready = nullptr;
+    std::size_t  count = 0;
+    {
+      std::scoped_lock lock(mutex_);
+      rcu_retired*     last = nullptr;
+      for (rcu_retired* r = retired_head_; r != nullptr && r->grace_period <= safe; r = r->next) {
+        last = r;
+        ++count;
+      }
+      if (last != nullptr) {
+        ready         = retired_head_;
+        retired_head_ = std::exchange(last->next, nullptr);
+        if (retired_head_ == nullptr) {
+          retired_tail_ = nullptr;
+        }
+        oldest_.store(retired_head_ != nullptr ? retired_head_->grace_period : 0,
+                      std::memory_order_release);
+      }
+    }
+    free_list(ready);
+    if (count != 0) {
+      std::scoped_lock lock(mutex_);
+      pending_ -= count;
+      reclaimed_ += count;
+    }
+
+    // A reader that finished a grace period while this reclaim was already requested did not
+    // request another one
+    maybe_reclaim();
+  }
+
+  // Retired objects not freed yet
+  [[nodiscard]] auto pending() const -> std::size_t {
+    std::scoped_lock lock(mutex_);
+    return pending_;
+  }
+
+  // Retired objects freed so far
+  [[nodiscard]] auto reclaimed() const -> std::uint64_t {
+    std::scoped_lock lock(mutex_);
+    return reclaimed_;
+  }
+
+ private:
+  static constexpr std::uint64_t offline_mark = 0;  // Grace periods start at 1
+
+  // Padded so that a reader's reports never invalidate another reader's line
+  struct alignas(64) reader_slot {
+    std::atomic<std::uint64_t> seen{offline_mark};
+  };
+
+  // Newest grace period every online reader has passed
+  [[nodiscard]] auto completed_grace_period() const noexcept -> std::uint64_t {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::uint64_t completed = grace_period_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < reader_count_; ++i) {
+      const std::uint64_t seen = readers_[i].seen.load(std::memory_order_acquire);
+      if (seen != offline_mark && seen < completed) {
+        completed = seen;
+      }
+    }
+    return completed;
+  }
+
+  // Request a reclaim when the oldest retired object has become unreachable
+  void maybe_reclaim() noexcept {
+    const std::uint64_t oldest = oldest_.load(std::memory_order_acquire);
+    if (oldest == 0 || completed_grace_period() < oldest) {
+      return;
+    }
+    if (!reclaim_requested_.exchange(true, std::memory_order_seq_cst)) {
+      hook_(context_);
+    }
+  }
+
+  static void free_list(rcu_retired* r) noexcept {
+    while (r != nullptr) {
+      r->destroy(std::exchange(r, r->next));
+    }
+  }
+
+  std::unique_ptr<reader_slot[]> readers_;
+  std::size_t                    reader_count_;
+  reclaim_hook                   hook_;
+  void*                          context_;
+
+  alignas(64) std::atomic<std::uint64_t> grace_period_{1};
+  std::atomic<std::uint64_t>             oldest_{0};  // Grace period of the list head, 0 if empty
+  std::atomic<bool>                      reclaim_requested_{false};
+
+  mutable detail::mutex mutex_{"rcu_domain::retired"};
+  rcu_retired*          retired_head_{nullptr};  // In grace period order
+  rcu_retired*          retired_tail_{nullptr};
+  std::size_t           pending_{0};
+  std::uint64_t         reclaimed_{0};
+};
+
+namespace _rcu_detail {
+
+template <class T>
+struct version : rcu_retired {
+  T value;
+
+  template <class... Args>
+  explicit version(Args&&... args) : value(std::forward<Args>(args)...) {
+    destroy = [](rcu_retired* r) noexcept { delete static_cast<version*>(r); };
+  }
+};
+
+}  // namespace _rcu_detail
+
+template <class T>
+class rcu_cell {
+ public:
+  template <class... Args>
+  explicit rcu_cell(rcu_domain& domain, Args&&... args)
+      : domain_(&domain), current_(new version(std::forward<Args>(args)...)) {}
+
+  rcu_cell(const rcu_cell&)                    = delete;
+  auto operator=(const rcu_cell&) -> rcu_cell& = delete;
+
+  // No reader may still be using the current version
+  ~rcu_cell() {
+    delete current_.load(std::memory_order_relaxed);
+  }
+
+  // The current version; valid until the calling task returns
+  [[nodiscard]] auto read() const noexcept -> const T& {
+    return current_.load(std::memory_order_acquire)->value;
+  }
+
+  // Publish a version constructed from `args`
+  template <class... Args>
+  void emplace(Args&&... args) {
+    auto             next = std::make_unique<version>(std::forward<Args>(args)...);
+    std::scoped_lock lock(update_mutex_);
+    publish(next.release());
+  }
+
+  void store(T value) {
+    emplace(std::move(value));
+  }
+
+  // Publish a copy of the current version modified by f(T&). Updates are serialized, so none
+  // of them is lost, and the version being copied cannot be retired under the copy.
+  template <class F>
+  void update(F&& f) {
+    std::scoped_lock lock(update_mutex_);
+    auto next = std::make_unique<version>(current_.load(std::memory_order_acquire)->value);
+    std::forward<F>(f)(next->value);
+    publish(next.release());
+  }
+
+ private:
+  using version = _rcu_detail::version<T>;
+
+  void publish(version* next) noexcept {
+    version* previous = current_.exchange(next, std::memory_order_acq_rel);
+    domain_->retire(previous);
+  }
+
+  rcu_domain*           domain_;
+  std::atomic<version*> current_;
+  detail::mutex         update_mutex_{"rcu_cell::update"};
+};
+
+}  // namespace flow::execution
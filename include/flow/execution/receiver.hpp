@@ -1,6 +1,7 @@
 #pragma once
 
 #include <concepts>
+#include <exception>
 #include <utility>
 
 #include "utils.hpp"
@@ -33,4 +34,20 @@ inline constexpr set_value_t   set_value{};
 inline constexpr set_error_t   set_error{};
 inline constexpr set_stopped_t set_stopped{};
 
+// Completes `rcvr` with set_value. Completion functions are noexcept for every receiver_of,
+// which then pays for no handler; a set_value that may throw has its exception reported
+// through set_error instead.
+template <class Rcvr, class... Args>
+void __set_value_or_error(Rcvr&& rcvr, Args&&... args) noexcept {
+  if constexpr (noexcept(std::forward<Rcvr>(rcvr).set_value(std::forward<Args>(args)...))) {
+    std::forward<Rcvr>(rcvr).set_value(std::forward<Args>(args)...);
+  } else {
+    try {
+      std::forward<Rcvr>(rcvr).set_value(std::forward<Args>(args)...);
+    } catch (...) {
+      std::forward<Rcvr>(rcvr).set_error(std::current_exception());
+    }
+  }
+}
+
 }  // namespace flow::execution
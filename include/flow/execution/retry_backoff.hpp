@@ -4,9 +4,9 @@
 #include <cstddef>
 #include <exception>
 #include <memory>
-#include <mutex>
 #include <thread>
 
+#include "../detail/mutex.hpp"
 #include "operation_state.hpp"
 #include "receiver.hpp"
 #include "scheduler.hpp"
@@ -42,7 +42,7 @@ struct _retry_with_backoff_state {
   std::unique_ptr<void, void (*)(void*)> nested_op_;
 
   // Thread safety: protects nested_op_, retrying_ flag, current_attempt_, and current_delay_
-  std::mutex mutex_;
+  detail::mutex mutex_{"retry_with_backoff"};
 
   // Reentry guard: prevents nested retry() calls when operation completes synchronously
   bool retrying_ = false;
@@ -66,7 +66,7 @@ struct _retry_with_backoff_state {
 
   template <class E>
   void retry_with_delay(E&& e) {
-    std::unique_lock<std::mutex> lock(mutex_);
+    detail::unique_lock lock(mutex_);
     ++current_attempt_;
     if (current_attempt_ >= max_attempts_) {
       // Max attempts reached
@@ -99,7 +99,7 @@ struct _retry_with_backoff_state {
     using op_t = decltype(sender_.connect(std::declval<_retry_with_backoff_receiver<S, R, Sch>>()));
 
     // Lock to prevent race conditions when operations complete on different threads
-    std::unique_lock<std::mutex> lock(mutex_);
+    detail::unique_lock lock(mutex_);
 
     // Prevent nested retry() calls (synchronous completion during start())
     if (retrying_) {
@@ -2,8 +2,8 @@
 
 #include <exception>
 #include <memory>
-#include <mutex>
 
+#include "../detail/mutex.hpp"
 #include "operation_state.hpp"
 #include "receiver.hpp"
 #include "sender.hpp"
@@ -61,7 +61,7 @@ struct _retry_state {
   std::unique_ptr<void, void (*)(void*)> nested_op_;
 
   // Thread safety: protects nested_op_ and retrying_ flag
-  std::mutex mutex_;
+  detail::mutex mutex_{"retry"};
 
   // Reentry guard: prevents nested retry() calls when operation completes synchronously
   bool retrying_ = false;
@@ -79,7 +79,7 @@ struct _retry_state {
     using op_t = decltype(sender_.connect(std::declval<_retry_receiver<S, R>>()));
 
     // Lock to prevent race conditions when operations complete on different threads
-    std::unique_lock<std::mutex> lock(mutex_);
+    detail::unique_lock lock(mutex_);
 
     // Prevent nested retry() calls (synchronous completion during start())
     if (retrying_) {
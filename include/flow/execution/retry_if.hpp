@@ -3,9 +3,9 @@
 #include <concepts>
 #include <exception>
 #include <memory>
-#include <mutex>
 #include <type_traits>
 
+#include "../detail/mutex.hpp"
 #include "operation_state.hpp"
 #include "receiver.hpp"
 #include "sender.hpp"
@@ -34,7 +34,7 @@ struct _retry_if_state {
   std::unique_ptr<void, void (*)(void*)> nested_op_;
 
   // Thread safety: protects nested_op_ and retrying_ flag
-  std::mutex mutex_;
+  detail::mutex mutex_{"retry_if"};
 
   // Reentry guard: prevents nested retry() calls when operation completes synchronously
   bool retrying_ = false;
@@ -77,7 +77,7 @@ struct _retry_if_state {
     using op_t = decltype(sender_.connect(std::declval<_retry_if_receiver<S, R, Pred>>()));
 
     // Lock to prevent race conditions when operations complete on different threads
-    std::unique_lock<std::mutex> lock(mutex_);
+    detail::unique_lock lock(mutex_);
 
     // Prevent nested retry() calls (synchronous completion during start())
     if (retrying_) {
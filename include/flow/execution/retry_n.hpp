@@ -3,8 +3,8 @@
 #include <cstddef>
 #include <exception>
 #include <memory>
-#include <mutex>
 
+#include "../detail/mutex.hpp"
 #include "operation_state.hpp"
 #include "receiver.hpp"
 #include "sender.hpp"
@@ -34,7 +34,7 @@ struct _retry_n_state {
   std::unique_ptr<void, void (*)(void*)> nested_op_;
 
   // Thread safety: protects nested_op_, retrying_ flag, and current_attempt_
-  std::mutex mutex_;
+  detail::mutex mutex_{"retry_n"};
 
   // Reentry guard: prevents nested retry() calls when operation completes synchronously
   bool retrying_ = false;
@@ -51,7 +51,7 @@ struct _retry_n_state {
 
   template <class E>
   void retry_or_fail(E&& e) {
-    std::unique_lock<std::mutex> lock(mutex_);
+    detail::unique_lock lock(mutex_);
     ++current_attempt_;
     if (current_attempt_ >= max_attempts_) {
       // Max attempts reached
@@ -72,7 +72,7 @@ struct _retry_n_state {
     using op_t = decltype(sender_.connect(std::declval<_retry_n_receiver<S, R>>()));
 
     // Lock to prevent race conditions when operations complete on different threads
-    std::unique_lock<std::mutex> lock(mutex_);
+    detail::unique_lock lock(mutex_);
 
     // Prevent nested retry() calls (synchronous completion during start())
     if (retrying_) {
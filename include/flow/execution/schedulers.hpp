@@ -1,17 +1,19 @@
 #pragma once
 
 #include <atomic>
-#include <condition_variable>
 #include <exception>
 #include <functional>
-#include <mutex>
+#include <optional>
 #include <queue>
 #include <thread>
 
+#include "../detail/mutex.hpp"
+#include "admission_control.hpp"
 #include "completion_signatures.hpp"
 #include "lock_free_queue.hpp"
 #include "queries.hpp"
 #include "scheduler.hpp"
+#include "trace.hpp"
 #include "try_scheduler.hpp"
 #include "type_list.hpp"
 #include "work_stealing_scheduler.hpp"
@@ -200,20 +202,29 @@ class run_loop {
     while (!stop_.load(std::memory_order_acquire)) {
       // First try lock-free queue (non-blocking)
       if (auto task = lock_free_queue_.try_pop()) {
+        FLOW_TRACE_EVENT(start, run_loop, 0);
         (*task)();
+        FLOW_TRACE_EVENT(finish, run_loop, 0);
         continue;
       }
 
       // Then wait on regular queue
-      std::unique_lock lock(mutex_);
-      cv_.wait(lock,
-               [this] -> bool { return !queue_.empty() || stop_.load(std::memory_order_relaxed); });
+      detail::unique_lock lock(mutex_);
+      if (queue_.empty() && !stop_.load(std::memory_order_relaxed)) {
+        FLOW_TRACE_EVENT(park, run_loop, 0);
+        cv_.wait(lock, [this] -> bool {
+          return !queue_.empty() || stop_.load(std::memory_order_relaxed);
+        });
+        FLOW_TRACE_EVENT(unpark, run_loop, 0);
+      }
 
       if (stop_.load(std::memory_order_relaxed) && queue_.empty()) {
         // Check lock-free queue one more time before exiting
         if (auto task = lock_free_queue_.try_pop()) {
           lock.unlock();
+          FLOW_TRACE_EVENT(start, run_loop, 0);
           (*task)();
+          FLOW_TRACE_EVENT(finish, run_loop, 0);
           continue;
         }
         break;
@@ -223,7 +234,9 @@ class run_loop {
         auto task = std::move(queue_.front());
         queue_.pop();
         lock.unlock();
+        FLOW_TRACE_EVENT(start, run_loop, 0);
         task();
+        FLOW_TRACE_EVENT(finish, run_loop, 0);
       }
     }
   }
@@ -241,6 +254,7 @@ class run_loop {
       std::scoped_lock lock(mutex_);
       queue_.push(std::move(task));
     }
+    FLOW_TRACE_EVENT(enqueue, run_loop, 0);
     cv_.notify_one();
   }
 
@@ -250,6 +264,7 @@ class run_loop {
     try {
       // Try to push to lock-free queue without blocking
       if (lock_free_queue_.try_push(std::move(task))) {
+        FLOW_TRACE_EVENT(enqueue, run_loop, 0);
         cv_.notify_one();
         return true;
       }
@@ -266,8 +281,8 @@ class run_loop {
 
   std::queue<std::function<void()>>                    queue_;
   lock_free_bounded_queue<std::function<void()>, 1024> lock_free_queue_;
-  std::mutex                                           mutex_;
-  std::condition_variable                              cv_;
+  detail::mutex                                        mutex_{"run_loop"};
+  detail::condition_variable                           cv_;
   std::atomic<bool>                                    stop_;
 };
 
@@ -275,10 +290,13 @@ class run_loop {
 class thread_pool {
  public:
   explicit thread_pool(std::size_t num_threads = std::thread::hardware_concurrency()) {
-    workers_.reserve(num_threads);
-    for (std::size_t i = 0; i < num_threads; ++i) {
-      workers_.emplace_back([this] -> void { worker_thread(); });
-    }
+    start_workers(num_threads);
+  }
+
+  // Thread pool with queue-delay admission control (admission_control.hpp)
+  thread_pool(std::size_t num_threads, codel_options admission) {
+    codel_.emplace(admission);
+    start_workers(num_threads);
   }
 
   ~thread_pool() {
@@ -317,6 +335,10 @@ class thread_pool {
       return forward_progress_guarantee::parallel;
     }
 
+    [[nodiscard]] auto query(get_parallelism_t /*unused*/) const noexcept -> std::size_t {
+      return pool_->workers_.size();
+    }
+
     auto operator==(const thread_pool_scheduler& other) const noexcept -> bool {
       return pool_ == other.pool_;
     }
@@ -332,6 +354,7 @@ class thread_pool {
 
       template <class Env>
       auto get_completion_signatures(Env&& /*unused*/) const noexcept {
+        // exception_ptr only carries an admission control rejection (overloaded_t)
         return completion_signatures<set_value_t(), set_error_t(std::exception_ptr)>{};
       }
 
@@ -353,21 +376,24 @@ class thread_pool {
       struct _operation {
         using operation_state_concept = operation_state_t;
 
-        thread_pool*      pool_{};
-        Rcvr              receiver_;
-        std::atomic<bool> started_{false};
+        thread_pool*                 pool_{};
+        Rcvr                         receiver_;
+        std::atomic<bool>            started_{false};
+        codel_controller::time_point enqueued_{};
 
         void start() & noexcept {
           if (started_.exchange(true, std::memory_order_relaxed)) {
             return;
           }
+          if (pool_->rejects_schedule() && !pool_->admit()) {
+            std::move(receiver_).set_error(std::make_exception_ptr(overloaded_t{}));
+            return;
+          }
 
+          enqueued_ = pool_->enqueue_stamp();
           pool_->submit([this] -> auto {
-            try {
-              std::move(receiver_).set_value();
-            } catch (...) {
-              std::move(receiver_).set_error(std::current_exception());
-            }
+            pool_->on_dequeue(enqueued_);
+            __set_value_or_error(std::move(receiver_));
           });
         }
       };
@@ -381,8 +407,7 @@ class thread_pool {
 
       template <class Env>
       auto get_completion_signatures(Env&& /*unused*/) const noexcept {
-        return completion_signatures<set_value_t(), set_error_t(would_block_t),
-                                     set_error_t(std::exception_ptr)>{};
+        return completion_signatures<set_value_t(), set_error_t(would_block_t)>{};
       }
 
       template <receiver R>
@@ -403,21 +428,25 @@ class thread_pool {
       struct _try_operation {
         using operation_state_concept = operation_state_t;
 
-        thread_pool*      pool_{};
-        Rcvr              receiver_;
-        std::atomic<bool> started_{false};
+        thread_pool*                 pool_{};
+        Rcvr                         receiver_;
+        std::atomic<bool>            started_{false};
+        codel_controller::time_point enqueued_{};
 
         void start() & noexcept {
           if (started_.exchange(true, std::memory_order_relaxed)) {
             return;
           }
+          // Fail fast while queued work is waiting longer than the admission target
+          if (!pool_->admit()) {
+            std::move(receiver_).set_error(would_block_t{});
+            return;
+          }
 
+          enqueued_      = pool_->enqueue_stamp();
           bool submitted = pool_->try_submit([this] -> auto {
-            try {
-              std::move(receiver_).set_value();
-            } catch (...) {
-              std::move(receiver_).set_error(std::current_exception());
-            }
+            pool_->on_dequeue(enqueued_);
+            __set_value_or_error(std::move(receiver_));
           });
 
           if (submitted) {
@@ -435,9 +464,40 @@ class thread_pool {
     return thread_pool_scheduler{this};
   }
 
+  // State of the admission controller; all zero when the pool has none
+  [[nodiscard]] auto admission_stats() const noexcept -> codel_stats {
+    return codel_ ? codel_->stats() : codel_stats{};
+  }
+
  private:
   friend class thread_pool_scheduler;
 
+  void start_workers(std::size_t num_threads) {
+    workers_.reserve(num_threads);
+    for (std::size_t i = 0; i < num_threads; ++i) {
+      workers_.emplace_back([this] -> void { worker_thread(); });
+    }
+  }
+
+  // Admission control hooks, no-ops without a controller
+  auto admit() noexcept -> bool {
+    return !codel_ || codel_->admit();
+  }
+
+  [[nodiscard]] auto rejects_schedule() const noexcept -> bool {
+    return codel_ && codel_->rejects_schedule();
+  }
+
+  [[nodiscard]] auto enqueue_stamp() const noexcept -> codel_controller::time_point {
+    return codel_ ? codel_controller::clock::now() : codel_controller::time_point{};
+  }
+
+  void on_dequeue(codel_controller::time_point enqueued) noexcept {
+    if (codel_) {
+      codel_->on_dequeue(enqueued);
+    }
+  }
+
   void submit(std::function<void()> task) {
     {
       std::scoped_lock lock(mutex_);
@@ -446,6 +506,7 @@ class thread_pool {
       }
       queue_.push(std::move(task));
     }
+    FLOW_TRACE_EVENT(enqueue, thread_pool, 0);
     cv_.notify_one();
   }
 
@@ -456,6 +517,7 @@ class thread_pool {
       // Try to push to lock-free queue without blocking
       if (lock_free_queue_.try_push(std::move(task))) {
         lock_free_has_work_.store(true, std::memory_order_release);
+        FLOW_TRACE_EVENT(enqueue, thread_pool, 0);
         cv_.notify_one();
         return true;
       }
@@ -467,30 +529,41 @@ class thread_pool {
   }
 
   void worker_thread() {
+    FLOW_TRACE_THREAD_NAME("thread_pool worker");
+
     while (true) {
       // First try lock-free queue (non-blocking)
       if (auto task = lock_free_queue_.try_pop()) {
         lock_free_has_work_.store(false, std::memory_order_relaxed);
+        FLOW_TRACE_EVENT(start, thread_pool, 0);
         (*task)();
+        FLOW_TRACE_EVENT(finish, thread_pool, 0);
         continue;
       }
 
       std::function<void()> task;
 
       {
-        std::unique_lock lock(mutex_);
+        detail::unique_lock lock(mutex_);
 
         // Wait if both queues appear empty
-        cv_.wait(lock, [this] -> bool {
+        auto ready = [this] -> bool {
           // Wake up if stop flag is set, regular queue has items, OR lock-free queue might have
           // work
           return stop_ || !queue_.empty() || lock_free_has_work_.load(std::memory_order_acquire);
-        });
+        };
+        if (!ready()) {
+          FLOW_TRACE_EVENT(park, thread_pool, 0);
+          cv_.wait(lock, ready);
+          FLOW_TRACE_EVENT(unpark, thread_pool, 0);
+        }
 
         if (stop_ && queue_.empty()) {
           // Check lock-free queue one more time before exiting
           if (auto final_task = lock_free_queue_.try_pop()) {
+            FLOW_TRACE_EVENT(start, thread_pool, 0);
             (*final_task)();
+            FLOW_TRACE_EVENT(finish, thread_pool, 0);
           }
           return;
         }
@@ -502,7 +575,9 @@ class thread_pool {
       }
 
       if (task) {
+        FLOW_TRACE_EVENT(start, thread_pool, 0);
         task();
+        FLOW_TRACE_EVENT(finish, thread_pool, 0);
       }
       // If no task from regular queue, loop back to check lock-free queue
     }
@@ -511,10 +586,11 @@ class thread_pool {
   lock_free_bounded_queue<std::function<void()>, 1024> lock_free_queue_;
   std::vector<std::thread>                             workers_;
   std::queue<std::function<void()>>                    queue_;
-  std::condition_variable                              cv_;
-  std::mutex                                           mutex_;
+  detail::condition_variable                           cv_;
+  detail::mutex                                        mutex_{"thread_pool"};
   std::atomic<bool>                                    lock_free_has_work_{false};
   bool                                                 stop_{false};
+  std::optional<codel_controller>                      codel_;
 };
 
 }  // namespace flow::execution
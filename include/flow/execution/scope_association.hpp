@@ -11,9 +11,11 @@
 
 #include "completion_signatures.hpp"
 #include "env.hpp"
+#include "queries.hpp"
 #include "receiver.hpp"
 #include "scope_concepts.hpp"
 #include "sender.hpp"
+#include "spawn_slab.hpp"
 #include "utils.hpp"
 
 namespace flow::execution {
@@ -175,20 +177,134 @@ struct spawn_receiver {
   }
 };
 
+namespace __async_scope {
+
+template <class Token>
+auto spawn_slots_of(const Token& token) noexcept -> _spawn_slab_detail::slot_pool* {
+  if constexpr (requires {
+                  { token.spawn_slots() } -> std::same_as<_spawn_slab_detail::slot_pool*>;
+                }) {
+    return token.spawn_slots();
+  } else {
+    return nullptr;
+  }
+}
+
+// Operation state of a spawned sender. It lives in a slot of the scope's slab or in memory
+// from the environment's allocator, and frees itself when the sender completes; only then is
+// the association with the scope released, so a joined scope has all its slots back.
+template <class Sndr, class Token, class Env>
+class spawn_operation {
+ public:
+  using allocator_type = typename std::allocator_traits<__decay_t<decltype(get_allocator(
+      std::declval<const Env&>()))>>::template rebind_alloc<spawn_operation>;
+  using allocator_traits = std::allocator_traits<allocator_type>;
+
+  // Places the operation in a free slot if it fits one, otherwise allocates it
+  static auto make(Sndr&& sndr, Token token, Env env) -> spawn_operation* {
+    auto* slots = spawn_slots_of(token);
+    if (void* slot = slots != nullptr
+                         ? slots->allocate(sizeof(spawn_operation), alignof(spawn_operation))
+                         : nullptr) {
+      try {
+        return ::new (slot)
+            spawn_operation(std::forward<Sndr>(sndr), token, std::move(env), slots);
+      } catch (...) {
+        slots->deallocate(slot);
+        throw;
+      }
+    }
+
+    allocator_type alloc(get_allocator(env));
+    auto*          p = allocator_traits::allocate(alloc, 1);
+    try {
+      return ::new (static_cast<void*>(p))
+          spawn_operation(std::forward<Sndr>(sndr), token, std::move(env), nullptr);
+    } catch (...) {
+      allocator_traits::deallocate(alloc, p, 1);
+      throw;
+    }
+  }
+
+  void start() noexcept {
+    op_.start();
+  }
+
+ private:
+  struct receiver {
+    using receiver_concept = receiver_t;
+
+    spawn_operation* op_;
+
+    template <class... Args>
+    void set_value(Args&&... /*unused*/) && noexcept {
+      op_->complete();
+    }
+
+    template <class E>
+    void set_error(E&& /*unused*/) && noexcept {
+      op_->complete();
+    }
+
+    void set_stopped() && noexcept {
+      op_->complete();
+    }
+
+    auto get_env() const noexcept -> Env {
+      return op_->env_;
+    }
+  };
+
+  using op_t = decltype(std::declval<const Token&>().wrap(std::declval<Sndr>()).connect(
+      std::declval<receiver>()));
+
+  spawn_operation(Sndr&& sndr, Token token, Env env, _spawn_slab_detail::slot_pool* slots)
+      : token_(token),
+        env_(std::move(env)),
+        slots_(slots),
+        op_(token_.wrap(std::forward<Sndr>(sndr)).connect(receiver{this})) {}
+
+  void complete() noexcept {
+    Token token = token_;
+    if (auto* slots = slots_) {
+      std::destroy_at(this);
+      slots->deallocate(this);
+    } else {
+      allocator_type alloc(get_allocator(env_));
+      std::destroy_at(this);
+      allocator_traits::deallocate(alloc, this, 1);
+    }
+    token.disassociate();
+  }
+
+  Token                          token_;
+  Env                            env_;
+  _spawn_slab_detail::slot_pool* slots_;
+  op_t                           op_;
+};
+
+}  // namespace __async_scope
+
 struct spawn_t {
   template <sender Sndr, scope_token Token>
   void operator()(Sndr&& sndr, Token token) const {
-    auto associated = associate(std::forward<Sndr>(sndr), token);
-    auto op         = flow::execution::connect(std::move(associated), spawn_receiver{});
-    op.start();
+    (*this)(std::forward<Sndr>(sndr), token, empty_env{});
   }
 
   template <sender Sndr, scope_token Token, class Env>
   void operator()(Sndr&& sndr, Token token, Env&& env) const {
-    (void)env;  // Suppress unused warning for now
-    auto associated = associate(std::forward<Sndr>(sndr), token);
-    auto op         = flow::execution::connect(std::move(associated), spawn_receiver{});
-    op.start();
+    using op_t = __async_scope::spawn_operation<Sndr, Token, __decay_t<Env>>;
+    if (!token.try_associate()) {
+      return;
+    }
+    op_t* op = nullptr;
+    try {
+      op = op_t::make(std::forward<Sndr>(sndr), token, std::forward<Env>(env));
+    } catch (...) {
+      token.disassociate();
+      throw;
+    }
+    op->start();
   }
 };
 
@@ -0,0 +1,470 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../detail/mutex.hpp"
+#include "../detail/waiter_stack.hpp"
+#include "completion_signatures.hpp"
+#include "env.hpp"
+#include "operation_state.hpp"
+#include "receiver.hpp"
+#include "sender.hpp"
+#include "type_list.hpp"
+#include "utils.hpp"
+
+namespace flow::execution {
+
+// Request coalescing
+//
+// singleflight<Key, Value> deduplicates concurrent lookups of the same key:
+//
+//   singleflight<std::string, profile> profiles({.ttl = 2s});
+//   profiles.get(user_id, [&](const std::string& id) { return backend.load(id); })
+//
+// The first get() of a key calls `factory(key)` and starts the returned sender (the "flight");
+// every get() of that key while the flight is running attaches to it and receives a copy of
+// its result. Keys are spread over independently locked shards. A flight's waiters are
+// intrusive nodes (the get() operation states) on a lock-free stack, so attaching allocates
+// nothing; the flight itself is one allocation per lookup, shared by all of its waiters.
+//
+// With a non-zero ttl a successful result is kept for that long and later get()s complete
+// with it immediately. Errors and set_stopped are delivered to the flight's waiters but never
+// cached. An expired result is dropped when its key is looked up again, and a shard sweeps
+// all of its expired results whenever its cache has doubled since the last sweep, so keys
+// that are never asked for again do not accumulate. The flight runs without a stop token,
+// since it is shared: a waiter cannot be cancelled, and the singleflight must outlive every
+// get() operation.
+
+struct singleflight_options {
+  std::chrono::steady_clock::duration ttl{0};     // How long a result is cached; zero disables
+  std::size_t                         shards{0};  // Map shards; zero: one per hardware thread
+};
+
+struct singleflight_stats {
+  std::uint64_t flights{0};    // Lookups started by a factory
+  std::uint64_t coalesced{0};  // get()s that attached to a running flight
+  std::uint64_t hits{0};       // get()s served from the result cache
+  std::uint64_t expired{0};    // Cached results dropped after their ttl
+};
+
+namespace _singleflight_detail {
+
+using detail::resume_all;
+using detail::waiter;
+
+enum class outcome : unsigned char { value, error, stopped };
+
+// Shared state of one in-flight lookup. References are held by the shard map entry and by
+// each attached get() operation.
+template <class Value>
+struct flight_base {
+  flight_base()                                      = default;
+  flight_base(const flight_base&)                    = delete;
+  auto operator=(const flight_base&) -> flight_base& = delete;
+  virtual ~flight_base()                             = default;
+
+  // Connects and starts the factory's sender
+  virtual void start() noexcept = 0;
+
+  // Links `w`; resumes it right away if the result is already published
+  void attach(waiter* w) noexcept {
+    waiter* head = waiters.load(std::memory_order_acquire);
+    do {
+      if (head == &published) {
+        w->resume(w);
+        return;
+      }
+      w->next = head;
+    } while (!waiters.compare_exchange_weak(head, w, std::memory_order_acq_rel,
+                                            std::memory_order_acquire));
+  }
+
+  // Makes the result visible and resumes every attached waiter in arrival order
+  void publish() noexcept {
+    resume_all(waiters.exchange(&published, std::memory_order_acq_rel));
+  }
+
+  void acquire() noexcept {
+    refs.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void release() noexcept {
+    if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+  std::atomic<std::size_t> refs{1};  // The shard map's reference
+  std::atomic<waiter*>     waiters{nullptr};
+  waiter                   published{};  // Address marks the published result
+  outcome                  kind{outcome::stopped};
+  std::optional<Value>     value;
+  std::exception_ptr       error;
+};
+
+inline auto default_shard_count() noexcept -> std::size_t {
+  return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+template <class Owner, class Factory>
+class flight;
+
+template <class Owner, class Factory, class Rcvr>
+class _get_operation;
+
+template <class Owner, class Factory>
+struct _get_sender;
+
+}  // namespace _singleflight_detail
+
+template <class Key, class Value, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class singleflight {
+  static_assert(std::is_copy_constructible_v<Value>,
+                "every waiter of a flight receives its own copy of the result");
+
+  using flight_base = _singleflight_detail::flight_base<Value>;
+  using clock       = std::chrono::steady_clock;
+
+  struct cached {
+    Value             value;
+    clock::time_point expires;
+  };
+
+  // Cache size below which a shard never sweeps
+  static constexpr std::size_t min_sweep = 16;
+
+  struct alignas(64) shard {
+    detail::mutex                                         mutex{"singleflight::shard"};
+    std::unordered_map<Key, flight_base*, Hash, KeyEqual> flights;
+    std::unordered_map<Key, cached, Hash, KeyEqual>       cache;
+    std::size_t                                           sweep_at{min_sweep};
+  };
+
+ public:
+  using key_type   = Key;
+  using value_type = Value;
+
+  explicit singleflight(singleflight_options options = {})
+      : ttl_(options.ttl),
+        shards_(options.shards > 0 ? options.shards
+                                   : _singleflight_detail::default_shard_count()) {}
+
+  singleflight(const singleflight&)                    = delete;
+  auto operator=(const singleflight&) -> singleflight& = delete;
+
+  // No get() may be pending
+  ~singleflight() = default;
+
+  // Sends the value for `key`: from the cache, from the running flight for `key`, or from a
+  // new flight started with `factory(key)`
+  template <class Factory>
+    requires std::invocable<Factory&, const Key&>
+             && sender<std::invoke_result_t<Factory&, const Key&>>
+  [[nodiscard]] auto get(Key key, Factory factory) {
+    return _singleflight_detail::_get_sender<singleflight, __decay_t<Factory>>{
+        this, std::move(key), std::move(factory)};
+  }
+
+  // Drops the cached result for `key`; a running flight is not affected
+  void invalidate(const Key& key) {
+    shard&           s = shard_of(key);
+    std::scoped_lock lock(s.mutex);
+    s.cache.erase(key);
+  }
+
+  [[nodiscard]] auto stats() const noexcept -> singleflight_stats {
+    singleflight_stats st;
+    st.flights   = flights_.load(std::memory_order_relaxed);
+    st.coalesced = coalesced_.load(std::memory_order_relaxed);
+    st.hits      = hits_.load(std::memory_order_relaxed);
+    st.expired   = expired_.load(std::memory_order_relaxed);
+    return st;
+  }
+
+ private:
+  template <class, class>
+  friend class _singleflight_detail::flight;
+
+  template <class, class, class>
+  friend class _singleflight_detail::_get_operation;
+
+  // Result of looking a key up: a cached value, or a referenced flight (started by us if
+  // `leader`)
+  struct lookup {
+    std::optional<Value> hit{};
+    flight_base*         flight{nullptr};
+    bool                 leader{false};
+  };
+
+  template <class Factory>
+  auto find_or_start(const Key& key, Factory& factory) -> lookup {
+    shard&           s = shard_of(key);
+    std::scoped_lock lock(s.mutex);
+    if (auto it = s.cache.find(key); it != s.cache.end()) {
+      if (clock::now() < it->second.expires) {
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return {.hit = it->second.value};
+      }
+      s.cache.erase(it);
+      expired_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (auto it = s.flights.find(key); it != s.flights.end()) {
+      it->second->acquire();
+      coalesced_.fetch_add(1, std::memory_order_relaxed);
+      return {.flight = it->second};
+    }
+
+    auto* f = new _singleflight_detail::flight<singleflight, Factory>(this, key, factory);
+    try {
+      s.flights.emplace(key, f);
+    } catch (...) {
+      delete f;
+      throw;
+    }
+    f->acquire();  // The leader's own reference
+    flights_.fetch_add(1, std::memory_order_relaxed);
+    return {.flight = f, .leader = true};
+  }
+
+  // The flight for `key` completed: forget it and cache a value
+  void retire(const Key& key, flight_base* f) noexcept {
+    shard&           s = shard_of(key);
+    std::scoped_lock lock(s.mutex);
+    if (auto it = s.flights.find(key); it != s.flights.end() && it->second == f) {
+      s.flights.erase(it);
+    }
+    if (ttl_ > clock::duration::zero() && f->kind == _singleflight_detail::outcome::value) {
+      const auto now = clock::now();
+      if (s.cache.size() >= s.sweep_at) {
+        sweep(s, now);
+      }
+      try {
+        s.cache.insert_or_assign(key, cached{*f->value, now + ttl_});
+      } catch (...) {
+        // Caching is best effort
+      }
+    }
+  }
+
+  // Drops the expired results of `s`; the next sweep waits until the cache has doubled, so
+  // sweeping costs O(1) amortized per insertion
+  void sweep(shard& s, clock::time_point now) noexcept {
+    const auto dropped =
+        std::erase_if(s.cache, [now](const auto& entry) { return entry.second.expires <= now; });
+    expired_.fetch_add(dropped, std::memory_order_relaxed);
+    s.sweep_at = std::max(min_sweep, 2 * s.cache.size());
+  }
+
+  // Fibonacci hashing, so that the shard and the shard map's bucket use different bits
+  auto shard_of(const Key& key) -> shard& {
+    const auto h = static_cast<std::uint64_t>(Hash{}(key)) * 0x9E3779B97F4A7C15ULL;
+    return shards_[(h >> 32) % shards_.size()];
+  }
+
+  const clock::duration      ttl_;
+  std::vector<shard>         shards_;
+  std::atomic<std::uint64_t> flights_{0};
+  std::atomic<std::uint64_t> coalesced_{0};
+  std::atomic<std::uint64_t> hits_{0};
+  std::atomic<std::uint64_t> expired_{0};
+};
+
+namespace _singleflight_detail {
+
+// One lookup started with `factory(key)`; deletes itself once the map and every waiter have
+// released it
+template <class Owner, class Factory>
+class flight final : public flight_base<typename Owner::value_type> {
+  using Key   = typename Owner::key_type;
+  using Value = typename Owner::value_type;
+
+  struct flight_receiver {
+    using receiver_concept = receiver_t;
+
+    flight* self_;
+
+    template <class... Vs>
+    void set_value(Vs&&... vs) && noexcept {
+      try {
+        self_->value.emplace(std::forward<Vs>(vs)...);
+        self_->kind = outcome::value;
+      } catch (...) {
+        self_->error = std::current_exception();
+        self_->kind  = outcome::error;
+      }
+      self_->finish();
+    }
+
+    template <class E>
+    void set_error(E&& e) && noexcept {
+      if constexpr (std::same_as<__decay_t<E>, std::exception_ptr>) {
+        self_->error = std::forward<E>(e);
+      } else {
+        self_->error = std::make_exception_ptr(std::forward<E>(e));
+      }
+      self_->kind = outcome::error;
+      self_->finish();
+    }
+
+    void set_stopped() && noexcept {
+      self_->kind = outcome::stopped;
+      self_->finish();
+    }
+  };
+
+  using sender_t = std::invoke_result_t<Factory&, const Key&>;
+  using op_t     = decltype(std::declval<sender_t>().connect(std::declval<flight_receiver>()));
+
+ public:
+  flight(Owner* owner, const Key& key, const Factory& factory)
+      : owner_(owner), key_(key), factory_(factory) {}
+
+  void start() noexcept override {
+    try {
+      op_.emplace(__emplace_from{[this] {
+        return std::invoke(factory_, std::as_const(key_)).connect(flight_receiver{this});
+      }});
+    } catch (...) {
+      this->error = std::current_exception();
+      this->kind  = outcome::error;
+      finish();
+      return;
+    }
+    op_->start();
+  }
+
+ private:
+  void finish() noexcept {
+    owner_->retire(key_, this);
+    this->publish();
+    this->release();  // The shard map's reference
+  }
+
+  Owner*              owner_;
+  Key                 key_;
+  Factory             factory_;
+  std::optional<op_t> op_;
+};
+
+// Operation of singleflight::get(): a waiter of the key's flight
+template <class Owner, class Factory, class Rcvr>
+class _get_operation : waiter {
+  using Key   = typename Owner::key_type;
+  using Value = typename Owner::value_type;
+
+ public:
+  using operation_state_concept = operation_state_t;
+
+  template <class R>
+  _get_operation(Owner* owner, Key&& key, Factory&& factory, R&& r)
+      : waiter{.resume = &on_resume},
+        owner_(owner),
+        key_(std::move(key)),
+        factory_(std::move(factory)),
+        receiver_(std::forward<R>(r)) {}
+
+  _get_operation(const _get_operation&)                    = delete;
+  auto operator=(const _get_operation&) -> _get_operation& = delete;
+
+  void start() & noexcept {
+    typename Owner::lookup found;
+    try {
+      found = owner_->find_or_start(key_, factory_);
+    } catch (...) {
+      std::move(receiver_).set_error(std::current_exception());
+      return;
+    }
+    if (found.hit) {
+      std::move(receiver_).set_value(std::move(*found.hit));
+      return;
+    }
+
+    flight_ = found.flight;
+    flight_->attach(this);
+    if (found.leader) {
+      flight_->start();
+    }
+  }
+
+ private:
+  static void on_resume(waiter* w) noexcept {
+    auto*                self  = static_cast<_get_operation*>(w);
+    auto*                f     = self->flight_;
+    const outcome        kind  = f->kind;
+    std::exception_ptr   error = f->error;
+    std::optional<Value> value;
+    if (kind == outcome::value) {
+      try {
+        value.emplace(*f->value);
+      } catch (...) {
+        f->release();
+        std::move(self->receiver_).set_error(std::current_exception());
+        return;
+      }
+    }
+    f->release();
+
+    switch (kind) {
+      case outcome::value:
+        std::move(self->receiver_).set_value(std::move(*value));
+        break;
+      case outcome::error:
+        std::move(self->receiver_).set_error(std::move(error));
+        break;
+      case outcome::stopped:
+        std::move(self->receiver_).set_stopped();
+        break;
+    }
+  }
+
+  Owner*              owner_;
+  Key                 key_;
+  Factory             factory_;
+  Rcvr                receiver_;
+  flight_base<Value>* flight_{nullptr};
+};
+
+template <class Owner, class Factory>
+struct _get_sender {
+  using sender_concept = sender_t;
+  using value_types    = type_list<typename Owner::value_type>;
+
+  Owner*                   owner_;
+  typename Owner::key_type key_;
+  Factory                  factory_;
+
+  template <class Env>
+  auto get_completion_signatures(Env&& /*unused*/) const noexcept {
+    return completion_signatures<set_value_t(typename Owner::value_type),
+                                 set_error_t(std::exception_ptr), set_stopped_t()>{};
+  }
+
+  template <receiver R>
+  auto connect(R&& r) && {
+    return _get_operation<Owner, Factory, __decay_t<R>>{owner_, std::move(key_),
+                                                        std::move(factory_), std::forward<R>(r)};
+  }
+
+  template <receiver R>
+  auto connect(R&& r) & {
+    return _get_operation<Owner, Factory, __decay_t<R>>{
+        owner_, typename Owner::key_type(key_), Factory(factory_), std::forward<R>(r)};
+  }
+};
+
+}  // namespace _singleflight_detail
+
+}  // namespace flow::execution
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace flow::execution {
+
+// Slab storage for spawned operation states
+//
+// spawn() has to keep the operation state of a fire-and-forget sender alive until it completes,
+// which without help costs one allocation per spawn. A counting scope can instead own a slab:
+// a fixed number of equally sized slots carved out of one block, handed out by a lock-free free
+// list. spawn() places the operation in a slot when one is free and the operation fits, and
+// returns the slot when the operation completes; otherwise it falls back to the allocator from
+// the spawn environment (get_allocator).
+//
+// The free list is a Treiber stack of slot indices. The head packs a 32-bit index with a 32-bit
+// tag bumped by every push and pop, which rules out ABA; the links live in their own array of
+// atomics, so reading the link of a slot another thread just claimed is not a data race.
+
+struct spawn_slab_options {
+  std::size_t slots{1024};     // Operation states the slab holds at once
+  std::size_t slot_size{256};  // Bytes per slot, rounded up to alignof(std::max_align_t)
+};
+
+namespace _spawn_slab_detail {
+
+inline constexpr std::size_t slot_alignment = alignof(std::max_align_t);
+
+constexpr auto round_slot_size(std::size_t size) noexcept -> std::size_t {
+  return (size + slot_alignment - 1) / slot_alignment * slot_alignment;
+}
+
+// Lock-free free list over caller-provided slots
+class slot_pool {
+ public:
+  slot_pool(std::byte* storage, std::atomic<std::uint32_t>* links, std::uint32_t count,
+            std::size_t slot_size) noexcept
+      : storage_(storage), links_(links), slot_size_(slot_size) {
+    for (std::uint32_t i = 0; i < count; ++i) {
+      links_[i].store(i + 1 < count ? i + 1 : end, std::memory_order_relaxed);
+    }
+    head_.store(pack(0, count > 0 ? 0 : end), std::memory_order_release);
+  }
+
+  slot_pool(const slot_pool&)                    = delete;
+  auto operator=(const slot_pool&) -> slot_pool& = delete;
+
+  [[nodiscard]] auto slot_size() const noexcept -> std::size_t {
+    return slot_size_;
+  }
+
+  // A free slot for an object of `size` bytes aligned to `align`; nullptr when the object does
+  // not fit a slot or every slot is taken
+  auto allocate(std::size_t size, std::size_t align) noexcept -> void* {
+    if (size > slot_size_ || align > slot_alignment) {
+      return nullptr;
+    }
+    std::uint64_t head = head_.load(std::memory_order_acquire);
+    while (index_of(head) != end) {
+      const std::uint32_t index = index_of(head);
+      const std::uint32_t next  = links_[index].load(std::memory_order_relaxed);
+      if (head_.compare_exchange_weak(head, pack(tag_of(head) + 1, next),
+                                      std::memory_order_acquire, std::memory_order_acquire)) {
+        return storage_ + (static_cast<std::size_t>(index) * slot_size_);
+      }
+    }
+    return nullptr;
+  }
+
+  void deallocate(void* slot) noexcept {
+    const auto index = static_cast<std::uint32_t>(
+        static_cast<std::size_t>(static_cast<std::byte*>(slot) - storage_) / slot_size_);
+    std::uint64_t head = head_.load(std::memory_order_relaxed);
+    do {
+      links_[index].store(index_of(head), std::memory_order_relaxed);
+    } while (!head_.compare_exchange_weak(head, pack(tag_of(head) + 1, index),
+                                          std::memory_order_release, std::memory_order_relaxed));
+  }
+
+ private:
+  static constexpr std::uint32_t end = ~std::uint32_t{0};
+
+  static constexpr auto pack(std::uint32_t tag, std::uint32_t index) noexcept -> std::uint64_t {
+    return (static_cast<std::uint64_t>(tag) << 32) | index;
+  }
+
+  static constexpr auto index_of(std::uint64_t head) noexcept -> std::uint32_t {
+    return static_cast<std::uint32_t>(head);
+  }
+
+  static constexpr auto tag_of(std::uint64_t head) noexcept -> std::uint32_t {
+    return static_cast<std::uint32_t>(head >> 32);
+  }
+
+  alignas(64) std::atomic<std::uint64_t> head_{pack(0, end)};
+  std::byte*                             storage_;
+  std::atomic<std::uint32_t>*            links_;
+  std::size_t                            slot_size_;
+};
+
+}  // namespace _spawn_slab_detail
+
+// Slab sized at run time; the slots are allocated once, when the slab is created
+class spawn_slab {
+ public:
+  explicit spawn_slab(spawn_slab_options options)
+      : storage_(new (std::align_val_t{_spawn_slab_detail::slot_alignment})
+                     std::byte[options.slots
+                               * _spawn_slab_detail::round_slot_size(options.slot_size)]),
+        links_(std::make_unique<std::atomic<std::uint32_t>[]>(options.slots)),
+        pool_(storage_.get(), links_.get(), static_cast<std::uint32_t>(options.slots),
+              _spawn_slab_detail::round_slot_size(options.slot_size)) {}
+
+  auto pool() noexcept -> _spawn_slab_detail::slot_pool& {
+    return pool_;
+  }
+
+ private:
+  struct aligned_delete {
+    void operator()(std::byte* p) const noexcept {
+      ::operator delete[](p, std::align_val_t{_spawn_slab_detail::slot_alignment});
+    }
+  };
+
+  std::unique_ptr<std::byte[], aligned_delete>  storage_;
+  std::unique_ptr<std::atomic<std::uint32_t>[]> links_;
+  _spawn_slab_detail::slot_pool                 pool_;
+};
+
+// Slab of `Slots` slots stored inline, for scopes that must not allocate at all
+template <std::size_t Slots, std::size_t SlotSize = 256>
+class inline_spawn_slab {
+ public:
+  static constexpr std::size_t slot_size = _spawn_slab_detail::round_slot_size(SlotSize);
+
+  inline_spawn_slab() noexcept = default;
+
+  auto pool() noexcept -> _spawn_slab_detail::slot_pool& {
+    return pool_;
+  }
+
+ private:
+  alignas(_spawn_slab_detail::slot_alignment) std::byte storage_[Slots * slot_size];
+  std::atomic<std::uint32_t>    links_[Slots];
+  _spawn_slab_detail::slot_pool pool_{storage_, links_, static_cast<std::uint32_t>(Slots),
+                                      slot_size};
+};
+
+}  // namespace flow::execution
@@ -1,12 +1,11 @@
 #pragma once
 
-#include <condition_variable>
 #include <exception>
-#include <mutex>
 #include <optional>
 #include <tuple>
 #include <variant>
 
+#include "../detail/mutex.hpp"
 #include "receiver.hpp"
 #include "sender.hpp"
 #include "type_list.hpp"
@@ -17,8 +16,8 @@ namespace _sync_wait_detail {
 
 template <class... Ts>
 struct _sync_wait_state {
-  std::mutex                                                          mutex;
-  std::condition_variable                                             cv;
+  detail::mutex                                                       mutex{"sync_wait"};
+  detail::condition_variable                                          cv;
   bool                                                                completed = false;
   std::variant<std::monostate, std::tuple<Ts...>, std::exception_ptr> result;
 };
@@ -32,15 +31,14 @@ struct _sync_wait_receiver {
   template <class... Args>
     requires std::constructible_from<std::tuple<Ts...>, Args...>
   void set_value(Args&&... args) && noexcept {
+    // Notify under the lock: the waiter destroys the state as soon as it sees `completed`
+    std::scoped_lock lock(state_->mutex);
     try {
-      std::scoped_lock lock(state_->mutex);
       state_->result.template emplace<1>(std::forward<Args>(args)...);
-      state_->completed = true;
     } catch (...) {
-      std::scoped_lock lock(state_->mutex);
       state_->result.template emplace<2>(std::current_exception());
-      state_->completed = true;
     }
+    state_->completed = true;
     state_->cv.notify_one();
   }
 
@@ -93,7 +91,7 @@ struct _sync_wait_with_types_t {
     op.start();
 
     {
-      std::unique_lock lock(state.mutex);
+      detail::unique_lock lock(state.mutex);
       state.cv.wait(lock, [&] -> auto { return state.completed; });
     }
 
@@ -6,6 +6,8 @@
 #include <utility>
 
 #include "completion_signatures.hpp"
+#include "instrument.hpp"
+#include "queries.hpp"
 #include "sender.hpp"
 #include "type_list.hpp"
 
@@ -22,6 +24,12 @@ template <class... Ts>
 struct _type_list_elements<type_list<Ts...>> {
   template <class F>
   using invoke_result = std::invoke_result<F, Ts...>;
+
+  // A predecessor may forward each value as an rvalue or as an lvalue
+  template <class F>
+  static constexpr bool nothrow_invocable = std::is_nothrow_invocable_v<F, Ts...>
+                                            && std::is_nothrow_invocable_v<F, Ts&...>
+                                            && std::is_nothrow_invocable_v<F, const Ts&...>;
 };
 
 // Deduce the return type of F when called with sender's value types
@@ -35,6 +43,12 @@ struct _deduce_then_result {
 template <class S, class F>
 using deduce_then_result_t = typename _deduce_then_result<S, F>::type;
 
+// Whether F cannot throw when called with the sender's values, however they are forwarded.
+// Both the completion signatures and the receiver's exception handler are decided by it.
+template <class S, class F>
+inline constexpr bool nothrow_then =
+    _type_list_elements<typename S::value_types>::template nothrow_invocable<F>;
+
 // Wrap result in type_list, but handle void specially
 template <class T>
 struct _wrap_in_type_list {
@@ -73,11 +87,16 @@ struct _then_sender {
   S sender_;
   F fun_;
 
+  // F's result replaces the predecessor's values; its errors and stopped pass through. A
+  // noexcept F adds no set_error(exception_ptr) and its receiver has no exception handler.
   template <class Env>
   auto get_completion_signatures(Env&& /*unused*/) const {
     // Convert value_types (type_list) to proper set_value_t signature
     using set_value_sig = _then_detail::type_list_to_set_value_t<value_types>;
-    return completion_signatures<set_value_sig, set_error_t(std::exception_ptr), set_stopped_t()>{};
+    return __concat_completion_signatures_t<
+        completion_signatures<set_value_sig>,
+        __completion_signatures_of_t<S, Env, set_error_t, set_stopped_t>,
+        __exception_signatures_t<!_then_detail::nothrow_then<S, F>>>{};
   }
 
   template <receiver R>
@@ -90,6 +109,13 @@ struct _then_sender {
     return sender_.connect(_then_receiver<F, R>{fun_, std::forward<R>(r)});
   }
 
+  // then completes where its predecessor does
+  template <class Sndr = S>
+    requires requires(const Sndr& s) { get_completion_scheduler<set_value_t>(s); }
+  [[nodiscard]] auto query(get_completion_scheduler_t<set_value_t> /*unused*/) const noexcept {
+    return get_completion_scheduler<set_value_t>(sender_);
+  }
+
  private:
   template <class Fn, class Rcvr>
   struct _then_receiver {
@@ -98,41 +124,47 @@ struct _then_sender {
     Fn   fun_;
     Rcvr receiver_;
 
-    void set_value() && noexcept {
-      try {
-        if constexpr (std::is_void_v<std::invoke_result_t<Fn>>) {
-          std::invoke(std::move(fun_));
-          std::move(receiver_).set_value();
-        } else {
-          std::move(receiver_).set_value(std::invoke(std::move(fun_)));
-        }
-      } catch (...) {
-        std::move(receiver_).set_error(std::current_exception());
-      }
-    }
-
     template <class... Args>
     void set_value(Args&&... args) && noexcept {
-      try {
-        if constexpr (std::is_void_v<std::invoke_result_t<Fn, Args...>>) {
-          std::invoke(std::move(fun_), std::forward<Args>(args)...);
-          std::move(receiver_).set_value();
-        } else {
-          std::move(receiver_).set_value(std::invoke(std::move(fun_), std::forward<Args>(args)...));
+      _instrument_detail::mark_stage(receiver_, "then", stage_completion::value);
+      if constexpr (_then_detail::nothrow_then<S, Fn>) {
+        static_assert(std::is_nothrow_invocable_v<Fn, Args...>,
+                      "then: values forwarded in a form the signatures do not cover");
+        invoke_and_complete(std::forward<Args>(args)...);
+      } else {
+        try {
+          invoke_and_complete(std::forward<Args>(args)...);
+        } catch (...) {
+          std::move(receiver_).set_error(std::current_exception());
         }
-      } catch (...) {
-        std::move(receiver_).set_error(std::current_exception());
       }
     }
 
     template <class E>
     void set_error(E&& e) && noexcept {
+      _instrument_detail::mark_stage(receiver_, "then", stage_completion::error);
       std::move(receiver_).set_error(std::forward<E>(e));
     }
 
     void set_stopped() && noexcept {
+      _instrument_detail::mark_stage(receiver_, "then", stage_completion::stopped);
       std::move(receiver_).set_stopped();
     }
+
+    auto get_env() const noexcept {
+      return flow::execution::get_env(receiver_);
+    }
+
+   private:
+    template <class... Args>
+    void invoke_and_complete(Args&&... args) {
+      if constexpr (std::is_void_v<std::invoke_result_t<Fn, Args...>>) {
+        std::invoke(std::move(fun_), std::forward<Args>(args)...);
+        std::move(receiver_).set_value();
+      } else {
+        std::move(receiver_).set_value(std::invoke(std::move(fun_), std::forward<Args>(args)...));
+      }
+    }
   };
 };
 
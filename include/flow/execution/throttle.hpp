@@ -0,0 +1,637 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "../detail/mutex.hpp"
+#include "../detail/trampoline.hpp"
+#include "completion_signatures.hpp"
+#include "env.hpp"
+#include "operation_state.hpp"
+#include "receiver.hpp"
+#include "sender.hpp"
+#include "stop_token.hpp"
+#include "timer_scheduler.hpp"
+#include "utils.hpp"
+
+namespace flow::execution {
+
+// Concurrency and rate limiting adaptors
+//
+//   concurrency_limiter limiter(16);                           // At most 16 in flight
+//   token_bucket        bucket(timer.get_scheduler(), 500, 50);  // 500/s, bursts of 50
+//
+//   call_backend(req) | limit_concurrency(limiter) | rate_limit(bucket)
+//
+// limit_concurrency(limiter) starts the wrapped sender once it holds one of the limiter's
+// permits and returns the permit when the sender completes. While no permit is free the
+// operation parks on an intrusive FIFO (the operation state is the node) and the next
+// returned permit goes straight to the oldest waiter, which starts its sender on the
+// returning thread. A parked operation completes with set_stopped when its stop token fires.
+//
+// rate_limit(bucket) starts the wrapped sender when the token bucket allows it. The bucket is
+// one atomic "theoretical arrival time" advanced by compare-and-swap, so every start reserves
+// the next free slot without locking; a start that is over the burst allowance waits for its
+// slot on the bucket's timer_scheduler and then starts the sender on the timer thread. Slots
+// are handed out in the order starts reserve them, so delayed starts run in FIFO order. A
+// reservation is not returned when a delayed start is cancelled.
+
+namespace _throttle_detail {
+
+// Spelled out so that nested receivers can declare get_env() before the operation is complete
+template <class Rcvr>
+using env_of_t = decltype(get_env(std::declval<const Rcvr&>()));
+
+// The wrapped sender's completions, plus set_stopped() (a cancelled wait) and
+// set_error(exception_ptr) (a throwing connect or a failed timer)
+template <class S, class Env>
+using signatures_t = __concat_completion_signatures_t<
+    __completion_signatures_of_t<S, Env, set_value_t, set_error_t, set_stopped_t>,
+    completion_signatures<set_error_t(std::exception_ptr), set_stopped_t()>>;
+
+template <class S, class Rcvr>
+class _limit_operation;
+
+template <class S, class Rcvr>
+class _rate_limit_operation;
+
+}  // namespace _throttle_detail
+
+struct concurrency_limiter_stats {
+  std::size_t                         permits{0};    // Permits owned by the limiter
+  std::size_t                         available{0};  // Permits not held by an operation
+  std::size_t                         waiting{0};    // Operations parked for a permit
+  std::uint64_t                       acquired{0};   // Permits handed out
+  std::uint64_t                       waited{0};     // Acquisitions that had to park
+  std::uint64_t                       cancelled{0};  // Parked operations that were stopped
+  std::chrono::steady_clock::duration throttled{0};  // Total time spent parked
+};
+
+class concurrency_limiter {
+ public:
+  using clock = std::chrono::steady_clock;
+
+  explicit concurrency_limiter(std::size_t permits) noexcept
+      : permits_(permits), available_(static_cast<std::ptrdiff_t>(permits)) {}
+
+  concurrency_limiter(const concurrency_limiter&)                    = delete;
+  auto operator=(const concurrency_limiter&) -> concurrency_limiter& = delete;
+
+  // Takes a permit if one is free and nobody is queued ahead
+  auto try_acquire() noexcept -> bool {
+    if (waiting_.load(std::memory_order_acquire) > 0 || !take()) {
+      return false;
+    }
+    acquired_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Returns a permit; the oldest parked operation receives it directly
+  void release() noexcept {
+    if (waiting_.load(std::memory_order_acquire) > 0) {
+      if (waiter* w = pop_waiter()) {
+        grant(w);
+        return;
+      }
+    }
+
+    available_.fetch_add(1, std::memory_order_seq_cst);
+    // Pairs with the increment in park(): either we see the waiter or its dispatch sees the
+    // permit
+    if (waiting_.load(std::memory_order_seq_cst) > 0) {
+      dispatch();
+    }
+  }
+
+  [[nodiscard]] auto stats() const noexcept -> concurrency_limiter_stats {
+    concurrency_limiter_stats s;
+    s.permits   = permits_;
+    s.available = static_cast<std::size_t>(
+        std::max<std::ptrdiff_t>(0, available_.load(std::memory_order_relaxed)));
+    s.waiting   = waiting_.load(std::memory_order_relaxed);
+    s.acquired  = acquired_.load(std::memory_order_relaxed);
+    s.waited    = waited_.load(std::memory_order_relaxed);
+    s.cancelled = cancelled_.load(std::memory_order_relaxed);
+    s.throttled = std::chrono::nanoseconds(throttled_ns_.load(std::memory_order_relaxed));
+    return s;
+  }
+
+ private:
+  template <class, class>
+  friend class _throttle_detail::_limit_operation;
+
+  // Intrusive node of a parked operation; `grant` is called once it holds a permit
+  struct waiter {
+    void (*grant)(waiter*) noexcept;
+    waiter*           prev{nullptr};
+    waiter*           next{nullptr};
+    clock::time_point parked{};
+    bool              linked{false};
+  };
+
+  // Parks `w` until a permit is free; a permit released meanwhile is granted right away
+  void park(waiter* w) noexcept {
+    {
+      std::scoped_lock lock(mutex_);
+      w->prev   = tail_;
+      w->next   = nullptr;
+      w->linked = true;
+      w->parked = clock::now();
+      (tail_ != nullptr ? tail_->next : head_) = w;
+      tail_                                    = w;
+      waiting_.fetch_add(1, std::memory_order_seq_cst);
+    }
+    waited_.fetch_add(1, std::memory_order_relaxed);
+    dispatch();
+  }
+
+  // Removes a parked waiter; false if a permit was already granted to it
+  auto unpark(waiter* w) noexcept -> bool {
+    {
+      std::scoped_lock lock(mutex_);
+      if (!w->linked) {
+        return false;
+      }
+      unlink(w);
+    }
+    cancelled_.fetch_add(1, std::memory_order_relaxed);
+    throttled_ns_.fetch_add(since(w->parked), std::memory_order_relaxed);
+    return true;
+  }
+
+  auto take() noexcept -> bool {
+    auto available = available_.load(std::memory_order_relaxed);
+    while (available > 0) {
+      if (available_.compare_exchange_weak(available, available - 1, std::memory_order_seq_cst,
+                                           std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  auto pop_waiter() noexcept -> waiter* {
+    std::scoped_lock lock(mutex_);
+    waiter*          w = head_;
+    if (w != nullptr) {
+      unlink(w);
+    }
+    return w;
+  }
+
+  void unlink(waiter* w) noexcept {
+    (w->prev != nullptr ? w->prev->next : head_) = w->next;
+    (w->next != nullptr ? w->next->prev : tail_) = w->prev;
+    w->linked                                    = false;
+    waiting_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void grant(waiter* w) noexcept {
+    acquired_.fetch_add(1, std::memory_order_relaxed);
+    throttled_ns_.fetch_add(since(w->parked), std::memory_order_relaxed);
+
+    // A granted operation starts its sender inline, and a sender that completes synchronously
+    // releases its permit to the next waiter: go through the trampoline so that a chain of
+    // such senders does not nest on the stack
+    detail::trampoline<waiter, &waiter::grant>::deliver(w);
+  }
+
+  // Moves free permits to parked waiters until one side runs out
+  void dispatch() noexcept {
+    while (waiting_.load(std::memory_order_seq_cst) > 0) {
+      if (!take()) {
+        return;
+      }
+      if (waiter* w = pop_waiter()) {
+        grant(w);
+      } else {
+        available_.fetch_add(1, std::memory_order_seq_cst);
+      }
+    }
+  }
+
+  static auto since(clock::time_point t) noexcept -> std::uint64_t {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - t).count());
+  }
+
+  const std::size_t                       permits_;
+  alignas(64) std::atomic<std::ptrdiff_t> available_;
+  alignas(64) std::atomic<std::size_t>    waiting_{0};
+  detail::mutex                           mutex_{"concurrency_limiter"};
+  waiter*                                 head_{nullptr};
+  waiter*                                 tail_{nullptr};
+  std::atomic<std::uint64_t>              acquired_{0};
+  std::atomic<std::uint64_t>              waited_{0};
+  std::atomic<std::uint64_t>              cancelled_{0};
+  std::atomic<std::uint64_t>              throttled_ns_{0};
+};
+
+struct token_bucket_stats {
+  std::uint64_t                       admitted{0};   // Starts allowed without waiting
+  std::uint64_t                       throttled{0};  // Starts delayed by the bucket
+  std::size_t                         waiting{0};    // Delayed starts not yet released
+  std::chrono::steady_clock::duration delayed{0};    // Total delay imposed on starts
+};
+
+class token_bucket {
+ public:
+  using clock    = timer_scheduler::clock;
+  using duration = timer_scheduler::duration;
+
+  // Allows `rate` starts per second on average and up to `burst` back-to-back starts
+  token_bucket(timer_scheduler::timer_scheduler_handle timer, double rate, std::size_t burst)
+      : timer_(timer),
+        interval_(std::max<std::int64_t>(
+            1, static_cast<std::int64_t>(1e9 / std::max(rate, 1e-9)))),
+        tolerance_(interval_ * static_cast<std::int64_t>(std::max<std::size_t>(1, burst))),
+        tat_(now_ns()) {}
+
+  token_bucket(const token_bucket&)                    = delete;
+  auto operator=(const token_bucket&) -> token_bucket& = delete;
+
+  // Reserves the next slot and returns how long to wait for it (zero: start now)
+  auto reserve() noexcept -> duration {
+    const std::int64_t now = now_ns();
+    std::int64_t       tat = tat_.load(std::memory_order_relaxed);
+    std::int64_t       next{};
+    do {
+      next = std::max(tat, now) + interval_;
+    } while (!tat_.compare_exchange_weak(tat, next, std::memory_order_relaxed));
+
+    const std::int64_t wait = next - tolerance_ - now;
+    if (wait <= 0) {
+      admitted_.fetch_add(1, std::memory_order_relaxed);
+      return duration::zero();
+    }
+    throttled_.fetch_add(1, std::memory_order_relaxed);
+    delayed_ns_.fetch_add(static_cast<std::uint64_t>(wait), std::memory_order_relaxed);
+    return std::chrono::duration_cast<duration>(std::chrono::nanoseconds(wait));
+  }
+
+  // Takes a slot only if it is available now
+  auto try_acquire() noexcept -> bool {
+    const std::int64_t now = now_ns();
+    std::int64_t       tat = tat_.load(std::memory_order_relaxed);
+    std::int64_t       next{};
+    do {
+      next = std::max(tat, now) + interval_;
+      if (next - tolerance_ > now) {
+        return false;
+      }
+    } while (!tat_.compare_exchange_weak(tat, next, std::memory_order_relaxed));
+    admitted_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  [[nodiscard]] auto timer() const noexcept -> timer_scheduler::timer_scheduler_handle {
+    return timer_;
+  }
+
+  [[nodiscard]] auto stats() const noexcept -> token_bucket_stats {
+    token_bucket_stats s;
+    s.admitted  = admitted_.load(std::memory_order_relaxed);
+    s.throttled = throttled_.load(std::memory_order_relaxed);
+    s.waiting   = waiting_.load(std::memory_order_relaxed);
+    s.delayed   = std::chrono::duration_cast<duration>(
+        std::chrono::nanoseconds(delayed_ns_.load(std::memory_order_relaxed)));
+    return s;
+  }
+
+ private:
+  template <class, class>
+  friend class _throttle_detail::_rate_limit_operation;
+
+  static auto now_ns() noexcept -> std::int64_t {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               clock::now().time_since_epoch())
+        .count();
+  }
+
+  timer_scheduler::timer_scheduler_handle timer_;
+  const std::int64_t                      interval_;   // Nanoseconds per token
+  const std::int64_t                      tolerance_;  // Burst allowance in nanoseconds
+  alignas(64) std::atomic<std::int64_t>   tat_;        // Theoretical arrival time
+  alignas(64) std::atomic<std::size_t>    waiting_{0};
+  std::atomic<std::uint64_t>              admitted_{0};
+  std::atomic<std::uint64_t>              throttled_{0};
+  std::atomic<std::uint64_t>              delayed_ns_{0};
+};
+
+namespace _throttle_detail {
+
+// limit_concurrency: holds a permit from start of the wrapped sender until its completion
+template <class S, class Rcvr>
+class _limit_operation : concurrency_limiter::waiter {
+  struct inner_receiver {
+    using receiver_concept = receiver_t;
+
+    _limit_operation* self_;
+
+    template <class... Vs>
+    void set_value(Vs&&... vs) && noexcept {
+      self_->limiter_->release();
+      std::move(self_->receiver_).set_value(std::forward<Vs>(vs)...);
+    }
+
+    template <class E>
+    void set_error(E&& e) && noexcept {
+      self_->limiter_->release();
+      std::move(self_->receiver_).set_error(std::forward<E>(e));
+    }
+
+    void set_stopped() && noexcept {
+      self_->limiter_->release();
+      std::move(self_->receiver_).set_stopped();
+    }
+
+    auto get_env() const noexcept -> env_of_t<Rcvr> {
+      return flow::execution::get_env(self_->receiver_);
+    }
+  };
+
+  struct on_stop_requested {
+    _limit_operation* self;
+
+    void operator()() const noexcept {
+      if (self->limiter_->unpark(self)) {
+        self->arrive();
+      }
+    }
+  };
+
+  using inner_op_t         = decltype(std::declval<S>().connect(std::declval<inner_receiver>()));
+  using stop_token_t       = stop_token_of_t<decltype(get_env(std::declval<const Rcvr&>()))>;
+  using on_stop_callback_t = stop_callback_for_t<stop_token_t, on_stop_requested>;
+
+ public:
+  using operation_state_concept = operation_state_t;
+
+  template <class Sndr, class R>
+  _limit_operation(Sndr&& sndr, concurrency_limiter* limiter, R&& r)
+      : concurrency_limiter::waiter{.grant = &on_grant},
+        sender_(std::forward<Sndr>(sndr)),
+        limiter_(limiter),
+        receiver_(std::forward<R>(r)) {}
+
+  _limit_operation(const _limit_operation&)                    = delete;
+  auto operator=(const _limit_operation&) -> _limit_operation& = delete;
+
+  void start() & noexcept {
+    if (limiter_->try_acquire()) {
+      run();
+      return;
+    }
+
+    auto token = get_stop_token(get_env(receiver_));
+    if (token.stop_requested()) {
+      std::move(receiver_).set_stopped();
+      return;
+    }
+
+    limiter_->park(this);
+    // Completion needs both the permit (or cancellation) and the end of start()
+    on_stop_.emplace(std::move(token), on_stop_requested{this});
+    arrive();
+  }
+
+ private:
+  static void on_grant(concurrency_limiter::waiter* w) noexcept {
+    auto* self     = static_cast<_limit_operation*>(w);
+    self->granted_ = true;
+    self->arrive();
+  }
+
+  void arrive() noexcept {
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    on_stop_.reset();
+    if (granted_) {
+      run();
+    } else {
+      std::move(receiver_).set_stopped();
+    }
+  }
+
+  // Starts the wrapped sender while holding a permit
+  void run() noexcept {
+    try {
+      inner_.emplace(
+          __emplace_from{[this] { return std::move(sender_).connect(inner_receiver{this}); }});
+    } catch (...) {
+      limiter_->release();
+      std::move(receiver_).set_error(std::current_exception());
+      return;
+    }
+    inner_->start();
+  }
+
+  S                                 sender_;
+  concurrency_limiter*              limiter_;
+  Rcvr                              receiver_;
+  bool                              granted_{false};
+  std::atomic<int>                  pending_{2};
+  std::optional<on_stop_callback_t> on_stop_;
+  std::optional<inner_op_t>         inner_;
+};
+
+// rate_limit: waits for the reserved slot on the bucket's timer, then starts the sender
+template <class S, class Rcvr>
+class _rate_limit_operation {
+  struct delay_receiver {
+    using receiver_concept = receiver_t;
+
+    _rate_limit_operation* self_;
+
+    void set_value() && noexcept {
+      self_->bucket_->waiting_.fetch_sub(1, std::memory_order_relaxed);
+      self_->run();
+    }
+
+    template <class E>
+    void set_error(E&& e) && noexcept {
+      self_->bucket_->waiting_.fetch_sub(1, std::memory_order_relaxed);
+      std::move(self_->receiver_).set_error(std::forward<E>(e));
+    }
+
+    void set_stopped() && noexcept {
+      self_->bucket_->waiting_.fetch_sub(1, std::memory_order_relaxed);
+      std::move(self_->receiver_).set_stopped();
+    }
+
+    auto get_env() const noexcept -> env_of_t<Rcvr> {
+      return flow::execution::get_env(self_->receiver_);
+    }
+  };
+
+  using delay_op_t = decltype(std::declval<timer_scheduler::timer_scheduler_handle&>()
+                                  .schedule_after(timer_scheduler::duration{})
+                                  .connect(std::declval<delay_receiver>()));
+  using inner_op_t = decltype(std::declval<S>().connect(std::declval<Rcvr>()));
+
+ public:
+  using operation_state_concept = operation_state_t;
+
+  template <class Sndr, class R>
+  _rate_limit_operation(Sndr&& sndr, token_bucket* bucket, R&& r)
+      : sender_(std::forward<Sndr>(sndr)), bucket_(bucket), receiver_(std::forward<R>(r)) {}
+
+  _rate_limit_operation(const _rate_limit_operation&)                    = delete;
+  auto operator=(const _rate_limit_operation&) -> _rate_limit_operation& = delete;
+
+  void start() & noexcept {
+    const auto delay = bucket_->reserve();
+    if (delay == timer_scheduler::duration::zero()) {
+      run();
+      return;
+    }
+
+    bucket_->waiting_.fetch_add(1, std::memory_order_relaxed);
+    try {
+      delay_.emplace(__emplace_from{[this, delay] {
+        return bucket_->timer_.schedule_after(delay).connect(delay_receiver{this});
+      }});
+    } catch (...) {
+      bucket_->waiting_.fetch_sub(1, std::memory_order_relaxed);
+      std::move(receiver_).set_error(std::current_exception());
+      return;
+    }
+    delay_->start();
+  }
+
+ private:
+  void run() noexcept {
+    try {
+      inner_.emplace(
+          __emplace_from{[this] { return std::move(sender_).connect(std::move(receiver_)); }});
+    } catch (...) {
+      std::move(receiver_).set_error(std::current_exception());
+      return;
+    }
+    inner_->start();
+  }
+
+  S                         sender_;
+  token_bucket*             bucket_;
+  Rcvr                      receiver_;
+  std::optional<delay_op_t> delay_;
+  std::optional<inner_op_t> inner_;
+};
+
+template <sender S>
+struct _limit_concurrency_sender {
+  using sender_concept = sender_t;
+  using value_types    = typename S::value_types;
+
+  S                    sender_;
+  concurrency_limiter* limiter_;
+
+  template <class Env>
+  auto get_completion_signatures(Env&& /*unused*/) const {
+    return _throttle_detail::signatures_t<S, Env>{};
+  }
+
+  template <receiver R>
+  auto connect(R&& r) && {
+    return _limit_operation<S, __decay_t<R>>{std::move(sender_), limiter_, std::forward<R>(r)};
+  }
+
+  template <receiver R>
+  auto connect(R&& r) & {
+    return _limit_operation<S, __decay_t<R>>{sender_, limiter_, std::forward<R>(r)};
+  }
+};
+
+template <sender S>
+struct _rate_limit_sender {
+  using sender_concept = sender_t;
+  using value_types    = typename S::value_types;
+
+  S             sender_;
+  token_bucket* bucket_;
+
+  template <class Env>
+  auto get_completion_signatures(Env&& /*unused*/) const {
+    return _throttle_detail::signatures_t<S, Env>{};
+  }
+
+  template <receiver R>
+  auto connect(R&& r) && {
+    return _rate_limit_operation<S, __decay_t<R>>{std::move(sender_), bucket_,
+                                                  std::forward<R>(r)};
+  }
+
+  template <receiver R>
+  auto connect(R&& r) & {
+    return _rate_limit_operation<S, __decay_t<R>>{sender_, bucket_, std::forward<R>(r)};
+  }
+};
+
+}  // namespace _throttle_detail
+
+// Pipeable version forward declarations
+struct _pipeable_limit_concurrency;
+struct _pipeable_rate_limit;
+
+struct limit_concurrency_t {
+  template <sender S>
+  auto operator()(S&& s, concurrency_limiter& limiter) const {
+    return _throttle_detail::_limit_concurrency_sender<__decay_t<S>>{std::forward<S>(s),
+                                                                     &limiter};
+  }
+
+  // Curried version for pipe syntax
+  auto operator()(concurrency_limiter& limiter) const -> _pipeable_limit_concurrency;
+};
+
+struct rate_limit_t {
+  template <sender S>
+  auto operator()(S&& s, token_bucket& bucket) const {
+    return _throttle_detail::_rate_limit_sender<__decay_t<S>>{std::forward<S>(s), &bucket};
+  }
+
+  // Curried version for pipe syntax
+  auto operator()(token_bucket& bucket) const -> _pipeable_rate_limit;
+};
+
+inline constexpr limit_concurrency_t limit_concurrency{};
+inline constexpr rate_limit_t        rate_limit{};
+
+// Pipeable versions
+struct _pipeable_limit_concurrency {
+  concurrency_limiter* limiter_;
+
+  template <sender S>
+  friend auto operator|(S&& s, const _pipeable_limit_concurrency& p) {
+    return limit_concurrency_t{}(std::forward<S>(s), *p.limiter_);
+  }
+};
+
+struct _pipeable_rate_limit {
+  token_bucket* bucket_;
+
+  template <sender S>
+  friend auto operator|(S&& s, const _pipeable_rate_limit& p) {
+    return rate_limit_t{}(std::forward<S>(s), *p.bucket_);
+  }
+};
+
+inline auto limit_concurrency_t::operator()(concurrency_limiter& limiter) const
+    -> _pipeable_limit_concurrency {
+  return _pipeable_limit_concurrency{&limiter};
+}
+
+inline auto rate_limit_t::operator()(token_bucket& bucket) const -> _pipeable_rate_limit {
+  return _pipeable_rate_limit{&bucket};
+}
+
+}  // namespace flow::execution
@@ -0,0 +1,327 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<mdspan>)
+#include <mdspan>
+#endif
+
+namespace flow::execution {
+
+// Multi-dimensional bulk shapes
+//
+// bulk and bulk_chunked also take an N-dimensional shape: a std::array of extents, a
+// std::extents when <mdspan> is available, or a tiled_shape carrying a tile-size hint. The
+// index space is cut into N-dimensional tiles, the tiles are ordered along a space-filling
+// curve, and the parallel bulk path splits that order into chunks, so every agent works on a
+// compact region instead of a slice of a linearized range that cuts across rows:
+//
+//   bulk(par, std::array{rows, cols}, [&](std::size_t i, std::size_t j) { ... })
+//   bulk(par, std::array{rows, cols}, [&](std::array<std::size_t, 2> idx) { ... })
+//   bulk_chunked(par, tiled_shape<2>{{rows, cols}, {32, 32}}, [&](md_tile<2> t) { ... })
+//
+// bulk calls the function once per index, walking each tile in row-major order (the last
+// dimension innermost); bulk_chunked calls it once per tile with the tile's bounds. The tile
+// order is computed once, when the sender is made, and shared by its copies.
+
+// Order in which tiles are handed to the bulk agents
+enum class tile_order : std::uint8_t {
+  row_major,  // Row by row, as a linearized loop would visit them
+  morton,     // Z-order curve: bit-interleaved tile coordinates
+  hilbert,    // Hilbert curve; two-dimensional shapes only, others fall back to morton
+};
+
+// Extents plus a tile-size hint; a tile extent of 0 picks a default so that a tile holds
+// about 4096 indices (64x64 in two dimensions, 16x16x16 in three)
+template <std::size_t N>
+struct tiled_shape {
+  std::array<std::size_t, N> extents{};
+  std::array<std::size_t, N> tile{};
+  tile_order                 order{tile_order::morton};
+};
+
+// Half-open box [begin, end) of indices handed to a per-tile function
+template <std::size_t N>
+struct md_tile {
+  std::array<std::size_t, N> begin{};
+  std::array<std::size_t, N> end{};
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t {
+    std::size_t count = 1;
+    for (std::size_t d = 0; d < N; ++d) {
+      count *= end[d] - begin[d];
+    }
+    return count;
+  }
+};
+
+namespace _tiling_detail {
+
+// Shapes bulk treats as multi-dimensional, with their conversion to a tiled_shape
+template <class Shape>
+struct shape_traits;
+
+template <std::integral I, std::size_t N>
+struct shape_traits<std::array<I, N>> {
+  static constexpr std::size_t rank = N;
+
+  static auto to_tiled(const std::array<I, N>& extents) noexcept -> tiled_shape<N> {
+    tiled_shape<N> out;
+    for (std::size_t d = 0; d < N; ++d) {
+      out.extents[d] = extents[d] > 0 ? static_cast<std::size_t>(extents[d]) : 0;
+    }
+    return out;
+  }
+};
+
+template <std::size_t N>
+struct shape_traits<tiled_shape<N>> {
+  static constexpr std::size_t rank = N;
+
+  static auto to_tiled(const tiled_shape<N>& shape) noexcept -> tiled_shape<N> {
+    return shape;
+  }
+};
+
+#if defined(__cpp_lib_mdspan)
+template <class I, std::size_t... E>
+struct shape_traits<std::extents<I, E...>> {
+  static constexpr std::size_t rank = sizeof...(E);
+
+  static auto to_tiled(const std::extents<I, E...>& extents) noexcept -> tiled_shape<rank> {
+    tiled_shape<rank> out;
+    for (std::size_t d = 0; d < rank; ++d) {
+      out.extents[d] = static_cast<std::size_t>(extents.extent(d));
+    }
+    return out;
+  }
+};
+#endif
+
+template <class Shape>
+concept multi_dim = requires { shape_traits<Shape>::rank; };
+
+// Largest edge e with e^N <= 4096
+template <std::size_t N>
+constexpr auto default_edge() noexcept -> std::size_t {
+  std::size_t edge = 1;
+  while (true) {
+    std::size_t volume = 1;
+    for (std::size_t d = 0; d < N; ++d) {
+      volume *= edge + 1;
+    }
+    if (volume > 4096) {
+      return edge;
+    }
+    ++edge;
+  }
+}
+
+// Z-order key: bit b of coordinate d lands at bit b*N + (N-1-d), so the last dimension varies
+// fastest, as it does in a row-major array
+template <std::size_t N>
+auto morton_key(const std::array<std::uint32_t, N>& c) noexcept -> std::uint64_t {
+  std::uint64_t key = 0;
+  for (std::size_t b = 0; b * N < 64; ++b) {
+    for (std::size_t d = 0; d < N && (b * N) + (N - 1 - d) < 64; ++d) {
+      key |= static_cast<std::uint64_t>((c[d] >> b) & 1U) << ((b * N) + (N - 1 - d));
+    }
+  }
+  return key;
+}
+
+// Distance of (x, y) along the Hilbert curve filling a `side` x `side` grid, side a power of two
+inline auto hilbert_key(std::uint64_t side, std::uint64_t x, std::uint64_t y) noexcept
+    -> std::uint64_t {
+  std::uint64_t key = 0;
+  for (std::uint64_t s = side / 2; s > 0; s /= 2) {
+    const std::uint64_t rx = (x & s) != 0 ? 1 : 0;
+    const std::uint64_t ry = (y & s) != 0 ? 1 : 0;
+    key += s * s * ((3 * rx) ^ ry);
+    if (ry == 0) {
+      if (rx == 1) {
+        x = side - 1 - x;
+        y = side - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return key;
+}
+
+// The tiles of a shape in curve order: tile t covers the box returned by box(t)
+template <std::size_t N>
+class tile_grid {
+  static_assert(N > 0, "a multi-dimensional shape needs at least one extent");
+
+ public:
+  using coords = std::array<std::uint32_t, N>;
+
+  explicit tile_grid(const tiled_shape<N>& shape) : extents_(shape.extents), order_(shape.order) {
+    count_ = 1;
+    for (std::size_t d = 0; d < N; ++d) {
+      const std::size_t hint = shape.tile[d] > 0 ? shape.tile[d] : default_edge<N>();
+      tile_[d]               = std::max<std::size_t>(1, std::min(hint, extents_[d]));
+      tiles_[d]              = (extents_[d] + tile_[d] - 1) / tile_[d];
+      count_ *= tiles_[d];
+    }
+    if (N != 2 && order_ == tile_order::hilbert) {
+      order_ = tile_order::morton;
+    }
+    if (order_ != tile_order::row_major && count_ > 1) {
+      order_table_ = std::make_shared<const std::vector<coords>>(curve_order());
+    }
+  }
+
+  // Number of tiles
+  [[nodiscard]] auto count() const noexcept -> std::size_t {
+    return count_;
+  }
+
+  [[nodiscard]] auto box(std::size_t t) const noexcept -> md_tile<N> {
+    const coords c = order_table_ ? (*order_table_)[t] : row_major_coords(t);
+    md_tile<N>   out;
+    for (std::size_t d = 0; d < N; ++d) {
+      out.begin[d] = c[d] * tile_[d];
+      out.end[d]   = std::min(out.begin[d] + tile_[d], extents_[d]);
+    }
+    return out;
+  }
+
+ private:
+  [[nodiscard]] auto row_major_coords(std::size_t t) const noexcept -> coords {
+    coords c{};
+    for (std::size_t d = N; d-- > 0;) {
+      c[d] = static_cast<std::uint32_t>(t % tiles_[d]);
+      t /= tiles_[d];
+    }
+    return c;
+  }
+
+  // Every tile's coordinates sorted by curve key
+  [[nodiscard]] auto curve_order() const -> std::vector<coords> {
+    std::uint64_t side = 1;
+    if constexpr (N == 2) {
+      side = std::bit_ceil(std::max<std::uint64_t>(tiles_[0], tiles_[1]));
+    }
+    std::vector<std::pair<std::uint64_t, coords>> keyed;
+    keyed.reserve(count_);
+    for (std::size_t t = 0; t < count_; ++t) {
+      const coords c = row_major_coords(t);
+      if constexpr (N == 2) {
+        if (order_ == tile_order::hilbert) {
+          keyed.emplace_back(hilbert_key(side, c[1], c[0]), c);
+          continue;
+        }
+      }
+      keyed.emplace_back(morton_key<N>(c), c);
+    }
+    std::ranges::sort(keyed, {}, &std::pair<std::uint64_t, coords>::first);
+    std::vector<coords> out;
+    out.reserve(count_);
+    for (const auto& entry : keyed) {
+      out.push_back(entry.second);
+    }
+    return out;
+  }
+
+  std::array<std::size_t, N>                 extents_{};
+  std::array<std::size_t, N>                 tile_{};
+  std::array<std::size_t, N>                 tiles_{};
+  std::size_t                                count_{0};
+  tile_order                                 order_;
+  std::shared_ptr<const std::vector<coords>> order_table_;
+};
+
+template <std::size_t>
+using index_t = std::size_t;
+
+// Whether F takes the N indices as separate arguments rather than as one std::array
+template <class F, std::size_t N, class... Values>
+inline constexpr bool spread_index = []<std::size_t... D>(std::index_sequence<D...>) {
+  return std::is_invocable_v<F&, index_t<D>..., Values&...>;
+}(std::make_index_sequence<N>{});
+
+template <class F, std::size_t N, class... Values>
+concept index_invocable = spread_index<F, N, Values...>
+                          || std::invocable<F&, const std::array<std::size_t, N>&, Values&...>;
+
+template <class F, std::size_t N, class... Values>
+inline constexpr bool nothrow_index = []<std::size_t... D>(std::index_sequence<D...>) {
+  if constexpr (spread_index<F, N, Values...>) {
+    return std::is_nothrow_invocable_v<F&, index_t<D>..., Values&...>;
+  } else {
+    return std::is_nothrow_invocable_v<F&, const std::array<std::size_t, N>&, Values&...>;
+  }
+}(std::make_index_sequence<N>{});
+
+template <class F, std::size_t N, class... Values>
+void call_index(F& fun, const std::array<std::size_t, N>& idx,
+                Values&... values) noexcept(nothrow_index<F, N, Values...>) {
+  if constexpr (spread_index<F, N, Values...>) {
+    [&]<std::size_t... D>(std::index_sequence<D...>) {
+      fun(idx[D]..., values...);
+    }(std::make_index_sequence<N>{});
+  } else {
+    fun(idx, values...);
+  }
+}
+
+// Visits the box in row-major order, one nested loop per dimension
+template <std::size_t D, class F, std::size_t N, class... Values>
+void for_each_index(F& fun, const md_tile<N>& box, std::array<std::size_t, N>& idx,
+                    Values&... values) noexcept(nothrow_index<F, N, Values...>) {
+  for (idx[D] = box.begin[D]; idx[D] < box.end[D]; ++idx[D]) {
+    if constexpr (D + 1 == N) {
+      call_index(fun, idx, values...);
+    } else {
+      for_each_index<D + 1>(fun, box, idx, values...);
+    }
+  }
+}
+
+// bulk_chunked body over tile numbers calling F once per index of each tile
+template <std::size_t N, class F>
+struct per_index {
+  tile_grid<N> grid_;
+  F            fun_;
+
+  template <class... Values>
+    requires index_invocable<F, N, Values...>
+  void operator()(std::size_t begin, std::size_t end,
+                  Values&... values) noexcept(nothrow_index<F, N, Values...>) {
+    std::array<std::size_t, N> idx{};
+    for (std::size_t t = begin; t < end; ++t) {
+      for_each_index<0>(fun_, grid_.box(t), idx, values...);
+    }
+  }
+};
+
+// bulk_chunked body over tile numbers calling F once per tile
+template <std::size_t N, class F>
+struct per_tile {
+  tile_grid<N> grid_;
+  F            fun_;
+
+  template <class... Values>
+    requires std::invocable<F&, const md_tile<N>&, Values&...>
+  void operator()(std::size_t begin, std::size_t end, Values&... values) noexcept(
+      std::is_nothrow_invocable_v<F&, const md_tile<N>&, Values&...>) {
+    for (std::size_t t = begin; t < end; ++t) {
+      fun_(grid_.box(t), values...);
+    }
+  }
+};
+
+}  // namespace _tiling_detail
+
+}  // namespace flow::execution
@@ -0,0 +1,391 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../detail/mutex.hpp"
+#include "completion_signatures.hpp"
+#include "env.hpp"
+#include "operation_state.hpp"
+#include "queries.hpp"
+#include "receiver.hpp"
+#include "scheduler.hpp"
+#include "sender.hpp"
+#include "stop_token.hpp"
+#include "trace.hpp"
+#include "type_list.hpp"
+
+namespace flow::execution {
+
+// [exec.sched.timer], timed scheduling
+//
+// timer_scheduler owns one thread that completes operations at a point in time:
+//
+//   timer_scheduler timer;
+//   auto sched = timer.get_scheduler();
+//   schedule_after(sched, 5ms) | then([] { poll(); })
+//
+// Pending operations are the nodes of a binary min-heap ordered by deadline (ties complete in
+// the order they were started). An operation whose stop token fires before its deadline is
+// removed from the heap and completes with set_stopped; destroying the timer_scheduler
+// completes every pending operation with set_stopped. Completions run on the timer thread,
+// so continuations should be short or move to another scheduler.
+
+struct schedule_after_t;
+struct schedule_at_t;
+
+// A scheduler whose senders can complete at or after a point in time
+template <class Sched>
+concept timed_scheduler =
+    scheduler<Sched> && requires(const Sched& sched, std::chrono::steady_clock::duration d) {
+      sched.now();
+      sched.schedule_after(d);
+      sched.schedule_at(sched.now() + d);
+    };
+
+class timer_scheduler {
+ public:
+  using clock      = std::chrono::steady_clock;
+  using time_point = clock::time_point;
+  using duration   = clock::duration;
+
+ private:
+  // Intrusive heap node of a pending operation; `fire(node, expired)` completes it, with
+  // `expired` false when the timer shuts down first
+  struct timer_node {
+    void (*fire)(timer_node*, bool) noexcept;
+    time_point    deadline{};
+    std::uint64_t sequence{0};
+    std::size_t   heap_index{npos};
+  };
+
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+ public:
+  timer_scheduler() : thread_([this] { run(); }) {}
+
+  ~timer_scheduler() {
+    {
+      std::scoped_lock lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+  }
+
+  timer_scheduler(const timer_scheduler&)                    = delete;
+  auto operator=(const timer_scheduler&) -> timer_scheduler& = delete;
+
+  class timer_scheduler_handle {
+   public:
+    using scheduler_concept = scheduler_t;
+
+    explicit timer_scheduler_handle(timer_scheduler* timer) noexcept : timer_(timer) {}
+
+    [[nodiscard]] auto schedule() const noexcept {
+      return _timer_sender{timer_, std::nullopt, {}};
+    }
+
+    [[nodiscard]] auto schedule_after(duration delay) const noexcept {
+      return _timer_sender{timer_, std::nullopt, delay};
+    }
+
+    [[nodiscard]] auto schedule_at(time_point deadline) const noexcept {
+      return _timer_sender{timer_, deadline, {}};
+    }
+
+    [[nodiscard]] static auto now() noexcept -> time_point {
+      return clock::now();
+    }
+
+    [[nodiscard]] static auto query(get_forward_progress_guarantee_t /*unused*/) noexcept {
+      return forward_progress_guarantee::concurrent;
+    }
+
+    auto operator==(const timer_scheduler_handle& other) const noexcept -> bool {
+      return timer_ == other.timer_;
+    }
+
+   private:
+    timer_scheduler* timer_;
+  };
+
+  auto get_scheduler() noexcept -> timer_scheduler_handle {
+    return timer_scheduler_handle{this};
+  }
+
+  // Operations waiting for their deadline
+  [[nodiscard]] auto pending() const noexcept -> std::size_t {
+    std::scoped_lock lock(mutex_);
+    return heap_.size();
+  }
+
+ private:
+  template <class Rcvr>
+  class _timer_operation : timer_node {
+    struct on_stop_requested {
+      _timer_operation* self;
+
+      void operator()() const noexcept {
+        if (self->timer_->cancel(self)) {
+          self->arrive();
+        }
+      }
+    };
+
+    using stop_token_t       = stop_token_of_t<decltype(get_env(std::declval<const Rcvr&>()))>;
+    using on_stop_callback_t = stop_callback_for_t<stop_token_t, on_stop_requested>;
+
+   public:
+    using operation_state_concept = operation_state_t;
+
+    template <class R>
+    _timer_operation(timer_scheduler* timer, std::optional<time_point> deadline, duration delay,
+                     R&& r)
+        : timer_node{.fire = &on_fire},
+          timer_(timer),
+          at_(deadline),
+          delay_(delay),
+          receiver_(std::forward<R>(r)) {}
+
+    _timer_operation(const _timer_operation&)                    = delete;
+    auto operator=(const _timer_operation&) -> _timer_operation& = delete;
+
+    void start() & noexcept {
+      auto token = get_stop_token(get_env(receiver_));
+      if (token.stop_requested()) {
+        std::move(receiver_).set_stopped();
+        return;
+      }
+      deadline = at_.value_or(clock::now() + delay_);
+      try {
+        if (!timer_->add(this)) {
+          std::move(receiver_).set_stopped();
+          return;
+        }
+      } catch (...) {
+        std::move(receiver_).set_error(std::current_exception());
+        return;
+      }
+
+      // Completion needs both the deadline (or cancellation) and the end of start()
+      on_stop_.emplace(std::move(token), on_stop_requested{this});
+      arrive();
+    }
+
+   private:
+    static void on_fire(timer_node* node, bool expired) noexcept {
+      auto* self   = static_cast<_timer_operation*>(node);
+      self->fired_ = expired;
+      self->arrive();
+    }
+
+    void arrive() noexcept {
+      if (pending_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+      }
+      on_stop_.reset();
+      if (fired_) {
+        std::move(receiver_).set_value();
+      } else {
+        std::move(receiver_).set_stopped();
+      }
+    }
+
+    timer_scheduler*                  timer_;
+    std::optional<time_point>         at_;
+    duration                          delay_;
+    Rcvr                              receiver_;
+    bool                              fired_{false};
+    std::atomic<int>                  pending_{2};
+    std::optional<on_stop_callback_t> on_stop_;
+  };
+
+  struct _timer_sender {
+    using sender_concept = sender_t;
+    using value_types    = type_list<>;  // schedule() sends no values
+
+    timer_scheduler*          timer_;
+    std::optional<time_point> deadline_;  // Absolute deadline, else `delay_` after start
+    duration                  delay_;
+
+    template <class Env>
+    auto get_completion_signatures(Env&& /*unused*/) const noexcept {
+      return completion_signatures<set_value_t(), set_error_t(std::exception_ptr),
+                                   set_stopped_t()>{};
+    }
+
+    template <receiver R>
+    auto connect(R&& r) const {
+      return _timer_operation<__decay_t<R>>{timer_, deadline_, delay_, std::forward<R>(r)};
+    }
+
+    [[nodiscard]] auto query(get_completion_scheduler_t<set_value_t> /*unused*/) const noexcept {
+      return timer_scheduler_handle{timer_};
+    }
+  };
+
+  // Links `node` into the heap; false if the timer is shutting down
+  auto add(timer_node* node) -> bool {
+    bool earliest = false;
+    {
+      std::scoped_lock lock(mutex_);
+      if (stop_) {
+        return false;
+      }
+      node->sequence = next_sequence_++;
+      heap_.push_back(node);
+      node->heap_index = heap_.size() - 1;
+      sift_up(node->heap_index);
+      earliest = heap_.front() == node;
+    }
+    FLOW_TRACE_EVENT(enqueue, timer_scheduler, 0);
+    if (earliest) {
+      cv_.notify_one();
+    }
+    return true;
+  }
+
+  // Removes a pending node; false if it already fired
+  auto cancel(timer_node* node) noexcept -> bool {
+    std::scoped_lock lock(mutex_);
+    if (node->heap_index == npos) {
+      return false;
+    }
+    remove(node->heap_index);
+    return true;
+  }
+
+  void run() {
+    FLOW_TRACE_THREAD_NAME("timer_scheduler");
+
+    std::vector<timer_node*> due;
+    detail::unique_lock      lock(mutex_);
+    while (!stop_) {
+      if (heap_.empty()) {
+        cv_.wait(lock);
+        continue;
+      }
+      const time_point deadline = heap_.front()->deadline;
+      if (clock::now() < deadline) {
+        cv_.wait_until(lock, deadline);
+        continue;
+      }
+
+      // Fire everything that is due in one pass, outside the lock
+      const time_point now = clock::now();
+      while (!heap_.empty() && heap_.front()->deadline <= now) {
+        due.push_back(heap_.front());
+        remove(0);
+      }
+      lock.unlock();
+      for (timer_node* node : due) {
+        FLOW_TRACE_EVENT(start, timer_scheduler, 0);
+        node->fire(node, true);
+        FLOW_TRACE_EVENT(finish, timer_scheduler, 0);
+      }
+      due.clear();
+      lock.lock();
+    }
+
+    // Shutdown: complete the remaining operations with set_stopped
+    while (!heap_.empty()) {
+      timer_node* node = heap_.front();
+      remove(0);
+      lock.unlock();
+      node->fire(node, false);
+      lock.lock();
+    }
+  }
+
+  static auto earlier(const timer_node* a, const timer_node* b) noexcept -> bool {
+    return a->deadline < b->deadline || (a->deadline == b->deadline && a->sequence < b->sequence);
+  }
+
+  void place(timer_node* node, std::size_t index) noexcept {
+    heap_[index]     = node;
+    node->heap_index = index;
+  }
+
+  void sift_up(std::size_t index) noexcept {
+    timer_node* node = heap_[index];
+    while (index > 0) {
+      const std::size_t parent = (index - 1) / 2;
+      if (!earlier(node, heap_[parent])) {
+        break;
+      }
+      place(heap_[parent], index);
+      index = parent;
+    }
+    place(node, index);
+  }
+
+  void sift_down(std::size_t index) noexcept {
+    timer_node*       node = heap_[index];
+    const std::size_t size = heap_.size();
+    while (true) {
+      std::size_t child = (2 * index) + 1;
+      if (child >= size) {
+        break;
+      }
+      if (child + 1 < size && earlier(heap_[child + 1], heap_[child])) {
+        ++child;
+      }
+      if (!earlier(heap_[child], node)) {
+        break;
+      }
+      place(heap_[child], index);
+      index = child;
+    }
+    place(node, index);
+  }
+
+  void remove(std::size_t index) noexcept {
+    timer_node* node = heap_[index];
+    timer_node* last = heap_.back();
+    heap_.pop_back();
+    node->heap_index = npos;
+    if (last != node) {
+      place(last, index);
+      sift_down(index);
+      sift_up(last->heap_index);
+    }
+  }
+
+  std::vector<timer_node*>   heap_;
+  std::uint64_t              next_sequence_{0};
+  mutable detail::mutex      mutex_{"timer_scheduler"};
+  detail::condition_variable cv_;
+  bool                       stop_{false};
+  std::thread                thread_;
+};
+
+struct schedule_after_t {
+  template <class Sched, class Rep, class Period>
+    requires requires(const Sched& sched, std::chrono::duration<Rep, Period> d) {
+      sched.schedule_after(d);
+    }
+  auto operator()(const Sched& sched, std::chrono::duration<Rep, Period> delay) const noexcept {
+    return sched.schedule_after(delay);
+  }
+};
+
+struct schedule_at_t {
+  template <class Sched, class TimePoint>
+    requires requires(const Sched& sched, TimePoint t) { sched.schedule_at(t); }
+  auto operator()(const Sched& sched, TimePoint deadline) const noexcept {
+    return sched.schedule_at(deadline);
+  }
+};
+
+inline constexpr schedule_after_t schedule_after{};
+inline constexpr schedule_at_t    schedule_at{};
+
+}  // namespace flow::execution
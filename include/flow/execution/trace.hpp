@@ -0,0 +1,517 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../detail/mutex.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace flow::execution::trace {
+
+// Task lifecycle tracing for the built-in schedulers
+//
+// Scheduler hot paths call FLOW_TRACE_EVENT(kind, source, id). When the library is built
+// without FLOW_ENABLE_TRACING the macro expands to nothing and its arguments are never
+// evaluated, so disabled builds carry no cost at all.
+//
+// When enabled, every thread owns a fixed-size ring buffer that only it writes to. Recording
+// an event is a thread_local lookup, a timestamp counter read and a single release store, with
+// no locks and no allocation after the first event on a thread. Old events are overwritten when
+// a ring wraps. The dump functions may run concurrently with recording, but events written while
+// a dump is in progress can be torn; dump after the schedulers have quiesced for exact output.
+//
+// A thread's buffer outlives the thread so that its events still appear in the next dump. Once
+// that dump (or a clear) has drained them, the buffer is handed to the next thread that starts
+// recording, so short-lived threads reuse buffers instead of adding one each.
+
+enum class event_kind : std::uint8_t { enqueue, start, finish, steal, park, unpark };
+
+enum class source : std::uint8_t {
+  work_stealing_scheduler,
+  thread_pool,
+  run_loop,
+  io_context,
+  timer_scheduler,
+  edf_scheduler
+};
+
+struct event {
+  std::uint64_t timestamp;  // Raw timestamp counter ticks
+  std::uint64_t id;         // Task identity (0 when the scheduler has none to offer)
+  event_kind    kind;
+  source        origin;
+};
+
+// All events recorded by one thread, with timestamps converted to nanoseconds
+struct thread_trace {
+  struct entry {
+    std::uint64_t time_ns;
+    std::uint64_t id;
+    event_kind    kind;
+    source        origin;
+  };
+
+  std::uint32_t      tid;
+  std::string        name;
+  std::vector<entry> events;
+};
+
+#if defined(FLOW_TRACE_BUFFER_EVENTS)
+inline constexpr std::size_t buffer_events = FLOW_TRACE_BUFFER_EVENTS;
+#else
+inline constexpr std::size_t buffer_events = std::size_t{1} << 16;
+#endif
+
+static_assert((buffer_events & (buffer_events - 1)) == 0, "trace buffer size must be a power of 2");
+
+namespace _trace_detail {
+
+inline auto read_counter() noexcept -> std::uint64_t {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  std::uint64_t ticks;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+#else
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                        std::chrono::steady_clock::now().time_since_epoch())
+                                        .count());
+#endif
+}
+
+inline auto steady_ns() noexcept -> std::uint64_t {
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                        std::chrono::steady_clock::now().time_since_epoch())
+                                        .count());
+}
+
+// Owner of a buffer: a recording thread, an exited thread whose events were not dumped yet, or
+// none
+enum class buffer_state : std::uint8_t { active, exited, free };
+
+// Single-writer ring buffer owned by one thread
+struct thread_buffer {
+  std::unique_ptr<event[]>   events{new event[buffer_events]};
+  std::atomic<std::uint64_t> head{0};
+  std::atomic<buffer_state>  state{buffer_state::active};
+  std::uint32_t              tid{0};
+  std::string                name;  // Guarded by registry::names_mutex_
+  thread_buffer*             next{nullptr};
+};
+
+class registry {
+ public:
+  static auto instance() noexcept -> registry& {
+    static registry reg;
+    return reg;
+  }
+
+  registry(const registry&)                    = delete;
+  auto operator=(const registry&) -> registry& = delete;
+
+  ~registry() {
+    auto* buf = buffers_.load(std::memory_order_acquire);
+    while (buf != nullptr) {
+      auto* next = buf->next;
+      delete buf;  // NOLINT(cppcoreguidelines-owning-memory)
+      buf = next;
+    }
+  }
+
+  // Buffer for the calling thread, registered on first use and retired when the thread exits
+  auto local() noexcept -> thread_buffer* {
+    thread_local const owner guard{register_thread()};
+    return guard.buf;
+  }
+
+  void set_name(std::string_view name) {
+    auto* buf = local();
+    if (buf == nullptr) {
+      return;
+    }
+    std::scoped_lock lock(names_mutex_);
+    buf->name.assign(name);
+  }
+
+  auto collect() -> std::vector<thread_trace> {
+    // Calibrate counter ticks against the steady clock over the whole recording window
+    const auto   now_ticks   = read_counter();
+    const auto   now_ns      = steady_ns();
+    const double ns_per_tick = now_ticks > start_ticks_
+                                   ? static_cast<double>(now_ns - start_ns_)
+                                         / static_cast<double>(now_ticks - start_ticks_)
+                                   : 1.0;
+
+    auto to_ns = [&](std::uint64_t ticks) -> std::uint64_t {
+      if (ticks <= start_ticks_) {
+        return 0;
+      }
+      return static_cast<std::uint64_t>(static_cast<double>(ticks - start_ticks_) * ns_per_tick);
+    };
+
+    std::vector<thread_trace> traces;
+    std::scoped_lock          lock(names_mutex_);
+    for (auto* buf = buffers_.load(std::memory_order_acquire); buf != nullptr; buf = buf->next) {
+      // Read before the events: a thread that has not exited yet may still record more
+      const auto state = buf->state.load(std::memory_order_acquire);
+      if (state == buffer_state::free) {
+        continue;
+      }
+      const auto head  = buf->head.load(std::memory_order_acquire);
+      const auto first = head > buffer_events ? head - buffer_events : 0;
+
+      thread_trace trace{.tid = buf->tid, .name = buf->name, .events = {}};
+      trace.events.reserve(static_cast<std::size_t>(head - first));
+      for (auto i = first; i < head; ++i) {
+        const auto& e = buf->events[i & (buffer_events - 1)];
+        trace.events.push_back({to_ns(e.timestamp), e.id, e.kind, e.origin});
+      }
+      traces.push_back(std::move(trace));
+      if (state == buffer_state::exited) {
+        release_if_exited(buf);  // Every event of the exited thread is in `traces` now
+      }
+    }
+    return traces;
+  }
+
+  // Drop recorded events; only meaningful while no thread is recording
+  void clear() noexcept {
+    for (auto* buf = buffers_.load(std::memory_order_acquire); buf != nullptr; buf = buf->next) {
+      buf->head.store(0, std::memory_order_release);
+      release_if_exited(buf);
+    }
+  }
+
+ private:
+  registry() : start_ticks_(read_counter()), start_ns_(steady_ns()) {}
+
+  // Retires the calling thread's buffer when the thread exits
+  struct owner {
+    thread_buffer* buf;
+
+    explicit owner(thread_buffer* b) noexcept : buf(b) {}
+
+    owner(const owner&)                    = delete;
+    auto operator=(const owner&) -> owner& = delete;
+
+    ~owner() {
+      if (buf != nullptr) {
+        // A buffer without events has nothing left to dump
+        buf->state.store(buf->head.load(std::memory_order_relaxed) == 0 ? buffer_state::free
+                                                                         : buffer_state::exited,
+                         std::memory_order_release);
+      }
+    }
+  };
+
+  // No thread writes an exited buffer, so its events can be dropped before it is freed
+  static void release_if_exited(thread_buffer* buf) noexcept {
+    if (buf->state.load(std::memory_order_acquire) != buffer_state::exited) {
+      return;
+    }
+    buf->head.store(0, std::memory_order_relaxed);
+    auto expected = buffer_state::exited;
+    buf->state.compare_exchange_strong(expected, buffer_state::free, std::memory_order_acq_rel);
+  }
+
+  // Takes over a buffer that no thread owns and that has been drained
+  auto reuse_thread_buffer() noexcept -> thread_buffer* {
+    for (auto* buf = buffers_.load(std::memory_order_acquire); buf != nullptr; buf = buf->next) {
+      auto expected = buffer_state::free;
+      if (buf->state.compare_exchange_strong(expected, buffer_state::active,
+                                             std::memory_order_acq_rel)) {
+        buf->head.store(0, std::memory_order_release);
+        return buf;
+      }
+    }
+    return nullptr;
+  }
+
+  auto register_thread() noexcept -> thread_buffer* {
+    thread_buffer* buf = nullptr;
+    try {
+      if ((buf = reuse_thread_buffer()) != nullptr) {
+        std::scoped_lock lock(names_mutex_);
+        buf->name.clear();
+        buf->tid = next_tid_.fetch_add(1, std::memory_order_relaxed);
+        return buf;
+      }
+      buf = new thread_buffer{};  // NOLINT(cppcoreguidelines-owning-memory)
+    } catch (...) {
+      // Tracing is best-effort; drop this thread's events
+      if (buf != nullptr) {
+        buf->state.store(buffer_state::free, std::memory_order_release);
+      }
+      return nullptr;
+    }
+    buf->tid = next_tid_.fetch_add(1, std::memory_order_relaxed);
+
+    // Push-only intrusive list: no ABA since nodes are never removed while running; buffers
+    // of exited threads stay linked and are reused in place
+    auto* head = buffers_.load(std::memory_order_relaxed);
+    do {
+      buf->next = head;
+    } while (!buffers_.compare_exchange_weak(head, buf, std::memory_order_release,
+                                             std::memory_order_relaxed));
+    return buf;
+  }
+
+  std::atomic<thread_buffer*> buffers_{nullptr};
+  std::atomic<std::uint32_t>  next_tid_{1};
+  detail::mutex               names_mutex_{"trace::thread_names"};
+  const std::uint64_t         start_ticks_;
+  const std::uint64_t         start_ns_;
+};
+
+inline auto source_name(source s) noexcept -> std::string_view {
+  switch (s) {
+    case source::work_stealing_scheduler:
+      return "work_stealing_scheduler";
+    case source::thread_pool:
+      return "thread_pool";
+    case source::run_loop:
+      return "run_loop";
+    case source::io_context:
+      return "io_context";
+    case source::timer_scheduler:
+      return "timer_scheduler";
+    case source::edf_scheduler:
+      return "edf_scheduler";
+  }
+  return "unknown";
+}
+
+// Slice/instant name shown in trace viewers
+inline auto event_name(const thread_trace::entry& e) -> std::string {
+  switch (e.kind) {
+    case event_kind::start:
+    case event_kind::finish:
+      return std::string(source_name(e.origin)) + ".task";
+    case event_kind::enqueue:
+      return std::string(source_name(e.origin)) + ".enqueue";
+    case event_kind::steal:
+      return std::string(source_name(e.origin)) + ".steal";
+    case event_kind::park:
+    case event_kind::unpark:
+      return std::string(source_name(e.origin)) + ".parked";
+  }
+  return "unknown";
+}
+
+inline void write_json_string(std::ostream& os, std::string_view s) {
+  os << '"';
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      os << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      os << ' ';
+    } else {
+      os << c;
+    }
+  }
+  os << '"';
+}
+
+// Minimal protobuf wire-format writer for the Perfetto trace schema
+class proto_writer {
+ public:
+  void varint(std::uint32_t field, std::uint64_t value) {
+    tag(field, 0);
+    raw_varint(value);
+  }
+
+  void bytes(std::uint32_t field, std::string_view value) {
+    tag(field, 2);
+    raw_varint(value.size());
+    out_.append(value);
+  }
+
+  void message(std::uint32_t field, const proto_writer& nested) {
+    bytes(field, nested.out_);
+  }
+
+  [[nodiscard]] auto data() const noexcept -> const std::string& {
+    return out_;
+  }
+
+ private:
+  void tag(std::uint32_t field, std::uint32_t wire_type) {
+    raw_varint((static_cast<std::uint64_t>(field) << 3) | wire_type);
+  }
+
+  void raw_varint(std::uint64_t value) {
+    while (value >= 0x80) {
+      out_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+    out_.push_back(static_cast<char>(value));
+  }
+
+  std::string out_;
+};
+
+}  // namespace _trace_detail
+
+// Record one event on the calling thread's ring buffer
+inline void record(event_kind kind, source origin, std::uint64_t id) noexcept {
+  auto* buf = _trace_detail::registry::instance().local();
+  if (buf == nullptr) {
+    return;
+  }
+  const auto head = buf->head.load(std::memory_order_relaxed);
+  buf->events[head & (buffer_events - 1)] =
+      event{.timestamp = _trace_detail::read_counter(), .id = id, .kind = kind, .origin = origin};
+  buf->head.store(head + 1, std::memory_order_release);
+}
+
+// Label the calling thread in dumped traces
+inline void set_thread_name(std::string_view name) {
+  _trace_detail::registry::instance().set_name(name);
+}
+
+// Snapshot of every thread's events, oldest first
+inline auto collect() -> std::vector<thread_trace> {
+  return _trace_detail::registry::instance().collect();
+}
+
+inline void clear() noexcept {
+  _trace_detail::registry::instance().clear();
+}
+
+// Chrome trace event format, loadable by chrome://tracing and ui.perfetto.dev
+inline void write_chrome_json(std::ostream& os) {
+  constexpr int pid   = 1;
+  bool          first = true;
+  auto          sep   = [&] {
+    os << (first ? "\n" : ",\n");
+    first = false;
+  };
+
+  os << R"({"displayTimeUnit":"ns","traceEvents":[)";
+  for (const auto& thread : collect()) {
+    if (!thread.name.empty()) {
+      sep();
+      os << R"({"name":"thread_name","ph":"M","pid":)" << pid << R"(,"tid":)" << thread.tid
+         << R"(,"args":{"name":)";
+      _trace_detail::write_json_string(os, thread.name);
+      os << "}}";
+    }
+
+    for (const auto& e : thread.events) {
+      const char* phase = "i";
+      if (e.kind == event_kind::start || e.kind == event_kind::park) {
+        phase = "B";
+      } else if (e.kind == event_kind::finish || e.kind == event_kind::unpark) {
+        phase = "E";
+      }
+
+      sep();
+      os << R"({"name":)";
+      _trace_detail::write_json_string(os, _trace_detail::event_name(e));
+      os << R"(,"cat":"flow","ph":")" << phase << R"(","ts":)" << (e.time_ns / 1000) << '.'
+         << (e.time_ns % 1000 / 100) << (e.time_ns % 100 / 10) << (e.time_ns % 10)
+         << R"(,"pid":)" << pid << R"(,"tid":)" << thread.tid;
+      if (phase[0] == 'i') {
+        os << R"(,"s":"t")";
+      }
+      os << R"(,"args":{"id":)" << e.id << "}}";
+    }
+  }
+  os << "\n]}\n";
+}
+
+// Perfetto protobuf trace (perfetto.protos.Trace), loadable by ui.perfetto.dev
+inline void write_perfetto(std::ostream& os) {
+  // Field numbers from perfetto/trace/trace_packet.proto and track_event/*.proto
+  constexpr std::uint32_t trace_packet               = 1;
+  constexpr std::uint32_t packet_timestamp           = 8;
+  constexpr std::uint32_t packet_sequence_id         = 10;
+  constexpr std::uint32_t packet_track_event         = 11;
+  constexpr std::uint32_t packet_track_descriptor    = 60;
+  constexpr std::uint32_t track_descriptor_uuid      = 1;
+  constexpr std::uint32_t track_descriptor_thread    = 4;
+  constexpr std::uint32_t thread_descriptor_pid      = 1;
+  constexpr std::uint32_t thread_descriptor_tid      = 2;
+  constexpr std::uint32_t thread_descriptor_name     = 5;
+  constexpr std::uint32_t track_event_type           = 9;
+  constexpr std::uint32_t track_event_track_uuid     = 11;
+  constexpr std::uint32_t track_event_name           = 23;
+  constexpr std::uint64_t type_slice_begin           = 1;
+  constexpr std::uint64_t type_slice_end             = 2;
+  constexpr std::uint64_t type_instant               = 3;
+  constexpr std::uint64_t sequence_id                = 1;
+  constexpr std::uint64_t pid                        = 1;
+  constexpr std::uint64_t track_uuid_base            = 0x666c6f77'00000000ULL;  // "flow"
+
+  auto emit = [&os](const _trace_detail::proto_writer& packet) {
+    _trace_detail::proto_writer wrapper;
+    wrapper.message(trace_packet, packet);
+    os.write(wrapper.data().data(), static_cast<std::streamsize>(wrapper.data().size()));
+  };
+
+  for (const auto& thread : collect()) {
+    const auto uuid = track_uuid_base + thread.tid;
+
+    _trace_detail::proto_writer thread_desc;
+    thread_desc.varint(thread_descriptor_pid, pid);
+    thread_desc.varint(thread_descriptor_tid, thread.tid);
+    if (!thread.name.empty()) {
+      thread_desc.bytes(thread_descriptor_name, thread.name);
+    }
+    _trace_detail::proto_writer track_desc;
+    track_desc.varint(track_descriptor_uuid, uuid);
+    track_desc.message(track_descriptor_thread, thread_desc);
+    _trace_detail::proto_writer desc_packet;
+    desc_packet.message(packet_track_descriptor, track_desc);
+    desc_packet.varint(packet_sequence_id, sequence_id);
+    emit(desc_packet);
+
+    for (const auto& e : thread.events) {
+      std::uint64_t type = type_instant;
+      if (e.kind == event_kind::start || e.kind == event_kind::park) {
+        type = type_slice_begin;
+      } else if (e.kind == event_kind::finish || e.kind == event_kind::unpark) {
+        type = type_slice_end;
+      }
+
+      _trace_detail::proto_writer track_event;
+      track_event.varint(track_event_type, type);
+      track_event.varint(track_event_track_uuid, uuid);
+      if (type != type_slice_end) {
+        track_event.bytes(track_event_name, _trace_detail::event_name(e));
+      }
+      _trace_detail::proto_writer packet;
+      packet.varint(packet_timestamp, e.time_ns);
+      packet.message(packet_track_event, track_event);
+      packet.varint(packet_sequence_id, sequence_id);
+      emit(packet);
+    }
+  }
+}
+
+}  // namespace flow::execution::trace
+
+// Hooks used by the scheduler implementations
+#if defined(FLOW_ENABLE_TRACING)
+#define FLOW_TRACE_EVENT(kind, origin, id)                                    \
+  ::flow::execution::trace::record(::flow::execution::trace::event_kind::kind, \
+                                   ::flow::execution::trace::source::origin,   \
+                                   static_cast<std::uint64_t>(id))
+#define FLOW_TRACE_THREAD_NAME(name) ::flow::execution::trace::set_thread_name(name)
+#else
+#define FLOW_TRACE_EVENT(kind, origin, id) static_cast<void>(0)
+#define FLOW_TRACE_THREAD_NAME(name) static_cast<void>(0)
+#endif
@@ -7,6 +7,7 @@
 #include <utility>
 
 #include "completion_signatures.hpp"
+#include "instrument.hpp"
 #include "scheduler.hpp"
 #include "sender.hpp"
 #include "type_list.hpp"
@@ -189,6 +190,7 @@ struct _transfer_sender {
       // On successful completion, store values and schedule continuation
       template <class... Args>
       void set_value(Args&&... args) && noexcept {
+        _instrument_detail::mark_stage(state_->receiver_, "transfer", stage_completion::value);
         try {
           // Store the values
           state_->storage_.store(std::forward<Args>(args)...);
@@ -234,14 +236,20 @@ struct _transfer_sender {
       // Errors and stopped are propagated directly without scheduling
       template <class E>
       void set_error(E&& e) && noexcept {
+        _instrument_detail::mark_stage(state_->receiver_, "transfer", stage_completion::error);
         state_->cleanup_ = nullptr;  // Clear cleanup
         std::move(state_->receiver_).set_error(std::forward<E>(e));
       }
 
       void set_stopped() && noexcept {
+        _instrument_detail::mark_stage(state_->receiver_, "transfer", stage_completion::stopped);
         state_->cleanup_ = nullptr;  // Clear cleanup
         std::move(state_->receiver_).set_stopped();
       }
+
+      auto get_env() const noexcept {
+        return flow::execution::get_env(state_->receiver_);
+      }
     };
 
     // Continuation receiver that runs on the new scheduler
@@ -276,6 +284,10 @@ struct _transfer_sender {
         state_->cleanup_ = nullptr;  // Clear cleanup
         std::move(state_->receiver_).set_stopped();
       }
+
+      auto get_env() const noexcept {
+        return flow::execution::get_env(state_->receiver_);
+      }
     };
   };
 };
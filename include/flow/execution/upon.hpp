@@ -6,6 +6,7 @@
 #include <utility>
 
 #include "completion_signatures.hpp"
+#include "instrument.hpp"
 #include "sender.hpp"
 #include "type_list.hpp"
 
@@ -48,6 +49,14 @@ struct _type_list_to_set_value<type_list<Ts...>> {
 template <class TypeList>
 using type_list_to_set_value_t = typename _type_list_to_set_value<TypeList>::type;
 
+// Whether F cannot throw for any of the errors in a signature list
+template <class F, class Sigs>
+inline constexpr bool nothrow_on_errors = false;
+
+template <class F, class... Es>
+inline constexpr bool nothrow_on_errors<F, completion_signatures<set_error_t(Es)...>> =
+    (std::is_nothrow_invocable_v<F, Es> && ...);
+
 }  // namespace _upon_detail
 
 // [exec.adaptors.upon_error], upon_error adaptor
@@ -60,11 +69,16 @@ struct _upon_error_sender {
   S sender_;
   F fun_;
 
+  // F's result replaces the predecessor's errors; a noexcept F adds no set_error(exception_ptr)
   template <class Env>
   auto get_completion_signatures(Env&& /*unused*/) const {
     // Convert value_types (type_list) to proper set_value_t signature
     using set_value_sig = _upon_detail::type_list_to_set_value_t<value_types>;
-    return completion_signatures<set_value_sig, set_error_t(std::exception_ptr), set_stopped_t()>{};
+    using errors        = __completion_signatures_of_t<S, Env, set_error_t>;
+    return __concat_completion_signatures_t<
+        completion_signatures<set_value_sig>,
+        __completion_signatures_of_t<S, Env, set_value_t, set_stopped_t>,
+        __exception_signatures_t<!_upon_detail::nothrow_on_errors<F, errors>>>{};
   }
 
   template <receiver R>
@@ -88,26 +102,43 @@ struct _upon_error_sender {
 
     template <class... Args>
     void set_value(Args&&... args) && noexcept {
+      _instrument_detail::mark_stage(receiver_, "upon_error", stage_completion::value);
       std::move(receiver_).set_value(std::forward<Args>(args)...);
     }
 
     template <class E>
     void set_error(E&& e) && noexcept {
-      try {
-        if constexpr (std::is_void_v<std::invoke_result_t<Fn, E>>) {
-          std::invoke(std::move(fun_), std::forward<E>(e));
-          std::move(receiver_).set_value();
-        } else {
-          std::move(receiver_).set_value(std::invoke(std::move(fun_), std::forward<E>(e)));
+      _instrument_detail::mark_stage(receiver_, "upon_error", stage_completion::error);
+      if constexpr (std::is_nothrow_invocable_v<Fn, E>) {
+        invoke_and_complete(std::forward<E>(e));
+      } else {
+        try {
+          invoke_and_complete(std::forward<E>(e));
+        } catch (...) {
+          std::move(receiver_).set_error(std::current_exception());
         }
-      } catch (...) {
-        std::move(receiver_).set_error(std::current_exception());
       }
     }
 
     void set_stopped() && noexcept {
+      _instrument_detail::mark_stage(receiver_, "upon_error", stage_completion::stopped);
       std::move(receiver_).set_stopped();
     }
+
+    auto get_env() const noexcept {
+      return flow::execution::get_env(receiver_);
+    }
+
+   private:
+    template <class... Args>
+    void invoke_and_complete(Args&&... args) {
+      if constexpr (std::is_void_v<std::invoke_result_t<Fn, Args...>>) {
+        std::invoke(std::move(fun_), std::forward<Args>(args)...);
+        std::move(receiver_).set_value();
+      } else {
+        std::move(receiver_).set_value(std::invoke(std::move(fun_), std::forward<Args>(args)...));
+      }
+    }
   };
 };
 
@@ -121,15 +152,14 @@ struct _upon_stopped_sender {
   S sender_;
   F fun_;
 
+  // F's result replaces the predecessor's stopped; a noexcept F adds no set_error(exception_ptr)
   template <class Env>
   auto get_completion_signatures(Env&& /*unused*/) const {
-    if constexpr (std::is_void_v<std::invoke_result_t<F>>) {
-      return completion_signatures<set_value_t(), set_error_t(std::exception_ptr),
-                                   set_stopped_t()>{};
-    } else {
-      return completion_signatures<set_value_t(std::invoke_result_t<F>),
-                                   set_error_t(std::exception_ptr), set_stopped_t()>{};
-    }
+    using set_value_sig = _upon_detail::type_list_to_set_value_t<value_types>;
+    return __concat_completion_signatures_t<
+        completion_signatures<set_value_sig>,
+        __completion_signatures_of_t<S, Env, set_value_t, set_error_t>,
+        __exception_signatures_t<!std::is_nothrow_invocable_v<F>>>{};
   }
 
   template <receiver R>
@@ -153,24 +183,41 @@ struct _upon_stopped_sender {
 
     template <class... Args>
     void set_value(Args&&... args) && noexcept {
+      _instrument_detail::mark_stage(receiver_, "upon_stopped", stage_completion::value);
       std::move(receiver_).set_value(std::forward<Args>(args)...);
     }
 
     template <class E>
     void set_error(E&& e) && noexcept {
+      _instrument_detail::mark_stage(receiver_, "upon_stopped", stage_completion::error);
       std::move(receiver_).set_error(std::forward<E>(e));
     }
 
     void set_stopped() && noexcept {
-      try {
-        if constexpr (std::is_void_v<std::invoke_result_t<Fn>>) {
-          std::invoke(std::move(fun_));
-          std::move(receiver_).set_value();
-        } else {
-          std::move(receiver_).set_value(std::invoke(std::move(fun_)));
+      _instrument_detail::mark_stage(receiver_, "upon_stopped", stage_completion::stopped);
+      if constexpr (std::is_nothrow_invocable_v<Fn>) {
+        invoke_and_complete();
+      } else {
+        try {
+          invoke_and_complete();
+        } catch (...) {
+          std::move(receiver_).set_error(std::current_exception());
         }
-      } catch (...) {
-        std::move(receiver_).set_error(std::current_exception());
+      }
+    }
+
+    auto get_env() const noexcept {
+      return flow::execution::get_env(receiver_);
+    }
+
+   private:
+    template <class... Args>
+    void invoke_and_complete(Args&&... args) {
+      if constexpr (std::is_void_v<std::invoke_result_t<Fn, Args...>>) {
+        std::invoke(std::move(fun_), std::forward<Args>(args)...);
+        std::move(receiver_).set_value();
+      } else {
+        std::move(receiver_).set_value(std::invoke(std::move(fun_), std::forward<Args>(args)...));
       }
     }
   };
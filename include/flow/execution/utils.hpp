@@ -1,6 +1,7 @@
 #pragma once
 
 #include <type_traits>
+#include <utility>
 
 namespace flow::execution {
 
@@ -11,4 +12,19 @@ using __decay_t = std::decay_t<T>;
 template <class T>
 using __remove_cvref_t = std::remove_cvref_t<T>;
 
+// Converts to the result of calling F. Lets immovable operation states be constructed in
+// place, e.g. op.emplace(__emplace_from{[&] { return connect(sndr, rcvr); }}) on an optional.
+template <class F>
+struct __emplace_from {
+  F fun_;
+
+  operator std::invoke_result_t<F>() && noexcept(  // NOLINT(google-explicit-constructor)
+      std::is_nothrow_invocable_v<F>) {
+    return std::move(fun_)();
+  }
+};
+
+template <class F>
+__emplace_from(F) -> __emplace_from<F>;
+
 }  // namespace flow::execution
@@ -2,12 +2,13 @@
 
 #include <atomic>
 #include <exception>
-#include <mutex>
 #include <optional>
 #include <tuple>
 #include <utility>
 
+#include "../detail/mutex.hpp"
 #include "completion_signatures.hpp"
+#include "instrument.hpp"
 #include "sender.hpp"
 #include "type_list.hpp"
 
@@ -105,7 +106,7 @@ struct _when_all_sender {
     std::atomic<std::size_t> completed_{0};
     std::atomic<bool>        error_occurred_{false};
     values_type              values_;
-    std::mutex               mutex_;
+    detail::mutex            mutex_{"when_all"};
     _when_all_operation(std::tuple<Ss...>&& sndrs, Rcvr&& r)
         : senders_(std::move(sndrs)), receiver_(std::move(r)) {}
 
@@ -172,6 +173,11 @@ struct _when_all_sender {
           std::move(parent_->receiver_).set_stopped();
         }
       }
+
+      // Children see the environment of when_all's receiver (stop token, deadline, ...)
+      auto get_env() const noexcept {
+        return _instrument_detail::concurrent_env(flow::execution::get_env(parent_->receiver_));
+      }
     };
 
     template <std::size_t... Is>
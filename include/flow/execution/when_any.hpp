@@ -9,6 +9,7 @@
 
 #include "completion_signatures.hpp"
 #include "env.hpp"
+#include "instrument.hpp"
 #include "sender.hpp"
 #include "stop_token.hpp"
 #include "type_list.hpp"
@@ -605,8 +606,9 @@ struct _when_any_sender {
       auto get_env() const noexcept {
         // Inject stop token into environment and forward parent receiver's environment
         // This ensures all environment queries are properly forwarded to nested operations
-        return make_env_with_stop_token(parent_->stop_source_.get_token(),
-                                        flow::execution::get_env(parent_->receiver_));
+        return make_env_with_stop_token(
+            parent_->stop_source_.get_token(),
+            _instrument_detail::concurrent_env(flow::execution::get_env(parent_->receiver_)));
       }
     };
   };
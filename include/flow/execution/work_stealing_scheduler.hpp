@@ -1,20 +1,31 @@
 #pragma once
 
+#include <array>
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
 #include <cstdint>
-#include <deque>
 #include <exception>
-#include <functional>
 #include <memory>
-#include <mutex>
+#include <new>
+#include <optional>
 #include <random>
+#include <stdexcept>
+#include <string>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "../detail/mutex.hpp"
+#include "../detail/topology.hpp"
+#include "admission_control.hpp"
 #include "completion_signatures.hpp"
+#include "lock_free_queue.hpp"
+#include "env.hpp"
 #include "queries.hpp"
+#include "rcu.hpp"
 #include "scheduler.hpp"
+#include "trace.hpp"
 #include "try_scheduler.hpp"
 #include "type_list.hpp"
 
@@ -30,78 +41,259 @@ namespace flow::execution {
 // - G (goroutine): Lightweight task abstraction
 // - P (processor): Logical processor with local run queue
 // - M (machine): OS thread that executes tasks from P
+//
+// Load shedding: schedule() records the deadline of its receiver's environment (get_deadline,
+// see with_deadline). A worker that dequeues a task whose deadline has passed completes it with
+// set_stopped instead of running it, and then drops every other expired task in its local queue
+// under the same lock, so a backlog of abandoned work is cleared in one pass rather than one
+// dequeue at a time. The clock is read at most once per batch of dequeued tasks, and only when
+// a task has a deadline. Shed tasks are counted in stats_snapshot::tasks_shed.
+//
+// Admission control: constructed with codel_options, the scheduler times how long each task
+// waited in a queue and refuses new work while that delay stands above the target
+// (admission_control.hpp): try_schedule() fails with would_block_t, and with reject_schedule
+// schedule() fails with an exception_ptr holding overloaded_t.
+//
+// RCU: the workers are the readers of the scheduler's rcu_domain (rcu.hpp). A worker reports a
+// quiescent state between tasks and goes offline while parked, and versions retired by
+// rcu_cell updates are freed by a task queued on the scheduler once every worker has moved on.
+//
+// Topology mode: worker i is pinned to a CPU, with CPUs taken node by node (detail/topology.hpp),
+// and get_agent_scheduler(sched, i) returns a scheduler whose schedule() queues on worker i's
+// local queue, where it is never stolen (past a full queue it waits in that worker's own overflow
+// list) and does not keep idle workers from parking. The parallel bulk path then gives every
+// worker a fixed block of the index space (parallel_bulk.hpp), so repeated passes over the same
+// data run each index on the same CPU and node. Without topology mode workers float and chunks
+// go to whoever claims them first.
+
+enum class topology_mode : bool { off, on };
 
 class work_stealing_scheduler {
  public:
   // Task represents a unit of work (analogous to Go's G)
+  // Tasks are recycled through a free list, and callables up to inline_capacity bytes are
+  // stored in place, so steady-state scheduling does not touch the allocator.
   struct task {
-    std::function<void()> work;
-    std::atomic<uint64_t> sequence{0};  // For ordering and fairness
+    using time_point = std::chrono::steady_clock::time_point;
+
+    static constexpr std::size_t inline_capacity = 64;
+    static constexpr time_point  no_deadline     = time_point::max();
+
+    // Passed to a stored callable that is shed instead of run: f(expired_t{}) must complete
+    // its operation without doing the work
+    struct expired_t {};
+
+    task*                 next{nullptr};  // Intrusive link for the global and overflow queues
+    std::atomic<uint64_t> sequence{0};    // For ordering and fairness
     std::atomic<bool>     cancelled{false};
+    bool                  pinned{false};          // Queued for one worker; never stolen
+    time_point            deadline{no_deadline};  // Shed when dequeued after this point
+    time_point            enqueued{};             // Set only under admission control
+
+    task() = default;
+
+    task(const task&)                    = delete;
+    auto operator=(const task&) -> task& = delete;
 
-    explicit task(std::function<void()> w) : work(std::move(w)) {}
+    ~task() {
+      reset();
+    }
+
+    // Store a callable, in place if it fits in the inline buffer. A task with a deadline
+    // must hold a callable that also accepts expired_t.
+    template <class F>
+    void emplace(F&& f, time_point due = no_deadline) {
+      using fn_t = std::decay_t<F>;
+      deadline = due;
+      if constexpr (sizeof(fn_t) <= inline_capacity
+                    && alignof(fn_t) <= alignof(std::max_align_t)) {
+        ::new (static_cast<void*>(storage_)) fn_t(std::forward<F>(f));
+        invoke_ = [](task& t, bool expired) noexcept {
+          auto* fn = std::launder(reinterpret_cast<fn_t*>(t.storage_));
+          call(*fn, expired);
+          fn->~fn_t();
+        };
+        destroy_ = [](task& t) noexcept {
+          std::launder(reinterpret_cast<fn_t*>(t.storage_))->~fn_t();
+        };
+      } else {
+        ::new (static_cast<void*>(storage_)) fn_t*(new fn_t(std::forward<F>(f)));
+        invoke_ = [](task& t, bool expired) noexcept {
+          auto* fn = *std::launder(reinterpret_cast<fn_t**>(t.storage_));
+          call(*fn, expired);
+          delete fn;
+        };
+        destroy_ = [](task& t) noexcept {
+          delete *std::launder(reinterpret_cast<fn_t**>(t.storage_));
+        };
+      }
+    }
+
+    // Run the stored callable and release it
+    void run() noexcept {
+      auto* invoke = std::exchange(invoke_, nullptr);
+      destroy_     = nullptr;
+      invoke(*this, false);
+    }
+
+    // Complete the stored callable as expired and release it
+    void expire() noexcept {
+      auto* invoke = std::exchange(invoke_, nullptr);
+      destroy_     = nullptr;
+      invoke(*this, true);
+    }
+
+    [[nodiscard]] auto expired_at(time_point now) const noexcept -> bool {
+      return deadline != no_deadline && deadline < now;
+    }
+
+    // Release the stored callable without running it
+    void reset() noexcept {
+      if (destroy_ != nullptr) {
+        std::exchange(destroy_, nullptr)(*this);
+        invoke_ = nullptr;
+      }
+    }
+
+   private:
+    template <class Fn>
+    static void call(Fn& fn, bool expired) noexcept {
+      if constexpr (std::is_invocable_v<Fn&, expired_t>) {
+        if (expired) {
+          fn(expired_t{});
+          return;
+        }
+      }
+      fn();
+    }
+
+    void (*invoke_)(task&, bool) noexcept = nullptr;
+    void (*destroy_)(task&) noexcept      = nullptr;
+    alignas(std::max_align_t) unsigned char storage_[inline_capacity];
   };
 
   // Processor context (analogous to Go's P)
   // Each P has a local run queue to minimize contention
   class processor_context {
    public:
+    // Local queue size limit (like Go's 256)
+    static constexpr size_t local_queue_max = 256;
+
     processor_context() : rng_(std::random_device{}()) {}
 
     // Try to push task to local queue (returns false if full)
-    auto try_push_local(std::shared_ptr<task> t) -> bool {
-      std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    auto try_push_local(task* t) -> bool {
+      detail::unique_lock lock(mutex_, std::try_to_lock);
       if (!lock.owns_lock()) {
         return false;
       }
 
-      // Local queue size limit (like Go's 256)
-      constexpr size_t local_queue_max = 256;
-      if (local_queue_.size() >= local_queue_max) {
+      if (size_ >= local_queue_max) {
         return false;
       }
 
       // Use release ordering to ensure task is fully constructed before being visible
       t->sequence.store(next_sequence_++, std::memory_order_release);
-      local_queue_.push_back(std::move(t));
+      append(t);
       return true;
     }
 
+    // Queue a pinned task for this worker, waiting for the lock. Past a full ring it waits in
+    // this worker's overflow list rather than the global queue, where anyone could take it.
+    void push_pinned(task* t) {
+      std::scoped_lock lock(mutex_);
+      t->sequence.store(next_sequence_++, std::memory_order_release);
+      if (size_ >= local_queue_max || overflow_head_ != nullptr) {
+        t->next = nullptr;
+        if (overflow_tail_ != nullptr) {
+          overflow_tail_->next = t;
+        } else {
+          overflow_head_ = t;
+        }
+        overflow_tail_ = t;
+        return;
+      }
+      append(t);
+    }
+
     // Pop from front of local queue (FIFO for cache locality)
-    auto pop_local() -> std::shared_ptr<task> {
+    auto pop_local() -> task* {
       std::scoped_lock lock(mutex_);
-      if (local_queue_.empty()) {
+      if (size_ == 0) {
         return nullptr;
       }
 
-      auto t = std::move(local_queue_.front());
-      local_queue_.pop_front();
+      task* t = local_queue_[head_];
+      head_   = (head_ + 1) % local_queue_max;
+      --size_;
+      if (!t->pinned) {
+        --stealable_;
+      }
+      refill();
       return t;
     }
 
     // Steal from back of queue (LIFO to reduce contention with owner)
-    auto try_steal() -> std::shared_ptr<task> {
-      std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
-      if (!lock.owns_lock() || local_queue_.empty()) {
+    auto try_steal() -> task* {
+      detail::unique_lock lock(mutex_, std::try_to_lock);
+      if (!lock.owns_lock() || stealable_ == 0) {
         return nullptr;
       }
 
-      // Steal from back (oldest task for better fairness)
-      auto t = std::move(local_queue_.back());
-      local_queue_.pop_back();
+      // Steal the newest task not queued for this worker; the ones behind it close the gap
+      size_t i = size_;
+      while (local_queue_[(head_ + i - 1) % local_queue_max]->pinned) {
+        --i;
+      }
+      task* t = local_queue_[(head_ + i - 1) % local_queue_max];
+      for (; i < size_; ++i) {
+        task*& slot = local_queue_[(head_ + i - 1) % local_queue_max];
+        slot        = local_queue_[(head_ + i) % local_queue_max];
+      }
+      --size_;
+      --stealable_;
+      refill();
       return t;
     }
 
-    // Check if queue has work
+    // Remove every task that expired before `now` into `out`, keeping the others in order.
+    // Returns how many were removed.
+    auto take_expired(task::time_point now, std::array<task*, local_queue_max>& out) -> size_t {
+      std::scoped_lock lock(mutex_);
+      size_t           kept    = 0;
+      size_t           removed = 0;
+      for (size_t i = 0; i < size_; ++i) {
+        task* t = local_queue_[(head_ + i) % local_queue_max];
+        if (t->expired_at(now)) {
+          out[removed++] = t;
+          if (!t->pinned) {
+            --stealable_;
+          }
+        } else {
+          local_queue_[(head_ + kept++) % local_queue_max] = t;
+        }
+      }
+      size_ = kept;
+      refill();
+      return removed;
+    }
+
+    // Check if queue has work for its owner (overflow implies a full ring)
     auto has_work() const -> bool {
       std::scoped_lock lock(mutex_);
-      return !local_queue_.empty();
+      return size_ != 0;
+    }
+
+    // Check if queue has work another worker may steal
+    auto has_stealable_work() const -> bool {
+      std::scoped_lock lock(mutex_);
+      return stealable_ != 0;
     }
 
     // Get approximate queue size (for load balancing)
     auto queue_size() const -> size_t {
       std::scoped_lock lock(mutex_);
-      return local_queue_.size();
+      return size_;
     }
 
     // Generate random processor id for work stealing
@@ -117,38 +309,71 @@ class work_stealing_scheduler {
     }
 
    private:
-    mutable std::mutex                mutex_;
-    std::deque<std::shared_ptr<task>> local_queue_;
-    uint64_t                          next_sequence_{0};
+    // Both expect mutex_ to be held
+    void append(task* t) {
+      local_queue_[(head_ + size_) % local_queue_max] = t;
+      ++size_;
+      if (!t->pinned) {
+        ++stealable_;
+      }
+    }
+
+    // Move overflowed pinned tasks into freed ring slots, oldest first
+    void refill() {
+      while (overflow_head_ != nullptr && size_ < local_queue_max) {
+        task* t        = overflow_head_;
+        overflow_head_ = t->next;
+        t->next        = nullptr;
+        append(t);
+      }
+      if (overflow_head_ == nullptr) {
+        overflow_tail_ = nullptr;
+      }
+    }
+
+    mutable detail::mutex              mutex_{"work_stealing_scheduler::processor"};
+    std::array<task*, local_queue_max> local_queue_{};
+    size_t                             head_{0};
+    size_t                             size_{0};
+    size_t                             stealable_{0};  // Queued tasks that are not pinned
+    uint64_t                           next_sequence_{0};
+    task*                              overflow_head_{nullptr};  // Pinned tasks past a full ring
+    task*                              overflow_tail_{nullptr};
 
     // RNG for work stealing victim selection
-    mutable std::mutex rng_mutex_;
-    std::mt19937       rng_;
+    mutable detail::mutex rng_mutex_{"work_stealing_scheduler::rng"};
+    std::mt19937          rng_;
   };
 
-  // Global run queue for overflow and load balancing
+  // Global run queue for overflow and load balancing (intrusive FIFO through task::next)
   class global_queue {
    public:
-    void push(std::shared_ptr<task> t) {
+    void push(task* t) {
       std::scoped_lock lock(mutex_);
-      queue_.push_back(std::move(t));
+      t->next = nullptr;
+      if (tail_ != nullptr) {
+        tail_->next = t;
+      } else {
+        head_ = t;
+      }
+      tail_ = t;
+      ++size_;
       has_work_.store(true, std::memory_order_release);
     }
 
-    auto try_pop() -> std::shared_ptr<task> {
-      std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
-      if (!lock.owns_lock() || queue_.empty()) {
+    auto try_pop() -> task* {
+      detail::unique_lock lock(mutex_, std::try_to_lock);
+      if (!lock.owns_lock() || head_ == nullptr) {
         return nullptr;
       }
 
-      auto t = std::move(queue_.front());
-      queue_.pop_front();
-
-      if (queue_.empty()) {
-        has_work_.store(false, std::memory_order_release);
-      }
+      return pop_front();
+    }
 
-      return t;
+    // Blocking pop used when draining at shutdown
+    auto pop() -> task* {
+      std::scoped_lock lock(mutex_);
+      return head_ != nullptr ? pop_front() : nullptr;
     }
 
     auto has_work() const -> bool {
@@ -157,20 +382,67 @@ class work_stealing_scheduler {
 
     auto size() const -> size_t {
       std::scoped_lock lock(mutex_);
-      return queue_.size();
+      return size_;
     }
 
    private:
-    mutable std::mutex                mutex_;
-    std::deque<std::shared_ptr<task>> queue_;
-    std::atomic<bool>                 has_work_{false};
+    auto pop_front() -> task* {
+      task* t = head_;
+      head_   = t->next;
+      t->next = nullptr;
+      --size_;
+
+      if (head_ == nullptr) {
+        tail_ = nullptr;
+        has_work_.store(false, std::memory_order_release);
+      }
+
+      return t;
+    }
+
+    mutable detail::mutex mutex_{"work_stealing_scheduler::global_queue"};
+    task*                 head_{nullptr};
+    task*                 tail_{nullptr};
+    size_t                size_{0};
+    std::atomic<bool>     has_work_{false};
   };
 
   explicit work_stealing_scheduler(std::size_t num_threads = std::thread::hardware_concurrency())
-      : num_procs_(num_threads), stop_(false) {
+      : work_stealing_scheduler(construct_tag{}, num_threads, std::nullopt, topology_mode::off) {}
+
+  // Scheduler with pinned workers and fixed bulk placement when `topology` is on
+  work_stealing_scheduler(std::size_t num_threads, topology_mode topology)
+      : work_stealing_scheduler(construct_tag{}, num_threads, std::nullopt, topology) {}
+
+  // Scheduler with queue-delay admission control (admission_control.hpp)
+  work_stealing_scheduler(std::size_t num_threads, codel_options admission,
+                          topology_mode topology = topology_mode::off)
+      : work_stealing_scheduler(construct_tag{}, num_threads, admission, topology) {}
+
+ private:
+  struct construct_tag {};
+
+  static constexpr std::size_t any_worker = ~std::size_t{0};
+
+  work_stealing_scheduler(construct_tag /*unused*/, std::size_t num_threads,
+                          std::optional<codel_options> admission, topology_mode topology)
+      : num_procs_(num_threads),
+        topology_(topology),
+        stop_(false),
+        rcu_(num_threads,
+             [](void* self) noexcept {
+               static_cast<work_stealing_scheduler*>(self)->schedule_reclaim();
+             },
+             this) {
     if (num_threads == 0) {
       throw std::invalid_argument("Number of threads must be greater than 0");
     }
+    if (admission) {
+      codel_.emplace(*admission);
+    }
+    if (topology_ == topology_mode::on) {
+      cpus_ = detail::topology::cpus_by_node();
+    }
 
     // Initialize processor contexts
     procs_.reserve(num_procs_);
@@ -181,6 +453,11 @@ class work_stealing_scheduler {
     // Initialize dynamic stats array
     worker_stats_.resize(num_procs_);
 
+    // Pre-populate the task free list so the first submissions do not allocate
+    for (size_t i = 0; i < prewarmed_tasks; ++i) {
+      recycle(new task());
+    }
+
     // Launch worker threads (M in Go terminology)
     workers_.reserve(num_procs_);
     for (size_t i = 0; i < num_procs_; ++i) {
@@ -188,6 +465,7 @@ class work_stealing_scheduler {
     }
   }
 
+ public:
   ~work_stealing_scheduler() {
     stop_.store(true, std::memory_order_release);
     cv_.notify_all();
@@ -197,6 +475,14 @@ class work_stealing_scheduler {
         worker.join();
       }
     }
+
+    // Tasks left in the global queue are destroyed without running
+    while (task* t = global_queue_.pop()) {
+      delete t;
+    }
+    while (auto t = free_tasks_.try_pop()) {
+      delete *t;
+    }
   }
 
   work_stealing_scheduler(const work_stealing_scheduler&)                    = delete;
@@ -209,11 +495,12 @@ class work_stealing_scheduler {
     using scheduler_concept     = scheduler_t;
     using try_scheduler_concept = try_scheduler_t;
 
-    explicit work_stealing_scheduler_handle(work_stealing_scheduler* sched) noexcept
-        : sched_(sched) {}
+    explicit work_stealing_scheduler_handle(work_stealing_scheduler* sched,
+                                            std::size_t worker = any_worker) noexcept
+        : sched_(sched), worker_(worker) {}
 
     [[nodiscard]] auto schedule() const noexcept {
-      return _schedule_sender{sched_};
+      return _schedule_sender{sched_, worker_};
     }
 
     [[nodiscard]] auto try_schedule() const noexcept {
@@ -224,36 +511,66 @@ class work_stealing_scheduler {
       return forward_progress_guarantee::parallel;
     }
 
+    [[nodiscard]] auto query(get_parallelism_t /*unused*/) const noexcept -> std::size_t {
+      return sched_->num_procs_;
+    }
+
+    // In topology mode, the scheduler of worker `agent` (modulo the worker count)
+    [[nodiscard]] auto query(get_agent_scheduler_t /*unused*/, std::size_t agent) const noexcept
+        -> std::optional<work_stealing_scheduler_handle> {
+      if (sched_->topology_ != topology_mode::on) {
+        return std::nullopt;
+      }
+      return work_stealing_scheduler_handle{sched_, agent % sched_->num_procs_};
+    }
+
     auto operator==(const work_stealing_scheduler_handle& other) const noexcept -> bool {
-      return sched_ == other.sched_;
+      return sched_ == other.sched_ && worker_ == other.worker_;
     }
 
    private:
     work_stealing_scheduler* sched_;
+    std::size_t              worker_;  // Worker whose queue schedule() uses, or any_worker
+
+    // Queued completion of a schedule operation: set_value when run, set_stopped when shed
+    template <class Rcvr>
+    struct _completion {
+      Rcvr rcvr;
+
+      void operator()() noexcept {
+        __set_value_or_error(std::move(rcvr));
+      }
+
+      void operator()(task::expired_t /*unused*/) noexcept {
+        std::move(rcvr).set_stopped();
+      }
+    };
 
     struct _schedule_sender {
       using sender_concept = sender_t;
       using value_types    = type_list<>;
 
       work_stealing_scheduler* sched_;
+      std::size_t              worker_;
 
       template <class Env>
       auto get_completion_signatures(Env&& /*unused*/) const noexcept {
-        return completion_signatures<set_value_t(), set_error_t(std::exception_ptr)>{};
+        return completion_signatures<set_value_t(), set_error_t(std::exception_ptr),
+                                     set_stopped_t()>{};
       }
 
       template <receiver R>
       auto connect(R&& r) && {
-        return _operation<std::remove_cvref_t<R>>{sched_, std::forward<R>(r)};
+        return _operation<std::remove_cvref_t<R>>{sched_, worker_, std::forward<R>(r)};
       }
 
       template <receiver R>
       auto connect(R&& r) & {
-        return _operation<std::remove_cvref_t<R>>{sched_, std::forward<R>(r)};
+        return _operation<std::remove_cvref_t<R>>{sched_, worker_, std::forward<R>(r)};
       }
 
       [[nodiscard]] auto query(get_completion_scheduler_t<set_value_t> /*unused*/) const noexcept {
-        return work_stealing_scheduler_handle{sched_};
+        return work_stealing_scheduler_handle{sched_, worker_};
       }
 
       template <class Rcvr>
@@ -261,19 +578,19 @@ class work_stealing_scheduler {
         using operation_state_concept = operation_state_t;
 
         work_stealing_scheduler* sched_;
+        std::size_t              worker_;
         Rcvr                     receiver_;
 
         void start() & noexcept {
           // SAFETY: The scheduler must outlive all operations.
           // Users must ensure scheduler lifetime exceeds operations.
           try {
-            sched_->submit([rcvr = std::move(receiver_)]() mutable {
-              try {
-                std::move(rcvr).set_value();
-              } catch (...) {
-                std::move(rcvr).set_error(std::current_exception());
-              }
-            });
+            if (sched_->codel_ && sched_->codel_->rejects_schedule() && !sched_->codel_->admit()) {
+              std::move(receiver_).set_error(std::make_exception_ptr(overloaded_t{}));
+              return;
+            }
+            const auto deadline = get_deadline(flow::execution::get_env(receiver_));
+            sched_->submit(_completion<Rcvr>{std::move(receiver_)}, deadline, worker_);
           } catch (...) {
             // If submit throws, call set_error on the receiver
             std::move(receiver_).set_error(std::current_exception());
@@ -290,8 +607,7 @@ class work_stealing_scheduler {
 
       template <class Env>
       auto get_completion_signatures(Env&& /*unused*/) const noexcept {
-        return completion_signatures<set_value_t(), set_error_t(would_block_t),
-                                     set_error_t(std::exception_ptr)>{};
+        return completion_signatures<set_value_t(), set_error_t(would_block_t), set_stopped_t()>{};
       }
 
       template <receiver R>
@@ -316,20 +632,28 @@ class work_stealing_scheduler {
         Rcvr                     receiver_;
 
         void start() & noexcept {
-          try {
-            bool submitted = sched_->try_submit([rcvr = std::move(receiver_)]() mutable {
-              try {
-                std::move(rcvr).set_value();
-              } catch (...) {
-                std::move(rcvr).set_error(std::current_exception());
-              }
-            });
-
-            if (!submitted) {
-              std::move(receiver_).set_error(would_block_t{});
+          // Fail fast while queued work is waiting longer than the admission target
+          if (sched_->codel_ && !sched_->codel_->admit()) {
+            std::move(receiver_).set_error(would_block_t{});
+            return;
+          }
+          const auto deadline = get_deadline(flow::execution::get_env(receiver_));
+          if (!submit(deadline)) {
+            std::move(receiver_).set_error(would_block_t{});
+          }
+        }
+
+        // A receiver that throws while being moved into the queue counts as work that could
+        // not be queued, so try_schedule() never needs set_error(exception_ptr)
+        auto submit(task::time_point deadline) noexcept -> bool {
+          if constexpr (std::is_nothrow_move_constructible_v<Rcvr>) {
+            return sched_->try_submit(_completion<Rcvr>{std::move(receiver_)}, deadline);
+          } else {
+            try {
+              return sched_->try_submit(_completion<Rcvr>{std::move(receiver_)}, deadline);
+            } catch (...) {
+              return false;
             }
-          } catch (...) {
-            std::move(receiver_).set_error(std::current_exception());
           }
         }
       };
@@ -340,6 +664,16 @@ class work_stealing_scheduler {
     return work_stealing_scheduler_handle{this};
   }
 
+  // Readers of this domain are the scheduler's workers: rcu_cell::read() is valid in its tasks
+  auto get_rcu_domain() noexcept -> rcu_domain& {
+    return rcu_;
+  }
+
+  // State of the admission controller; all zero when the scheduler has none
+  [[nodiscard]] auto admission_stats() const noexcept -> codel_stats {
+    return codel_ ? codel_->stats() : codel_stats{};
+  }
+
   // Statistics for monitoring and debugging
   struct stats {
     std::atomic<uint64_t> tasks_executed{0};
@@ -347,6 +681,7 @@ class work_stealing_scheduler {
     std::atomic<uint64_t> steals_succeeded{0};
     std::atomic<uint64_t> global_queue_pops{0};
     std::atomic<uint64_t> local_queue_pops{0};
+    std::atomic<uint64_t> tasks_shed{0};  // Completed with set_stopped past their deadline
 
     // Make movable for vector operations
     stats() = default;
@@ -355,14 +690,16 @@ class work_stealing_scheduler {
           steals_attempted(other.steals_attempted.load(std::memory_order_relaxed)),
           steals_succeeded(other.steals_succeeded.load(std::memory_order_relaxed)),
           global_queue_pops(other.global_queue_pops.load(std::memory_order_relaxed)),
-          local_queue_pops(other.local_queue_pops.load(std::memory_order_relaxed)) {}
+          local_queue_pops(other.local_queue_pops.load(std::memory_order_relaxed)),
+          tasks_shed(other.tasks_shed.load(std::memory_order_relaxed)) {}
 
     stats(stats&& other) noexcept
         : tasks_executed(other.tasks_executed.load(std::memory_order_relaxed)),
           steals_attempted(other.steals_attempted.load(std::memory_order_relaxed)),
           steals_succeeded(other.steals_succeeded.load(std::memory_order_relaxed)),
           global_queue_pops(other.global_queue_pops.load(std::memory_order_relaxed)),
-          local_queue_pops(other.local_queue_pops.load(std::memory_order_relaxed)) {}
+          local_queue_pops(other.local_queue_pops.load(std::memory_order_relaxed)),
+          tasks_shed(other.tasks_shed.load(std::memory_order_relaxed)) {}
 
     stats& operator=(const stats& other) {
       tasks_executed.store(other.tasks_executed.load(std::memory_order_relaxed),
@@ -375,6 +712,8 @@ class work_stealing_scheduler {
                               std::memory_order_relaxed);
       local_queue_pops.store(other.local_queue_pops.load(std::memory_order_relaxed),
                              std::memory_order_relaxed);
+      tasks_shed.store(other.tasks_shed.load(std::memory_order_relaxed),
+                       std::memory_order_relaxed);
       return *this;
     }
 
@@ -389,6 +728,8 @@ class work_stealing_scheduler {
                               std::memory_order_relaxed);
       local_queue_pops.store(other.local_queue_pops.load(std::memory_order_relaxed),
                              std::memory_order_relaxed);
+      tasks_shed.store(other.tasks_shed.load(std::memory_order_relaxed),
+                       std::memory_order_relaxed);
       return *this;
     }
   };
@@ -400,6 +741,7 @@ class work_stealing_scheduler {
     uint64_t steals_succeeded;
     uint64_t global_queue_pops;
     uint64_t local_queue_pops;
+    uint64_t tasks_shed;
   };
 
   auto get_stats(size_t proc_id) const -> stats_snapshot {
@@ -408,19 +750,119 @@ class work_stealing_scheduler {
               .steals_attempted  = 0,
               .steals_succeeded  = 0,
               .global_queue_pops = 0,
-              .local_queue_pops  = 0};
+              .local_queue_pops  = 0,
+              .tasks_shed        = 0};
     }
     const auto& s = worker_stats_[proc_id];
     return {.tasks_executed    = s.tasks_executed.load(std::memory_order_relaxed),
             .steals_attempted  = s.steals_attempted.load(std::memory_order_relaxed),
             .steals_succeeded  = s.steals_succeeded.load(std::memory_order_relaxed),
             .global_queue_pops = s.global_queue_pops.load(std::memory_order_relaxed),
-            .local_queue_pops  = s.local_queue_pops.load(std::memory_order_relaxed)};
+            .local_queue_pops  = s.local_queue_pops.load(std::memory_order_relaxed),
+            .tasks_shed        = s.tasks_shed.load(std::memory_order_relaxed)};
   }
 
  private:
-  void submit(std::function<void()> work) {
-    auto t = std::make_shared<task>(std::move(work));
+  // Take a task node from the free list, falling back to the allocator when it is empty
+  auto acquire_task() -> task* {
+    if (auto t = free_tasks_.try_pop()) {
+      return *t;
+    }
+    return new task();
+  }
+
+  // Return a task node to the free list once its callable has been released
+  void recycle(task* t) noexcept {
+    t->reset();
+    t->cancelled.store(false, std::memory_order_relaxed);
+    t->pinned = false;
+    if (!free_tasks_.try_push(std::move(t))) {
+      delete t;
+    }
+  }
+
+  // Report how long a dequeued task waited to the admission controller
+  void note_dequeue(const task* t) noexcept {
+    if (codel_) {
+      codel_->on_dequeue(t->enqueued);
+    }
+  }
+
+  // Run a dequeued task and hand its node back to the free list. Cancelled tasks are not
+  // counted as executed.
+  void execute(task* t, stats& s) noexcept {
+    note_dequeue(t);
+    if (!t->cancelled.load(std::memory_order_acquire)) {
+      s.tasks_executed.fetch_add(1, std::memory_order_relaxed);
+      FLOW_TRACE_EVENT(start, work_stealing_scheduler, reinterpret_cast<std::uintptr_t>(t));
+      t->run();
+      FLOW_TRACE_EVENT(finish, work_stealing_scheduler, reinterpret_cast<std::uintptr_t>(t));
+    }
+    recycle(t);
+  }
+
+  // Complete a dequeued task past its deadline without running it
+  void shed(task* t, stats& s) noexcept {
+    note_dequeue(t);
+    s.tasks_shed.fetch_add(1, std::memory_order_relaxed);
+    if (!t->cancelled.load(std::memory_order_acquire)) {
+      t->expire();
+    }
+    recycle(t);
+  }
+
+  // Clock reading shared by one batch of dequeued tasks, taken on first use. It lags the clock,
+  // so a task is only shed if it had already expired when the reading was taken.
+  class batch_clock {
+   public:
+    auto now() noexcept -> task::time_point {
+      if (!valid_) {
+        now_   = std::chrono::steady_clock::now();
+        valid_ = true;
+      }
+      return now_;
+    }
+
+    void reset() noexcept {
+      valid_ = false;
+    }
+
+   private:
+    task::time_point now_{};
+    bool             valid_{false};
+  };
+
+  // Run a dequeued task, or shed it when its deadline has passed
+  void dispatch(task* t, stats& s, batch_clock& clock) noexcept {
+    if (t->deadline != task::no_deadline && t->expired_at(clock.now())) {
+      shed(t, s);
+      return;
+    }
+    execute(t, s);
+  }
+
+  template <class F>
+  void submit(F&& work, task::time_point deadline = task::no_deadline,
+              std::size_t worker = any_worker) {
+    task* t = acquire_task();
+    try {
+      t->emplace(std::forward<F>(work), deadline);
+    } catch (...) {
+      recycle(t);
+      throw;
+    }
+    if (codel_) {
+      t->enqueued = std::chrono::steady_clock::now();
+    }
+    FLOW_TRACE_EVENT(enqueue, work_stealing_scheduler, reinterpret_cast<std::uintptr_t>(t));
+
+    if (worker != any_worker) {
+      // Only that worker may take it, so wake them all rather than one that cannot
+      t->pinned = true;
+      procs_[worker]->push_pinned(t);
+      cv_.notify_all();
+      return;
+    }
 
     // Try to submit to a random processor's local queue
     // Use thread-local RNG for better performance (avoids repeated random_device construction)
@@ -430,16 +872,23 @@ class work_stealing_scheduler {
 
     if (!procs_[proc_id]->try_push_local(t)) {
       // Local queue full, use global queue
-      global_queue_.push(std::move(t));
+      global_queue_.push(t);
     }
 
     // Wake up a worker
     cv_.notify_one();
   }
 
-  auto try_submit(std::function<void()> work) noexcept -> bool {
+  template <class F>
+  auto try_submit(F&& work, task::time_point deadline = task::no_deadline) noexcept -> bool {
+    task* t = nullptr;
     try {
-      auto t = std::make_shared<task>(std::move(work));
+      t = acquire_task();
+      t->emplace(std::forward<F>(work), deadline);
+      if (codel_) {
+        t->enqueued = std::chrono::steady_clock::now();
+      }
+      FLOW_TRACE_EVENT(enqueue, work_stealing_scheduler, reinterpret_cast<std::uintptr_t>(t));
 
       // Try round-robin placement to balance load
       size_t start_proc = next_proc_.fetch_add(1, std::memory_order_relaxed) % num_procs_;
@@ -454,46 +903,80 @@ class work_stealing_scheduler {
       }
 
       // All local queues full, would need to use global queue which might block
+      recycle(t);
       return false;
     } catch (...) {
+      if (t != nullptr) {
+        recycle(t);
+      }
       return false;
     }
   }
 
+  // Free retired RCU versions from a worker, off the updating thread. Without a queued task
+  // (shutting down, or the task could not be allocated) they are freed right here.
+  void schedule_reclaim() noexcept {
+    if (!stop_.load(std::memory_order_acquire)) {
+      try {
+        submit([this] { rcu_.reclaim(); });
+        return;
+      } catch (...) {
+      }
+    }
+    rcu_.reclaim();
+  }
+
   void worker_thread(size_t proc_id) {
     auto& proc  = procs_[proc_id];
     auto& stats = worker_stats_[proc_id];
 
     constexpr size_t work_batch_size = 32;  // Process up to 32 tasks before checking
 
+    FLOW_TRACE_THREAD_NAME("work_stealing_scheduler worker " + std::to_string(proc_id));
+    if (!cpus_.empty()) {
+      detail::topology::pin_current_thread(cpus_[proc_id % cpus_.size()]);
+    }
+
+    batch_clock                                           clock;
+    std::array<task*, processor_context::local_queue_max> expired{};
+
+    rcu_.online(proc_id);
     while (!stop_.load(std::memory_order_acquire)) {
       size_t processed = 0;
+      clock.reset();
+      rcu_.quiescent(proc_id);
 
       // Phase 1: Process local queue (best cache locality)
+      // Counters are bumped before running so that observers woken by the task see them
       while (processed < work_batch_size) {
-        auto t = proc->pop_local();
-        if (!t) {
+        task* t = proc->pop_local();
+        if (t == nullptr) {
           break;
         }
 
-        if (!t->cancelled.load(std::memory_order_acquire)) {
-          t->work();
-          stats.tasks_executed.fetch_add(1, std::memory_order_relaxed);
-          stats.local_queue_pops.fetch_add(1, std::memory_order_relaxed);
-        }
+        stats.local_queue_pops.fetch_add(1, std::memory_order_relaxed);
         processed++;
+        if (t->deadline != task::no_deadline && t->expired_at(clock.now())) {
+          // Expired work is rarely alone under overload: drop the rest of it in one pass
+          shed(t, stats);
+          const size_t count = proc->take_expired(clock.now(), expired);
+          for (size_t i = 0; i < count; ++i) {
+            shed(expired[i], stats);
+          }
+          rcu_.quiescent(proc_id);
+          continue;
+        }
+        execute(t, stats);
+        rcu_.quiescent(proc_id);
       }
 
-      // Phase 2: Check global queue periodically (1 in 61 like Go)
-      // This provides fairness and prevents global queue starvation
-      if (stats.tasks_executed.load(std::memory_order_relaxed) % 61 == 0
+      // Phase 2: Check global queue periodically (1 in 61 like Go) and whenever the local
+      // queue ran dry. This provides fairness and prevents global queue starvation
+      if ((processed == 0 || stats.tasks_executed.load(std::memory_order_relaxed) % 61 == 0)
           && global_queue_.has_work()) {
-        if (auto t = global_queue_.try_pop()) {
-          if (!t->cancelled.load(std::memory_order_acquire)) {
-            t->work();
-            stats.tasks_executed.fetch_add(1, std::memory_order_relaxed);
-            stats.global_queue_pops.fetch_add(1, std::memory_order_relaxed);
-          }
+        if (task* t = global_queue_.try_pop()) {
+          stats.global_queue_pops.fetch_add(1, std::memory_order_relaxed);
+          dispatch(t, stats, clock);
           processed++;
         }
       }
@@ -506,23 +989,23 @@ class work_stealing_scheduler {
           stats.steals_attempted.fetch_add(1, std::memory_order_relaxed);
 
           size_t victim_id = proc->random_victim(num_procs_, proc_id);
-          auto   stolen    = procs_[victim_id]->try_steal();
+          task*  stolen    = procs_[victim_id]->try_steal();
 
-          if (stolen) {
+          if (stolen != nullptr) {
             stats.steals_succeeded.fetch_add(1, std::memory_order_relaxed);
-            if (!stolen->cancelled.load(std::memory_order_acquire)) {
-              stolen->work();
-              stats.tasks_executed.fetch_add(1, std::memory_order_relaxed);
-            }
+            FLOW_TRACE_EVENT(steal, work_stealing_scheduler,
+                             reinterpret_cast<std::uintptr_t>(stolen));
+            dispatch(stolen, stats, clock);
             processed++;
             break;  // Successfully stole and executed
           }
         }
       }
 
-      // Phase 4: If no work found, wait
+      // Phase 4: If no work found, wait. A parked worker holds no RCU references.
       if (processed == 0) {
-        std::unique_lock<std::mutex> lock(cv_mutex_);
+        rcu_.offline(proc_id);
+        detail::unique_lock lock(cv_mutex_);
 
         // Double-check before waiting (avoid missed wakeup)
         // Use acquire ordering to synchronize with submit/try_submit
@@ -531,28 +1014,32 @@ class work_stealing_scheduler {
         if (!has_work && !stop_.load(std::memory_order_acquire)) {
           // Wait for work or shutdown
           // Use timed wait to periodically check for work stealing opportunities
+          FLOW_TRACE_EVENT(park, work_stealing_scheduler, proc_id);
           cv_.wait_for(lock, std::chrono::microseconds(100), [this, &proc, proc_id] {
             return stop_.load(std::memory_order_acquire) || proc->has_work()
                    || global_queue_.has_work() || any_proc_has_work(proc_id);
           });
+          FLOW_TRACE_EVENT(unpark, work_stealing_scheduler, proc_id);
         }
+        lock.unlock();
+        rcu_.online(proc_id);
       }
       // If we processed work, immediately check for more (stay hot)
     }
 
     // Cleanup: process remaining local work before exiting
-    while (auto t = proc->pop_local()) {
-      if (!t->cancelled.load(std::memory_order_acquire)) {
-        t->work();
-        stats.tasks_executed.fetch_add(1, std::memory_order_relaxed);
-      }
+    clock.reset();
+    while (task* t = proc->pop_local()) {
+      dispatch(t, stats, clock);
     }
+    rcu_.offline(proc_id);
   }
 
-  // Check if any processor has work (for work stealing decision)
+  // Check if any processor has work this one could steal (for the park decision). Pinned
+  // tasks only keep their own worker awake.
   auto any_proc_has_work(size_t exclude_proc) const -> bool {
     for (size_t i = 0; i < num_procs_; ++i) {
-      if (i != exclude_proc && procs_[i]->has_work()) {
+      if (i != exclude_proc && procs_[i]->has_stealable_work()) {
         return true;
       }
     }
@@ -560,16 +1047,26 @@ class work_stealing_scheduler {
   }
 
   const size_t                                    num_procs_;
+  const topology_mode                             topology_;
+  std::vector<int>                                cpus_;  // Pinning order in topology mode
   std::vector<std::unique_ptr<processor_context>> procs_;
   global_queue                                    global_queue_;
   std::vector<std::thread>                        workers_;
-  std::condition_variable                         cv_;
-  mutable std::mutex                              cv_mutex_;
+  detail::condition_variable                      cv_;
+  mutable detail::mutex                           cv_mutex_{"work_stealing_scheduler::sleep"};
   std::atomic<bool>                               stop_;
   std::atomic<size_t>                             next_proc_{0};
 
+  // Recycled task nodes shared by all submitters and workers
+  static constexpr size_t              prewarmed_tasks = 64;
+  lock_free_bounded_queue<task*, 1024> free_tasks_;
+
   // Per-worker statistics (dynamic sizing to handle any thread count)
   std::vector<stats> worker_stats_;
+
+  std::optional<codel_controller> codel_;  // Admission control, when enabled
+
+  rcu_domain rcu_;  // Readers are the workers, indexed by proc_id
 };
 
 }  // namespace flow::execution
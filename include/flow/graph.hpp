@@ -0,0 +1,1240 @@
+#pragma once
+
+// [graph] Dataflow graph executor
+//
+// A graph is a DAG of sender stages that is built once and then streams records through it.
+// Every node is a sender factory: for each input value it invokes fn(value), connects the
+// returned sender and runs it on the node's scheduler. The single value the sender completes
+// with travels along the node's outgoing edges, which are typed: an edge from a node producing
+// T can only go into an input taking T.
+//
+//   flow::graph g;
+//   auto parse  = g.add_node<std::string>(pool, [](std::string s) { return just(parse(s)); });
+//   auto geo    = g.add_node<record>(pool, [](record r) { return just(lookup_geo(r)); });
+//   auto user   = g.add_node<record>(pool, [](record r) { return just(lookup_user(r)); });
+//   auto merge  = g.add_join<geo_info, user_info>(pool, [](geo_info g, user_info u) { ... });
+//   auto sink   = g.add_node<row>(io, [](row r) { return write(r); }, {.concurrency = 4});
+//   g.connect(parse, geo);
+//   g.connect(parse, user);  // Fan-out: each successor receives a copy
+//   g.connect(geo, merge.input<0>());
+//   g.connect(user, merge.input<1>());
+//   g.connect(merge, sink);
+//
+//   for (auto& line : lines) {
+//     sync_wait(g.push(parse, line));  // Completes once the record is admitted
+//   }
+//   sync_wait(g.drain());  // Completes when no record is in flight
+//
+// Records: every pushed value becomes a record that holds one of max_in_flight tickets until
+// every terminal node (a node without successors) reachable from its source has finished it.
+// A regular node has at most one predecessor; branches are merged by join nodes, which count
+// the arrivals of each record on their inputs and run once all of them are in. A record whose
+// stage completes with an error or stopped is dropped: its successors skip it, joins discard
+// the parts that did arrive, and it counts as failed. The first error is kept for error().
+//
+// Backpressure: every node has a bounded input queue and runs at most `concurrency` senders
+// at once. A worker that cannot hand its result to a full successor queue parks until that
+// queue has room, so a slow stage fills the queues upstream of it and eventually push() parks
+// too. Join inputs never block: a join buffers one entry per ticket.
+//
+// Allocation: queues, join buffers, records and operation states are allocated when the graph
+// is built; streaming a record allocates nothing beyond what the stage senders themselves do.
+//
+// The graph must outlive every operation started from it. Destroying a graph waits for the
+// records in flight to finish; it must not be destroyed while push() operations are parked.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "detail/mutex.hpp"
+#include "execution/completion_signatures.hpp"
+#include "execution/lock_free_queue.hpp"
+#include "execution/operation_state.hpp"
+#include "execution/receiver.hpp"
+#include "execution/scheduler.hpp"
+#include "execution/sender.hpp"
+#include "execution/type_list.hpp"
+#include "execution/utils.hpp"
+
+namespace flow {
+
+namespace _graph_detail {
+
+inline constexpr std::uint32_t no_ticket = ~std::uint32_t{0};
+
+// Record tickets and node inboxes, sized when the graph is built
+template <class T>
+using queue = execution::lock_free_bounded_queue<T, execution::dynamic_queue_capacity>;
+
+// An operation or worker parked until capacity frees up. Waiters are intrusive, so parking
+// never allocates.
+struct waiter {
+  void (*resume)(waiter*) noexcept = nullptr;
+  waiter* next                     = nullptr;
+};
+
+// FIFO of parked waiters. Notifiers only take the lock when someone is parked.
+class waiter_list {
+ public:
+  // Parks `w` unless `ready()` succeeds once `w` is registered. Returns true when parked; a
+  // parked waiter belongs to the list until a notify resumes it.
+  template <class Ready>
+  auto park(waiter* w, Ready&& ready) -> bool {
+    std::scoped_lock lock(mutex_);
+    waiter*          prev = tail_;
+    w->next               = nullptr;
+    (prev != nullptr ? prev->next : head_) = w;
+    tail_                                  = w;
+    waiting_.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (!std::forward<Ready>(ready)()) {
+      return true;
+    }
+    (prev != nullptr ? prev->next : head_) = nullptr;
+    tail_                                  = prev;
+    waiting_.fetch_sub(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // Call after making capacity available
+  void notify_one() noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting_.load(std::memory_order_relaxed) == 0) {
+      return;
+    }
+
+    waiter* w = nullptr;
+    {
+      std::scoped_lock lock(mutex_);
+      w = head_;
+      if (w != nullptr) {
+        head_ = w->next;
+        if (head_ == nullptr) {
+          tail_ = nullptr;
+        }
+        waiting_.fetch_sub(1, std::memory_order_relaxed);
+      }
+    }
+    if (w != nullptr) {
+      w->resume(w);
+    }
+  }
+
+  void notify_all() noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting_.load(std::memory_order_relaxed) == 0) {
+      return;
+    }
+
+    waiter* w = nullptr;
+    {
+      std::scoped_lock lock(mutex_);
+      w     = head_;
+      head_ = tail_ = nullptr;
+      waiting_.store(0, std::memory_order_relaxed);
+    }
+    while (w != nullptr) {
+      auto* next = w->next;  // A resumed waiter may be destroyed
+      w->resume(w);
+      w = next;
+    }
+  }
+
+ private:
+  detail::mutex              mutex_{"graph::waiters"};
+  waiter*                    head_{nullptr};
+  waiter*                    tail_{nullptr};
+  std::atomic<std::uint32_t> waiting_{0};
+};
+
+// Tickets of the records in flight and per-record completion counts
+class record_table {
+ public:
+  explicit record_table(std::size_t capacity)
+      : capacity_(static_cast<std::uint32_t>(std::clamp<std::size_t>(capacity, 1, no_ticket - 1))),
+        records_(std::make_unique<record[]>(capacity_)),
+        free_(capacity_) {
+    for (std::uint32_t ticket = 0; ticket < capacity_; ++ticket) {
+      free_.try_emplace(ticket);
+    }
+  }
+
+  [[nodiscard]] auto capacity() const noexcept -> std::uint32_t {
+    return capacity_;
+  }
+
+  auto try_acquire() noexcept -> std::optional<std::uint32_t> {
+    return free_.try_pop();
+  }
+
+  // Parks `w` when every ticket is taken; it is resumed when a record finishes
+  auto acquire(waiter* w) -> std::optional<std::uint32_t> {
+    if (auto ticket = free_.try_pop()) {
+      return ticket;
+    }
+    std::optional<std::uint32_t> ticket;
+    if (ticket_waiters_.park(w, [&] { return (ticket = free_.try_pop()).has_value(); })) {
+      return std::nullopt;
+    }
+    return ticket;
+  }
+
+  // The record holding `ticket` completes after `terminals` terminal nodes finish it
+  void begin(std::uint32_t ticket, std::uint32_t terminals) noexcept {
+    records_[ticket].pending.store(terminals, std::memory_order_relaxed);
+    in_flight_.fetch_add(1, std::memory_order_relaxed);
+    admitted_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Undoes begin() for a record that never entered the graph
+  void abandon(std::uint32_t ticket) noexcept {
+    admitted_.fetch_sub(1, std::memory_order_relaxed);
+    release(ticket);
+  }
+
+  // A terminal node is done with the record
+  void finish(std::uint32_t ticket, bool failed) noexcept {
+    auto& r = records_[ticket];
+    if (failed) {
+      r.failed.store(true, std::memory_order_relaxed);
+    }
+    if (r.pending.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    (r.failed.exchange(false, std::memory_order_relaxed) ? failed_ : completed_)
+        .fetch_add(1, std::memory_order_relaxed);
+    release(ticket);
+  }
+
+  void report(std::exception_ptr error) noexcept {
+    std::scoped_lock lock(error_mutex_);
+    if (!first_error_) {
+      first_error_ = std::move(error);
+    }
+  }
+
+  [[nodiscard]] auto first_error() -> std::exception_ptr {
+    std::scoped_lock lock(error_mutex_);
+    return first_error_;
+  }
+
+  // Parks `w` until no record is in flight; returns false when that is already the case
+  auto park_until_idle(waiter* w) -> bool {
+    return idle_waiters_.park(w, [&] { return in_flight_.load(std::memory_order_acquire) == 0; });
+  }
+
+  void worker_started() noexcept {
+    busy_workers_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void worker_stopped() noexcept {
+    busy_workers_.fetch_sub(1, std::memory_order_release);
+  }
+
+  // No record in flight and no worker running: nothing references the graph any more
+  [[nodiscard]] auto quiescent() const noexcept -> bool {
+    return in_flight_.load(std::memory_order_acquire) == 0
+           && busy_workers_.load(std::memory_order_acquire) == 0;
+  }
+
+  [[nodiscard]] auto admitted() const noexcept -> std::uint64_t {
+    return admitted_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto completed() const noexcept -> std::uint64_t {
+    return completed_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto failed() const noexcept -> std::uint64_t {
+    return failed_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto in_flight() const noexcept -> std::size_t {
+    return in_flight_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct record {
+    std::atomic<std::uint32_t> pending{0};
+    std::atomic<bool>          failed{false};
+  };
+
+  void release(std::uint32_t ticket) noexcept {
+    free_.try_emplace(ticket);
+    ticket_waiters_.notify_one();
+    if (in_flight_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      idle_waiters_.notify_all();
+    }
+  }
+
+  const std::uint32_t         capacity_;
+  std::unique_ptr<record[]>   records_;  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+  queue<std::uint32_t>        free_;
+  waiter_list                 ticket_waiters_;
+  waiter_list                 idle_waiters_;
+  std::atomic<std::size_t>    in_flight_{0};
+  std::atomic<std::size_t>    busy_workers_{0};
+  std::atomic<std::uint64_t>  admitted_{0};
+  std::atomic<std::uint64_t>  completed_{0};
+  std::atomic<std::uint64_t>  failed_{0};
+  detail::mutex               error_mutex_{"graph::error"};
+  std::exception_ptr          first_error_;
+};
+
+// Topology and counters shared by every kind of node
+struct node_base {
+  node_base(record_table& table, std::string_view node_name, std::size_t workers, bool is_join,
+            std::size_t input_count)
+      : records(table),
+        name(node_name),
+        concurrency(std::max<std::size_t>(workers, 1)),
+        join(is_join),
+        predecessors(input_count, nullptr) {}
+
+  node_base(const node_base&)                    = delete;
+  auto operator=(const node_base&) -> node_base& = delete;
+  virtual ~node_base()                           = default;
+
+  [[nodiscard]] virtual auto queued() const noexcept -> std::size_t = 0;
+
+  [[nodiscard]] auto is_source() const noexcept -> bool {
+    return !join && predecessors.front() == nullptr;
+  }
+
+  record_table&              records;
+  const std::string          name;
+  const std::size_t          concurrency;
+  const bool                 join;
+  std::size_t                index{0};
+  std::vector<node_base*>    predecessors;  // One per input port
+  std::vector<node_base*>    successors;
+  std::uint32_t              terminals{0};  // Terminal nodes reachable from a source
+  std::atomic<std::uint64_t> processed{0};
+  std::atomic<std::uint64_t> failed{0};
+  std::atomic<std::uint64_t> waits{0};  // Hand-offs that parked on this node's full queue
+};
+
+// Receiving end of an edge carrying T
+template <class T>
+struct input_port {
+  // Moves `value` in and returns true, or leaves it untouched and returns false when the queue
+  // is full. With a waiter the caller is parked and resumed once there is room.
+  virtual auto offer(std::uint32_t ticket, T& value, waiter* w) noexcept -> bool = 0;
+
+  // The record failed upstream; pass it on without running anything
+  virtual void drop(std::uint32_t ticket) noexcept = 0;
+
+ protected:
+  input_port()                                     = default;
+  input_port(const input_port&)                    = default;
+  auto operator=(const input_port&) -> input_port& = default;
+  ~input_port()                                    = default;
+};
+
+// Outgoing edges of a node producing T
+template <class T>
+struct output_ports {
+  std::vector<input_port<T>*> ports;
+};
+
+template <>
+struct output_ports<void> {};
+
+template <class List>
+struct _single_value {
+  static_assert(sizeof(List) == 0, "graph stages must complete with at most one value");
+};
+
+template <>
+struct _single_value<execution::type_list<>> {
+  using type = void;
+};
+
+template <class T>
+struct _single_value<execution::type_list<T>> {
+  using type = std::decay_t<T>;
+};
+
+template <class In, class Fn>
+using stage_sender_t = std::invoke_result_t<Fn&, In>;
+
+template <class In, class Fn>
+using stage_value_t = typename _single_value<
+    typename execution::__decay_t<stage_sender_t<In, Fn>>::value_types>::type;
+
+struct unit {};
+
+// A node running fn(In) -> sender on Sched with `concurrency` workers
+template <class In, class Sched, class Fn>
+class node_impl : public node_base,
+                  public input_port<In>,
+                  public output_ports<stage_value_t<In, Fn>> {
+ public:
+  using out_type = stage_value_t<In, Fn>;
+
+  node_impl(record_table& table, Sched sched, Fn fn, std::string_view node_name,
+            std::size_t workers, std::size_t queue_capacity, bool is_join = false,
+            std::size_t input_count = 1)
+      : node_base(table, node_name, workers, is_join, input_count),
+        sched_(std::move(sched)),
+        fn_(std::move(fn)),
+        inbox_(queue_capacity),
+        workers_(std::make_unique<worker[]>(concurrency)) {
+    for (std::size_t i = 0; i < concurrency; ++i) {
+      workers_[i].node   = this;
+      workers_[i].resume = &resume_worker;
+    }
+  }
+
+  [[nodiscard]] auto queued() const noexcept -> std::size_t override {
+    return inbox_.size();
+  }
+
+  auto offer(std::uint32_t ticket, In& value, waiter* w) noexcept -> bool override {
+    if (!inbox_.try_emplace(ticket, std::move(value))) {
+      if (w == nullptr) {
+        return false;
+      }
+      waits.fetch_add(1, std::memory_order_relaxed);
+      if (space_.park(w, [&] { return inbox_.try_emplace(ticket, std::move(value)); })) {
+        return false;
+      }
+    }
+    wake_one();
+    return true;
+  }
+
+  void drop(std::uint32_t ticket) noexcept override {
+    drop_downstream(ticket);
+  }
+
+ protected:
+  void drop_downstream(std::uint32_t ticket) noexcept {
+    if constexpr (!std::is_void_v<out_type>) {
+      if (!this->ports.empty()) {
+        for (auto* port : this->ports) {
+          port->drop(ticket);
+        }
+        return;
+      }
+    }
+    records.finish(ticket, true);
+  }
+
+ private:
+  using stored_type = std::conditional_t<std::is_void_v<out_type>, unit, out_type>;
+
+  struct envelope {
+    envelope(std::uint32_t t, In&& v) noexcept : ticket(t), value(std::move(v)) {}
+
+    std::uint32_t ticket;
+    In            value;
+  };
+
+  struct worker;
+
+  // Resumes a worker on the node's scheduler. An error or stop means the scheduler could not
+  // run the worker, which then keeps going on this thread.
+  struct hop_receiver {
+    using receiver_concept = execution::receiver_t;
+
+    worker* w_;
+
+    void set_value() && noexcept {
+      node_impl::hop_done(*w_);
+    }
+
+    template <class E>
+    void set_error(E&& /*unused*/) && noexcept {
+      node_impl::hop_done(*w_);
+    }
+
+    void set_stopped() && noexcept {
+      node_impl::hop_done(*w_);
+    }
+  };
+
+  // Completion of the sender produced for one input, stored in body slot `slot_`
+  struct body_receiver {
+    using receiver_concept = execution::receiver_t;
+
+    worker*     w_;
+    std::size_t slot_;
+
+    template <class... Vs>
+    void set_value(Vs&&... vs) && noexcept {
+      auto* self = w_->node;
+      try {
+        w_->output.emplace(std::forward<Vs>(vs)...);
+        self->processed.fetch_add(1, std::memory_order_relaxed);
+      } catch (...) {
+        self->fail(*w_, std::current_exception());
+      }
+      self->body_done(*w_, slot_);
+    }
+
+    template <class E>
+    void set_error(E&& e) && noexcept {
+      auto* self = w_->node;
+      if constexpr (std::is_same_v<execution::__decay_t<E>, std::exception_ptr>) {
+        self->fail(*w_, std::forward<E>(e));
+      } else {
+        self->fail(*w_, std::make_exception_ptr(std::forward<E>(e)));
+      }
+      self->body_done(*w_, slot_);
+    }
+
+    void set_stopped() && noexcept {
+      auto* self = w_->node;
+      self->fail(*w_, nullptr);
+      self->body_done(*w_, slot_);
+    }
+  };
+
+  using hop_op = decltype(execution::connect(execution::schedule(std::declval<Sched&>()),
+                                             std::declval<hop_receiver>()));
+  using body_op =
+      decltype(execution::connect(std::declval<stage_sender_t<In, Fn>>(),
+                                  std::declval<body_receiver>()));
+
+  // Operation phases, used to tell an inline completion from an asynchronous one
+  static constexpr std::uint8_t phase_starting  = 0;
+  static constexpr std::uint8_t phase_started   = 1;
+  static constexpr std::uint8_t phase_completed = 2;
+
+  // No body slot is on the current stack
+  static constexpr std::size_t no_slot = 2;
+
+  // An operation is never re-emplaced from inside its own start() or completion: an inline
+  // completion is picked up after start() returns, and a body that completes asynchronously
+  // drives the worker from its completion, so the next body goes into the other slot.
+  struct alignas(64) worker : waiter {
+    node_impl*                            node{nullptr};
+    std::optional<hop_op>                 hop;
+    std::array<std::optional<body_op>, 2> body;
+    std::optional<stored_type>            output;  // Result not yet handed to every successor
+    std::size_t                           next_output{0};
+    std::size_t                           body_slot{0};  // Slot of the latest body
+    std::uint32_t                         ticket{no_ticket};
+    std::atomic<std::uint8_t>             hop_phase{phase_starting};
+    std::atomic<std::uint8_t>             phase{phase_starting};
+    std::atomic<bool>                     running{false};
+  };
+
+  static void resume_worker(waiter* w) noexcept {
+    auto& self = static_cast<worker&>(*w);
+    self.node->reschedule(self);
+  }
+
+  // Claim an idle worker for newly queued input
+  void wake_one() noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (std::size_t i = 0; i < concurrency; ++i) {
+      auto& w = workers_[i];
+      if (!w.running.load(std::memory_order_relaxed)
+          && !w.running.exchange(true, std::memory_order_acq_rel)) {
+        records.worker_started();
+        reschedule(w);
+        return;
+      }
+    }
+  }
+
+  // Moves the worker onto the node's scheduler. `pinned` is the body slot whose completion is
+  // on the current stack, if any.
+  void reschedule(worker& w, std::size_t pinned = no_slot) noexcept {
+    try {
+      w.hop.emplace(execution::__emplace_from{
+          [&] { return execution::connect(execution::schedule(sched_), hop_receiver{&w}); }});
+    } catch (...) {
+      run(w, pinned);
+      return;
+    }
+
+    w.hop_phase.store(phase_starting, std::memory_order_relaxed);
+    w.hop->start();
+    if (w.hop_phase.exchange(phase_started, std::memory_order_acq_rel) == phase_completed) {
+      // Completed inline: run here, now that start() has returned
+      run(w, pinned);
+    }
+  }
+
+  static void hop_done(worker& w) noexcept {
+    if (w.hop_phase.exchange(phase_completed, std::memory_order_acq_rel) == phase_started) {
+      w.node->run(w, no_slot);
+    }
+  }
+
+  // Worker loop on the node's scheduler: hand off the last result, then take the next input.
+  // Returns once the worker is parked, waiting for an asynchronous body, or idle.
+  void run(worker& w, std::size_t pinned) noexcept {
+    while (true) {
+      if (w.output.has_value() && !deliver(w)) {
+        return;
+      }
+
+      auto item = inbox_.try_pop();
+      if (!item) {
+        if (retire(w)) {
+          return;
+        }
+        continue;
+      }
+      space_.notify_one();
+
+      if (start_body(w, std::move(*item), pinned)) {
+        return;
+      }
+    }
+  }
+
+  // Returns true when the body completes asynchronously; body_done() then resumes the worker.
+  // The body never goes into the `pinned` slot.
+  auto start_body(worker& w, envelope&& item, std::size_t pinned) noexcept -> bool {
+    const std::size_t slot = pinned != no_slot ? pinned ^ 1U : w.body_slot ^ 1U;
+    w.body_slot            = slot;
+    w.ticket               = item.ticket;
+    try {
+      w.body[slot].emplace(execution::__emplace_from{[&] {
+        return execution::connect(std::invoke(fn_, std::move(item.value)),
+                                  body_receiver{&w, slot});
+      }});
+    } catch (...) {
+      fail(w, std::current_exception());
+      return false;
+    }
+
+    w.phase.store(phase_starting, std::memory_order_relaxed);
+    w.body[slot]->start();
+    return w.phase.exchange(phase_started, std::memory_order_acq_rel) != phase_completed;
+  }
+
+  void body_done(worker& w, std::size_t slot) noexcept {
+    if (w.phase.exchange(phase_completed, std::memory_order_acq_rel) == phase_started) {
+      reschedule(w, slot);
+    }
+  }
+
+  void fail(worker& w, std::exception_ptr error) noexcept {
+    failed.fetch_add(1, std::memory_order_relaxed);
+    if (error) {
+      records.report(std::move(error));
+    }
+    drop_downstream(w.ticket);
+  }
+
+  // Hands the result to every successor; returns false when parked on a full queue
+  auto deliver(worker& w) noexcept -> bool {
+    if constexpr (std::is_void_v<out_type>) {
+      records.finish(w.ticket, false);
+    } else {
+      auto& ports = this->ports;
+      if (ports.empty()) {
+        records.finish(w.ticket, false);
+      }
+      while (w.next_output < ports.size()) {
+        auto* port = ports[w.next_output];
+        if (w.next_output + 1 == ports.size()) {
+          if (!port->offer(w.ticket, *w.output, &w)) {
+            return false;
+          }
+        } else {
+          bool accepted = true;
+          try {
+            out_type copy(*w.output);
+            accepted = port->offer(w.ticket, copy, &w);
+          } catch (...) {
+            records.report(std::current_exception());
+            port->drop(w.ticket);
+          }
+          if (!accepted) {
+            return false;
+          }
+        }
+        ++w.next_output;
+      }
+    }
+    w.next_output = 0;
+    w.output.reset();
+    return true;
+  }
+
+  // Returns true when the worker went idle, false when it picked up new input instead
+  auto retire(worker& w) noexcept -> bool {
+    w.running.store(false, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!inbox_.empty() && !w.running.exchange(true, std::memory_order_acq_rel)) {
+      return false;
+    }
+    records.worker_stopped();
+    return true;
+  }
+
+  Sched                     sched_;
+  Fn                        fn_;
+  queue<envelope>           inbox_;
+  waiter_list               space_;  // Upstream workers and pushes waiting for queue room
+  std::unique_ptr<worker[]> workers_;  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+};
+
+template <class Fn>
+struct apply_fn {
+  Fn fn_;
+
+  template <class Tuple>
+  auto operator()(Tuple&& args) -> decltype(std::apply(fn_, std::forward<Tuple>(args))) {
+    return std::apply(fn_, std::forward<Tuple>(args));
+  }
+};
+
+// A node whose input is assembled from one value per input port
+template <class Sched, class Fn, class... Ins>
+class join_impl final : public node_impl<std::tuple<Ins...>, Sched, apply_fn<Fn>> {
+  using base = node_impl<std::tuple<Ins...>, Sched, apply_fn<Fn>>;
+
+ public:
+  template <std::size_t I>
+  using input_type = std::tuple_element_t<I, std::tuple<Ins...>>;
+
+  // The queue holds at most one entry per ticket, so completing a join never blocks
+  join_impl(record_table& table, Sched sched, Fn fn, std::string_view node_name,
+            std::size_t workers)
+      : base(table, std::move(sched), apply_fn<Fn>{std::move(fn)}, node_name, workers,
+             table.capacity(), true, sizeof...(Ins)),
+        assemblies_(std::make_unique<assembly[]>(table.capacity())) {
+    std::apply([this](auto&... port) { ((port.self = this), ...); }, ports_);
+  }
+
+  template <std::size_t I>
+  auto port() noexcept -> input_port<input_type<I>>* {
+    return &std::get<I>(ports_);
+  }
+
+ private:
+  struct assembly {
+    std::tuple<std::optional<Ins>...> parts;
+    std::atomic<std::size_t>          remaining{sizeof...(Ins)};
+    std::atomic<bool>                 failed{false};
+  };
+
+  template <std::size_t I>
+  struct join_port final : input_port<input_type<I>> {
+    join_impl* self{nullptr};
+
+    auto offer(std::uint32_t ticket, input_type<I>& value, waiter* /*unused*/) noexcept
+        -> bool override {
+      std::get<I>(self->assemblies_[ticket].parts).emplace(std::move(value));
+      self->arrive(ticket, false);
+      return true;
+    }
+
+    void drop(std::uint32_t ticket) noexcept override {
+      self->arrive(ticket, true);
+    }
+  };
+
+  template <class Seq>
+  struct _ports;
+
+  template <std::size_t... Is>
+  struct _ports<std::index_sequence<Is...>> {
+    using type = std::tuple<join_port<Is>...>;
+  };
+
+  // Dependency count of a record: the last arrival runs the join or drops the record
+  void arrive(std::uint32_t ticket, bool failed) noexcept {
+    auto& a = assemblies_[ticket];
+    if (failed) {
+      a.failed.store(true, std::memory_order_relaxed);
+    }
+    if (a.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    a.remaining.store(sizeof...(Ins), std::memory_order_relaxed);
+
+    auto reset = [&] { std::apply([](auto&... part) { (part.reset(), ...); }, a.parts); };
+    if (a.failed.exchange(false, std::memory_order_relaxed)) {
+      reset();
+      this->drop_downstream(ticket);
+      return;
+    }
+
+    auto joined =
+        std::apply([](auto&... part) { return std::tuple<Ins...>(std::move(*part)...); }, a.parts);
+    reset();
+    this->offer(ticket, joined, nullptr);
+  }
+
+  std::unique_ptr<assembly[]> assemblies_;  // NOLINT(cppcoreguidelines-avoid-c-arrays)
+  typename _ports<std::index_sequence_for<Ins...>>::type ports_;
+};
+
+// push(): admits one record, parking while every ticket is taken or the source queue is full
+template <class T, class Rcvr>
+struct push_operation : waiter {
+  using operation_state_concept = execution::operation_state_t;
+
+  push_operation(record_table& table, node_base* source, input_port<T>* port, T value,
+                 Rcvr rcvr)
+      : records_(&table),
+        source_(source),
+        port_(port),
+        value_(std::move(value)),
+        receiver_(std::move(rcvr)) {
+    resume = &resume_push;
+  }
+
+  push_operation(push_operation&&) = delete;
+
+  void start() & noexcept {
+    admit();
+  }
+
+ private:
+  static void resume_push(waiter* w) noexcept {
+    static_cast<push_operation*>(w)->admit();
+  }
+
+  void admit() noexcept {
+    if (ticket_ == no_ticket) {
+      auto ticket = records_->acquire(this);
+      if (!ticket) {
+        return;
+      }
+      ticket_ = *ticket;
+      records_->begin(ticket_, source_->terminals);
+    }
+    if (!port_->offer(ticket_, value_, this)) {
+      return;
+    }
+    std::move(receiver_).set_value();
+  }
+
+  record_table*  records_;
+  node_base*     source_;
+  input_port<T>* port_;
+  T              value_;
+  Rcvr           receiver_;
+  std::uint32_t  ticket_{no_ticket};
+};
+
+template <class T>
+struct push_sender {
+  using sender_concept = execution::sender_t;
+  using value_types    = execution::type_list<>;
+
+  record_table*  records_;
+  node_base*     source_;
+  input_port<T>* port_;
+  T              value_;
+
+  template <class Env>
+  auto get_completion_signatures(Env&& /*unused*/) const noexcept {
+    return execution::completion_signatures<execution::set_value_t()>{};
+  }
+
+  template <execution::receiver R>
+  auto connect(R&& r) && {
+    return push_operation<T, execution::__decay_t<R>>{*records_, source_, port_, std::move(value_),
+                                               std::forward<R>(r)};
+  }
+
+  template <execution::receiver R>
+  auto connect(R&& r) & {
+    return push_operation<T, execution::__decay_t<R>>{*records_, source_, port_, value_,
+                                               std::forward<R>(r)};
+  }
+};
+
+// drain(): completes once no record is in flight
+template <class Rcvr>
+struct drain_operation : waiter {
+  using operation_state_concept = execution::operation_state_t;
+
+  drain_operation(record_table& table, Rcvr rcvr)
+      : records_(&table), receiver_(std::move(rcvr)) {
+    resume = &resume_drain;
+  }
+
+  drain_operation(drain_operation&&) = delete;
+
+  void start() & noexcept {
+    if (!records_->park_until_idle(this)) {
+      std::move(receiver_).set_value();
+    }
+  }
+
+ private:
+  static void resume_drain(waiter* w) noexcept {
+    std::move(static_cast<drain_operation*>(w)->receiver_).set_value();
+  }
+
+  record_table* records_;
+  Rcvr          receiver_;
+};
+
+struct drain_sender {
+  using sender_concept = execution::sender_t;
+  using value_types    = execution::type_list<>;
+
+  record_table* records_;
+
+  template <class Env>
+  auto get_completion_signatures(Env&& /*unused*/) const noexcept {
+    return execution::completion_signatures<execution::set_value_t()>{};
+  }
+
+  template <execution::receiver R>
+  auto connect(R&& r) const {
+    return drain_operation<execution::__decay_t<R>>{*records_, std::forward<R>(r)};
+  }
+};
+
+}  // namespace _graph_detail
+
+struct graph_node_stats {
+  std::string   name;
+  std::size_t   concurrency{0};
+  std::size_t   queued{0};
+  std::uint64_t processed{0};           // Stage senders that completed with a value
+  std::uint64_t failed{0};              // Stage senders that completed with error or stopped
+  std::uint64_t backpressure_waits{0};  // Hand-offs that parked because the queue was full
+};
+
+struct graph_stats {
+  std::uint64_t                 admitted{0};
+  std::uint64_t                 completed{0};
+  std::uint64_t                 failed{0};
+  std::size_t                   in_flight{0};
+  std::vector<graph_node_stats> nodes;
+};
+
+class graph {
+ public:
+  struct options {
+    std::size_t max_in_flight = 256;  // Records admitted but not yet finished
+  };
+
+  struct node_options {
+    std::string_view name{};
+    std::size_t      concurrency    = 1;   // Stage senders running at once
+    std::size_t      queue_capacity = 64;  // Bounded input queue; ignored by joins
+  };
+
+  // Handle to one input of a join
+  template <class T>
+  class input {
+   public:
+    using value_type = T;
+
+   private:
+    friend class graph;
+
+    input(_graph_detail::node_base* node, _graph_detail::input_port<T>* port, std::size_t index)
+        : node_(node), port_(port), index_(index) {}
+
+    _graph_detail::node_base*     node_;
+    _graph_detail::input_port<T>* port_;
+    std::size_t                   index_;
+  };
+
+  // Handle to a node taking In and producing Out (void for terminal-only nodes)
+  template <class In, class Out>
+  class node {
+   public:
+    using input_type  = In;
+    using output_type = Out;
+
+   private:
+    friend class graph;
+
+    node(_graph_detail::node_base* base, _graph_detail::input_port<In>* in,
+         _graph_detail::output_ports<Out>* out)
+        : node_(base), in_(in), out_(out) {}
+
+   protected:
+    _graph_detail::node_base*         node_;
+    _graph_detail::input_port<In>*    in_;
+    _graph_detail::output_ports<Out>* out_;
+  };
+
+  template <class Out, class... Ins>
+  class join : public node<std::tuple<Ins...>, Out> {
+   public:
+    template <std::size_t I>
+    [[nodiscard]] auto input() const -> graph::input<std::tuple_element_t<I, std::tuple<Ins...>>> {
+      return {this->node_, std::get<I>(ports_), I};
+    }
+
+   private:
+    friend class graph;
+
+    join(node<std::tuple<Ins...>, Out> base, std::tuple<_graph_detail::input_port<Ins>*...> ports)
+        : node<std::tuple<Ins...>, Out>(base), ports_(ports) {}
+
+    std::tuple<_graph_detail::input_port<Ins>*...> ports_;
+  };
+
+  graph() : graph(options{}) {}
+
+  explicit graph(options opts) : records_(opts.max_in_flight) {}
+
+  graph(const graph&)                    = delete;
+  auto operator=(const graph&) -> graph& = delete;
+
+  ~graph() {
+    while (!records_.quiescent()) {
+      std::this_thread::yield();
+    }
+  }
+
+  // Adds a node running fn(In) on `sched`; fn returns a sender of at most one value
+  template <class In, execution::scheduler Sched, class Fn>
+  auto add_node(Sched sched, Fn fn, node_options opts = {}) {
+    static_assert(!std::is_void_v<In> && std::is_nothrow_move_constructible_v<In>,
+                  "graph node inputs must be nothrow move constructible values");
+    static_assert(execution::sender<_graph_detail::stage_sender_t<In, Fn>>,
+                  "graph node functions must return a sender");
+    using impl = _graph_detail::node_impl<In, Sched, Fn>;
+
+    auto* n = add<impl>(std::move(sched), std::move(fn), opts.name, opts.concurrency,
+                        opts.queue_capacity);
+    return node<In, typename impl::out_type>{n, n, n};
+  }
+
+  // Adds a node that runs fn(Ins...) once every input has received the same record
+  template <class... Ins, execution::scheduler Sched, class Fn>
+  auto add_join(Sched sched, Fn fn, node_options opts = {}) {
+    static_assert(sizeof...(Ins) > 0, "a join needs at least one input");
+    static_assert((std::is_nothrow_move_constructible_v<Ins> && ...),
+                  "graph node inputs must be nothrow move constructible values");
+    using impl = _graph_detail::join_impl<Sched, Fn, Ins...>;
+    using out  = typename impl::out_type;
+
+    auto* n     = add<impl>(std::move(sched), std::move(fn), opts.name, opts.concurrency);
+    auto  ports = [n]<std::size_t... Is>(std::index_sequence<Is...>) {
+      return std::tuple<_graph_detail::input_port<Ins>*...>{n->template port<Is>()...};
+    }(std::index_sequence_for<Ins...>{});
+    return join<out, Ins...>{node<std::tuple<Ins...>, out>{n, n, n}, ports};
+  }
+
+  // Edge from a node producing T to a node taking T
+  template <class In, class T, class Out>
+  void connect(const node<In, T>& from, const node<T, Out>& to) {
+    if (to.node_->join) {
+      throw std::invalid_argument("flow::graph: connect to a join through join.input<I>()");
+    }
+    link(from, to.node_, to.in_, 0);
+  }
+
+  // Edge from a node producing T to a join input taking T
+  template <class In, class T>
+  void connect(const node<In, T>& from, const input<T>& to) {
+    link(from, to.node_, to.port_, to.index_);
+  }
+
+  // Validates and freezes the topology. Called by the first push; throws std::invalid_argument
+  // when the edges form a cycle, a join input is unconnected or a join is fed from two sources.
+  void seal() {
+    if (sealed_.load(std::memory_order_acquire)) {
+      return;
+    }
+    std::scoped_lock lock(topology_mutex_);
+    if (!sealed_.load(std::memory_order_relaxed)) {
+      validate();
+      sealed_.store(true, std::memory_order_release);
+    }
+  }
+
+  // Sender that admits `value` as a new record at `source` and completes once it is queued
+  template <class In, class Out>
+  auto push(const node<In, Out>& source, In value) -> _graph_detail::push_sender<In> {
+    check_source(source);
+    seal();
+    return {&records_, source.node_, source.in_, std::move(value)};
+  }
+
+  // Admits `value` unless no ticket is free or the source queue is full
+  template <class In, class Out>
+  auto try_push(const node<In, Out>& source, In value) -> bool {
+    check_source(source);
+    seal();
+    auto ticket = records_.try_acquire();
+    if (!ticket) {
+      return false;
+    }
+    records_.begin(*ticket, source.node_->terminals);
+    if (source.in_->offer(*ticket, value, nullptr)) {
+      return true;
+    }
+    records_.abandon(*ticket);
+    return false;
+  }
+
+  // Sender that completes once no record is in flight
+  [[nodiscard]] auto drain() noexcept -> _graph_detail::drain_sender {
+    return {&records_};
+  }
+
+  // First error a stage completed with, if any
+  [[nodiscard]] auto error() -> std::exception_ptr {
+    return records_.first_error();
+  }
+
+  [[nodiscard]] auto stats() const -> graph_stats {
+    graph_stats s{.admitted  = records_.admitted(),
+                  .completed = records_.completed(),
+                  .failed    = records_.failed(),
+                  .in_flight = records_.in_flight(),
+                  .nodes     = {}};
+    s.nodes.reserve(nodes_.size());
+    for (const auto& n : nodes_) {
+      s.nodes.push_back({.name               = n->name,
+                         .concurrency        = n->concurrency,
+                         .queued             = n->queued(),
+                         .processed          = n->processed.load(std::memory_order_relaxed),
+                         .failed             = n->failed.load(std::memory_order_relaxed),
+                         .backpressure_waits = n->waits.load(std::memory_order_relaxed)});
+    }
+    return s;
+  }
+
+ private:
+  template <class Impl, class... Args>
+  auto add(Args&&... args) -> Impl* {
+    std::scoped_lock lock(topology_mutex_);
+    check_unsealed();
+    auto  owned = std::make_unique<Impl>(records_, std::forward<Args>(args)...);
+    auto* n     = owned.get();
+    n->index    = nodes_.size();
+    nodes_.push_back(std::move(owned));
+    return n;
+  }
+
+  template <class In, class T>
+  void link(const node<In, T>& from, _graph_detail::node_base* to,
+            _graph_detail::input_port<T>* port, std::size_t index) {
+    std::scoped_lock lock(topology_mutex_);
+    check_unsealed();
+    if (to->predecessors[index] != nullptr) {
+      throw std::invalid_argument("flow::graph: input of '" + to->name
+                                  + "' is already connected; merge branches with add_join");
+    }
+    if constexpr (!std::is_copy_constructible_v<T>) {
+      if (!from.out_->ports.empty()) {
+        throw std::invalid_argument("flow::graph: fan-out needs copy constructible values");
+      }
+    }
+    from.out_->ports.push_back(port);
+    from.node_->successors.push_back(to);
+    to->predecessors[index] = from.node_;
+  }
+
+  void check_unsealed() const {
+    if (sealed_.load(std::memory_order_relaxed)) {
+      throw std::logic_error("flow::graph: the topology is sealed once records are pushed");
+    }
+  }
+
+  template <class In, class Out>
+  static void check_source(const node<In, Out>& source) {
+    if (!source.node_->is_source()) {
+      throw std::invalid_argument("flow::graph: records can only be pushed into source nodes");
+    }
+  }
+
+  void validate() {
+    for (const auto& n : nodes_) {
+      if (std::ranges::find(n->predecessors, nullptr) != n->predecessors.end() && n->join) {
+        throw std::invalid_argument("flow::graph: join '" + n->name + "' has an unconnected input");
+      }
+    }
+
+    // Kahn's algorithm: every node must be reachable in topological order
+    std::vector<std::size_t> pending(nodes_.size());
+    std::vector<std::size_t> ready;
+    for (const auto& n : nodes_) {
+      pending[n->index] = static_cast<std::size_t>(
+          std::ranges::count_if(n->predecessors, [](auto* p) { return p != nullptr; }));
+      if (pending[n->index] == 0) {
+        ready.push_back(n->index);
+      }
+    }
+    std::size_t ordered = 0;
+    while (!ready.empty()) {
+      auto* n = nodes_[ready.back()].get();
+      ready.pop_back();
+      ++ordered;
+      for (auto* s : n->successors) {
+        if (--pending[s->index] == 0) {
+          ready.push_back(s->index);
+        }
+      }
+    }
+    if (ordered != nodes_.size()) {
+      throw std::invalid_argument("flow::graph: edges form a cycle");
+    }
+
+    // A record finishes once every terminal reachable from its source is done with it, and a
+    // join only runs once all its inputs saw the record, so they must share the source
+    std::vector<bool>                      reachable(nodes_.size());
+    std::vector<_graph_detail::node_base*> stack;
+    for (const auto& source : nodes_) {
+      if (!source->is_source()) {
+        continue;
+      }
+      std::fill(reachable.begin(), reachable.end(), false);
+      stack.assign(1, source.get());
+      reachable[source->index] = true;
+      while (!stack.empty()) {
+        auto* n = stack.back();
+        stack.pop_back();
+        for (auto* s : n->successors) {
+          if (!reachable[s->index]) {
+            reachable[s->index] = true;
+            stack.push_back(s);
+          }
+        }
+      }
+
+      std::uint32_t terminals = 0;
+      for (const auto& n : nodes_) {
+        if (!reachable[n->index]) {
+          continue;
+        }
+        terminals += n->successors.empty() ? 1 : 0;
+        for (auto* p : n->predecessors) {
+          if (p != nullptr && !reachable[p->index]) {
+            throw std::invalid_argument("flow::graph: join '" + n->name
+                                        + "' is fed from more than one source");
+          }
+        }
+      }
+      source->terminals = terminals;
+    }
+  }
+
+  _graph_detail::record_table                            records_;
+  std::vector<std::unique_ptr<_graph_detail::node_base>> nodes_;
+  detail::mutex                                          topology_mutex_{"graph::topology"};
+  std::atomic<bool>                                      sealed_{false};
+};
+
+}  // namespace flow
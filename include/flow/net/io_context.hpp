@@ -4,10 +4,11 @@
 #include <cstdint>
 #include <exception>
 #include <functional>
-#include <mutex>
 #include <queue>
 
+#include "../detail/mutex.hpp"
 #include "../execution/scheduler.hpp"
+#include "../execution/trace.hpp"
 #include "concepts.hpp"
 
 namespace flow::net {
@@ -62,7 +63,7 @@ class io_context {
   std::size_t run_one() {
     std::function<void()> work;
     {
-      std::unique_lock lock(mutex_);
+      detail::unique_lock lock(mutex_);
       if (work_queue_.empty()) {
         return 0;
       }
@@ -71,7 +72,9 @@ class io_context {
     }
 
     if (work) {
+      FLOW_TRACE_EVENT(start, io_context, 0);
       work();
+      FLOW_TRACE_EVENT(finish, io_context, 0);
       return 1;
     }
     return 0;
@@ -96,9 +99,10 @@ class io_context {
   // Post work to the context (internal use)
   void post(std::function<void()> work) {
     {
-      std::unique_lock lock(mutex_);
+      detail::unique_lock lock(mutex_);
       work_queue_.push(std::move(work));
     }
+    FLOW_TRACE_EVENT(enqueue, io_context, 0);
     cv_.notify_one();
   }
 
@@ -131,8 +135,8 @@ class io_context {
  private:
   std::uintptr_t                    context_id_;
   std::atomic<bool>                 stopped_;
-  std::mutex                        mutex_;
-  std::condition_variable           cv_;
+  detail::mutex                     mutex_{"io_context"};
+  detail::condition_variable        cv_;
   std::queue<std::function<void()>> work_queue_;
 };
 
@@ -0,0 +1,207 @@
+// The adaptive backing is opt-in; this suite always exercises it
+#ifndef FLOW_ENABLE_ADAPTIVE_MUTEX
+#define FLOW_ENABLE_ADAPTIVE_MUTEX
+#endif
+
+#include <atomic>
+#include <boost/ut.hpp>
+#include <chrono>
+#include <flow/execution.hpp>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+int main() {
+  using namespace boost::ut;
+  using namespace std::chrono_literals;
+  using flow::detail::adaptive_condition_variable;
+  using flow::detail::adaptive_mutex;
+
+  "adaptive_mutex_is_one_byte"_test = [] {
+    expect(sizeof(adaptive_mutex) == 1_ul);
+    expect(sizeof(adaptive_condition_variable) == 1_ul);
+  };
+
+  "try_lock_fails_while_held"_test = [] {
+    adaptive_mutex m;
+    expect(m.try_lock());
+    expect(not m.try_lock());
+    m.unlock();
+    expect(m.try_lock());
+    m.unlock();
+  };
+
+  "contended_increments_are_not_lost"_test = [] {
+    constexpr int threads    = 16;
+    constexpr int increments = 20'000;
+
+    adaptive_mutex           m;
+    long                     counter = 0;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+      workers.emplace_back([&] {
+        for (int i = 0; i < increments; ++i) {
+          std::scoped_lock lock(m);
+          ++counter;
+        }
+      });
+    }
+    for (auto& w : workers) {
+      w.join();
+    }
+    expect(counter == static_cast<long>(threads) * increments);
+  };
+
+  "long_critical_sections_park_and_every_thread_progresses"_test = [] {
+    constexpr int threads = 8;
+
+    adaptive_mutex           m;
+    std::atomic<bool>        stop{false};
+    std::vector<long>        acquired(threads, 0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        while (!stop.load(std::memory_order_relaxed)) {
+          std::scoped_lock lock(m);
+          ++acquired[t];
+          std::this_thread::sleep_for(10us);  // Long enough that waiters park
+        }
+      });
+    }
+    std::this_thread::sleep_for(200ms);
+    stop.store(true);
+    for (auto& w : workers) {
+      w.join();
+    }
+    // Fair handoffs keep a thread that re-locks in a loop from starving the sleepers
+    for (long count : acquired) {
+      expect(count > 0_l);
+    }
+  };
+
+  "requeued_waiter_keeps_its_place_and_wait_time"_test = [] {
+    namespace lot = flow::detail::parking_lot;
+    int               key = 0;
+    std::atomic<int>  sleeping{0};
+    std::vector<char> order;
+    std::mutex        order_mutex;
+    auto              park = [&](char name, bool requeue) {
+      lot::park(&key, [] { return true; }, [&] { sleeping.fetch_add(1); }, std::nullopt, requeue);
+      if (requeue || name == 'b') {
+        std::scoped_lock lock(order_mutex);
+        order.push_back(name);
+      }
+    };
+    auto wait_for_sleepers = [&](int n) {
+      while (sleeping.load() < n) {
+        std::this_thread::yield();
+      }
+    };
+
+    std::thread a([&] {
+      park('a', false);
+      park('a', true);  // Lost the race for whatever it waits on: back to the head
+    });
+    wait_for_sleepers(1);
+    std::this_thread::sleep_for(5ms);
+    std::thread b([&] { park('b', false); });
+    wait_for_sleepers(2);
+
+    lot::unpark_one(&key, [](lot::unpark_result) { return std::intptr_t{0}; });  // Wakes a
+    wait_for_sleepers(3);
+    std::chrono::steady_clock::duration waited{};
+    lot::unpark_one(&key, [&](lot::unpark_result result) {
+      waited = result.waited;
+      return std::intptr_t{0};
+    });
+    a.join();
+    lot::unpark_one(&key, [](lot::unpark_result) { return std::intptr_t{0}; });
+    b.join();
+
+    expect(order == std::vector<char>{'a', 'b'});
+    expect(waited >= 5ms);
+  };
+
+  "condition_variable_wakes_waiters"_test = [] {
+    adaptive_mutex              m;
+    adaptive_condition_variable cv;
+    int                         stage = 0;
+    std::vector<std::thread>    waiters;
+    std::atomic<int>            woken{0};
+    for (int t = 0; t < 4; ++t) {
+      waiters.emplace_back([&] {
+        std::unique_lock lock(m);
+        cv.wait(lock, [&] { return stage == 1; });
+        woken.fetch_add(1);
+      });
+    }
+    {
+      std::scoped_lock lock(m);
+      stage = 1;
+    }
+    cv.notify_all();
+    for (auto& w : waiters) {
+      w.join();
+    }
+    expect(woken.load() == 4_i);
+  };
+
+  "notify_one_hands_values_to_a_consumer"_test = [] {
+    adaptive_mutex              m;
+    adaptive_condition_variable cv;
+    std::vector<int>            queue;
+    long                        sum = 0;
+    std::thread                 consumer([&] {
+      std::unique_lock lock(m);
+      for (int received = 0; received < 1000;) {
+        cv.wait(lock, [&] { return !queue.empty(); });
+        for (int v : queue) {
+          sum += v;
+          ++received;
+        }
+        queue.clear();
+      }
+    });
+    for (int i = 1; i <= 1000; ++i) {
+      {
+        std::scoped_lock lock(m);
+        queue.push_back(i);
+      }
+      cv.notify_one();
+    }
+    consumer.join();
+    expect(sum == 500'500_l);
+  };
+
+  "wait_for_times_out"_test = [] {
+    adaptive_mutex              m;
+    adaptive_condition_variable cv;
+    std::unique_lock            lock(m);
+    auto                        begin = std::chrono::steady_clock::now();
+    expect(cv.wait_for(lock, 5ms) == std::cv_status::timeout);
+    expect(std::chrono::steady_clock::now() - begin >= 5ms);
+    expect(not cv.wait_for(lock, 1ms, [] { return false; }));
+    expect(lock.owns_lock());
+  };
+
+  "detail_mutex_is_adaptive"_test = [] {
+    expect(flow::detail::adaptive_mutex_enabled);
+    flow::detail::mutex              m{"test::adaptive"};
+    flow::detail::condition_variable cv;
+    bool                             ready = false;
+    std::thread                      setter([&] {
+      std::scoped_lock lock(m);
+      ready = true;
+      cv.notify_one();
+    });
+    {
+      flow::detail::unique_lock lock(m);
+      cv.wait(lock, [&] { return ready; });
+    }
+    setter.join();
+    expect(ready);
+  };
+
+  return 0;
+}
@@ -0,0 +1,183 @@
+#include <atomic>
+#include <boost/ut.hpp>
+#include <chrono>
+#include <exception>
+#include <flow/execution.hpp>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace flow::execution;
+using namespace std::chrono_literals;
+using flow::this_thread::sync_wait;
+using clock_type = std::chrono::steady_clock;
+
+constexpr codel_options tight{.target = 1ms, .interval = 5ms};
+
+void burn(std::chrono::nanoseconds d) {
+  const auto until = clock_type::now() + d;
+  while (clock_type::now() < until) {
+  }
+}
+
+// Keeps more work queued on `sched` than its workers can run, until destroyed
+template <class Sched>
+class overload {
+ public:
+  explicit overload(Sched sched, int producers = 6) {
+    for (int i = 0; i < producers; ++i) {
+      threads_.emplace_back([this, sched] {
+        while (!stop_.load()) {
+          try {
+            sync_wait(schedule(sched) | then([] { burn(2ms); }));
+          } catch (const overloaded_t&) {
+            std::this_thread::sleep_for(1ms);
+          }
+        }
+      });
+    }
+  }
+
+  ~overload() {
+    stop_.store(true);
+    for (auto& t : threads_) {
+      t.join();
+    }
+  }
+
+ private:
+  std::atomic<bool>        stop_{false};
+  std::vector<std::thread> threads_;
+};
+
+// Whether try_schedule(sched) was refused within `timeout`
+template <class Sched>
+auto try_schedule_refused_within(Sched sched, std::chrono::milliseconds timeout) -> bool {
+  const auto until = clock_type::now() + timeout;
+  while (clock_type::now() < until) {
+    try {
+      sync_wait(try_schedule(sched));
+    } catch (const would_block_t&) {
+      return true;
+    }
+    // An admitted probe skips the queue, so its short sojourn must not land in every window
+    std::this_thread::sleep_for(2 * tight.interval);
+  }
+  return false;
+}
+
+template <class Pool>
+void check_admission_control(Pool& pool) {
+  using namespace boost::ut;
+  auto sched = pool.get_scheduler();
+
+  expect(not pool.admission_stats().overloaded);
+  {
+    overload<decltype(sched)> load(sched);
+    expect(try_schedule_refused_within(sched, 5s));
+    auto stats = pool.admission_stats();
+    expect(stats.episodes >= 1_ul);
+    expect(stats.rejected >= 1_ul);
+    expect(stats.min_sojourn > tight.target);
+  }
+
+  // Once the backlog is gone and the workers have been idle for an interval, work is admitted
+  std::this_thread::sleep_for(4 * tight.interval);
+  expect(sync_wait(try_schedule(sched)).has_value());
+}
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+
+  "controller_flags_standing_delay"_test = [] {
+    codel_controller codel(tight);
+    expect(codel.admit());
+
+    // Every task of a full interval waited 3 ms: the delay is standing
+    const auto until = clock_type::now() + 2 * tight.interval;
+    while (clock_type::now() < until) {
+      codel.on_dequeue(clock_type::now() - 3ms);
+    }
+    expect(not codel.admit());
+    auto stats = codel.stats();
+    expect(stats.overloaded);
+    expect(stats.episodes == 1_ul);
+    expect(stats.rejected == 1_ul);
+    expect(stats.min_sojourn >= 3ms);
+
+    // A task dequeued within the target means the backlog has drained
+    codel.on_dequeue(clock_type::now());
+    expect(codel.admit());
+    expect(not codel.stats().overloaded);
+  };
+
+  "controller_ignores_a_burst_within_the_interval"_test = [] {
+    codel_controller codel({.target = 1ms, .interval = 1h});
+    for (int i = 0; i < 100; ++i) {
+      codel.on_dequeue(clock_type::now() - 10ms);
+    }
+    expect(codel.admit());
+  };
+
+  "controller_recovers_after_an_idle_interval"_test = [] {
+    codel_controller codel(tight);
+    const auto       until = clock_type::now() + 2 * tight.interval;
+    while (clock_type::now() < until) {
+      codel.on_dequeue(clock_type::now() - 3ms);
+    }
+    expect(not codel.admit());
+    std::this_thread::sleep_for(2 * tight.interval);
+    expect(codel.admit());
+  };
+
+  "schedulers_without_a_controller_report_nothing"_test = [] {
+    thread_pool             pool(1);
+    work_stealing_scheduler ws(1);
+    expect(not pool.admission_stats().overloaded);
+    expect(ws.admission_stats().rejected == 0_ul);
+    expect(sync_wait(try_schedule(pool.get_scheduler())).has_value());
+  };
+
+  "thread_pool_try_schedule_fails_fast_under_standing_delay"_test = [] {
+    thread_pool pool(1, tight);
+    check_admission_control(pool);
+  };
+
+  "work_stealing_try_schedule_fails_fast_under_standing_delay"_test = [] {
+    work_stealing_scheduler ws(1, tight);
+    check_admission_control(ws);
+  };
+
+  "reject_schedule_fails_schedule_with_overloaded"_test = [] {
+    work_stealing_scheduler ws(1, {.target = 1ms, .interval = 5ms, .reject_schedule = true});
+    auto                    sched = ws.get_scheduler();
+
+    overload<decltype(sched)> load(sched);
+    bool                      rejected = false;
+    const auto                until    = clock_type::now() + 5s;
+    while (!rejected && clock_type::now() < until) {
+      try {
+        sync_wait(schedule(sched));
+      } catch (const overloaded_t&) {
+        rejected = true;
+      }
+    }
+    expect(rejected);
+  };
+
+  "overloaded_is_rethrown_as_a_std_exception"_test = [] {
+    auto sndr = just_error(std::make_exception_ptr(overloaded_t{}));
+    bool caught = false;
+    try {
+      sync_wait(std::move(sndr));
+    } catch (const std::exception& e) {
+      caught = dynamic_cast<const overloaded_t*>(&e) != nullptr;
+    }
+    expect(caught);
+  };
+
+  return 0;
+}
@@ -0,0 +1,352 @@
+#include <atomic>
+#include <boost/ut.hpp>
+#include <cstddef>
+#include <exception>
+#include <flow/execution.hpp>
+#include <flow/graph.hpp>
+#include <list>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "allocation_counter.hpp"
+
+namespace {
+
+constexpr int warmup_runs   = 16;
+constexpr int measured_runs = 200;
+
+// Allocations made by the calling thread, or with flow::test::all_threads by every thread,
+// over measured_runs runs of `pipeline`, after warm-up. Compare against budget * measured_runs
+// rather than dividing, which would round a pipeline that allocates on only some runs down to
+// zero.
+template <class Pipeline, class... Mode>
+auto allocations_over_runs(Pipeline&& pipeline, Mode... mode) -> std::size_t {
+  for (int i = 0; i < warmup_runs; ++i) {
+    pipeline();
+  }
+
+  flow::test::allocation_scope scope{mode...};
+  for (int i = 0; i < measured_runs; ++i) {
+    pipeline();
+  }
+  return scope.allocations();
+}
+
+// Per-run allocation budget scaled to the measured runs
+constexpr auto budget(std::size_t per_run) -> std::size_t {
+  return per_run * measured_runs;
+}
+
+// Receiver larger than a work-stealing task's inline buffer
+struct large_receiver {
+  using receiver_concept = flow::execution::receiver_t;
+
+  std::atomic<bool>* done;
+  char               padding[256]{};
+
+  void set_value() && noexcept {
+    done->store(true, std::memory_order_release);
+  }
+
+  void set_error(std::exception_ptr /*unused*/) && noexcept {
+    done->store(true, std::memory_order_release);
+  }
+
+  void set_stopped() && noexcept {
+    done->store(true, std::memory_order_release);
+  }
+};
+
+// Parallel scheduler that completes schedule() inline, so that a parallel bulk path runs
+// entirely on the calling thread
+struct inline_parallel_scheduler {
+  using scheduler_concept = flow::execution::scheduler_t;
+
+  template <class Rcvr>
+  struct operation {
+    using operation_state_concept = flow::execution::operation_state_t;
+
+    Rcvr receiver;
+
+    void start() & noexcept {
+      std::move(receiver).set_value();
+    }
+  };
+
+  struct sender {
+    using sender_concept = flow::execution::sender_t;
+    using value_types    = flow::execution::type_list<>;
+
+    template <class Env>
+    auto get_completion_signatures(Env&& /*unused*/) const noexcept {
+      return flow::execution::completion_signatures<flow::execution::set_value_t()>{};
+    }
+
+    [[nodiscard]] auto query(
+        flow::execution::get_completion_scheduler_t<flow::execution::set_value_t> /*unused*/)
+        const noexcept {
+      return inline_parallel_scheduler{};
+    }
+
+    template <flow::execution::receiver R>
+    auto connect(R&& r) const {
+      return operation<std::decay_t<R>>{std::forward<R>(r)};
+    }
+  };
+
+  [[nodiscard]] static auto schedule() noexcept {
+    return sender{};
+  }
+
+  [[nodiscard]] static auto query(flow::execution::get_parallelism_t /*unused*/) noexcept
+      -> std::size_t {
+    return 4;
+  }
+
+  auto operator==(const inline_parallel_scheduler&) const noexcept -> bool = default;
+};
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+  using namespace flow::execution;
+  using flow::this_thread::sync_wait;
+
+  // ============================================================================
+  // Harness
+  // ============================================================================
+
+  "counts_allocations_in_scope"_test = [] {
+    flow::test::allocation_scope scope;
+    auto                         value = std::make_unique<int>(42);
+    std::vector<int>             values(16);
+    expect(scope.allocations() == 2_ul);
+    expect(scope.bytes() >= sizeof(int) + 16 * sizeof(int));
+
+    value.reset();
+    expect(scope.deallocations() == 1_ul);
+  };
+
+  "counts_aligned_and_array_allocations"_test = [] {
+    struct alignas(128) wide {
+      char bytes[128];
+    };
+
+    constexpr std::align_val_t align{alignof(wide)};
+
+    // The operators are called directly: new/delete expressions may be elided when optimizing
+    flow::test::allocation_scope scope;
+    void*                        one  = ::operator new(sizeof(wide), align);
+    void*                        many = ::operator new[](8 * sizeof(int));
+    ::operator delete(one, align);
+    ::operator delete[](many);
+    expect(scope.allocations() == 2_ul);
+    expect(scope.deallocations() == 2_ul);
+  };
+
+  "ignores_other_threads"_test = [] {
+    flow::test::allocation_scope scope;
+    std::thread                  other;
+    auto                         before = scope.allocations();
+    other = std::thread([] { auto discard = std::make_unique<std::vector<int>>(1024); });
+    other.join();
+
+    // Thread creation itself may allocate on this thread, the worker's allocations must not
+    auto after = scope.allocations();
+    expect(after - before <= 1_ul);
+  };
+
+  "all_threads_counts_other_threads"_test = [] {
+    flow::test::allocation_scope scope{flow::test::all_threads};
+    std::thread                  other([] { ::operator delete(::operator new(64)); });
+    other.join();
+
+    expect(scope.allocations() >= 1_ul);
+    expect(scope.deallocations() >= 1_ul);
+  };
+
+  // ============================================================================
+  // Allocation-free pipelines
+  // ============================================================================
+
+  "just_then_allocates_nothing"_test = [] {
+    auto runs = allocations_over_runs([] {
+      auto result = sync_wait(just(1) | then([](int x) { return x + 1; }));
+      expect(std::get<0>(*result) == 2_i);
+    });
+    expect(runs == budget(0));
+  };
+
+  "bulk_allocates_nothing"_test = [] {
+    int  sum  = 0;
+    auto runs = allocations_over_runs(
+        [&sum] { sync_wait(just() | bulk(seq, 16, [&sum](int i) { sum += i; })); });
+    expect(runs == budget(0));
+    expect(sum > 0_i);
+  };
+
+  "let_value_allocates_nothing"_test = [] {
+    auto runs = allocations_over_runs([] {
+      auto result = sync_wait(just(3) | let_value([](int x) { return just(x * 2); }));
+      expect(std::get<0>(*result) == 6_i);
+    });
+    expect(runs == budget(0));
+  };
+
+  "nested_let_family_allocates_nothing"_test = [] {
+    auto runs = allocations_over_runs([] {
+      auto stop   = [](int x) { return just_stopped() | then([x] { return x; }); };
+      auto result = sync_wait(just(1) | let_value([](int x) { return just(x + 1); })
+                              | let_value(stop) | let_stopped([] { return just(5); }));
+      expect(std::get<0>(*result) == 5_i);
+    });
+    expect(runs == budget(0));
+  };
+
+  "spawn_into_a_slab_allocates_nothing"_test = [] {
+    bounded_counting_scope<8> scope;
+    int                       count = 0;
+    auto                      runs  = allocations_over_runs(
+        [&] { spawn(just(1) | then([&](int x) { count += x; }), scope.get_token()); });
+    sync_wait(scope.join());
+    expect(runs == budget(0));
+    expect(count == warmup_runs + measured_runs);
+  };
+
+  "upon_stopped_allocates_nothing"_test = [] {
+    auto runs = allocations_over_runs(
+        [] { sync_wait(just_stopped() | upon_stopped([] { return 1; })); });
+    expect(runs == budget(0));
+  };
+
+  "when_all_allocates_nothing"_test = [] {
+    auto runs = allocations_over_runs([] { sync_wait(when_all(just(1), just(2))); });
+    expect(runs == budget(0));
+  };
+
+  "inline_scheduler_allocates_nothing"_test = [] {
+    inline_scheduler sched;
+    auto             runs = allocations_over_runs(
+        [&sched] { sync_wait(sched.schedule() | then([] { return 1; })); });
+    expect(runs == budget(0));
+  };
+
+  // Counted on every thread: the continuation runs on a worker
+  "work_stealing_schedule_allocates_nothing_after_warmup"_test = [] {
+    work_stealing_scheduler ws(4);
+    auto                    sched = ws.get_scheduler();
+
+    auto runs = allocations_over_runs(
+        [&sched] {
+          auto result = sync_wait(schedule(sched) | then([] { return 7; }));
+          expect(std::get<0>(*result) == 7_i);
+        },
+        flow::test::all_threads);
+    expect(runs == budget(0));
+  };
+
+  "work_stealing_try_schedule_allocates_nothing_after_warmup"_test = [] {
+    work_stealing_scheduler ws(2);
+    auto                    sched = ws.get_scheduler();
+
+    auto runs = allocations_over_runs(
+        [&sched] { sync_wait(sched.try_schedule() | then([] { return 7; })); },
+        flow::test::all_threads);
+    expect(runs == budget(0));
+  };
+
+  "work_stealing_large_receiver_allocates_once"_test = [] {
+    work_stealing_scheduler ws(2);
+    auto                    sched = ws.get_scheduler();
+
+    // A completion carrying the receiver no longer fits in the task's inline buffer and
+    // falls back to one heap allocation
+    static_assert(sizeof(large_receiver) > work_stealing_scheduler::task::inline_capacity);
+    auto runs = allocations_over_runs([&sched] {
+      std::atomic<bool> done{false};
+      auto              op = connect(schedule(sched), large_receiver{.done = &done});
+      start(op);
+      while (!done.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+    });
+    expect(runs == budget(1));
+  };
+
+  "sequential_for_each_over_a_list_allocates_nothing"_test = [] {
+    inline_parallel_scheduler sched;
+    std::list<int>            values(100, 1);
+    auto                      runs = allocations_over_runs([&] {
+      sync_wait(schedule(sched) | for_each(seq, values, [](int& v) { v += 1; }));
+    });
+    expect(runs == budget(0));
+    expect(values.front() == 1 + warmup_runs + measured_runs);
+  };
+
+  "graph_record_allocates_nothing"_test = [] {
+    inline_scheduler sched;
+    flow::graph      g({.max_in_flight = 8});
+    auto             source = g.add_node<int>(sched, [](int v) { return just(v + 1); });
+    auto             left   = g.add_node<int>(sched, [](int v) { return just(v * 2); });
+    auto             right  = g.add_node<int>(sched, [](int v) { return just(v * 3); });
+    auto             merge  = g.add_join<int, int>(sched, [](int x, int y) { return just(x + y); });
+    auto             sink   = g.add_node<int>(sched, [](int) { return just(); });
+    g.connect(source, left);
+    g.connect(source, right);
+    g.connect(left, merge.input<0>());
+    g.connect(right, merge.input<1>());
+    g.connect(merge, sink);
+
+    int  next = 0;
+    auto runs = allocations_over_runs([&] { sync_wait(g.push(source, next++)); });
+    expect(runs == budget(0));
+    expect(g.stats().completed == 216_ul);
+  };
+
+  // ============================================================================
+  // Known allocation budgets. Lower these when the adaptor stops allocating.
+  // ============================================================================
+
+  "transfer_budget"_test = [] {
+    inline_scheduler sched;
+    auto             runs = allocations_over_runs([&sched] {
+      sync_wait(just(1) | transfer(sched) | then([](int x) { return x; }));
+    });
+    // shared state, two operation holders and two cleanup callbacks
+    expect(runs == budget(5));
+  };
+
+  "retry_budget"_test = [] {
+    auto runs = allocations_over_runs([] { sync_wait(just(1) | retry()); });
+    // shared state and the heap-allocated inner operation
+    expect(runs == budget(2));
+  };
+
+  "parallel_bulk_budget"_test = [] {
+    inline_parallel_scheduler sched;
+    int                       sum  = 0;
+    auto                      runs = allocations_over_runs(
+        [&] { sync_wait(schedule(sched) | bulk(par, 64, [&](int i) { sum += i; })); });
+    // the run's shared state and its helper operations
+    expect(runs == budget(2));
+    expect(sum > 0_i);
+  };
+
+  "parallel_for_each_over_a_list_budget"_test = [] {
+    inline_parallel_scheduler sched;
+    std::list<int>            values(100, 1);
+    auto                      runs = allocations_over_runs([&] {
+      sync_wait(schedule(sched) | for_each(par, values, [](int& v) { v += 1; }));
+    });
+    // the block starts, the run's shared state and its helper operations
+    expect(runs == budget(3));
+    expect(values.back() == 1 + warmup_runs + measured_runs);
+  };
+
+  return 0;
+}
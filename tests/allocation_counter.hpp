@@ -0,0 +1,226 @@
+#pragma once
+
+// Allocation counting for tests.
+//
+// Replaces the global operator new/delete family with versions that forward to malloc/free
+// and bump per-thread counters. allocation_scope snapshots the calling thread's counters so a
+// test can assert the exact number of allocations a pipeline performs:
+//
+//   flow::test::allocation_scope scope;
+//   run_pipeline();
+//   expect(scope.allocations() == 0_ul);
+//
+// Work handed to other threads, such as scheduler workers, allocates on those threads. A scope
+// constructed with flow::test::all_threads counts every thread of the process instead, from
+// process-wide totals kept next to the per-thread counters; it can only be exact while no
+// unrelated thread allocates.
+//
+// Replacement allocation functions must be defined once per program, so include this header
+// from exactly one translation unit of a test executable.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace flow::test {
+
+struct allocation_counts {
+  std::size_t allocations   = 0;
+  std::size_t deallocations = 0;
+  std::size_t bytes         = 0;
+};
+
+namespace _allocation_detail {
+
+// Constant-initialized so it is usable from operator new during thread start-up
+constinit inline thread_local allocation_counts counts{};
+
+// Totals over every thread
+constinit inline std::atomic<std::size_t> total_allocations{0};
+constinit inline std::atomic<std::size_t> total_deallocations{0};
+constinit inline std::atomic<std::size_t> total_bytes{0};
+
+inline auto allocate(std::size_t size, std::size_t alignment) noexcept -> void* {
+  if (size == 0) {
+    size = 1;
+  }
+
+  void* ptr = nullptr;
+  if (alignment <= alignof(std::max_align_t)) {
+    ptr = std::malloc(size);
+  } else {
+    // aligned_alloc requires the size to be a multiple of the alignment
+    ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+  }
+
+  if (ptr != nullptr) {
+    ++counts.allocations;
+    counts.bytes += size;
+    total_allocations.fetch_add(1, std::memory_order_relaxed);
+    total_bytes.fetch_add(size, std::memory_order_relaxed);
+  }
+  return ptr;
+}
+
+inline auto allocate_or_throw(std::size_t size, std::size_t alignment) -> void* {
+  for (;;) {
+    if (void* ptr = allocate(size, alignment)) {
+      return ptr;
+    }
+    auto handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+
+inline void deallocate(void* ptr) noexcept {
+  if (ptr != nullptr) {
+    ++counts.deallocations;
+    total_deallocations.fetch_add(1, std::memory_order_relaxed);
+    std::free(ptr);
+  }
+}
+
+}  // namespace _allocation_detail
+
+// Counters of the calling thread since program start
+inline auto thread_allocation_counts() noexcept -> allocation_counts {
+  return _allocation_detail::counts;
+}
+
+// Counters of every thread since program start
+inline auto process_allocation_counts() noexcept -> allocation_counts {
+  return {.allocations   = _allocation_detail::total_allocations.load(std::memory_order_relaxed),
+          .deallocations = _allocation_detail::total_deallocations.load(std::memory_order_relaxed),
+          .bytes         = _allocation_detail::total_bytes.load(std::memory_order_relaxed)};
+}
+
+// Tag for an allocation_scope that counts every thread
+struct all_threads_t {
+  explicit all_threads_t() = default;
+};
+
+inline constexpr all_threads_t all_threads{};
+
+// Measures the allocations made during its lifetime by the calling thread, or with
+// all_threads by every thread
+class allocation_scope {
+ public:
+  allocation_scope() noexcept : start_(thread_allocation_counts()) {}
+
+  explicit allocation_scope(all_threads_t /*unused*/) noexcept
+      : all_threads_(true), start_(process_allocation_counts()) {}
+
+  [[nodiscard]] auto allocations() const noexcept -> std::size_t {
+    return current().allocations - start_.allocations;
+  }
+
+  [[nodiscard]] auto deallocations() const noexcept -> std::size_t {
+    return current().deallocations - start_.deallocations;
+  }
+
+  [[nodiscard]] auto bytes() const noexcept -> std::size_t {
+    return current().bytes - start_.bytes;
+  }
+
+ private:
+  [[nodiscard]] auto current() const noexcept -> allocation_counts {
+    return all_threads_ ? process_allocation_counts() : thread_allocation_counts();
+  }
+
+  bool              all_threads_ = false;
+  allocation_counts start_;
+};
+
+}  // namespace flow::test
+
+// Replacement allocation functions ([new.delete])
+
+auto operator new(std::size_t size) -> void* {
+  return flow::test::_allocation_detail::allocate_or_throw(size, alignof(std::max_align_t));
+}
+
+auto operator new[](std::size_t size) -> void* {
+  return flow::test::_allocation_detail::allocate_or_throw(size, alignof(std::max_align_t));
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment) -> void* {
+  return flow::test::_allocation_detail::allocate_or_throw(size,
+                                                            static_cast<std::size_t>(alignment));
+}
+
+auto operator new[](std::size_t size, std::align_val_t alignment) -> void* {
+  return flow::test::_allocation_detail::allocate_or_throw(size,
+                                                            static_cast<std::size_t>(alignment));
+}
+
+auto operator new(std::size_t size, const std::nothrow_t& /*unused*/) noexcept -> void* {
+  return flow::test::_allocation_detail::allocate(size, alignof(std::max_align_t));
+}
+
+auto operator new[](std::size_t size, const std::nothrow_t& /*unused*/) noexcept -> void* {
+  return flow::test::_allocation_detail::allocate(size, alignof(std::max_align_t));
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment,
+                  const std::nothrow_t& /*unused*/) noexcept -> void* {
+  return flow::test::_allocation_detail::allocate(size, static_cast<std::size_t>(alignment));
+}
+
+auto operator new[](std::size_t size, std::align_val_t alignment,
+                    const std::nothrow_t& /*unused*/) noexcept -> void* {
+  return flow::test::_allocation_detail::allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept {
+  flow::test::_allocation_detail::deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  flow::test::_allocation_detail::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*unused*/) noexcept {
+  flow::test::_allocation_detail::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t /*unused*/) noexcept {
+  flow::test::_allocation_detail::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t /*unused*/) noexcept {
+  flow::test::_allocation_detail::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t /*unused*/) noexcept {
+  flow::test::_allocation_detail::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*unused*/, std::align_val_t /*unused*/) noexcept {
+  flow::test::_allocation_detail::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t /*unused*/, std::align_val_t /*unused*/) noexcept {
+  flow::test::_allocation_detail::deallocate(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t& /*unused*/) noexcept {
+  flow::test::_allocation_detail::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t& /*unused*/) noexcept {
+  flow::test::_allocation_detail::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t /*unused*/,
+                     const std::nothrow_t& /*unused*/) noexcept {
+  flow::test::_allocation_detail::deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t /*unused*/,
+                       const std::nothrow_t& /*unused*/) noexcept {
+  flow::test::_allocation_detail::deallocate(ptr);
+}
@@ -0,0 +1,273 @@
+#include <atomic>
+#include <boost/ut.hpp>
+#include <chrono>
+#include <flow/execution.hpp>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace flow::execution;
+
+// Records the order in which waiters resume and the thread they resume on
+struct recording_receiver {
+  using receiver_concept = receiver_t;
+
+  int               index;
+  std::vector<int>* order;
+  std::mutex*       mutex;
+  std::thread::id*  thread{nullptr};
+  std::atomic<int>* done{nullptr};
+
+  void set_value() && noexcept {
+    {
+      std::scoped_lock lock(*mutex);
+      order->push_back(index);
+      if (thread != nullptr) {
+        *thread = std::this_thread::get_id();
+      }
+    }
+    if (done != nullptr) {
+      done->fetch_add(1);
+    }
+  }
+
+  void set_error(std::exception_ptr /*unused*/) && noexcept {}
+
+  void set_stopped() && noexcept {}
+};
+
+// Environment exposing the scheduler a waiter should resume on
+template <class Sched>
+struct scheduler_env {
+  Sched sched;
+
+  [[nodiscard]] auto query(get_scheduler_t /*unused*/) const noexcept -> Sched {
+    return sched;
+  }
+};
+
+template <class Sched>
+struct env_receiver {
+  using receiver_concept = receiver_t;
+
+  Sched             sched;
+  std::thread::id*  thread;
+  std::atomic<int>* done;
+
+  void set_value() && noexcept {
+    *thread = std::this_thread::get_id();
+    done->fetch_add(1);
+  }
+
+  void set_error(std::exception_ptr /*unused*/) && noexcept {}
+
+  void set_stopped() && noexcept {}
+
+  [[nodiscard]] auto get_env() const noexcept {
+    return scheduler_env<Sched>{sched};
+  }
+};
+
+// Receiver whose deadline has already passed; counts its completions
+struct expired_receiver {
+  using receiver_concept = receiver_t;
+
+  std::atomic<int>* values;
+  std::atomic<int>* stopped;
+
+  void set_value() && noexcept {
+    values->fetch_add(1);
+  }
+
+  void set_error(std::exception_ptr /*unused*/) && noexcept {}
+
+  void set_stopped() && noexcept {
+    stopped->fetch_add(1);
+  }
+
+  [[nodiscard]] auto get_env() const noexcept {
+    return make_env_with_deadline(std::chrono::steady_clock::now() - std::chrono::seconds(1),
+                                  empty_env{});
+  }
+};
+
+void wait_for(const std::atomic<int>& counter, int value) {
+  while (counter.load() < value) {
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+
+  // ============================================================================
+  // async_latch
+  // ============================================================================
+
+  "latch_releases_waiters_in_arrival_order"_test = [] {
+    async_latch      latch(2);
+    std::vector<int> order;
+    std::mutex       mutex;
+
+    auto op1 = latch.wait().connect(recording_receiver{1, &order, &mutex});
+    auto op2 = latch.wait().connect(recording_receiver{2, &order, &mutex});
+    auto op3 = latch.arrive_and_wait().connect(recording_receiver{3, &order, &mutex});
+    op1.start();
+    op2.start();
+    op3.start();
+    expect(order.empty());
+    expect(not latch.try_wait());
+
+    latch.count_down();
+    expect(order == std::vector<int>{1, 2, 3});
+    expect(latch.try_wait());
+  };
+
+  "released_latch_completes_immediately"_test = [] {
+    async_latch      latch(1);
+    std::vector<int> order;
+    std::mutex       mutex;
+
+    latch.count_down();
+    auto op = latch.wait().connect(recording_receiver{7, &order, &mutex});
+    op.start();
+    expect(order == std::vector<int>{7});
+
+    async_latch open(0);
+    expect(open.try_wait());
+    expect(flow::this_thread::sync_wait(open.wait()).has_value());
+  };
+
+  "latch_arrivals_from_many_threads"_test = [] {
+    constexpr int            threads = 8;
+    async_latch              latch(threads);
+    std::atomic<int>         passed{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+      workers.emplace_back([&] {
+        flow::this_thread::sync_wait(latch.arrive_and_wait());
+        passed.fetch_add(1);
+      });
+    }
+    for (auto& w : workers) {
+      w.join();
+    }
+    expect(passed.load() == threads);
+  };
+
+  // ============================================================================
+  // async_barrier
+  // ============================================================================
+
+  "barrier_runs_completion_once_per_phase"_test = [] {
+    constexpr int participants = 6;
+    constexpr int phases       = 50;
+
+    std::atomic<int> arrived{0};
+    std::atomic<int> mismatches{0};
+    int              completed = 0;
+    async_barrier    barrier(participants, [&]() noexcept {
+      // Every participant has arrived for this phase and none has moved on
+      if (arrived.exchange(0) != participants) {
+        mismatches.fetch_add(1);
+      }
+      ++completed;
+    });
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < participants; ++t) {
+      workers.emplace_back([&] {
+        for (int p = 0; p < phases; ++p) {
+          arrived.fetch_add(1);
+          flow::this_thread::sync_wait(barrier.arrive_and_wait());
+        }
+      });
+    }
+    for (auto& w : workers) {
+      w.join();
+    }
+
+    expect(completed == phases);
+    expect(mismatches.load() == 0_i);
+    expect(barrier.phase() == static_cast<std::uint64_t>(phases));
+  };
+
+  "barrier_resumes_waiters_on_their_scheduler"_test = [] {
+    thread_pool      pool(2);
+    async_barrier    barrier(3);
+    std::vector<int> order;
+    std::mutex       mutex;
+    std::thread::id  resumed;
+    std::atomic<int> done{0};
+
+    auto op1 = barrier.arrive_and_wait(pool.get_scheduler())
+                   .connect(recording_receiver{1, &order, &mutex, &resumed, &done});
+    auto op2 = barrier.arrive_and_wait().connect(recording_receiver{2, &order, &mutex});
+    op1.start();
+    op2.start();
+    expect(order.empty());
+
+    barrier.arrive();
+    wait_for(done, 1);
+    {
+      std::scoped_lock lock(mutex);
+      expect(order.size() == 2_ul);
+      expect(resumed != std::this_thread::get_id());
+    }
+    expect(barrier.phase() == 1_ul);
+  };
+
+  "waiter_resumes_on_environment_scheduler"_test = [] {
+    work_stealing_scheduler ws(2);
+    auto                    sched = ws.get_scheduler();
+    async_latch             latch(1);
+    std::thread::id         resumed;
+    std::atomic<int>        done{0};
+
+    auto op = latch.wait().connect(env_receiver<decltype(sched)>{sched, &resumed, &done});
+    op.start();
+    latch.count_down();
+    wait_for(done, 1);
+    expect(resumed != std::this_thread::get_id());
+  };
+
+  "expired_waiter_is_shed_by_its_scheduler"_test = [] {
+    work_stealing_scheduler ws(2);
+    auto                    sched = ws.get_scheduler();
+    async_latch             latch(1);
+    std::atomic<int>        values{0};
+    std::atomic<int>        stopped{0};
+
+    auto op = latch.wait(sched).connect(expired_receiver{&values, &stopped});
+    op.start();
+    latch.count_down();
+    wait_for(stopped, 1);
+    expect(values.load() == 0_i);
+  };
+
+  "arrive_and_drop_shrinks_later_phases"_test = [] {
+    async_barrier    barrier(3);
+    std::vector<int> order;
+    std::mutex       mutex;
+
+    barrier.arrive_and_drop();
+    barrier.arrive();
+    auto op1 = barrier.arrive_and_wait().connect(recording_receiver{1, &order, &mutex});
+    op1.start();
+    expect(order == std::vector<int>{1});
+
+    // Two participants remain
+    auto op2 = barrier.arrive_and_wait().connect(recording_receiver{2, &order, &mutex});
+    op2.start();
+    expect(order == std::vector<int>{1});
+    barrier.arrive();
+    expect(order == std::vector<int>{1, 2});
+    expect(barrier.phase() == 2_ul);
+  };
+
+  return 0;
+}
@@ -0,0 +1,330 @@
+#include <atomic>
+#include <boost/ut.hpp>
+#include <chrono>
+#include <flow/execution.hpp>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace flow::execution;
+
+struct connection {
+  int id;
+  int uses{0};
+};
+
+using connection_pool = async_pool<connection>;
+
+// Records the order in which parked acquires complete and keeps their leases
+struct recording_receiver {
+  using receiver_concept = receiver_t;
+
+  int                                  index;
+  std::vector<int>*                    order;
+  std::vector<connection_pool::lease>* leases;
+  inplace_stop_token                   token;
+
+  void set_value(connection_pool::lease l) && noexcept {
+    order->push_back(index);
+    leases->push_back(std::move(l));
+  }
+
+  void set_error(std::exception_ptr /*unused*/) && noexcept {}
+
+  void set_stopped() && noexcept {
+    order->push_back(-index);
+  }
+
+  [[nodiscard]] auto get_env() const noexcept {
+    return make_env_with_stop_token(token, empty_env{});
+  }
+};
+
+// Drops its lease as soon as it receives it, handing the object to the next waiter
+struct returning_receiver {
+  using receiver_concept = receiver_t;
+
+  int* served;
+
+  void set_value(connection_pool::lease l) && noexcept {
+    ++*served;
+    l.reset();
+  }
+
+  void set_error(std::exception_ptr /*unused*/) && noexcept {}
+
+  void set_stopped() && noexcept {}
+};
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+  using namespace std::chrono_literals;
+
+  // ============================================================================
+  // Leases
+  // ============================================================================
+
+  "lease_returns_object_on_destruction"_test = [] {
+    int             next_id = 0;
+    connection_pool pool(2, [&next_id] { return connection{next_id++}; }, 1);
+    expect(pool.size() == 2_ul);
+
+    {
+      auto a = pool.try_acquire();
+      auto b = pool.try_acquire();
+      expect(a.has_value() && b.has_value());
+      if (!a || !b) {
+        return;
+      }
+      expect((*a)->id != (*b)->id);
+      expect(not pool.try_acquire().has_value());
+      expect(pool.stats().available == 0_ul);
+    }
+
+    auto stats = pool.stats();
+    expect(stats.available == 2_ul);
+    expect(stats.acquired == 2_ul);
+    expect(pool.try_acquire().has_value());
+  };
+
+  "lease_moves_and_resets"_test = [] {
+    connection_pool pool(1, [] { return connection{7}; }, 1);
+
+    auto first = pool.try_acquire();
+    if (!first) {
+      return;
+    }
+    connection_pool::lease moved = std::move(*first);
+    expect(not *first);
+    expect(static_cast<bool>(moved));
+    expect(moved->id == 7_i);
+    moved->uses++;
+
+    moved.reset();
+    expect(not moved);
+    auto again = pool.try_acquire();
+    expect(again.has_value());
+    if (again) {
+      expect((*again)->uses == 1_i);
+    }
+  };
+
+  "acquire_completes_inline_when_free"_test = [] {
+    connection_pool pool(1, [] { return connection{3}; });
+
+    auto result = flow::this_thread::sync_wait(pool.acquire() | then([](connection_pool::lease l) {
+                                                 return l->id;
+                                               }));
+    expect(result.has_value());
+    if (result) {
+      expect(std::get<0>(*result) == 3_i);
+    }
+    expect(pool.stats().waited == 0_ul);
+  };
+
+  // ============================================================================
+  // Waiters
+  // ============================================================================
+
+  "release_hands_object_to_oldest_waiter"_test = [] {
+    connection_pool pool(1, [] { return connection{1}; }, 1);
+    auto            held = pool.try_acquire();
+    if (!held) {
+      return;
+    }
+
+    std::vector<int>                    order;
+    std::vector<connection_pool::lease> leases;
+    auto op1 = pool.acquire().connect(recording_receiver{1, &order, &leases, {}});
+    auto op2 = pool.acquire().connect(recording_receiver{2, &order, &leases, {}});
+    op1.start();
+    op2.start();
+    expect(order.empty());
+    expect(pool.stats().waiting == 2_ul);
+
+    held->reset();
+    expect(order == std::vector<int>{1});
+    leases.front().reset();
+    expect(order == std::vector<int>{1, 2});
+
+    auto stats = pool.stats();
+    expect(stats.waited == 2_ul);
+    expect(stats.handoffs == 2_ul);
+    expect(stats.waiting == 0_ul);
+    expect(stats.available == 0_ul);
+  };
+
+  "synchronous_waiters_are_handed_off_without_nesting"_test = [] {
+    // Each waiter returns its object inline, handing it to the next one; a chain this long
+    // would overflow the stack if every hand-off nested inside the previous one
+    constexpr int   waiters = 200'000;
+    connection_pool pool(1, [] { return connection{1}; }, 1);
+    auto            held = pool.try_acquire();
+    if (!held) {
+      return;
+    }
+
+    int  served = 0;
+    using op_t  = decltype(pool.acquire().connect(returning_receiver{&served}));
+    std::vector<std::optional<op_t>> ops(waiters);
+    for (auto& op : ops) {
+      op.emplace(flow::execution::__emplace_from{
+          [&] { return pool.acquire().connect(returning_receiver{&served}); }});
+      op->start();
+    }
+    held->reset();
+    expect(served == waiters);
+    expect(pool.stats().available == 1_ul);
+    expect(pool.stats().handoffs == static_cast<std::uint64_t>(waiters));
+  };
+
+  "add_feeds_parked_acquire"_test = [] {
+    connection_pool                     pool(1);
+    std::vector<int>                    order;
+    std::vector<connection_pool::lease> leases;
+
+    auto op = pool.acquire().connect(recording_receiver{1, &order, &leases, {}});
+    op.start();
+    expect(order.empty());
+
+    pool.add(connection{42});
+    expect(order == std::vector<int>{1});
+    expect(leases.size() == 1_ul);
+    if (!leases.empty()) {
+      expect(leases.front()->id == 42_i);
+    }
+  };
+
+  "stop_cancels_parked_acquire"_test = [] {
+    connection_pool pool(1, [] { return connection{1}; }, 1);
+    auto            held = pool.try_acquire();
+    if (!held) {
+      return;
+    }
+
+    inplace_stop_source                 source;
+    std::vector<int>                    order;
+    std::vector<connection_pool::lease> leases;
+    auto op1 = pool.acquire().connect(recording_receiver{1, &order, &leases, source.get_token()});
+    auto op2 = pool.acquire().connect(recording_receiver{2, &order, &leases, {}});
+    op1.start();
+    op2.start();
+
+    source.request_stop();
+    expect(order == std::vector<int>{-1});
+
+    held->reset();
+    expect(order == std::vector<int>{-1, 2});
+    expect(pool.stats().cancelled == 1_ul);
+  };
+
+  "stopped_token_completes_without_parking"_test = [] {
+    connection_pool pool(1);
+
+    inplace_stop_source source;
+    source.request_stop();
+    std::vector<int>                    order;
+    std::vector<connection_pool::lease> leases;
+    auto op = pool.acquire().connect(recording_receiver{5, &order, &leases, source.get_token()});
+    op.start();
+
+    expect(order == std::vector<int>{-5});
+    expect(pool.stats().waiting == 0_ul);
+  };
+
+  // ============================================================================
+  // Caches and concurrency
+  // ============================================================================
+
+  "empty_cache_steals_from_peers"_test = [] {
+    connection_pool pool(4);
+    std::thread     producer([&pool] {
+      for (int i = 0; i < 4; ++i) {
+        pool.add(connection{i});
+      }
+    });
+    producer.join();
+
+    std::vector<connection_pool::lease> leases;
+    for (int i = 0; i < 4; ++i) {
+      auto l = pool.try_acquire();
+      expect(l.has_value());
+      if (l) {
+        leases.push_back(std::move(*l));
+      }
+    }
+    expect(pool.stats().steals >= 1_ul);
+  };
+
+  "concurrent_acquires_never_exceed_pool_size"_test = [] {
+    constexpr int   pool_size = 3;
+    int             next_id   = 0;
+    connection_pool pool(pool_size, [&next_id] { return connection{next_id++}; });
+
+    std::atomic<int>         active{0};
+    std::atomic<int>         peak{0};
+    std::atomic<int>         done{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+      threads.emplace_back([&] {
+        for (int i = 0; i < 200; ++i) {
+          auto result = flow::this_thread::sync_wait(pool.acquire());
+          if (!result) {
+            continue;
+          }
+          auto now  = active.fetch_add(1) + 1;
+          auto seen = peak.load();
+          while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+          }
+          std::get<0>(*result)->uses++;
+          active.fetch_sub(1);
+          done.fetch_add(1);
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+
+    expect(done.load() == 1600_i);
+    expect(peak.load() <= pool_size);
+    auto stats = pool.stats();
+    expect(stats.available == 3_ul);
+    expect(stats.waiting == 0_ul);
+    expect(stats.acquired == 1600_ul);
+  };
+
+  "release_on_worker_completes_waiter_there"_test = [] {
+    work_stealing_scheduler ws(2);
+    auto                    sched = ws.get_scheduler();
+    connection_pool         pool(1, [] { return connection{9}; });
+    auto                    held = pool.try_acquire();
+    if (!held) {
+      return;
+    }
+
+    std::vector<int>                    order;
+    std::vector<connection_pool::lease> leases;
+    auto op = pool.acquire().connect(recording_receiver{1, &order, &leases, {}});
+    op.start();
+
+    auto main_id   = std::this_thread::get_id();
+    auto worker_id = main_id;
+    flow::this_thread::sync_wait(schedule(sched) | then([&] {
+                                   worker_id = std::this_thread::get_id();
+                                   held->reset();
+                                 }));
+
+    expect(worker_id != main_id);
+    expect(order == std::vector<int>{1});
+    expect(leases.size() == 1_ul);
+    leases.clear();
+    expect(pool.stats().available == 1_ul);
+  };
+
+  return 0;
+}
@@ -0,0 +1,267 @@
+#include <atomic>
+#include <boost/ut.hpp>
+#include <chrono>
+#include <flow/execution.hpp>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace flow::execution;
+using namespace std::chrono_literals;
+
+// Stores the item's result (or -1 on error, -2 on stopped)
+struct result_receiver {
+  using receiver_concept = receiver_t;
+
+  std::atomic<int>* result;
+  std::atomic<int>* done;
+
+  void set_value(int value) && noexcept {
+    result->store(value);
+    done->fetch_add(1);
+  }
+
+  void set_error(std::exception_ptr /*unused*/) && noexcept {
+    result->store(-1);
+    done->fetch_add(1);
+  }
+
+  void set_stopped() && noexcept {
+    result->store(-2);
+    done->fetch_add(1);
+  }
+};
+
+void wait_for(const std::atomic<int>& counter, int value) {
+  while (counter.load() < value) {
+    std::this_thread::yield();
+  }
+}
+
+// Doubles every item and records the batch sizes it saw
+struct doubling_batch {
+  std::vector<std::size_t>* sizes;
+  std::mutex*               mutex;
+
+  auto operator()(std::span<int> items) const {
+    {
+      std::scoped_lock lock(*mutex);
+      sizes->push_back(items.size());
+    }
+    std::vector<int> results;
+    for (int item : items) {
+      results.push_back(item * 2);
+    }
+    return just(std::move(results));
+  }
+};
+
+template <class Batcher>
+void submit_all(Batcher& batcher, int count, std::vector<std::atomic<int>>& results,
+                std::atomic<int>& done) {
+  using op_t = decltype(batcher.submit(0).connect(result_receiver{nullptr, nullptr}));
+  std::vector<std::optional<op_t>> ops(count);
+  for (int i = 0; i < count; ++i) {
+    ops[i].emplace(flow::execution::__emplace_from{
+        [&] { return batcher.submit(i).connect(result_receiver{&results[i], &done}); }});
+    ops[i]->start();
+  }
+  wait_for(done, count);
+}
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+
+  "full_batches_flush_without_waiting_for_the_timer"_test = [] {
+    thread_pool              pool(2);
+    timer_scheduler          timer;
+    std::vector<std::size_t> sizes;
+    std::mutex               mutex;
+    batcher<int, int>        doubler(pool.get_scheduler(), timer.get_scheduler(),
+                                     {.max_items = 4, .max_delay = 10s},
+                                     doubling_batch{&sizes, &mutex});
+
+    std::vector<std::atomic<int>> results(8);
+    std::atomic<int>              done{0};
+    submit_all(doubler, 8, results, done);
+
+    for (int i = 0; i < 8; ++i) {
+      expect(results[i].load() == 2 * i);
+    }
+    std::scoped_lock lock(mutex);
+    expect(sizes == std::vector<std::size_t>{4, 4});
+    auto stats = doubler.stats();
+    expect(stats.batches == 2_ul);
+    expect(stats.items == 8_ul);
+    expect(stats.full == 2_ul);
+    expect(stats.pending == 0_ul);
+  };
+
+  "partial_batch_flushes_after_max_delay"_test = [] {
+    timer_scheduler          timer;
+    std::vector<std::size_t> sizes;
+    std::mutex               mutex;
+    batcher<int, int>        doubler(inline_scheduler{}, timer.get_scheduler(),
+                                     {.max_items = 100, .max_delay = 5ms},
+                                     doubling_batch{&sizes, &mutex});
+
+    std::vector<std::atomic<int>> results(3);
+    std::atomic<int>              done{0};
+    auto                          begin = std::chrono::steady_clock::now();
+    submit_all(doubler, 3, results, done);
+
+    expect(std::chrono::steady_clock::now() - begin >= 5ms);
+    expect(results[2].load() == 4_i);
+    std::scoped_lock lock(mutex);
+    expect(sizes == std::vector<std::size_t>{3});
+    expect(doubler.stats().timed == 1_ul);
+  };
+
+  "flush_starts_pending_batch"_test = [] {
+    timer_scheduler          timer;
+    std::vector<std::size_t> sizes;
+    std::mutex               mutex;
+    batcher<int, int>        doubler(inline_scheduler{}, timer.get_scheduler(),
+                                     {.max_items = 100, .max_delay = 10s},
+                                     doubling_batch{&sizes, &mutex});
+
+    std::atomic<int> result{0};
+    std::atomic<int> done{0};
+    auto             op = doubler.submit(21).connect(result_receiver{&result, &done});
+    op.start();
+    expect(done.load() == 0_i);
+    doubler.flush();
+    wait_for(done, 1);
+    expect(result.load() == 42_i);
+  };
+
+  "batch_error_fans_out_to_every_item"_test = [] {
+    timer_scheduler   timer;
+    batcher<int, int> failing(inline_scheduler{}, timer.get_scheduler(),
+                              {.max_items = 3, .max_delay = 10s}, [](std::span<int> /*items*/) {
+                                return just_error(std::make_exception_ptr(
+                                    std::runtime_error("storage unavailable")));
+                              });
+
+    std::vector<std::atomic<int>> results(3);
+    std::atomic<int>              done{0};
+    submit_all(failing, 3, results, done);
+    for (auto& r : results) {
+      expect(r.load() == -1_i);
+    }
+  };
+
+  "result_count_mismatch_is_an_error"_test = [] {
+    timer_scheduler   timer;
+    batcher<int, int> short_batch(
+        inline_scheduler{}, timer.get_scheduler(), {.max_items = 2, .max_delay = 10s},
+        [](std::span<int> /*items*/) { return just(std::vector<int>{1}); });
+
+    std::vector<std::atomic<int>> results(2);
+    std::atomic<int>              done{0};
+    submit_all(short_batch, 2, results, done);
+    expect(results[0].load() == -1_i);
+    expect(results[1].load() == -1_i);
+  };
+
+  "concurrent_submitters_all_receive_their_results"_test = [] {
+    constexpr int threads   = 8;
+    constexpr int per_thread = 200;
+
+    thread_pool              pool(4);
+    timer_scheduler          timer;
+    std::vector<std::size_t> sizes;
+    std::mutex               mutex;
+    batcher<int, int>        doubler(pool.get_scheduler(), timer.get_scheduler(),
+                                     {.max_items = 16, .max_delay = 200us},
+                                     doubling_batch{&sizes, &mutex});
+
+    std::atomic<int>         wrong{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        for (int i = 0; i < per_thread; ++i) {
+          const int item   = (t * per_thread) + i;
+          auto      result = flow::this_thread::sync_wait(doubler.submit(item));
+          if (!result || std::get<0>(*result) != 2 * item) {
+            wrong.fetch_add(1);
+          }
+        }
+      });
+    }
+    for (auto& w : workers) {
+      w.join();
+    }
+
+    expect(wrong.load() == 0_i);
+    auto stats = doubler.stats();
+    expect(stats.items == static_cast<std::uint64_t>(threads * per_thread));
+    std::scoped_lock lock(mutex);
+    for (auto size : sizes) {
+      expect(size <= 16_ul);
+    }
+  };
+
+  "pushes_racing_the_timer_never_strand_a_batch"_test = [] {
+    // Batches never fill, so every item relies on some batch's max_delay timer. A push that
+    // opens a batch while the timer of the previous one is detaching it must still arm a
+    // timer that flushes the new batch.
+    constexpr int threads    = 4;
+    constexpr int per_thread = 1000;
+
+    timer_scheduler          timer;
+    std::vector<std::size_t> sizes;
+    std::mutex               mutex;
+    batcher<int, int>        doubler(inline_scheduler{}, timer.get_scheduler(),
+                                     {.max_items = 1'000'000, .max_delay = 20us},
+                                     doubling_batch{&sizes, &mutex});
+
+    std::atomic<int>         done{0};
+    std::atomic<int>         wrong{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        for (int i = 0; i < per_thread; ++i) {
+          const int item   = (t * per_thread) + i;
+          auto      result = flow::this_thread::sync_wait(doubler.submit(item));
+          if (!result || std::get<0>(*result) != 2 * item) {
+            wrong.fetch_add(1);
+          }
+          done.fetch_add(1);
+        }
+      });
+    }
+
+    // A stranded batch only completes through flush(); count how often it was needed
+    int  rescues  = 0;
+    auto progress = done.load();
+    auto last     = std::chrono::steady_clock::now();
+    while (done.load() < threads * per_thread) {
+      std::this_thread::sleep_for(1ms);
+      if (done.load() != progress) {
+        progress = done.load();
+        last     = std::chrono::steady_clock::now();
+      } else if (std::chrono::steady_clock::now() - last > 2s) {
+        ++rescues;
+        doubler.flush();
+        last = std::chrono::steady_clock::now();
+      }
+    }
+    for (auto& w : workers) {
+      w.join();
+    }
+
+    expect(rescues == 0_i);
+    expect(wrong.load() == 0_i);
+    expect(doubler.stats().full == 0_ul);
+  };
+
+  return 0;
+}
@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <boost/ut.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <flow/detail/streaming_store.hpp>
+#include <flow/execution.hpp>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace flow::execution;
+using flow::this_thread::sync_wait;
+namespace streaming = flow::detail::streaming;
+
+// Kernels this CPU can run, plain memcpy first
+auto kernels() -> std::vector<streaming::isa> {
+  std::vector<streaming::isa> out{streaming::isa::none};
+  if (streaming::best() != streaming::isa::none) {
+    out.push_back(streaming::isa::avx2);
+  }
+  if (streaming::best() == streaming::isa::avx512) {
+    out.push_back(streaming::isa::avx512);
+  }
+  return out;
+}
+
+// Twelve bytes: its size does not divide 64, so bulk_fill never streams it
+struct rgb {
+  std::int32_t r;
+  std::int32_t g;
+  std::int32_t b;
+
+  auto operator==(const rgb&) const -> bool = default;
+};
+
+// The ranges outlive the call only when they are lvalues or borrowed
+template <class Src, class Dst>
+concept can_copy = requires(Src&& src, Dst&& dst) {
+  bulk_copy(seq, std::forward<Src>(src), std::forward<Dst>(dst));
+};
+
+template <class Dst>
+concept can_fill = requires(Dst&& dst) { bulk_fill(seq, std::forward<Dst>(dst), 0); };
+
+static_assert(can_copy<std::vector<int>&, std::vector<int>&>);
+static_assert(can_copy<std::span<const int>, std::span<int>>);
+static_assert(!can_copy<std::vector<int>, std::vector<int>&>);
+static_assert(!can_copy<std::vector<int>&, std::vector<int>>);
+static_assert(can_fill<std::vector<int>&>);
+static_assert(can_fill<std::span<int>>);
+static_assert(!can_fill<std::vector<int>>);
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+
+  "streaming_copy_matches_memcpy_at_any_alignment"_test = [] {
+    std::vector<unsigned char> src(5000);
+    for (std::size_t i = 0; i < src.size(); ++i) {
+      src[i] = static_cast<unsigned char>((i * 7) + 1);
+    }
+    bool ok = true;
+    for (auto kernel : kernels()) {
+      for (std::size_t offset : {0, 1, 31, 33, 63}) {
+        for (std::size_t bytes : {0, 5, 64, 129, 4000}) {
+          std::vector<unsigned char> dst(5100, 0);
+          streaming::copy(kernel, dst.data() + offset, src.data() + 3, bytes);
+          for (std::size_t i = 0; i < dst.size(); ++i) {
+            const bool inside = i >= offset && i < offset + bytes;
+            ok = ok && dst[i] == (inside ? src[i - offset + 3] : 0);
+          }
+        }
+      }
+    }
+    expect(ok);
+  };
+
+  "streaming_fill_repeats_the_pattern_by_address"_test = [] {
+    std::vector<std::uint16_t> dst(3000);
+    unsigned char              pattern[64];
+    for (std::size_t k = 0; k < 64; ++k) {
+      pattern[k] = static_cast<unsigned char>(k);
+    }
+    bool ok = true;
+    for (auto kernel : kernels()) {
+      for (std::size_t offset : {0, 1, 17, 32}) {
+        std::fill(dst.begin(), dst.end(), 0);
+        auto* bytes = reinterpret_cast<unsigned char*>(dst.data());
+        streaming::fill(kernel, bytes + offset, pattern, 5000);
+        for (std::size_t i = 0; i < dst.size() * 2; ++i) {
+          const bool        inside = i >= offset && i < offset + 5000;
+          const std::size_t phase  = reinterpret_cast<std::uintptr_t>(bytes + i) % 64;
+          ok                       = ok && bytes[i] == (inside ? pattern[phase] : 0);
+        }
+      }
+    }
+    expect(ok);
+  };
+
+  "bulk_copy_copies_every_element_in_each_mode"_test = [] {
+    work_stealing_scheduler ws(4);
+    std::vector<int>        src(3'000'001);
+    for (std::size_t i = 0; i < src.size(); ++i) {
+      src[i] = static_cast<int>(i * 3);
+    }
+    for (auto mode : {store_mode::automatic, store_mode::cached, store_mode::streaming}) {
+      std::vector<int> dst(src.size() + 1, -1);
+      // Start one element in, so the destination is not page aligned
+      sync_wait(schedule(ws.get_scheduler())
+                | bulk_copy(par, src, std::span<int>(dst).subspan(1), mode));
+      expect(dst[0] == -1_i);
+      expect(std::equal(src.begin(), src.end(), dst.begin() + 1));
+    }
+  };
+
+  "bulk_copy_stops_at_the_shorter_range"_test = [] {
+    std::vector<double> src(100, 2.5);
+    std::vector<double> dst(150, 0.0);
+    sync_wait(just() | bulk_copy(seq, src, dst));
+    expect(dst[99] == 2.5_d);
+    expect(dst[100] == 0.0_d);
+
+    std::vector<double> small(10, 0.0);
+    sync_wait(just() | bulk_copy(seq, src, small));
+    expect(small[9] == 2.5_d);
+  };
+
+  "bulk_fill_sets_every_element_in_each_mode"_test = [] {
+    work_stealing_scheduler ws(4);
+    for (auto mode : {store_mode::automatic, store_mode::cached, store_mode::streaming}) {
+      std::vector<double> d(2'000'003, 0.0);
+      sync_wait(schedule(ws.get_scheduler())
+                | bulk_fill(par, std::span<double>(d).subspan(3), 1.25, mode));
+      expect(d[2] == 0.0_d);
+      expect(std::all_of(d.begin() + 3, d.end(), [](double x) { return x == 1.25; }));
+
+      std::vector<rgb> pixels(100'000);
+      sync_wait(schedule(ws.get_scheduler()) | bulk_fill(par, pixels, rgb{1, 2, 3}, mode));
+      expect(std::all_of(pixels.begin(), pixels.end(),
+                         [](const rgb& p) { return p == rgb{1, 2, 3}; }));
+    }
+  };
+
+  "bulk_fill_writes_into_numa_vector"_test = [] {
+    work_stealing_scheduler ws(4, topology_mode::on);
+    numa_vector<float>      v(1 << 20);
+    sync_wait(schedule(ws.get_scheduler()) | bulk_fill(par, v, 7.0F, store_mode::streaming));
+    expect(std::all_of(v.begin(), v.end(), [](float x) { return x == 7.0F; }));
+  };
+
+  "predecessor_values_pass_through"_test = [] {
+    std::vector<int> src(10, 4);
+    std::vector<int> dst(10);
+    auto             result = sync_wait(just(42) | bulk_copy(par, src, dst));
+    expect(std::get<0>(*result) == 42_i);
+    expect(dst[9] == 4_i);
+
+    auto filled = sync_wait(just(7) | bulk_fill(seq, std::span<int>(dst).first(0), 1));
+    expect(std::get<0>(*filled) == 7_i);
+  };
+
+  return 0;
+}
@@ -0,0 +1,193 @@
+#include <atomic>
+#include <boost/ut.hpp>
+#include <chrono>
+#include <flow/execution.hpp>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace flow::execution;
+using namespace std::chrono_literals;
+using flow::this_thread::sync_wait;
+using clock_type = std::chrono::steady_clock;
+
+// Receiver whose environment carries a deadline; counts its completions
+struct deadline_receiver {
+  using receiver_concept = receiver_t;
+
+  clock_type::time_point deadline;
+  std::atomic<int>*      values;
+  std::atomic<int>*      stopped;
+
+  void set_value() && noexcept {
+    values->fetch_add(1);
+  }
+
+  void set_error(std::exception_ptr /*unused*/) && noexcept {}
+
+  void set_stopped() && noexcept {
+    stopped->fetch_add(1);
+  }
+
+  [[nodiscard]] auto get_env() const noexcept {
+    return make_env_with_deadline(deadline, empty_env{});
+  }
+};
+
+// Sends the deadline its receiver's environment reports
+struct read_deadline_sender {
+  using sender_concept = sender_t;
+  using value_types    = type_list<clock_type::time_point>;
+
+  template <class Env>
+  auto get_completion_signatures(Env&& /*unused*/) const noexcept {
+    return completion_signatures<set_value_t(clock_type::time_point)>{};
+  }
+
+  template <class Rcvr>
+  struct _operation {
+    using operation_state_concept = operation_state_t;
+
+    Rcvr receiver_;
+
+    void start() & noexcept {
+      std::move(receiver_).set_value(get_deadline(get_env(receiver_)));
+    }
+  };
+
+  template <receiver R>
+  auto connect(R&& r) const {
+    return _operation<__decay_t<R>>{std::forward<R>(r)};
+  }
+};
+
+void wait_for(const std::atomic<int>& counter, int value) {
+  while (counter.load() < value) {
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+
+  "no_deadline_by_default"_test = [] {
+    expect(get_deadline(empty_env{}) == clock_type::time_point::max());
+    auto result = sync_wait(read_deadline_sender{});
+    expect(result.has_value());
+    expect(std::get<0>(*result) == clock_type::time_point::max());
+  };
+
+  "with_deadline_reaches_nested_senders"_test = [] {
+    const auto deadline = clock_type::now() + 1h;
+    auto       result   = sync_wait(just() | let_value([] { return read_deadline_sender{}; })
+                                    | then([](clock_type::time_point d) { return d; })
+                                    | with_deadline(deadline));
+    expect(result.has_value());
+    expect(std::get<0>(*result) == deadline);
+  };
+
+  "inner_with_deadline_only_tightens"_test = [] {
+    const auto outer = clock_type::now() + 1h;
+    auto       tight = sync_wait(read_deadline_sender{} | with_deadline(outer - 1min)
+                                 | with_deadline(outer));
+    auto       loose = sync_wait(read_deadline_sender{} | with_deadline(outer + 1min)
+                                 | with_deadline(outer));
+    expect(std::get<0>(*tight) == outer - 1min);
+    expect(std::get<0>(*loose) == outer);
+  };
+
+  "deadline_is_forwarded_through_when_all"_test = [] {
+    const auto deadline = clock_type::now() + 1h;
+    auto result = sync_wait(when_all(read_deadline_sender{}, read_deadline_sender{})
+                            | with_deadline(deadline));
+    expect(result.has_value());
+    expect(std::get<0>(*result) == deadline);
+    expect(std::get<1>(*result) == deadline);
+  };
+
+  "work_stealing_runs_work_within_its_deadline"_test = [] {
+    work_stealing_scheduler ws(2);
+    auto                    result = sync_wait(schedule(ws.get_scheduler()) | then([] { return 7; })
+                                               | with_deadline(clock_type::now() + 1h));
+    expect(result.has_value());
+    expect(std::get<0>(*result) == 7_i);
+  };
+
+  "work_stealing_sheds_work_dequeued_after_its_deadline"_test = [] {
+    using op_t = decltype(schedule(std::declval<work_stealing_scheduler&>().get_scheduler())
+                              .connect(std::declval<deadline_receiver>()));
+    constexpr int expiring = 40;
+    constexpr int lasting  = 10;
+
+    work_stealing_scheduler ws(1);
+    std::atomic<bool>       started{false};
+    std::atomic<bool>       release{false};
+    std::thread             gate([&] {
+      sync_wait(schedule(ws.get_scheduler()) | then([&] {
+                  started.store(true);
+                  while (!release.load()) {
+                    std::this_thread::yield();
+                  }
+                }));
+    });
+    while (!started.load()) {
+      std::this_thread::yield();
+    }
+
+    std::atomic<int>                   values{0};
+    std::atomic<int>                   stopped{0};
+    std::vector<std::unique_ptr<op_t>> ops;
+    const auto                         soon  = clock_type::now() + 1ms;
+    const auto                         later = clock_type::now() + 1h;
+    for (int i = 0; i < expiring + lasting; ++i) {
+      const auto deadline = i % 5 == 0 ? later : soon;
+      ops.emplace_back(new op_t(schedule(ws.get_scheduler())
+                                    .connect(deadline_receiver{deadline, &values, &stopped})));
+      ops.back()->start();
+    }
+    std::this_thread::sleep_for(5ms);
+    release.store(true);
+    gate.join();
+
+    wait_for(values, lasting);
+    wait_for(stopped, expiring);
+    expect(values.load() == lasting);
+    expect(stopped.load() == expiring);
+    expect(ws.get_stats(0).tasks_shed == static_cast<std::uint64_t>(expiring));
+  };
+
+  "shed_work_completes_stopped_through_sync_wait"_test = [] {
+    work_stealing_scheduler ws(1);
+    std::atomic<bool>       started{false};
+    std::atomic<bool>       release{false};
+    std::thread             gate([&] {
+      sync_wait(schedule(ws.get_scheduler()) | then([&] {
+                  started.store(true);
+                  while (!release.load()) {
+                    std::this_thread::yield();
+                  }
+                }));
+    });
+    while (!started.load()) {
+      std::this_thread::yield();
+    }
+
+    std::thread releaser([&] {
+      std::this_thread::sleep_for(5ms);
+      release.store(true);
+    });
+    bool ran    = false;
+    auto result = sync_wait(schedule(ws.get_scheduler()) | then([&] { ran = true; })
+                            | with_deadline(clock_type::now() + 1ms));
+    releaser.join();
+    gate.join();
+    expect(not result.has_value());
+    expect(not ran);
+  };
+
+  return 0;
+}
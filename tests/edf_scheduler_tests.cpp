@@ -0,0 +1,232 @@
+#include <atomic>
+#include <boost/ut.hpp>
+#include <chrono>
+#include <flow/execution.hpp>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace flow::execution;
+using namespace std::chrono_literals;
+using flow::this_thread::sync_wait;
+
+// Records completions: index on value, -index on stopped
+struct recording_receiver {
+  using receiver_concept = receiver_t;
+
+  int                index;
+  std::vector<int>*  order;
+  std::mutex*        mutex;
+  std::atomic<int>*  done;
+  inplace_stop_token token{};
+
+  void set_value() && noexcept {
+    record(index);
+  }
+
+  void set_error(std::exception_ptr /*unused*/) && noexcept {
+    record(0);
+  }
+
+  void set_stopped() && noexcept {
+    record(-index);
+  }
+
+  [[nodiscard]] auto get_env() const noexcept {
+    return make_env_with_stop_token(token, empty_env{});
+  }
+
+ private:
+  void record(int value) const {
+    {
+      std::scoped_lock lock(*mutex);
+      order->push_back(value);
+    }
+    done->fetch_add(1);
+  }
+};
+
+using edf_sender = decltype(std::declval<edf_scheduler&>().get_scheduler().schedule());
+using edf_op     = decltype(std::declval<edf_sender>().connect(std::declval<recording_receiver>()));
+
+void wait_for(const std::atomic<int>& counter, int value) {
+  while (counter.load() < value) {
+    std::this_thread::yield();
+  }
+}
+
+// Occupies the worker that runs it until `release` is set
+struct gate_receiver {
+  using receiver_concept = receiver_t;
+
+  std::atomic<bool>* started;
+  std::atomic<bool>* release;
+
+  void set_value() && noexcept {
+    started->store(true);
+    while (!release->load()) {
+      std::this_thread::yield();
+    }
+  }
+
+  void set_error(std::exception_ptr /*unused*/) && noexcept {}
+
+  void set_stopped() && noexcept {}
+
+  [[nodiscard]] auto get_env() const noexcept {
+    return empty_env{};
+  }
+};
+
+using gate_op = decltype(std::declval<edf_sender>().connect(std::declval<gate_receiver>()));
+
+auto block_worker(edf_scheduler& edf, std::atomic<bool>& started, std::atomic<bool>& release)
+    -> std::unique_ptr<gate_op> {
+  std::unique_ptr<gate_op> gate(
+      new gate_op(edf.get_scheduler().schedule().connect(gate_receiver{&started, &release})));
+  gate->start();
+  while (!started.load()) {
+    std::this_thread::yield();
+  }
+  return gate;
+}
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+
+  "schedule_runs_on_a_worker"_test = [] {
+    edf_scheduler edf(2);
+    auto          main_id = std::this_thread::get_id();
+    auto          result  = sync_wait(schedule(edf.get_scheduler())
+                                      | then([] { return std::this_thread::get_id(); }));
+    expect(result.has_value());
+    expect(std::get<0>(*result) != main_id);
+  };
+
+  "zero_threads_throws"_test = [] {
+    expect(throws<std::invalid_argument>([] { edf_scheduler edf(0); }));
+  };
+
+  "queued_work_runs_earliest_deadline_first"_test = [] {
+    edf_scheduler     edf(1);
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+    auto              gate = block_worker(edf, started, release);
+
+    std::vector<int>                     order;
+    std::mutex                           mutex;
+    std::atomic<int>                     done{0};
+    std::vector<std::unique_ptr<edf_op>> ops;
+    const auto                           base       = edf_scheduler::clock::now() + 1h;
+    const int                            shuffled[] = {5, 2, 8, 1, 7, 3, 6, 4};
+    auto                                 sched      = edf.get_scheduler();
+    for (int i : shuffled) {
+      ops.emplace_back(new edf_op(schedule_by(sched, base + (i * 1ms))
+                                      .connect(recording_receiver{i, &order, &mutex, &done})));
+      ops.back()->start();
+    }
+    release.store(true);
+    wait_for(done, 8);
+    expect(order == std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8});
+  };
+
+  "work_without_deadline_runs_last_in_fifo_order"_test = [] {
+    edf_scheduler     edf(1);
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+    auto              gate = block_worker(edf, started, release);
+
+    std::vector<int>                     order;
+    std::mutex                           mutex;
+    std::atomic<int>                     done{0};
+    std::vector<std::unique_ptr<edf_op>> ops;
+    auto                                 sched    = edf.get_scheduler();
+    const auto                           deadline = edf_scheduler::clock::now() + 1h;
+    for (int i = 1; i <= 6; ++i) {
+      auto sndr = i % 2 == 0 ? sched.schedule_by(deadline + (i * 1ms)) : sched.schedule();
+      ops.emplace_back(new edf_op(sndr.connect(recording_receiver{i, &order, &mutex, &done})));
+      ops.back()->start();
+    }
+    release.store(true);
+    wait_for(done, 6);
+    expect(order == std::vector<int>{2, 4, 6, 1, 3, 5});
+  };
+
+  "late_start_counts_a_deadline_miss"_test = [] {
+    edf_scheduler edf(1);
+    auto          sched = edf.get_scheduler();
+    sync_wait(schedule_by(sched, sched.now() - 5ms));
+    sync_wait(schedule_by(sched, sched.now() + 1h));
+    sync_wait(schedule(sched));
+
+    auto stats = edf.stats();
+    expect(stats.executed == 3_ul);
+    expect(stats.deadline_misses == 1_ul);
+    expect(stats.lateness.count == 1_ul);
+    expect(stats.lateness.max_ns >= 5'000'000_ul);
+  };
+
+  "at_binds_a_deadline_for_transfer"_test = [] {
+    edf_scheduler edf(2);
+    auto          sched    = edf.get_scheduler();
+    const auto    deadline = sched.now() + 1h;
+    expect(sched.at(deadline).deadline() == deadline);
+    expect(sched.at(deadline) != sched);
+    expect(sched.at(deadline) == sched.at(deadline));
+
+    auto result = sync_wait(just(20) | transfer(sched.at(deadline))
+                            | then([](int v) { return v + 22; }));
+    expect(result.has_value());
+    expect(std::get<0>(*result) == 42_i);
+  };
+
+  "stop_requested_while_queued_completes_stopped"_test = [] {
+    edf_scheduler     edf(1);
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+    auto              gate = block_worker(edf, started, release);
+
+    std::vector<int>        order;
+    std::mutex              mutex;
+    std::atomic<int>        done{0};
+    inplace_stop_source     stop;
+    auto                    sched = edf.get_scheduler();
+    std::unique_ptr<edf_op> op(new edf_op(sched.schedule_by(sched.now()).connect(
+        recording_receiver{1, &order, &mutex, &done, stop.get_token()})));
+    op->start();
+    stop.request_stop();
+    release.store(true);
+    wait_for(done, 1);
+    expect(order == std::vector<int>{-1});
+  };
+
+  "tasks_from_many_threads_all_complete"_test = [] {
+    constexpr int producers  = 4;
+    constexpr int per_thread = 500;
+
+    edf_scheduler            edf(3);
+    auto                     sched = edf.get_scheduler();
+    std::atomic<int>         sum{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < producers; ++t) {
+      threads.emplace_back([&, t] {
+        for (int i = 0; i < per_thread; ++i) {
+          auto deadline = sched.now() + std::chrono::microseconds((i * 7 + t) % 100);
+          sync_wait(schedule_by(sched, deadline) | then([&] { sum.fetch_add(1); }));
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    expect(sum.load() == producers * per_thread);
+    expect(edf.stats().executed == static_cast<std::uint64_t>(producers * per_thread));
+  };
+
+  return 0;
+}
@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <atomic>
+#include <boost/ut.hpp>
+#include <chrono>
+#include <flow/execution.hpp>
+#include <flow/graph.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+int main() {
+  using namespace boost::ut;
+  using namespace flow::execution;
+  using namespace std::chrono_literals;
+
+  // ============================================================================
+  // Topology
+  // ============================================================================
+
+  "linear_pipeline_runs_inline"_test = [] {
+    flow::graph      g;
+    inline_scheduler sched;
+    std::vector<int> seen;
+
+    auto parse  = g.add_node<std::string>(sched, [](std::string s) { return just(std::stoi(s)); },
+                                          {.name = "parse"});
+    auto square = g.add_node<int>(sched, [](int v) { return just(v * v); }, {.name = "square"});
+    auto sink   = g.add_node<int>(
+        sched, [&seen](int v) { return just() | then([&seen, v] { seen.push_back(v); }); },
+        {.name = "sink"});
+    g.connect(parse, square);
+    g.connect(square, sink);
+
+    for (int i = 1; i <= 5; ++i) {
+      expect(g.try_push(parse, std::to_string(i)));
+    }
+
+    expect(seen == std::vector<int>{1, 4, 9, 16, 25});
+    auto stats = g.stats();
+    expect(stats.admitted == 5_ul);
+    expect(stats.completed == 5_ul);
+    expect(stats.failed == 0_ul);
+    expect(stats.in_flight == 0_ul);
+    expect(stats.nodes.size() == 3_ul);
+    expect(stats.nodes[1].name == "square");
+    expect(stats.nodes[1].processed == 5_ul);
+  };
+
+  "fan_out_and_join_etl_shape"_test = [] {
+    work_stealing_scheduler ws(4);
+    auto                    sched = ws.get_scheduler();
+    std::atomic<long>       total{0};
+
+    flow::graph g({.max_in_flight = 32});
+    auto        parse = g.add_node<int>(sched, [](int v) { return just(v); });
+    auto        a     = g.add_node<int>(
+        sched, [sched](int v) { return schedule(sched) | then([v] { return v; }); },
+        {.name = "a", .concurrency = 2});
+    auto b     = g.add_node<int>(sched, [](int v) { return just(2L * v); });
+    auto c     = g.add_node<int>(sched, [](int v) { return just(std::to_string(v)); });
+    auto merge = g.add_join<int, long, std::string>(
+        sched, [](int x, long y, const std::string& z) { return just(x + y + std::stol(z)); });
+    auto sink = g.add_node<long>(
+        sched, [&total](long v) { return just() | then([&total, v] { total += v; }); },
+        {.name = "sink", .concurrency = 4});
+
+    g.connect(parse, a);
+    g.connect(parse, b);
+    g.connect(parse, c);
+    g.connect(a, merge.input<0>());
+    g.connect(b, merge.input<1>());
+    g.connect(c, merge.input<2>());
+    g.connect(merge, sink);
+
+    long expected = 0;
+    for (int i = 0; i < 1000; ++i) {
+      flow::this_thread::sync_wait(g.push(parse, i));
+      expected += 4L * i;
+    }
+    flow::this_thread::sync_wait(g.drain());
+
+    expect(total.load() == expected);
+    auto stats = g.stats();
+    expect(stats.completed == 1000_ul);
+    expect(stats.failed == 0_ul);
+    expect(stats.in_flight == 0_ul);
+  };
+
+  // ============================================================================
+  // Concurrency and backpressure
+  // ============================================================================
+
+  "concurrency_limit_is_respected"_test = [] {
+    thread_pool      pool(4);
+    auto             sched = pool.get_scheduler();
+    std::atomic<int> active{0};
+    std::atomic<int> peak{0};
+
+    flow::graph g;
+    auto        source = g.add_node<int>(
+        sched,
+        [&](int) {
+          return schedule(sched) | then([&] {
+                   auto now = active.fetch_add(1) + 1;
+                   auto seen = peak.load();
+                   while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+                   }
+                   std::this_thread::sleep_for(1ms);
+                   active.fetch_sub(1);
+                 });
+        },
+        {.name = "source", .concurrency = 2});
+
+    for (int i = 0; i < 40; ++i) {
+      flow::this_thread::sync_wait(g.push(source, i));
+    }
+    flow::this_thread::sync_wait(g.drain());
+
+    expect(peak.load() <= 2_i);
+    expect(peak.load() >= 1_i);
+    expect(g.stats().completed == 40_ul);
+  };
+
+  "slow_stage_applies_backpressure"_test = [] {
+    work_stealing_scheduler ws(2);
+    auto                    sched = ws.get_scheduler();
+    std::atomic<int>        sunk{0};
+
+    flow::graph g({.max_in_flight = 64});
+    auto        source = g.add_node<int>(sched, [](int v) { return just(v); }, {.name = "source"});
+    auto        slow   = g.add_node<int>(
+        sched,
+        [&sunk](int) {
+          return just() | then([&sunk] {
+                   std::this_thread::sleep_for(200us);
+                   sunk.fetch_add(1);
+                 });
+        },
+        {.name = "slow", .queue_capacity = 2});
+    g.connect(source, slow);
+
+    std::size_t max_queued = 0;
+    for (int i = 0; i < 100; ++i) {
+      flow::this_thread::sync_wait(g.push(source, i));
+      max_queued = std::max(max_queued, g.stats().nodes[1].queued);
+    }
+    flow::this_thread::sync_wait(g.drain());
+
+    auto stats = g.stats();
+    expect(sunk.load() == 100_i);
+    expect(max_queued <= 2_ul);
+    expect(stats.nodes[1].backpressure_waits > 0_ul);
+    expect(stats.completed == 100_ul);
+  };
+
+  "inline_node_driven_by_asynchronous_bodies"_test = [] {
+    // Each body finishes on a pool thread, whose completion resumes the worker inline and
+    // starts the next body while the finished one is still on that stack
+    thread_pool      pool(2);
+    std::atomic<int> sunk{0};
+
+    flow::graph g({.max_in_flight = 16});
+    auto        hop  = g.add_node<int>(inline_scheduler{}, [&pool](int v) {
+      return schedule(pool.get_scheduler()) | then([v] { return v; });
+    });
+    auto        sink = g.add_node<int>(inline_scheduler{}, [&pool, &sunk](int) {
+      return schedule(pool.get_scheduler()) | then([&sunk] { sunk.fetch_add(1); });
+    });
+    g.connect(hop, sink);
+
+    for (int i = 0; i < 500; ++i) {
+      flow::this_thread::sync_wait(g.push(hop, i));
+    }
+    flow::this_thread::sync_wait(g.drain());
+
+    expect(sunk.load() == 500_i);
+    expect(g.stats().completed == 500_ul);
+  };
+
+  "try_push_fails_when_tickets_run_out"_test = [] {
+    run_loop    loop;
+    flow::graph g({.max_in_flight = 2});
+    auto        source = g.add_node<int>(
+        inline_scheduler{}, [&loop](int) { return schedule(loop.get_scheduler()); });
+
+    expect(g.try_push(source, 1));
+    expect(g.try_push(source, 2));
+    expect(not g.try_push(source, 3));
+    expect(g.stats().in_flight == 2_ul);
+
+    std::thread driver([&loop] { loop.run(); });
+    flow::this_thread::sync_wait(g.drain());
+    expect(g.try_push(source, 4));
+    flow::this_thread::sync_wait(g.drain());
+    loop.finish();
+    driver.join();
+
+    expect(g.stats().completed == 3_ul);
+  };
+
+  // ============================================================================
+  // Failures
+  // ============================================================================
+
+  "failed_records_are_dropped_downstream"_test = [] {
+    inline_scheduler sched;
+    std::vector<int> joined;
+
+    flow::graph g;
+    auto        source    = g.add_node<int>(sched, [](int v) { return just(v); });
+    auto        odd_fails = g.add_node<int>(sched, [](int v) {
+      return just(v) | then([](int x) {
+               if (x % 2 == 1) {
+                 throw std::runtime_error("odd");
+               }
+               return x;
+             });
+    });
+    auto pass  = g.add_node<int>(sched, [](int v) { return just(v); });
+    auto merge = g.add_join<int, int>(sched, [&joined](int x, int y) {
+      return just() | then([&joined, x, y] { joined.push_back(x + y); });
+    });
+    g.connect(source, odd_fails);
+    g.connect(source, pass);
+    g.connect(odd_fails, merge.input<0>());
+    g.connect(pass, merge.input<1>());
+
+    for (int i = 0; i < 6; ++i) {
+      expect(g.try_push(source, i));
+    }
+
+    expect(joined == std::vector<int>{0, 4, 8});
+    auto stats = g.stats();
+    expect(stats.completed == 3_ul);
+    expect(stats.failed == 3_ul);
+    expect(stats.in_flight == 0_ul);
+    expect(stats.nodes[1].failed == 3_ul);
+    expect(g.error() != nullptr);
+  };
+
+  "stopped_stage_fails_the_record"_test = [] {
+    flow::graph g;
+    auto        source = g.add_node<int>(inline_scheduler{}, [](int) { return just_stopped(); });
+
+    expect(g.try_push(source, 1));
+    expect(g.stats().failed == 1_ul);
+    expect(g.error() == nullptr);
+  };
+
+  // ============================================================================
+  // Validation
+  // ============================================================================
+
+  "invalid_topologies_are_rejected"_test = [] {
+    inline_scheduler sched;
+    auto             identity = [](int v) { return just(v); };
+
+    {
+      flow::graph g;
+      auto        a = g.add_node<int>(sched, identity);
+      auto        b = g.add_node<int>(sched, identity);
+      auto        c = g.add_node<int>(sched, identity);
+      g.connect(a, c);
+      expect(throws<std::invalid_argument>([&] { g.connect(b, c); }));
+    }
+    {
+      flow::graph g;
+      auto        a = g.add_node<int>(sched, identity);
+      auto        b = g.add_node<int>(sched, identity);
+      auto        c = g.add_node<int>(sched, identity);
+      g.connect(a, b);
+      g.connect(b, c);
+      g.connect(c, a);
+      expect(throws<std::invalid_argument>([&] { g.seal(); }));
+    }
+    {
+      flow::graph g;
+      auto        a = g.add_node<int>(sched, identity);
+      auto        j = g.add_join<int, int>(sched, [](int x, int y) { return just(x + y); });
+      g.connect(a, j.input<0>());
+      expect(throws<std::invalid_argument>([&] { g.seal(); }));
+    }
+    {
+      flow::graph g;
+      auto        a = g.add_node<int>(sched, identity);
+      auto        b = g.add_node<int>(sched, identity);
+      auto        j = g.add_join<int, int>(sched, [](int x, int y) { return just(x + y); });
+      g.connect(a, j.input<0>());
+      g.connect(b, j.input<1>());
+      expect(throws<std::invalid_argument>([&] { g.seal(); }));
+    }
+    {
+      flow::graph g;
+      auto        a = g.add_node<int>(sched, identity);
+      auto        b = g.add_node<int>(sched, identity);
+      g.connect(a, b);
+      expect(throws<std::invalid_argument>([&] { (void)g.try_push(b, 1); }));
+      expect(g.try_push(a, 1));
+      expect(throws<std::logic_error>([&] { (void)g.add_node<int>(sched, identity); }));
+    }
+  };
+
+  return 0;
+}
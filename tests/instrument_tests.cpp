@@ -0,0 +1,206 @@
+#include <boost/ut.hpp>
+#include <chrono>
+#include <cstdint>
+#include <flow/execution.hpp>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+int main() {
+  using namespace boost::ut;
+  using namespace flow::execution;
+
+  // ============================================================================
+  // Histogram
+  // ============================================================================
+
+  "histogram_buckets_are_monotonic"_test = [] {
+    std::size_t prev = 0;
+    for (std::uint64_t ns = 0; ns < 1'000'000; ns += 7) {
+      auto index = latency_histogram::bucket_index(ns);
+      expect(index >= prev);
+      expect(ns <= latency_histogram::bucket_upper_bound(index));
+      prev = index;
+    }
+    expect(latency_histogram::bucket_index(~std::uint64_t{0})
+           == latency_histogram::bucket_count - 1);
+  };
+
+  "histogram_percentiles"_test = [] {
+    latency_histogram histogram;
+    for (std::uint64_t ns = 1; ns <= 1000; ++ns) {
+      histogram.record(ns);
+    }
+
+    auto snap = histogram.snapshot();
+    expect(snap.count == 1000_ul);
+    expect(snap.max_ns == 1000_ul);
+    expect(snap.percentile(0.5) >= 500_ul and snap.percentile(0.5) <= 575_ul);
+    expect(snap.percentile(0.99) >= 990_ul and snap.percentile(0.99) <= 1000_ul);
+    expect(snap.percentile(1.0) == 1000_ul);
+    expect(snap.mean() > 500.0 and snap.mean() < 501.0);
+  };
+
+  "histogram_concurrent_recording"_test = [] {
+    latency_histogram        histogram;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&histogram] {
+        for (int i = 0; i < 1000; ++i) {
+          histogram.record(100);
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    expect(histogram.snapshot().count == 4000_ul);
+  };
+
+  // ============================================================================
+  // Registry
+  // ============================================================================
+
+  "registry_returns_same_stage_for_name"_test = [] {
+    instrument_registry registry;
+    std::vector<stage_metrics*> seen(8);
+    std::vector<std::thread>    threads;
+    for (std::size_t t = 0; t < seen.size(); ++t) {
+      threads.emplace_back([&, t] { seen[t] = &registry.stage("shared"); });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    for (auto* s : seen) {
+      expect(s == seen.front());
+    }
+    expect(registry.snapshot().size() == 1_ul);
+  };
+
+  "registry_reset"_test = [] {
+    instrument_registry registry;
+    registry.stage("a").value.record(10);
+    registry.reset();
+    auto snap = registry.snapshot("a");
+    expect(snap.has_value());
+    expect(snap->value.count == 0_ul);
+    expect(!registry.snapshot("missing").has_value());
+  };
+
+  // ============================================================================
+  // instrument adaptor
+  // ============================================================================
+
+  "instrument_records_value_completion"_test = [] {
+    instrument_registry registry;
+    auto sndr   = instrument(just(20) | then([](int x) { return x + 22; }), "answer", registry);
+    auto result = flow::this_thread::sync_wait(std::move(sndr));
+
+    expect(std::get<0>(*result) == 42_i);
+    auto snap = registry.snapshot("answer");
+    expect(snap->started == 1_ul);
+    expect(snap->value.count == 1_ul);
+    expect(snap->error.count == 0_ul);
+  };
+
+  "instrument_records_error_and_stopped"_test = [] {
+    instrument_registry registry;
+
+    expect(throws([&] {
+      flow::this_thread::sync_wait(
+          just_error(std::make_exception_ptr(std::runtime_error("boom")))
+          | instrument("failing", registry));
+    }));
+    flow::this_thread::sync_wait(just_stopped() | instrument("cancelled", registry));
+
+    expect(registry.snapshot("failing")->error.count == 1_ul);
+    expect(registry.snapshot("cancelled")->stopped.count == 1_ul);
+  };
+
+  "instrument_measures_start_to_completion"_test = [] {
+    instrument_registry registry;
+    flow::this_thread::sync_wait(
+        just() | then([] { std::this_thread::sleep_for(std::chrono::milliseconds(2)); })
+        | instrument("sleepy", registry));
+
+    auto snap = registry.snapshot("sleepy");
+    expect(snap->value.max_ns >= 2'000'000_ul);
+  };
+
+  "instrument_on_scheduler"_test = [] {
+    instrument_registry     registry;
+    work_stealing_scheduler sched(2);
+    for (int i = 0; i < 10; ++i) {
+      flow::this_thread::sync_wait(schedule(sched.get_scheduler()) | then([] { return 1; })
+                                   | instrument("hop", registry));
+    }
+    expect(registry.snapshot("hop")->value.count == 10_ul);
+  };
+
+  // ============================================================================
+  // Environment-driven stage attribution
+  // ============================================================================
+
+  "instrument_stages_names_every_adaptor"_test = [] {
+    instrument_registry registry;
+    auto result = flow::this_thread::sync_wait(
+        just(1) | then([](int x) { return x + 1; })
+        | let_value([](int x) { return just(x * 10); })
+        | then([](int x) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            return x;
+          })
+        | instrument_stages("pipeline", registry));
+
+    expect(std::get<0>(*result) == 20_i);
+
+    auto stages = registry.snapshot();
+    expect(stages.size() == 4_ul);
+    expect(registry.snapshot("pipeline/0:source").has_value());
+    expect(registry.snapshot("pipeline/1:then").has_value());
+    expect(registry.snapshot("pipeline/2:let_value").has_value());
+
+    // The sleeping stage dominates, and is attributed to the last then
+    auto slow = registry.snapshot("pipeline/3:then");
+    expect(slow.has_value());
+    expect(slow->value.count == 1_ul);
+    expect(slow->value.max_ns >= 2'000'000_ul);
+    expect(registry.snapshot("pipeline/1:then")->value.max_ns < slow->value.max_ns);
+  };
+
+  "instrument_stages_attributes_error_channel"_test = [] {
+    instrument_registry registry;
+    auto result = flow::this_thread::sync_wait(
+        just() | then([]() -> int { throw std::runtime_error("bad"); })
+        | upon_error([](std::exception_ptr) { return 7; })
+        | instrument_stages("recover", registry));
+
+    expect(std::get<0>(*result) == 7_i);
+    expect(registry.snapshot("recover/1:then")->error.count == 1_ul);
+    expect(registry.snapshot("recover/2:upon_error")->value.count == 1_ul);
+  };
+
+  "concurrent_children_do_not_share_the_tracer"_test = [] {
+    // when_all children run on different threads; marking from them would race on the tracer
+    instrument_registry registry;
+    thread_pool         pool(2);
+    auto                sched  = pool.get_scheduler();
+    auto                result = flow::this_thread::sync_wait(
+        when_all(schedule(sched) | then([] { return 1; }), schedule(sched) | then([] { return 2; }))
+        | then([](int a, int b) { return a + b; }) | instrument_stages("fan_out", registry));
+
+    expect(std::get<0>(*result) == 3_i);
+    expect(registry.snapshot().size() == 2_ul);
+    expect(registry.snapshot("fan_out/0:source").has_value());
+    expect(registry.snapshot("fan_out/1:then").has_value());
+  };
+
+  "uninstrumented_chains_are_unaffected"_test = [] {
+    // Without a tracer in the environment adaptors must not touch the global registry
+    auto before = instrument_registry::global().snapshot().size();
+    flow::this_thread::sync_wait(just(1) | then([](int x) { return x; }));
+    expect(instrument_registry::global().snapshot().size() == before);
+  };
+
+  return 0;
+}
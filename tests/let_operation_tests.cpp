@@ -0,0 +1,106 @@
+#include <atomic>
+#include <boost/ut.hpp>
+#include <exception>
+#include <flow/execution.hpp>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+using namespace flow::execution;
+
+struct network_error {
+  int code;
+};
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+  using flow::this_thread::sync_wait;
+
+  "let_value_inner_sender_completes_after_upstream_returns"_test = [] {
+    thread_pool pool(2);
+    // The inner sender finishes on a pool thread, long after set_value returned
+    auto result = sync_wait(just(std::string("payload")) | let_value([&](std::string& s) {
+                              return schedule(pool.get_scheduler())
+                                   | then([&s] { return s.size(); });
+                            }));
+    expect(result.has_value());
+    if (!result) {
+      return;
+    }
+    expect(std::get<0>(*result) == 7_ul);
+  };
+
+  "let_value_moves_stored_values_into_rvalue_functions"_test = [] {
+    auto result = sync_wait(just(std::make_unique<int>(4))
+                            | let_value([](std::unique_ptr<int> p) { return just(*p * 10); }));
+    expect(result.has_value() && std::get<0>(*result) == 40);
+  };
+
+  "let_error_and_let_stopped_run_async_inner_senders"_test = [] {
+    thread_pool pool(2);
+    auto        recovered = sync_wait(
+        just_error(std::runtime_error("boom")) | let_error([&](auto) {
+          return schedule(pool.get_scheduler()) | then([] { return 1; });
+        }));
+    auto fallback = sync_wait(just_stopped() | let_stopped([&] {
+                                return schedule(pool.get_scheduler()) | then([] { return 2; });
+                              }));
+    expect(recovered.has_value() && std::get<0>(*recovered) == 1);
+    expect(fallback.has_value() && std::get<0>(*fallback) == 2);
+  };
+
+  "let_error_keeps_declared_error_types"_test = [] {
+    auto result = sync_wait(just_error(network_error{503}) | let_error([](auto e) {
+                              if constexpr (std::same_as<decltype(e), network_error>) {
+                                return just(e.code);
+                              } else {
+                                return just(-1);
+                              }
+                            }));
+    expect(result.has_value() && std::get<0>(*result) == 503);
+  };
+
+  "let_error_falls_back_to_exception_ptr"_test = [] {
+    // F only takes exception_ptr: the network_error arrives wrapped in one
+    auto result = sync_wait(just_error(network_error{7}) | let_error([](std::exception_ptr ep) {
+                              try {
+                                std::rethrow_exception(ep);
+                              } catch (const network_error& e) {
+                                return just(e.code);
+                              }
+                            }));
+    expect(result.has_value() && std::get<0>(*result) == 7);
+  };
+
+  "exception_from_function_becomes_set_error"_test = [] {
+    auto sender = just(1) | let_value([](int) -> decltype(just(0)) {
+                    throw std::runtime_error("no sender");
+                  });
+    expect(throws([&] { sync_wait(std::move(sender)); }));
+  };
+
+  "deep_let_value_chain_runs_in_place"_test = [] {
+    thread_pool pool(2);
+    auto        step = [&](int x) {
+      return schedule(pool.get_scheduler()) | then([x] { return x + 1; });
+    };
+    auto result = sync_wait(just(0) | let_value(step) | let_value(step) | let_value(step)
+                            | let_value(step) | let_value(step));
+    expect(result.has_value() && std::get<0>(*result) == 5);
+  };
+
+  "let_operation_can_be_started_from_an_lvalue_sender"_test = [] {
+    auto sender = just(20) | let_value([](int x) { return just(x + 1); });
+    auto first  = sync_wait(sender);
+    auto second = sync_wait(sender);
+    expect(first.has_value() && std::get<0>(*first) == 21);
+    expect(second.has_value() && std::get<0>(*second) == 21);
+  };
+
+  return 0;
+}
@@ -0,0 +1,172 @@
+// Lock profiling is opt-in; this suite always exercises the enabled code path
+#ifndef FLOW_ENABLE_LOCK_PROFILING
+#define FLOW_ENABLE_LOCK_PROFILING
+#endif
+
+#include <boost/ut.hpp>
+#include <chrono>
+#include <flow/execution.hpp>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace {
+
+auto find_site(std::string_view name) -> std::optional<flow::detail::lock_site_snapshot> {
+  for (auto& site : flow::detail::lock_profile_snapshot()) {
+    if (site.name == name) {
+      return site;
+    }
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+  using namespace flow::execution;
+  using namespace std::chrono_literals;
+
+  "site_names_source_location"_test = [] {
+    flow::detail::mutex m{"test::located"};
+    std::scoped_lock    lock(m);
+
+    auto site = find_site("test::located");
+    expect(site.has_value());
+    if (!site) {
+      return;
+    }
+    expect(site->file.ends_with("lock_profiling_tests.cpp"));
+    expect(site->line > 0_u);
+  };
+
+  "uncontended_acquisitions_are_counted"_test = [] {
+    flow::detail::mutex m{"test::uncontended"};
+    for (int i = 0; i < 10; ++i) {
+      std::scoped_lock lock(m);
+    }
+    expect(m.try_lock());
+    m.unlock();
+
+    auto site = find_site("test::uncontended");
+    expect(site.has_value());
+    if (!site) {
+      return;
+    }
+    expect(site->acquisitions == 11_ul);
+    expect(site->contended == 0_ul);
+    expect(site->wait.count == 0_ul);
+  };
+
+  "contended_acquisition_records_wait_time"_test = [] {
+    flow::detail::mutex m{"test::contended"};
+    std::atomic<bool>   held{false};
+
+    std::thread holder([&] {
+      std::scoped_lock lock(m);
+      held.store(true);
+      std::this_thread::sleep_for(20ms);
+    });
+    while (!held.load()) {
+      std::this_thread::yield();
+    }
+    { std::scoped_lock lock(m); }
+    holder.join();
+
+    auto site = find_site("test::contended");
+    expect(site.has_value());
+    if (!site) {
+      return;
+    }
+    expect(site->acquisitions == 2_ul);
+    expect(site->contended == 1_ul);
+    expect(site->wait.count == 1_ul);
+    expect(site->wait.max_ns >= 5'000'000_ul);
+  };
+
+  "mutexes_from_one_site_share_counters"_test = [] {
+    for (int i = 0; i < 3; ++i) {
+      flow::detail::mutex m{"test::shared"};
+      std::scoped_lock    lock(m);
+    }
+
+    int sites = 0;
+    for (auto& site : flow::detail::lock_profile_snapshot()) {
+      if (site.name == "test::shared") {
+        ++sites;
+        expect(site.acquisitions == 3_ul);
+      }
+    }
+    expect(sites == 1_i);
+  };
+
+  "library_lock_sites_are_reported"_test = [] {
+    {
+      work_stealing_scheduler ws(2);
+      auto                    sched = ws.get_scheduler();
+      for (int i = 0; i < 20; ++i) {
+        flow::this_thread::sync_wait(schedule(sched) | then([] { return 1; }));
+      }
+    }
+
+    auto processor = find_site("work_stealing_scheduler::processor");
+    expect(processor.has_value());
+    if (!processor) {
+      return;
+    }
+    expect(processor->acquisitions > 0_ul);
+    expect(processor->file.ends_with("work_stealing_scheduler.hpp"));
+
+    auto sync = find_site("sync_wait");
+    expect(sync.has_value());
+    if (!sync) {
+      return;
+    }
+    expect(sync->acquisitions >= 20_ul);
+  };
+
+  "condition_variable_waits_work"_test = [] {
+    thread_pool pool(2);
+    auto        sched  = pool.get_scheduler();
+    auto        result = flow::this_thread::sync_wait(schedule(sched) | then([] { return 5; }));
+    expect(std::get<0>(*result) == 5_i);
+
+    auto site = find_site("thread_pool");
+    expect(site.has_value());
+    if (!site) {
+      return;
+    }
+    expect(site->acquisitions > 0_ul);
+  };
+
+  "report_lists_sites"_test = [] {
+    flow::detail::mutex m{"test::report"};
+    { std::scoped_lock lock(m); }
+
+    std::ostringstream out;
+    flow::detail::write_lock_profile(out);
+    auto report = out.str();
+    expect(report.find("acquisitions") != std::string::npos);
+    expect(report.find("test::report") != std::string::npos);
+    expect(report.find("lock_profiling_tests.cpp:") != std::string::npos);
+  };
+
+  "reset_clears_counters"_test = [] {
+    flow::detail::mutex m{"test::reset"};
+    { std::scoped_lock lock(m); }
+    flow::detail::lock_profile_reset();
+
+    auto site = find_site("test::reset");
+    expect(site.has_value());
+    if (!site) {
+      return;
+    }
+    expect(site->acquisitions == 0_ul);
+  };
+
+  return 0;
+}
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <boost/ut.hpp>
+#include <concepts>
+#include <exception>
+#include <flow/execution.hpp>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace flow::execution;
+using flow::this_thread::sync_wait;
+
+template <class S>
+using sigs_of = decltype(std::declval<S>().get_completion_signatures(empty_env{}));
+
+template <class Sig, class Sigs>
+inline constexpr bool has_sig = false;
+
+template <class Sig, class... Sigs>
+inline constexpr bool has_sig<Sig, completion_signatures<Sigs...>> =
+    (std::same_as<Sig, Sigs> || ...);
+
+template <class S>
+inline constexpr bool declares_exception = has_sig<set_error_t(std::exception_ptr), sigs_of<S>>;
+
+auto twice(int v) noexcept -> int {
+  return 2 * v;
+}
+
+auto twice_or_throw(int v) -> int {
+  if (v < 0) {
+    throw std::runtime_error("negative");
+  }
+  return 2 * v;
+}
+
+using just_int = decltype(just(1));
+
+// then
+static_assert(std::same_as<sigs_of<decltype(just(1) | then(twice))>,
+                           completion_signatures<set_value_t(int)>>);
+static_assert(declares_exception<decltype(just(1) | then(twice_or_throw))>);
+static_assert(has_sig<set_error_t(int), sigs_of<decltype(just_error(7) | then([]() noexcept {}))>>);
+static_assert(!declares_exception<decltype(just_error(7) | then([]() noexcept {}))>);
+static_assert(has_sig<set_stopped_t(), sigs_of<decltype(just_stopped() | then([]() noexcept {}))>>);
+
+// noexcept only for rvalues: a predecessor forwarding lvalues could still make it throw
+struct nothrow_for_rvalues {
+  auto operator()(int&& v) const noexcept -> int {
+    return v;
+  }
+  auto operator()(const int& v) const -> int {
+    return v;
+  }
+};
+
+static_assert(declares_exception<decltype(just(1) | then(nothrow_for_rvalues{}))>);
+
+// upon_error / upon_stopped
+static_assert(!declares_exception<decltype(just_error(std::exception_ptr{})
+                                           | upon_error([](std::exception_ptr) noexcept {}))>);
+static_assert(declares_exception<decltype(just_error(std::exception_ptr{})
+                                          | upon_error([](std::exception_ptr) {}))>);
+static_assert(std::same_as<sigs_of<decltype(just_stopped() | upon_stopped([]() noexcept {
+                                              return 3;
+                                            }))>,
+                           completion_signatures<set_value_t(int)>>);
+
+// let_value
+static_assert(!declares_exception<decltype(just(1) | let_value([](int v) noexcept {
+                                             return just(v + 1);
+                                           }))>);
+static_assert(declares_exception<decltype(just(1) | let_value([](int v) { return just(v + 1); }))>);
+static_assert(has_sig<set_error_t(int), sigs_of<decltype(just(1) | let_value([](int) noexcept {
+                                                            return just_error(5);
+                                                          }))>>);
+
+// bulk
+static_assert(!declares_exception<decltype(just(1) | bulk(seq, 4, [](int, int) noexcept {}))>);
+static_assert(declares_exception<decltype(just(1) | bulk(seq, 4, [](int, int) {}))>);
+static_assert(
+    !declares_exception<decltype(just(1) | bulk_unchunked(seq, 4, [](int, int) noexcept {}))>);
+static_assert(
+    !declares_exception<decltype(just(1) | bulk_chunked(seq, 4, [](int, int, int) noexcept {}))>);
+
+// The parallel path moves the values into shared state, which may throw under a noexcept body
+struct throwing_move {
+  throwing_move() = default;
+  throwing_move(const throwing_move& /*unused*/) {}
+  throwing_move(throwing_move&& /*unused*/) noexcept(false) {}
+};
+
+static_assert(declares_exception<decltype(just(throwing_move{})
+                                          | bulk(par, 4, [](int, throwing_move&) noexcept {}))>);
+
+// A parallel bulk on a parallel scheduler can be cancelled; inline runs cannot
+template <class S>
+inline constexpr bool declares_stopped = has_sig<set_stopped_t(), sigs_of<S>>;
+
+using pool_schedule = decltype(schedule(std::declval<thread_pool&>().get_scheduler()));
+
+static_assert(!declares_stopped<pool_schedule>);
+static_assert(!declares_stopped<decltype(just(1) | bulk(par, 4, [](int, int) noexcept {}))>);
+static_assert(!declares_stopped<decltype(just(1) | bulk_chunked(par, 4, [](int, int, int) {}))>);
+static_assert(!declares_stopped<decltype(std::declval<pool_schedule>()
+                                         | bulk(seq, 4, [](std::size_t) noexcept {}))>);
+static_assert(declares_stopped<decltype(std::declval<pool_schedule>()
+                                        | bulk(par, 4, [](std::size_t) noexcept {}))>);
+static_assert(declares_stopped<decltype(std::declval<pool_schedule>() | bulk_chunked(
+                                            par_unseq, 4, [](std::size_t, std::size_t) {}))>);
+static_assert(declares_stopped<decltype(std::declval<pool_schedule>()
+                                        | bulk_with_state(par, 4, [] { return 0; },
+                                                          [](std::size_t, int&) {}))>);
+
+// bulk searches forward the predecessor's errors
+static_assert(has_sig<set_error_t(int), sigs_of<decltype(just_error(7) | bulk_find_if(
+                                            seq, 4, [](std::size_t) { return true; }))>>);
+static_assert(has_sig<set_error_t(int), sigs_of<decltype(just_error(7) | bulk_any_of(
+                                            par, 4, [](std::size_t) { return true; }))>>);
+
+// and add an exception_ptr error only for a predicate that may throw
+static_assert(!declares_exception<decltype(just(1) | bulk_find_if(par, 4, [](int, int) noexcept {
+                                             return true;
+                                           }))>);
+static_assert(declares_exception<decltype(just(1) | bulk_any_of(par, 4, [](int, int) {
+                                            return true;
+                                          }))>);
+
+// Schedulers whose operations cannot fail to queue
+static_assert(
+    !declares_exception<decltype(std::declval<thread_pool&>().get_scheduler().try_schedule())>);
+static_assert(
+    !declares_exception<decltype(std::declval<work_stealing_scheduler&>().get_scheduler()
+                                     .try_schedule())>);
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+
+  "noexcept_then_completes_with_its_result"_test = [] {
+    auto result = sync_wait(just(21) | then(twice) | then([](int v) noexcept { return v + 0; }));
+    expect(result.has_value());
+    expect(std::get<0>(*result) == 42_i);
+  };
+
+  "throwing_then_still_reports_its_exception"_test = [] {
+    expect(throws<std::runtime_error>([] { sync_wait(just(-1) | then(twice_or_throw)); }));
+  };
+
+  "noexcept_then_forwards_upstream_errors"_test = [] {
+    bool handled = false;
+    auto result  = sync_wait(just_error(std::make_exception_ptr(std::runtime_error("x")))
+                             | then([]() noexcept { return 1; })
+                             | upon_error([&](std::exception_ptr) noexcept {
+                                handled = true;
+                                return 2;
+                              }));
+    expect(handled);
+    expect(std::get<0>(*result) == 2_i);
+  };
+
+  "noexcept_upon_stopped_replaces_stopped"_test = [] {
+    auto result = sync_wait(just_stopped() | upon_stopped([]() noexcept { return 5; }));
+    expect(result.has_value());
+    expect(std::get<0>(*result) == 5_i);
+  };
+
+  "noexcept_let_value_starts_its_sender"_test = [] {
+    auto result = sync_wait(just(20) | let_value([](int v) noexcept { return just(v + 22); }));
+    expect(result.has_value());
+    expect(std::get<0>(*result) == 42_i);
+  };
+
+  "throwing_let_value_reports_its_exception"_test = [] {
+    auto sndr = just(1) | let_value([](int) -> decltype(just(0)) {
+                  throw std::runtime_error("let");
+                });
+    expect(throws<std::runtime_error>([&] { sync_wait(std::move(sndr)); }));
+  };
+
+  "noexcept_parallel_bulk_visits_every_index"_test = [] {
+    thread_pool      pool(4);
+    std::vector<int> hits(1000, 0);
+    auto             result = sync_wait(schedule(pool.get_scheduler())
+                                        | bulk(par, 1000, [&](int i) noexcept { hits[i] += 1; }));
+    expect(result.has_value());
+    expect(std::count(hits.begin(), hits.end(), 1) == 1000_l);
+  };
+
+  "throwing_parallel_bulk_reports_its_exception"_test = [] {
+    thread_pool pool(4);
+    expect(throws<std::runtime_error>([&] {
+      sync_wait(schedule(pool.get_scheduler()) | bulk(par, 1000, [](int i) {
+                  if (i == 500) {
+                    throw std::runtime_error("bulk");
+                  }
+                }));
+    }));
+  };
+
+  "noexcept_bulk_unchunked_visits_every_index"_test = [] {
+    int  sum    = 0;
+    auto result = sync_wait(just(3) | bulk_unchunked(seq, 4, [&](int i, int v) noexcept {
+                              sum += i * v;
+                            }));
+    expect(result.has_value());
+    expect(sum == 18_i);
+  };
+
+  "schedulers_complete_noexcept_receivers"_test = [] {
+    thread_pool             pool(2);
+    work_stealing_scheduler ws(2);
+    expect(sync_wait(schedule(pool.get_scheduler()) | then([]() noexcept { return 1; }))
+               .has_value());
+    expect(sync_wait(try_schedule(ws.get_scheduler())).has_value());
+  };
+
+  return 0;
+}
@@ -0,0 +1,175 @@
+#include <atomic>
+#include <boost/ut.hpp>
+#include <cstddef>
+#include <flow/execution.hpp>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace flow::execution;
+using flow::this_thread::sync_wait;
+
+// Thread that ran each index of a bulk_chunked pass over `shape` indices on `sched`
+template <class Sched>
+auto owners_of(Sched sched, std::size_t shape) -> std::vector<std::thread::id> {
+  std::vector<std::thread::id> owners(shape);
+  sync_wait(schedule(sched) | bulk_chunked(par, shape, [&](std::size_t begin, std::size_t end) {
+              for (std::size_t i = begin; i < end; ++i) {
+                owners[i] = std::this_thread::get_id();
+              }
+            }));
+  return owners;
+}
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+
+  "numa_vector_starts_zeroed"_test = [] {
+    numa_vector<double> v(10'000);
+    expect(v.size() == 10'000_ul);
+    bool zero = true;
+    for (double x : v) {
+      zero = zero && x == 0.0;
+    }
+    expect(zero);
+    v[9'999] = 1.5;
+    expect(v[9'999] == 1.5_d);
+  };
+
+  "numa_vector_moves_its_mapping"_test = [] {
+    numa_vector<int> a(100);
+    a[3]            = 7;
+    const int* data = a.data();
+    numa_vector<int> b(std::move(a));
+    expect(b.data() == data);
+    expect(b[3] == 7_i);
+    expect(a.empty());
+    numa_vector<int> c;
+    c = std::move(b);
+    expect(c.data() == data);
+    expect(b.data() == nullptr);
+  };
+
+  "numa_vector_rejects_counts_whose_size_overflows"_test = [] {
+    using vector = numa_vector<double>;
+    expect(throws<std::length_error>([] { vector v(vector::max_size() + 1); }));
+    expect(throws<std::length_error>([] { vector v(static_cast<std::size_t>(-1)); }));
+  };
+
+  "bulk_allocate_fills_every_element"_test = [] {
+    for (auto mode : {topology_mode::off, topology_mode::on}) {
+      work_stealing_scheduler ws(4, mode);
+      auto identity = [](std::size_t i) { return static_cast<int>(i); };
+      auto result   = sync_wait(bulk_allocate<int>(ws.get_scheduler(), 100'000, identity));
+      expect(result.has_value());
+      auto& v  = std::get<0>(*result);
+      bool  ok = v.size() == 100'000;
+      for (std::size_t i = 0; i < v.size(); ++i) {
+        ok = ok && v[i] == static_cast<int>(i);
+      }
+      expect(ok);
+    }
+  };
+
+  "agent_schedulers_exist_only_in_topology_mode"_test = [] {
+    work_stealing_scheduler floating(2);
+    work_stealing_scheduler pinned(2, topology_mode::on);
+    expect(not get_agent_scheduler(floating.get_scheduler(), 0).has_value());
+    auto agent = get_agent_scheduler(pinned.get_scheduler(), 3);
+    expect(agent.has_value());
+    expect(*agent == *get_agent_scheduler(pinned.get_scheduler(), 1));
+    expect(*agent != pinned.get_scheduler());
+  };
+
+  "work_for_an_agent_always_runs_on_its_worker"_test = [] {
+    work_stealing_scheduler ws(4, topology_mode::on);
+    for (std::size_t agent = 0; agent < 4; ++agent) {
+      auto sched = *get_agent_scheduler(ws.get_scheduler(), agent);
+      auto first = std::get<0>(
+          *sync_wait(schedule(sched) | then([] { return std::this_thread::get_id(); })));
+      bool same = true;
+      for (int i = 0; i < 20; ++i) {
+        auto id = std::get<0>(
+            *sync_wait(schedule(sched) | then([] { return std::this_thread::get_id(); })));
+        same = same && id == first;
+      }
+      expect(same);
+    }
+  };
+
+  "agent_work_past_a_full_queue_stays_on_its_worker"_test = [] {
+    work_stealing_scheduler ws(4, topology_mode::on);
+    auto                    sched = *get_agent_scheduler(ws.get_scheduler(), 2);
+    simple_counting_scope   scope;
+    std::atomic<bool>       release{false};
+    std::thread::id         owner;
+
+    // Hold the worker so that the rest overflows its 256-slot local queue
+    spawn(schedule(sched) | then([&] {
+            owner = std::this_thread::get_id();
+            while (!release.load()) {
+              std::this_thread::yield();
+            }
+          }),
+          scope.get_token());
+    std::atomic<int> elsewhere{0};
+    for (int i = 0; i < 600; ++i) {
+      spawn(schedule(sched) | then([&] {
+              if (std::this_thread::get_id() != owner) {
+                elsewhere.fetch_add(1);
+              }
+            }),
+            scope.get_token());
+    }
+    // Unpinned work queued behind the pinned tasks can still be stolen
+    std::atomic<int> floating{0};
+    for (int i = 0; i < 64; ++i) {
+      spawn(schedule(ws.get_scheduler()) | then([&] { floating.fetch_add(1); }),
+            scope.get_token());
+    }
+    while (floating.load() < 64) {
+      std::this_thread::yield();
+    }
+    release.store(true);
+    sync_wait(scope.join());
+    expect(elsewhere.load() == 0_i);
+  };
+
+  "topology_mode_runs_each_index_on_the_same_worker_every_pass"_test = [] {
+    work_stealing_scheduler ws(4, topology_mode::on);
+    const auto              first = owners_of(ws.get_scheduler(), 4096);
+    bool                    same  = true;
+    for (int pass = 0; pass < 5; ++pass) {
+      same = same && owners_of(ws.get_scheduler(), 4096) == first;
+    }
+    expect(same);
+
+    // One contiguous block per worker
+    std::size_t changes = 0;
+    for (std::size_t i = 1; i < first.size(); ++i) {
+      changes += first[i] != first[i - 1] ? 1 : 0;
+    }
+    expect(changes == 3_ul);
+  };
+
+  "topology_mode_reports_body_exceptions"_test = [] {
+    work_stealing_scheduler ws(4, topology_mode::on);
+    std::atomic<int>        calls{0};
+    expect(throws<std::runtime_error>([&] {
+      sync_wait(schedule(ws.get_scheduler())
+                | bulk_chunked(par, 1000, [&](std::size_t begin, std::size_t /*end*/) {
+                    calls.fetch_add(1);
+                    if (begin == 0) {
+                      throw std::runtime_error("chunk");
+                    }
+                  }));
+    }));
+    expect(calls.load() >= 1_i);
+  };
+
+  return 0;
+}
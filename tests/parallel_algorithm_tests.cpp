@@ -0,0 +1,543 @@
+#include <algorithm>
+#include <atomic>
+#include <boost/ut.hpp>
+#include <chrono>
+#include <flow/execution.hpp>
+#include <forward_list>
+#include <list>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Distinct threads that ran a body
+class thread_set {
+ public:
+  void record() {
+    std::scoped_lock lock(mutex_);
+    ids_.insert(std::this_thread::get_id());
+  }
+
+  auto size() -> std::size_t {
+    std::scoped_lock lock(mutex_);
+    return ids_.size();
+  }
+
+ private:
+  std::mutex                 mutex_;
+  std::set<std::thread::id> ids_;
+};
+
+// Records how a bulk completed; carries a stop token into the bulk's environment
+struct completion_receiver {
+  using receiver_concept = flow::execution::receiver_t;
+
+  std::atomic<int>*                    state;  // 1 value, 2 error, 3 stopped
+  flow::execution::inplace_stop_token token;
+
+  template <class... Args>
+  void set_value(Args&&... /*unused*/) && noexcept {
+    *state = 1;
+  }
+
+  void set_error(std::exception_ptr /*unused*/) && noexcept {
+    *state = 2;
+  }
+
+  void set_stopped() && noexcept {
+    *state = 3;
+  }
+
+  [[nodiscard]] auto get_env() const noexcept {
+    return flow::execution::make_env_with_stop_token(token, flow::execution::empty_env{});
+  }
+};
+
+// Parallel scheduler that completes schedule() inline and records the deadline of every
+// receiver it is connected to
+struct deadline_recording_scheduler {
+  using scheduler_concept = flow::execution::scheduler_t;
+  using time_point        = std::chrono::steady_clock::time_point;
+
+  std::vector<time_point>* deadlines;
+
+  template <class Rcvr>
+  struct operation {
+    using operation_state_concept = flow::execution::operation_state_t;
+
+    std::vector<time_point>* deadlines;
+    Rcvr                     receiver;
+
+    void start() & noexcept {
+      deadlines->push_back(flow::execution::get_deadline(flow::execution::get_env(receiver)));
+      std::move(receiver).set_value();
+    }
+  };
+
+  struct sender {
+    using sender_concept = flow::execution::sender_t;
+    using value_types    = flow::execution::type_list<>;
+
+    std::vector<time_point>* deadlines;
+
+    template <class Env>
+    auto get_completion_signatures(Env&& /*unused*/) const noexcept {
+      return flow::execution::completion_signatures<flow::execution::set_value_t()>{};
+    }
+
+    [[nodiscard]] auto query(
+        flow::execution::get_completion_scheduler_t<flow::execution::set_value_t> /*unused*/)
+        const noexcept {
+      return deadline_recording_scheduler{deadlines};
+    }
+
+    template <flow::execution::receiver R>
+    auto connect(R&& r) const {
+      return operation<std::decay_t<R>>{deadlines, std::forward<R>(r)};
+    }
+  };
+
+  [[nodiscard]] auto schedule() const noexcept {
+    return sender{deadlines};
+  }
+
+  [[nodiscard]] auto query(flow::execution::get_parallelism_t /*unused*/) const noexcept
+      -> std::size_t {
+    return 4;
+  }
+
+  auto operator==(const deadline_recording_scheduler&) const noexcept -> bool = default;
+};
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+  using namespace flow::execution;
+
+  // ============================================================================
+  // Parallel bulk path
+  // ============================================================================
+
+  "parallelism_is_reported_by_pool_schedulers"_test = [] {
+    work_stealing_scheduler ws(3);
+    thread_pool             pool(2);
+    expect(get_parallelism(ws.get_scheduler()) == 3_ul);
+    expect(get_parallelism(pool.get_scheduler()) == 2_ul);
+  };
+
+  "bulk_runs_on_several_workers"_test = [] {
+    thread_pool       pool(4);
+    auto              sched = pool.get_scheduler();
+    thread_set        threads;
+    std::atomic<long> sum{0};
+
+    flow::this_thread::sync_wait(schedule(sched) | bulk(par, 10'000, [&](std::size_t i) {
+                                   threads.record();
+                                   sum.fetch_add(static_cast<long>(i));
+                                   std::this_thread::yield();
+                                 }));
+
+    expect(sum.load() == 10'000L * 9'999 / 2);
+    expect(threads.size() > 1_ul);
+  };
+
+  "bulk_chunked_covers_the_shape_exactly_once"_test = [] {
+    work_stealing_scheduler ws(4);
+    std::vector<int>        hits(1000, 0);
+    std::atomic<int>        chunks{0};
+
+    auto result = flow::this_thread::sync_wait(
+        schedule(ws.get_scheduler()) | then([] { return 7; })
+        | bulk_chunked(par, hits.size(), [&](std::size_t begin, std::size_t end, int seven) {
+            chunks.fetch_add(1);
+            for (auto i = begin; i != end; ++i) {
+              hits[i] += seven;
+            }
+          }));
+
+    expect(result.has_value());
+    if (result) {
+      expect(std::get<0>(*result) == 7_i);
+    }
+    expect(std::ranges::all_of(hits, [](int h) { return h == 7; }));
+    expect(chunks.load() > 1_i);
+  };
+
+  "bulk_error_completes_with_first_exception"_test = [] {
+    thread_pool pool(4);
+    auto        sched = pool.get_scheduler();
+
+    auto run = [&] {
+      flow::this_thread::sync_wait(schedule(sched) | bulk(par, 100, [](std::size_t i) {
+                                     if (i == 42) {
+                                       throw std::runtime_error("bad index");
+                                     }
+                                   }));
+    };
+    expect(throws<std::runtime_error>(run));
+  };
+
+  "sequenced_policy_stays_on_one_thread"_test = [] {
+    thread_pool pool(4);
+    thread_set  threads;
+
+    flow::this_thread::sync_wait(schedule(pool.get_scheduler())
+                                 | bulk(seq, 1000, [&](std::size_t) { threads.record(); }));
+    expect(threads.size() == 1_ul);
+  };
+
+  "stop_request_skips_remaining_chunks"_test = [] {
+    inplace_stop_source source;
+    source.request_stop();
+    std::atomic<int> calls{0};
+    std::atomic<int> state{0};
+
+    thread_pool pool(4);
+    auto op = (schedule(pool.get_scheduler())
+               | bulk(par, 1000, [&](std::size_t) { calls.fetch_add(1); }))
+                  .connect(completion_receiver{&state, source.get_token()});
+    op.start();
+    while (state.load() == 0) {
+      std::this_thread::yield();
+    }
+    expect(state.load() == 3_i);
+    expect(calls.load() == 0_i);
+
+    // The sequential path checks the token between chunks too
+    state.store(0);
+    auto op2 = (just() | bulk_any_of(seq, 1000, [&](std::size_t) { return false; }))
+                   .connect(completion_receiver{&state, source.get_token()});
+    op2.start();
+    expect(state.load() == 3_i);
+  };
+
+  "helpers_are_scheduled_with_the_receivers_environment"_test = [] {
+    std::vector<std::chrono::steady_clock::time_point> deadlines;
+    deadline_recording_scheduler                        sched{&deadlines};
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::hours(1);
+
+    std::atomic<int> calls{0};
+    flow::this_thread::sync_wait(schedule(sched)
+                                 | bulk(par, 64, [&](std::size_t) { calls.fetch_add(1); })
+                                 | with_deadline(deadline));
+    expect(calls.load() == 64_i);
+    // The predecessor and three helpers
+    expect(deadlines.size() == 4_ul);
+    expect(std::ranges::all_of(deadlines, [&](auto d) { return d == deadline; }));
+  };
+
+  "error_skips_remaining_chunks"_test = [] {
+    thread_pool      pool(2);
+    std::atomic<int> calls{0};
+
+    auto run = [&] {
+      flow::this_thread::sync_wait(schedule(pool.get_scheduler())
+                                   | bulk(par, 100'000, [&](std::size_t i) {
+                                       calls.fetch_add(1);
+                                       if (i == 0) {
+                                         throw std::runtime_error("first");
+                                       }
+                                     }));
+    };
+    expect(throws<std::runtime_error>(run));
+    expect(calls.load() < 100'000_i);
+  };
+
+  // ============================================================================
+  // Searches
+  // ============================================================================
+
+  "bulk_find_if_returns_lowest_match"_test = [] {
+    work_stealing_scheduler ws(4);
+    std::vector<int>        values(20'000, 0);
+    values[12'345] = 1;
+    values[17'000] = 1;
+
+    auto found = flow::this_thread::sync_wait(
+        schedule(ws.get_scheduler())
+        | bulk_find_if(par, values.size(), [&](std::size_t i) { return values[i] == 1; }));
+    auto missing = flow::this_thread::sync_wait(
+        schedule(ws.get_scheduler())
+        | bulk_find_if(par, values.size(), [&](std::size_t i) { return values[i] == 2; }));
+
+    expect(found.has_value() && missing.has_value());
+    if (!found || !missing) {
+      return;
+    }
+    expect(std::get<0>(*found) == std::optional<std::size_t>(12'345));
+    expect(not std::get<0>(*missing).has_value());
+  };
+
+  "bulk_find_if_returns_lowest_match_with_fixed_blocks"_test = [] {
+    // The match in the top block is found first; the bottom block must still reach its own
+    work_stealing_scheduler ws(4, topology_mode::on);
+    std::atomic<bool>       high_found{false};
+    auto                    pred = [&](std::size_t i) {
+      if (i == 0) {
+        const auto until = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!high_found.load() && std::chrono::steady_clock::now() < until) {
+          std::this_thread::yield();
+        }
+      }
+      if (i == 3500) {
+        high_found.store(true);
+      }
+      return i == 900 || i == 3500;
+    };
+
+    auto found = flow::this_thread::sync_wait(schedule(ws.get_scheduler())
+                                              | bulk_find_if(par, std::size_t{4000}, pred));
+    expect(found.has_value());
+    if (found) {
+      expect(std::get<0>(*found) == std::optional<std::size_t>(900));
+    }
+  };
+
+  "bulk_find_if_passes_predecessor_values"_test = [] {
+    auto result = flow::this_thread::sync_wait(
+        just(7) | bulk_find_if(seq, 100, [](int i, int target) { return i == target; }));
+
+    expect(result.has_value());
+    if (result) {
+      expect(std::get<0>(*result) == std::optional<int>(7));
+    }
+  };
+
+  "bulk_any_of_exits_early"_test = [] {
+    thread_pool      pool(4);
+    std::atomic<int> calls{0};
+
+    auto result = flow::this_thread::sync_wait(
+        schedule(pool.get_scheduler()) | bulk_any_of(par, 1'000'000, [&](std::size_t i) {
+          calls.fetch_add(1);
+          return i == 10;
+        }));
+    auto none = flow::this_thread::sync_wait(
+        just() | bulk_any_of(par, 50, [](std::size_t) { return false; }));
+
+    expect(result.has_value() && none.has_value());
+    if (!result || !none) {
+      return;
+    }
+    expect(std::get<0>(*result));
+    expect(not std::get<0>(*none));
+    expect(calls.load() < 1'000'000 / 2);
+  };
+
+  // ============================================================================
+  // Per-agent state
+  // ============================================================================
+
+  "bulk_with_state_builds_one_state_per_agent"_test = [] {
+    work_stealing_scheduler ws(4);
+    std::atomic<int>        inits{0};
+    std::atomic<long>       sum{0};
+    long                    combined = 0;
+    int                     combines = 0;
+
+    auto result = flow::this_thread::sync_wait(
+        schedule(ws.get_scheduler()) | then([] { return 2L; })
+        | bulk_with_state(
+            par, 10'000,
+            [&] {
+              inits.fetch_add(1);
+              return std::vector<long>{};
+            },
+            [](std::size_t i, std::vector<long>& scratch, long factor) {
+              scratch.push_back(static_cast<long>(i) * factor);
+            },
+            [&](std::vector<long>& scratch) {
+              ++combines;
+              combined += std::accumulate(scratch.begin(), scratch.end(), 0L);
+              sum.fetch_add(static_cast<long>(scratch.size()));
+            }));
+
+    expect(result.has_value());
+    if (result) {
+      expect(std::get<0>(*result) == 2_l);
+    }
+    expect(combined == 10'000L * 9'999);
+    expect(sum.load() == 10'000_l);
+    expect(inits.load() >= 1_i && inits.load() <= 4_i);
+    expect(combines == inits.load());
+  };
+
+  "bulk_with_state_sequential_uses_a_single_state"_test = [] {
+    int  inits = 0;
+    long total = 0;
+
+    flow::this_thread::sync_wait(
+        just() | bulk_with_state(
+                     seq, 100,
+                     [&] {
+                       ++inits;
+                       return 0L;
+                     },
+                     [](int i, long& acc) { acc += i; }, [&](long& acc) { total += acc; }));
+
+    expect(inits == 1_i);
+    expect(total == 4950_l);
+  };
+
+  "bulk_with_state_init_error_propagates"_test = [] {
+    thread_pool pool(2);
+
+    auto run = [&] {
+      flow::this_thread::sync_wait(
+          schedule(pool.get_scheduler())
+          | bulk_with_state(
+              par, 100, []() -> int { throw std::runtime_error("no scratch"); },
+              [](std::size_t, int&) {}));
+    };
+    expect(throws<std::runtime_error>(run));
+  };
+
+  // ============================================================================
+  // Range algorithms
+  // ============================================================================
+
+  "for_each_over_vector"_test = [] {
+    work_stealing_scheduler ws(4);
+    std::vector<int>        values(5000);
+    std::iota(values.begin(), values.end(), 0);
+
+    flow::this_thread::sync_wait(schedule(ws.get_scheduler())
+                                 | for_each(par, values, [](int& v) { v *= 2; }));
+
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      expect(values[i] == static_cast<int>(2 * i)) << "index" << i;
+    }
+  };
+
+  "for_each_over_view_and_span"_test = [] {
+    thread_pool      pool(3);
+    auto             sched = pool.get_scheduler();
+    std::vector<int> values(100, 1);
+
+    flow::this_thread::sync_wait(
+        schedule(sched)
+        | for_each(par, values | std::views::drop(50), [](int& v) { v = 5; }));
+    flow::this_thread::sync_wait(
+        schedule(sched) | for_each(par_unseq, std::span(values).first(10), [](int& v) { v = 9; }));
+
+    expect(std::count(values.begin(), values.end(), 5) == 50_l);
+    expect(std::count(values.begin(), values.end(), 9) == 10_l);
+    expect(std::count(values.begin(), values.end(), 1) == 40_l);
+  };
+
+  "for_each_over_forward_ranges_buffers_blocks"_test = [] {
+    work_stealing_scheduler ws(4);
+    std::list<int>          list(1000, 1);
+    std::forward_list<int>  flist(777, 2);
+    std::atomic<long>       sum{0};
+
+    flow::this_thread::sync_wait(schedule(ws.get_scheduler())
+                                 | for_each(par, list, [](int& v) { v += 1; }));
+    flow::this_thread::sync_wait(schedule(ws.get_scheduler())
+                                 | for_each(par, flist, [&sum](int v) { sum.fetch_add(v); }));
+
+    expect(std::ranges::all_of(list, [](int v) { return v == 2; }));
+    expect(sum.load() == 1554_l);
+  };
+
+  "for_each_passes_predecessor_values"_test = [] {
+    std::vector<int> values(10, 0);
+
+    auto result = flow::this_thread::sync_wait(
+        just(3) | for_each(seq, values, [](int& v, int add) { v += add; }));
+
+    expect(result.has_value());
+    if (result) {
+      expect(std::get<0>(*result) == 3_i);
+    }
+    expect(std::ranges::all_of(values, [](int v) { return v == 3; }));
+  };
+
+  "for_each_n_processes_prefix"_test = [] {
+    thread_pool      pool(2);
+    std::vector<int> values(20, 0);
+    std::list<int>   list(20, 0);
+
+    flow::this_thread::sync_wait(schedule(pool.get_scheduler())
+                                 | for_each_n(par, values.begin(), 8, [](int& v) { v = 1; }));
+    flow::this_thread::sync_wait(schedule(pool.get_scheduler())
+                                 | for_each_n(par, list.begin(), 5, [](int& v) { v = 1; }));
+
+    expect(std::accumulate(values.begin(), values.begin() + 8, 0) == 8_i);
+    expect(std::accumulate(values.begin() + 8, values.end(), 0) == 0_i);
+    expect(std::accumulate(list.begin(), list.end(), 0) == 5_i);
+  };
+
+  "transform_into_iterator_and_range"_test = [] {
+    work_stealing_scheduler ws(4);
+    auto                    sched = ws.get_scheduler();
+    std::vector<int>        in(3000);
+    std::iota(in.begin(), in.end(), 0);
+    std::vector<long>  out(in.size());
+    std::list<int>     list_in(in.begin(), in.end());
+    std::vector<long>  list_out(in.size());
+
+    flow::this_thread::sync_wait(
+        schedule(sched) | transform(par, in, out.begin(), [](int v) { return 3L * v; }));
+    flow::this_thread::sync_wait(
+        schedule(sched) | transform(par, list_in, list_out, [](int v) { return v + 1L; }));
+
+    for (std::size_t i = 0; i < in.size(); ++i) {
+      expect(out[i] == 3L * in[i]) << "index" << i;
+      expect(list_out[i] == in[i] + 1L) << "index" << i;
+    }
+  };
+
+  "transform_error_propagates"_test = [] {
+    thread_pool      pool(2);
+    std::vector<int> in(100, 1);
+    std::vector<int> out(100);
+
+    auto run = [&] {
+      flow::this_thread::sync_wait(schedule(pool.get_scheduler())
+                                   | transform(par, in, out.begin(), [](int) -> int {
+                                       throw std::logic_error("no");
+                                     }));
+    };
+    expect(throws<std::logic_error>(run));
+  };
+
+  "pipe_accepts_temporary_ranges"_test = [] {
+    work_stealing_scheduler ws(4);
+    auto                    sched = ws.get_scheduler();
+    std::atomic<int>        sum{0};
+    std::vector<int>        out(3);
+
+    flow::this_thread::sync_wait(
+        schedule(sched)
+        | for_each(par, std::vector<int>{1, 2, 3}, [&sum](int v) { sum.fetch_add(v); }));
+    flow::this_thread::sync_wait(
+        schedule(sched)
+        | transform(par, std::vector<int>{4, 5, 6}, out.begin(), [](int v) { return v * 10; }));
+
+    expect(sum.load() == 6_i);
+    expect(out == std::vector<int>{40, 50, 60});
+  };
+
+  "empty_ranges_complete_immediately"_test = [] {
+    thread_pool      pool(2);
+    std::vector<int> empty;
+    int              calls = 0;
+
+    flow::this_thread::sync_wait(schedule(pool.get_scheduler())
+                                 | for_each(par, empty, [&calls](int) { ++calls; }));
+    expect(calls == 0_i);
+  };
+
+  return 0;
+}
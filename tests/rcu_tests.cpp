@@ -0,0 +1,184 @@
+#include <atomic>
+#include <boost/ut.hpp>
+#include <chrono>
+#include <flow/execution.hpp>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace flow::execution;
+using namespace std::chrono_literals;
+using flow::this_thread::sync_wait;
+using clock_type = std::chrono::steady_clock;
+
+// Counts destructions and remembers the thread of the last one
+struct tracked {
+  int                           value{0};
+  std::atomic<int>*             destroyed{nullptr};
+  std::atomic<std::thread::id>* freed_on{nullptr};
+
+  tracked(int v, std::atomic<int>* d, std::atomic<std::thread::id>* t)
+      : value(v), destroyed(d), freed_on(t) {}
+
+  tracked(const tracked&) = default;
+
+  ~tracked() {
+    destroyed->fetch_add(1);
+    freed_on->store(std::this_thread::get_id());
+  }
+};
+
+// Two fields an update always changes together
+struct pair_state {
+  int a{0};
+  int b{0};
+};
+
+// Reads cell.read() projected by `field` from a task on `sched`
+template <class Sched, class Cell, class Field = std::identity>
+auto read_on(Sched sched, const Cell& cell, Field field = {}) {
+  auto result = sync_wait(schedule(sched) | then([&] { return std::invoke(field, cell.read()); }));
+  return std::get<0>(*result);
+}
+
+auto wait_until_reclaimed(const rcu_domain& domain, std::chrono::seconds timeout = 5s) -> bool {
+  const auto until = clock_type::now() + timeout;
+  while (domain.pending() != 0 && clock_type::now() < until) {
+    std::this_thread::sleep_for(1ms);
+  }
+  return domain.pending() == 0;
+}
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+
+  "read_sees_the_latest_store"_test = [] {
+    work_stealing_scheduler ws(2);
+    rcu_cell<int>           cell(ws.get_rcu_domain(), 1);
+    expect(read_on(ws.get_scheduler(), cell) == 1_i);
+    cell.store(2);
+    expect(read_on(ws.get_scheduler(), cell) == 2_i);
+    cell.emplace(3);
+    expect(read_on(ws.get_scheduler(), cell) == 3_i);
+  };
+
+  "retired_versions_are_freed_on_a_worker"_test = [] {
+    std::atomic<int>             destroyed{0};
+    std::atomic<std::thread::id> freed_on{};
+    {
+      work_stealing_scheduler ws(2);
+      rcu_cell<tracked>       cell(ws.get_rcu_domain(), 0, &destroyed, &freed_on);
+      for (int i = 1; i <= 10; ++i) {
+        cell.emplace(i, &destroyed, &freed_on);
+      }
+      expect(wait_until_reclaimed(ws.get_rcu_domain()));
+      expect(destroyed.load() == 10_i);
+      expect(ws.get_rcu_domain().reclaimed() == 10_ul);
+      expect(freed_on.load() != std::this_thread::get_id());
+      expect(read_on(ws.get_scheduler(), cell, &tracked::value) == 10_i);
+    }
+    // The cell frees its last version
+    expect(destroyed.load() == 11_i);
+  };
+
+  "reclamation_waits_for_a_task_still_reading"_test = [] {
+    std::atomic<int>             destroyed{0};
+    std::atomic<std::thread::id> freed_on{};
+    work_stealing_scheduler      ws(2);
+    rcu_cell<tracked>            cell(ws.get_rcu_domain(), 1, &destroyed, &freed_on);
+
+    std::atomic<bool> reading{false};
+    std::atomic<bool> release{false};
+    std::atomic<int>  seen{0};
+    std::thread       reader([&] {
+      sync_wait(schedule(ws.get_scheduler()) | then([&] {
+                  const tracked& held = cell.read();
+                  reading.store(true);
+                  while (!release.load()) {
+                    std::this_thread::yield();
+                  }
+                  seen.store(held.value);
+                }));
+    });
+    while (!reading.load()) {
+      std::this_thread::yield();
+    }
+
+    cell.emplace(2, &destroyed, &freed_on);
+    std::this_thread::sleep_for(20ms);
+    expect(destroyed.load() == 0_i);
+    expect(ws.get_rcu_domain().pending() == 1_ul);
+
+    release.store(true);
+    reader.join();
+    expect(seen.load() == 1_i);
+    expect(wait_until_reclaimed(ws.get_rcu_domain()));
+    expect(destroyed.load() == 1_i);
+  };
+
+  "concurrent_updates_are_not_lost"_test = [] {
+    work_stealing_scheduler  ws(2);
+    rcu_cell<int>            cell(ws.get_rcu_domain(), 0);
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 4; ++w) {
+      writers.emplace_back([&] {
+        for (int i = 0; i < 500; ++i) {
+          cell.update([](int& v) { ++v; });
+        }
+      });
+    }
+    for (auto& t : writers) {
+      t.join();
+    }
+    expect(read_on(ws.get_scheduler(), cell) == 2000_i);
+    expect(wait_until_reclaimed(ws.get_rcu_domain()));
+    expect(ws.get_rcu_domain().reclaimed() == 2000_ul);
+  };
+
+  "readers_see_whole_versions_while_updating"_test = [] {
+    work_stealing_scheduler ws(2);
+    rcu_cell<pair_state>    cell(ws.get_rcu_domain(), pair_state{0, 0});
+    std::atomic<bool>       done{false};
+    std::atomic<int>        torn{0};
+    std::atomic<int>        reads{0};
+
+    std::thread writer([&] {
+      for (int i = 1; i <= 2000; ++i) {
+        cell.store(pair_state{i, -i});
+      }
+      done.store(true);
+    });
+
+    auto sched = ws.get_scheduler();
+    auto check = [&] {
+      const auto& s = cell.read();
+      reads.fetch_add(1);
+      return s.a + s.b != 0 ? 1 : 0;
+    };
+    while (!done.load()) {
+      auto result =
+          sync_wait(when_all(schedule(sched) | then(check), schedule(sched) | then(check)));
+      torn.fetch_add(std::get<0>(*result) + std::get<1>(*result));
+    }
+    writer.join();
+
+    expect(torn.load() == 0_i);
+    expect(reads.load() > 0_i);
+    expect(read_on(sched, cell, &pair_state::a) == 2000_i);
+    expect(wait_until_reclaimed(ws.get_rcu_domain()));
+  };
+
+  "idle_workers_do_not_hold_back_reclamation"_test = [] {
+    work_stealing_scheduler ws(4);
+    rcu_cell<int>           cell(ws.get_rcu_domain(), 0);
+    std::this_thread::sleep_for(5ms);  // Let every worker park
+    cell.store(1);
+    expect(wait_until_reclaimed(ws.get_rcu_domain(), 1s));
+  };
+
+  return 0;
+}
@@ -0,0 +1,197 @@
+#include <atomic>
+#include <boost/ut.hpp>
+#include <chrono>
+#include <flow/execution.hpp>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace flow::execution;
+using namespace std::chrono_literals;
+
+// Stores the value (or -1 on error, -2 on stopped)
+struct value_receiver {
+  using receiver_concept = receiver_t;
+
+  std::atomic<int>* result;
+  std::atomic<int>* done;
+
+  void set_value(int value) && noexcept {
+    result->store(value);
+    done->fetch_add(1);
+  }
+
+  void set_error(std::exception_ptr /*unused*/) && noexcept {
+    result->store(-1);
+    done->fetch_add(1);
+  }
+
+  void set_stopped() && noexcept {
+    result->store(-2);
+    done->fetch_add(1);
+  }
+};
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+
+  "concurrent_gets_share_one_flight"_test = [] {
+    singleflight<std::string, int> lookups;
+    async_latch                    gate(1);
+    std::atomic<int>               calls{0};
+    auto                           factory = [&](const std::string& key) {
+      calls.fetch_add(1);
+      return gate.wait() | then([&key] { return static_cast<int>(key.size()); });
+    };
+
+    using op_t = decltype(lookups.get("key", factory).connect(value_receiver{nullptr, nullptr}));
+    std::vector<std::atomic<int>>    results(5);
+    std::atomic<int>                 done{0};
+    std::vector<std::optional<op_t>> ops(5);
+    for (int i = 0; i < 5; ++i) {
+      ops[i].emplace(flow::execution::__emplace_from{
+          [&] { return lookups.get("key", factory).connect(value_receiver{&results[i], &done}); }});
+      ops[i]->start();
+    }
+    expect(calls.load() == 1_i);
+    expect(done.load() == 0_i);
+
+    gate.count_down();
+    expect(done.load() == 5_i);
+    for (auto& r : results) {
+      expect(r.load() == 3_i);
+    }
+    auto stats = lookups.stats();
+    expect(stats.flights == 1_ul);
+    expect(stats.coalesced == 4_ul);
+  };
+
+  "distinct_keys_run_separate_flights"_test = [] {
+    singleflight<int, int> lookups;
+    std::atomic<int>       calls{0};
+    auto                   factory = [&](int key) {
+      calls.fetch_add(1);
+      return just(key * 10);
+    };
+
+    auto a = flow::this_thread::sync_wait(lookups.get(1, factory));
+    auto b = flow::this_thread::sync_wait(lookups.get(2, factory));
+    expect(a.has_value() && std::get<0>(*a) == 10);
+    expect(b.has_value() && std::get<0>(*b) == 20);
+    expect(calls.load() == 2_i);
+  };
+
+  "errors_reach_every_waiter_and_are_not_cached"_test = [] {
+    singleflight<int, int> lookups({.ttl = 1h});
+    std::atomic<int>       calls{0};
+    auto                   factory = [&](int /*key*/) {
+      calls.fetch_add(1);
+      return just_error(std::make_exception_ptr(std::runtime_error("backend down")))
+           | then([] { return 0; });
+    };
+
+    std::atomic<int> result{0};
+    std::atomic<int> done{0};
+    auto             op = lookups.get(7, factory).connect(value_receiver{&result, &done});
+    op.start();
+    expect(result.load() == -1_i);
+
+    expect(throws([&] { flow::this_thread::sync_wait(lookups.get(7, factory)); }));
+    expect(calls.load() == 2_i);
+    expect(lookups.stats().hits == 0_ul);
+  };
+
+  "ttl_serves_cached_value_until_invalidated"_test = [] {
+    singleflight<int, int> lookups({.ttl = 1h});
+    std::atomic<int>       calls{0};
+    auto                   factory = [&](int key) {
+      calls.fetch_add(1);
+      return just(key + calls.load());
+    };
+
+    auto first  = flow::this_thread::sync_wait(lookups.get(1, factory));
+    auto second = flow::this_thread::sync_wait(lookups.get(1, factory));
+    expect(first.has_value() && second.has_value());
+    if (!first || !second) {
+      return;
+    }
+    expect(std::get<0>(*first) == 2_i);
+    expect(std::get<0>(*second) == 2_i);
+    expect(calls.load() == 1_i);
+    expect(lookups.stats().hits == 1_ul);
+
+    lookups.invalidate(1);
+    auto third = flow::this_thread::sync_wait(lookups.get(1, factory));
+    expect(third.has_value() && std::get<0>(*third) == 3);
+    expect(calls.load() == 2_i);
+  };
+
+  "expired_entries_start_a_new_flight"_test = [] {
+    singleflight<int, int> lookups({.ttl = 5ms});
+    std::atomic<int>       calls{0};
+    auto                   factory = [&](int key) {
+      calls.fetch_add(1);
+      return just(key);
+    };
+
+    flow::this_thread::sync_wait(lookups.get(4, factory));
+    std::this_thread::sleep_for(10ms);
+    flow::this_thread::sync_wait(lookups.get(4, factory));
+    expect(calls.load() == 2_i);
+  };
+
+  "expired_entries_of_other_keys_are_swept"_test = [] {
+    singleflight<int, int> lookups({.ttl = 1ms, .shards = 1});
+    auto                   factory = [](int key) { return just(key); };
+
+    for (int key = 0; key < 100; ++key) {
+      flow::this_thread::sync_wait(lookups.get(key, factory));
+    }
+    std::this_thread::sleep_for(5ms);
+    // None of the first keys is asked for again
+    for (int key = 100; key < 200; ++key) {
+      flow::this_thread::sync_wait(lookups.get(key, factory));
+    }
+    expect(lookups.stats().expired >= 100_ul);
+  };
+
+  "gets_from_many_threads_receive_their_key"_test = [] {
+    constexpr int threads    = 8;
+    constexpr int per_thread = 500;
+
+    thread_pool            pool(4);
+    singleflight<int, int> lookups({.shards = 4});
+    std::atomic<int>       wrong{0};
+    auto                   factory = [&](int key) {
+      return schedule(pool.get_scheduler()) | then([key] { return key * key; });
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        for (int i = 0; i < per_thread; ++i) {
+          const int key    = (t + i) % 16;
+          auto      result = flow::this_thread::sync_wait(lookups.get(key, factory));
+          if (!result || std::get<0>(*result) != key * key) {
+            wrong.fetch_add(1);
+          }
+        }
+      });
+    }
+    for (auto& w : workers) {
+      w.join();
+    }
+
+    expect(wrong.load() == 0_i);
+    auto stats = lookups.stats();
+    expect(stats.flights + stats.coalesced == static_cast<std::uint64_t>(threads * per_thread));
+  };
+
+  return 0;
+}
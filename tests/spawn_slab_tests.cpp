@@ -0,0 +1,166 @@
+#include <array>
+#include <atomic>
+#include <boost/ut.hpp>
+#include <chrono>
+#include <cstddef>
+#include <flow/execution.hpp>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace flow::execution;
+
+// Counts the operation states spawn() allocates through the environment
+template <class T>
+struct counting_allocator {
+  using value_type = T;
+
+  std::atomic<int>* count;
+
+  explicit counting_allocator(std::atomic<int>* c) noexcept : count(c) {}
+
+  template <class U>
+  counting_allocator(const counting_allocator<U>& other) noexcept : count(other.count) {}
+
+  auto allocate(std::size_t n) -> T* {
+    count->fetch_add(1);
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    std::allocator<T>{}.deallocate(p, n);
+  }
+
+  friend auto operator==(const counting_allocator&, const counting_allocator&) -> bool = default;
+};
+
+void wait_for(const std::atomic<int>& counter, int value) {
+  while (counter.load() < value) {
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+  using flow::this_thread::sync_wait;
+
+  "slot_pool_hands_out_each_slot_once"_test = [] {
+    inline_spawn_slab<4, 64> slab;
+    auto&                    pool = slab.pool();
+    std::vector<void*>       slots;
+    while (void* slot = pool.allocate(32, alignof(std::max_align_t))) {
+      slots.push_back(slot);
+    }
+    expect(slots.size() == 4_ul);
+    expect(pool.allocate(65, 8) == nullptr);  // Larger than a slot
+
+    pool.deallocate(slots[2]);
+    expect(pool.allocate(8, 8) == slots[2]);
+  };
+
+  "spawned_work_outlives_spawn_and_join_waits_for_it"_test = [] {
+    thread_pool                pool(2);
+    bounded_counting_scope<64> scope;
+    async_latch                gate(1);
+    std::atomic<int>           done{0};
+    for (int i = 0; i < 8; ++i) {
+      spawn(gate.wait() | let_value([&] {
+              return schedule(pool.get_scheduler()) | then([&] { done.fetch_add(1); });
+            }),
+            scope.get_token());
+    }
+    expect(done.load() == 0_i);
+
+    std::atomic<bool> joined{false};
+    std::thread       joiner([&] {
+      sync_wait(scope.join());
+      joined.store(true);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    expect(not joined.load());  // Eight spawns are still parked on the latch
+
+    gate.count_down();
+    joiner.join();
+    expect(done.load() == 8_i);
+  };
+
+  "operations_larger_than_a_slot_use_the_environment_allocator"_test = [] {
+    std::atomic<int>      allocations{0};
+    auto                  env = make_env_with_allocator(counting_allocator<std::byte>{&allocations},
+                                                        empty_env{});
+    simple_counting_scope scope({.slots = 4, .slot_size = 128});
+    std::atomic<int>      done{0};
+
+    spawn(just() | then([&] { done.fetch_add(1); }), scope.get_token(), env);
+    std::array<char, 256> big{};
+    spawn(just() | then([&, big] { done.fetch_add(1 + big[0]); }), scope.get_token(), env);
+    sync_wait(scope.join());
+
+    expect(done.load() == 2_i);
+    expect(allocations.load() == 1_i);  // Only the operation that did not fit a slot
+  };
+
+  "exhausted_slab_falls_back_and_recycles_slots"_test = [] {
+    thread_pool               pool(2);
+    std::atomic<int>          allocations{0};
+    auto                      env = make_env_with_allocator(
+        counting_allocator<std::byte>{&allocations}, empty_env{});
+    bounded_counting_scope<2> scope;
+    async_latch               gate(1);
+    std::atomic<int>          done{0};
+
+    for (int i = 0; i < 4; ++i) {
+      spawn(gate.wait() | then([&] { done.fetch_add(1); }), scope.get_token(), env);
+    }
+    expect(allocations.load() == 2_i);  // Two slots, two fallbacks
+    gate.count_down();
+    wait_for(done, 4);
+
+    for (int i = 0; i < 2; ++i) {
+      spawn(schedule(pool.get_scheduler()) | then([&] { done.fetch_add(1); }), scope.get_token(),
+            env);
+    }
+    sync_wait(scope.join());
+    expect(done.load() == 6_i);
+    expect(allocations.load() == 2_i);  // The slots came back
+  };
+
+  "spawns_from_many_threads_into_one_slab"_test = [] {
+    constexpr int threads    = 4;
+    constexpr int per_thread = 2000;
+
+    thread_pool           pool(2);
+    simple_counting_scope scope({.slots = 256});
+    std::atomic<int>      done{0};
+    {
+      std::vector<std::thread> spawners;
+      for (int t = 0; t < threads; ++t) {
+        spawners.emplace_back([&] {
+          for (int i = 0; i < per_thread; ++i) {
+            spawn(schedule(pool.get_scheduler()) | then([&] { done.fetch_add(1); }),
+                  scope.get_token());
+          }
+        });
+      }
+      for (auto& s : spawners) {
+        s.join();
+      }
+    }
+    sync_wait(scope.join());
+    expect(done.load() == threads * per_thread);
+  };
+
+  "spawn_into_a_closed_scope_runs_nothing"_test = [] {
+    bounded_counting_scope<4> scope;
+    scope.close();
+    bool ran = false;
+    spawn(just() | then([&] { ran = true; }), scope.get_token());
+    expect(not ran);
+  };
+
+  return 0;
+}
@@ -0,0 +1,322 @@
+#include <atomic>
+#include <boost/ut.hpp>
+#include <chrono>
+#include <concepts>
+#include <flow/execution.hpp>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace flow::execution;
+using namespace std::chrono_literals;
+
+// Records completions: index on value, -index on stopped
+struct recording_receiver {
+  using receiver_concept = receiver_t;
+
+  int                 index;
+  std::vector<int>*   order;
+  std::mutex*         mutex;
+  std::atomic<int>*   done;
+  inplace_stop_token  token{};
+
+  template <class... Vs>
+  void set_value(Vs&&... /*unused*/) && noexcept {
+    record(index);
+  }
+
+  void set_error(std::exception_ptr /*unused*/) && noexcept {
+    record(0);
+  }
+
+  void set_stopped() && noexcept {
+    record(-index);
+  }
+
+  [[nodiscard]] auto get_env() const noexcept {
+    return make_env_with_stop_token(token, empty_env{});
+  }
+
+ private:
+  void record(int value) const {
+    {
+      std::scoped_lock lock(*mutex);
+      order->push_back(value);
+    }
+    done->fetch_add(1);
+  }
+};
+
+template <class S>
+using sigs_of = decltype(std::declval<S>().get_completion_signatures(empty_env{}));
+
+// The adaptors add their own cancellation and failure to the wrapped sender's completions
+static_assert(std::same_as<sigs_of<decltype(just(1) | limit_concurrency(
+                                                std::declval<concurrency_limiter&>()))>,
+                           completion_signatures<set_value_t(int), set_error_t(std::exception_ptr),
+                                                 set_stopped_t()>>);
+static_assert(std::same_as<sigs_of<decltype(just(1) | rate_limit(std::declval<token_bucket&>()))>,
+                           completion_signatures<set_value_t(int), set_error_t(std::exception_ptr),
+                                                 set_stopped_t()>>);
+
+void wait_for(const std::atomic<int>& counter, int value) {
+  while (counter.load() < value) {
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+
+  // ============================================================================
+  // timer_scheduler
+  // ============================================================================
+
+  "schedule_after_waits_for_the_delay"_test = [] {
+    timer_scheduler timer;
+    auto            sched = timer.get_scheduler();
+
+    auto begin  = std::chrono::steady_clock::now();
+    auto result = flow::this_thread::sync_wait(schedule_after(sched, 20ms)
+                                               | then([] { return std::this_thread::get_id(); }));
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+
+    expect(result.has_value());
+    if (result) {
+      expect(std::get<0>(*result) != std::this_thread::get_id());
+    }
+    expect(elapsed >= 20ms);
+  };
+
+  "timers_fire_in_deadline_order"_test = [] {
+    timer_scheduler  timer;
+    auto             sched = timer.get_scheduler();
+    std::vector<int> order;
+    std::mutex       mutex;
+    std::atomic<int> done{0};
+
+    auto now = sched.now();
+    auto op3 = schedule_at(sched, now + 30ms).connect(recording_receiver{3, &order, &mutex, &done});
+    auto op1 = schedule_at(sched, now + 10ms).connect(recording_receiver{1, &order, &mutex, &done});
+    auto op2 = schedule_at(sched, now + 20ms).connect(recording_receiver{2, &order, &mutex, &done});
+    op3.start();
+    op1.start();
+    op2.start();
+
+    wait_for(done, 3);
+    std::scoped_lock lock(mutex);
+    expect(order == std::vector<int>{1, 2, 3});
+  };
+
+  "stop_cancels_pending_timer"_test = [] {
+    timer_scheduler     timer;
+    auto                sched = timer.get_scheduler();
+    inplace_stop_source source;
+    std::vector<int>    order;
+    std::mutex          mutex;
+    std::atomic<int>    done{0};
+
+    auto op = schedule_after(sched, 10s).connect(
+        recording_receiver{4, &order, &mutex, &done, source.get_token()});
+    op.start();
+    expect(timer.pending() == 1_ul);
+
+    source.request_stop();
+    wait_for(done, 1);
+    expect(order == std::vector<int>{-4});
+    expect(timer.pending() == 0_ul);
+  };
+
+  "destroying_timer_stops_pending_operations"_test = [] {
+    std::vector<int> order;
+    std::mutex       mutex;
+    std::atomic<int> done{0};
+    {
+      timer_scheduler timer;
+      auto op = schedule_after(timer.get_scheduler(), 10s)
+                    .connect(recording_receiver{5, &order, &mutex, &done});
+      op.start();
+    }
+    expect(order == std::vector<int>{-5});
+  };
+
+  // ============================================================================
+  // limit_concurrency
+  // ============================================================================
+
+  "limit_concurrency_caps_in_flight_work"_test = [] {
+    thread_pool         pool(8);
+    concurrency_limiter limiter(3);
+    std::atomic<int>    active{0};
+    std::atomic<int>    peak{0};
+    std::atomic<int>    done{0};
+    std::vector<int>    order;
+    std::mutex          mutex;
+
+    auto work = [&] {
+      auto now  = active.fetch_add(1) + 1;
+      auto seen = peak.load();
+      while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+      }
+      std::this_thread::sleep_for(1ms);
+      active.fetch_sub(1);
+    };
+
+    using op_t = decltype((schedule(pool.get_scheduler()) | then(work)
+                           | limit_concurrency(limiter))
+                              .connect(recording_receiver{0, &order, &mutex, &done}));
+    std::vector<std::optional<op_t>> ops(40);
+    for (int i = 0; i < 40; ++i) {
+      ops[i].emplace(flow::execution::__emplace_from{[&] {
+        return (schedule(pool.get_scheduler()) | then(work) | limit_concurrency(limiter))
+            .connect(recording_receiver{i + 1, &order, &mutex, &done});
+      }});
+    }
+    for (auto& op : ops) {
+      op->start();
+    }
+    wait_for(done, 40);
+
+    expect(peak.load() <= 3_i);
+    auto stats = limiter.stats();
+    expect(stats.acquired == 40_ul);
+    expect(stats.available == 3_ul);
+    expect(stats.waiting == 0_ul);
+  };
+
+  "limiter_grants_permits_in_fifo_order"_test = [] {
+    concurrency_limiter limiter(1);
+    std::vector<int>    started;
+    std::vector<int>    order;
+    std::mutex          mutex;
+    std::atomic<int>    done{0};
+    expect(limiter.try_acquire());
+
+    auto limited = [&](int index) {
+      return just() | then([&started, index] { started.push_back(index); })
+             | limit_concurrency(limiter);
+    };
+    auto op1 = limited(1).connect(recording_receiver{1, &order, &mutex, &done});
+    auto op2 = limited(2).connect(recording_receiver{2, &order, &mutex, &done});
+    op1.start();
+    op2.start();
+    expect(started.empty());
+    expect(limiter.stats().waiting == 2_ul);
+    expect(not limiter.try_acquire());
+
+    limiter.release();
+    expect(started == std::vector<int>{1, 2});
+    expect(done.load() == 2_i);
+    auto stats = limiter.stats();
+    expect(stats.waited == 2_ul);
+    expect(stats.available == 1_ul);
+    expect(stats.throttled > std::chrono::steady_clock::duration::zero());
+  };
+
+  "synchronous_waiters_are_granted_without_nesting"_test = [] {
+    // Each granted sender completes inline and hands its permit to the next waiter; a chain
+    // this long would overflow the stack if every hand-off nested inside the previous one
+    constexpr int       waiters = 200'000;
+    concurrency_limiter limiter(1);
+    std::vector<int>    order;
+    std::mutex          mutex;
+    std::atomic<int>    done{0};
+    expect(limiter.try_acquire());
+
+    using op_t = decltype((just() | limit_concurrency(limiter))
+                              .connect(recording_receiver{0, &order, &mutex, &done}));
+    std::vector<std::optional<op_t>> ops(waiters);
+    for (int i = 0; i < waiters; ++i) {
+      ops[i].emplace(flow::execution::__emplace_from{[&] {
+        return (just() | limit_concurrency(limiter))
+            .connect(recording_receiver{i + 1, &order, &mutex, &done});
+      }});
+      ops[i]->start();
+    }
+    limiter.release();
+    expect(done.load() == waiters);
+    expect(order.size() == static_cast<std::size_t>(waiters));
+    expect(order.front() == 1_i);
+    expect(order.back() == waiters);
+    expect(limiter.stats().available == 1_ul);
+  };
+
+  "stop_cancels_parked_operation"_test = [] {
+    concurrency_limiter limiter(1);
+    inplace_stop_source source;
+    std::vector<int>    order;
+    std::mutex          mutex;
+    std::atomic<int>    done{0};
+    expect(limiter.try_acquire());
+
+    auto op1 = (just() | limit_concurrency(limiter))
+                   .connect(recording_receiver{1, &order, &mutex, &done, source.get_token()});
+    auto op2 = (just() | limit_concurrency(limiter))
+                   .connect(recording_receiver{2, &order, &mutex, &done});
+    op1.start();
+    op2.start();
+
+    source.request_stop();
+    expect(order == std::vector<int>{-1});
+    limiter.release();
+    expect(order == std::vector<int>{-1, 2});
+    expect(limiter.stats().cancelled == 1_ul);
+  };
+
+  // ============================================================================
+  // rate_limit
+  // ============================================================================
+
+  "rate_limit_admits_burst_then_spaces_starts"_test = [] {
+    timer_scheduler  timer;
+    token_bucket     bucket(timer.get_scheduler(), 200.0, 2);  // 5ms per token
+    std::vector<int> order;
+    std::mutex       mutex;
+    std::atomic<int> done{0};
+
+    auto begin = std::chrono::steady_clock::now();
+    using op_t = decltype((just() | rate_limit(bucket))
+                              .connect(recording_receiver{0, &order, &mutex, &done}));
+    std::vector<std::optional<op_t>> ops(6);
+    for (int i = 0; i < 6; ++i) {
+      ops[i].emplace(flow::execution::__emplace_from{[&] {
+        return (just() | rate_limit(bucket))
+            .connect(recording_receiver{i + 1, &order, &mutex, &done});
+      }});
+      ops[i]->start();
+    }
+    {
+      std::scoped_lock lock(mutex);
+      expect(order == std::vector<int>{1, 2});  // The burst starts inline
+    }
+    wait_for(done, 6);
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+
+    std::scoped_lock lock(mutex);
+    expect(order == std::vector<int>{1, 2, 3, 4, 5, 6});
+    expect(elapsed >= 15ms);
+    auto stats = bucket.stats();
+    expect(stats.admitted == 2_ul);
+    expect(stats.throttled == 4_ul);
+    expect(stats.waiting == 0_ul);
+    expect(stats.delayed > std::chrono::steady_clock::duration::zero());
+  };
+
+  "token_bucket_try_acquire_respects_burst"_test = [] {
+    timer_scheduler timer;
+    token_bucket    bucket(timer.get_scheduler(), 1.0, 3);
+
+    expect(bucket.try_acquire());
+    expect(bucket.try_acquire());
+    expect(bucket.try_acquire());
+    expect(not bucket.try_acquire());
+    expect(bucket.stats().admitted == 3_ul);
+  };
+
+  return 0;
+}
@@ -0,0 +1,155 @@
+#include <array>
+#include <atomic>
+#include <boost/ut.hpp>
+#include <cstddef>
+#include <flow/execution.hpp>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace flow::execution;
+using flow::this_thread::sync_wait;
+
+using tile_coords = std::pair<std::size_t, std::size_t>;
+
+// Tile coordinates (row, column) of a sequential per-tile pass, in visiting order
+auto tile_sequence(const tiled_shape<2>& shape) -> std::vector<tile_coords> {
+  std::vector<tile_coords> seen;
+  sync_wait(just() | bulk_chunked(seq, shape, [&](const md_tile<2>& t) {
+              seen.emplace_back(t.begin[0] / shape.tile[0], t.begin[1] / shape.tile[1]);
+            }));
+  return seen;
+}
+
+// Whether a parallel bulk over rows x cols calls the body exactly once per index
+auto visits_each_index_once(std::size_t rows, std::size_t cols, std::array<std::size_t, 2> tile,
+                            tile_order order) -> bool {
+  work_stealing_scheduler       ws(4);
+  std::vector<std::atomic<int>> hits(rows * cols);
+  sync_wait(schedule(ws.get_scheduler())
+            | bulk(par, tiled_shape<2>{{rows, cols}, tile, order},
+                   [&](std::size_t i, std::size_t j) noexcept {
+                     hits[(i * cols) + j].fetch_add(1);
+                   }));
+  for (const auto& h : hits) {
+    if (h.load() != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+
+  "two_dimensional_bulk_visits_every_index_once"_test = [] {
+    for (auto order : {tile_order::row_major, tile_order::morton, tile_order::hilbert}) {
+      expect(visits_each_index_once(37, 53, {8, 16}, order));
+      expect(visits_each_index_once(300, 7, {0, 0}, order));
+    }
+  };
+
+  "array_shape_takes_spread_or_array_indices"_test = [] {
+    std::vector<int> grid(12 * 10);
+    sync_wait(just() | bulk(seq, std::array{12, 10}, [&](std::size_t i, std::size_t j) {
+                grid[(i * 10) + j] += static_cast<int>(i);
+              }));
+    sync_wait(just() | bulk(seq, std::array{12, 10}, [&](const std::array<std::size_t, 2>& idx) {
+                grid[(idx[0] * 10) + idx[1]] += static_cast<int>(idx[1]);
+              }));
+    bool ok = true;
+    for (std::size_t i = 0; i < 12; ++i) {
+      for (std::size_t j = 0; j < 10; ++j) {
+        ok = ok && grid[(i * 10) + j] == static_cast<int>(i + j);
+      }
+    }
+    expect(ok);
+  };
+
+  "predecessor_values_reach_the_function"_test = [] {
+    auto result = sync_wait(just(std::vector<int>(6 * 4, 0))
+                            | bulk(seq, std::array{6, 4},
+                                   [](std::size_t i, std::size_t j, std::vector<int>& v) {
+                                     v[(i * 4) + j] = static_cast<int>(i * j);
+                                   }));
+    const auto& v = std::get<0>(*result);
+    expect(v[(5 * 4) + 3] == 15_i);
+    expect(v[3] == 0_i);
+  };
+
+  "per_tile_calls_cover_the_shape_with_clamped_tiles"_test = [] {
+    work_stealing_scheduler ws(4);
+    std::atomic<std::size_t> indices{0};
+    std::atomic<int>         tiles{0};
+    std::atomic<bool>        oversized{false};
+    sync_wait(schedule(ws.get_scheduler())
+              | bulk_chunked(par, tiled_shape<3>{{9, 20, 33}, {4, 8, 16}},
+                             [&](const md_tile<3>& t) noexcept {
+                               tiles.fetch_add(1);
+                               indices.fetch_add(t.size());
+                               if (t.end[0] - t.begin[0] > 4 || t.end[1] - t.begin[1] > 8
+                                   || t.end[2] - t.begin[2] > 16) {
+                                 oversized.store(true);
+                               }
+                             }));
+    expect(indices.load() == std::size_t{9 * 20 * 33});
+    expect(tiles.load() == 3 * 3 * 3_i);
+    expect(not oversized.load());
+  };
+
+  "tiles_follow_the_requested_curve"_test = [] {
+    const auto morton = tile_sequence({{32, 32}, {8, 8}, tile_order::morton});
+    expect(morton.size() == 16_ul);
+    expect(morton[0] == tile_coords{0, 0} and morton[1] == tile_coords{0, 1});
+    expect(morton[2] == tile_coords{1, 0} and morton[3] == tile_coords{1, 1});
+    expect(morton[4] == tile_coords{0, 2});
+
+    const auto rows = tile_sequence({{32, 32}, {8, 8}, tile_order::row_major});
+    expect(rows[3] == tile_coords{0, 3} and rows[4] == tile_coords{1, 0});
+
+    // Consecutive Hilbert tiles always share an edge
+    const auto hilbert  = tile_sequence({{64, 64}, {8, 8}, tile_order::hilbert});
+    bool       adjacent = hilbert.size() == 64;
+    for (std::size_t t = 1; t < hilbert.size(); ++t) {
+      const auto [r0, c0] = hilbert[t - 1];
+      const auto [r1, c1] = hilbert[t];
+      adjacent = adjacent && (r0 > r1 ? r0 - r1 : r1 - r0) + (c0 > c1 ? c0 - c1 : c1 - c0) == 1;
+    }
+    expect(adjacent);
+  };
+
+  "empty_extent_runs_nothing"_test = [] {
+    int  calls  = 0;
+    auto result = sync_wait(just(5) | bulk(seq, std::array{0, 10}, [&](std::size_t, std::size_t,
+                                                                       int) { ++calls; }));
+    expect(std::get<0>(*result) == 5_i);
+    expect(calls == 0_i);
+  };
+
+  "body_exceptions_propagate"_test = [] {
+    work_stealing_scheduler ws(4);
+    expect(throws<std::runtime_error>([&] {
+      sync_wait(schedule(ws.get_scheduler())
+                | bulk(par, std::array{64, 64}, [](std::size_t i, std::size_t j) {
+                    if (i == 40 && j == 3) {
+                      throw std::runtime_error("index");
+                    }
+                  }));
+    }));
+  };
+
+#if defined(__cpp_lib_mdspan)
+  "mdspan_extents_are_a_shape"_test = [] {
+    std::atomic<int> calls{0};
+    sync_wait(just() | bulk(seq, std::extents<int, 3, std::dynamic_extent>(5),
+                            [&](std::size_t, std::size_t) { calls.fetch_add(1); }));
+    expect(calls.load() == 15_i);
+  };
+#endif
+
+  return 0;
+}
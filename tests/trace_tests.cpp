@@ -0,0 +1,194 @@
+// Tracing is opt-in; this suite always exercises the enabled code path
+#ifndef FLOW_ENABLE_TRACING
+#define FLOW_ENABLE_TRACING
+#endif
+
+#include <algorithm>
+#include <boost/ut.hpp>
+#include <cstdint>
+#include <flow/execution.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+auto count_events(const std::vector<flow::execution::trace::thread_trace>& traces,
+                  flow::execution::trace::event_kind kind, flow::execution::trace::source origin)
+    -> std::size_t {
+  std::size_t count = 0;
+  for (const auto& thread : traces) {
+    count += static_cast<std::size_t>(std::ranges::count_if(thread.events, [&](const auto& e) {
+      return e.kind == kind && e.origin == origin;
+    }));
+  }
+  return count;
+}
+
+}  // namespace
+
+int main() {
+  using namespace boost::ut;
+  using namespace flow::execution;
+
+  "records_work_stealing_lifecycle"_test = [] {
+    trace::clear();
+    {
+      work_stealing_scheduler sched(2);
+      for (int i = 0; i < 16; ++i) {
+        flow::this_thread::sync_wait(schedule(sched.get_scheduler()) | then([] {}));
+      }
+    }
+
+    auto traces = trace::collect();
+    expect(count_events(traces, trace::event_kind::enqueue,
+                        trace::source::work_stealing_scheduler)
+           == 16_ul);
+    expect(count_events(traces, trace::event_kind::start, trace::source::work_stealing_scheduler)
+           == 16_ul);
+    expect(count_events(traces, trace::event_kind::finish, trace::source::work_stealing_scheduler)
+           == 16_ul);
+  };
+
+  "start_and_finish_share_task_id"_test = [] {
+    trace::clear();
+    {
+      work_stealing_scheduler sched(1);
+      flow::this_thread::sync_wait(schedule(sched.get_scheduler()) | then([] {}));
+    }
+
+    std::uint64_t enqueued = 0;
+    std::uint64_t started  = 0;
+    std::uint64_t finished = 0;
+    for (const auto& thread : trace::collect()) {
+      for (const auto& e : thread.events) {
+        if (e.origin != trace::source::work_stealing_scheduler) {
+          continue;
+        }
+        if (e.kind == trace::event_kind::enqueue) {
+          enqueued = e.id;
+        } else if (e.kind == trace::event_kind::start) {
+          started = e.id;
+        } else if (e.kind == trace::event_kind::finish) {
+          finished = e.id;
+        }
+      }
+    }
+    expect(enqueued != 0_ul);
+    expect(enqueued == started);
+    expect(started == finished);
+  };
+
+  "records_thread_pool_and_run_loop"_test = [] {
+    trace::clear();
+    {
+      thread_pool pool(2);
+      flow::this_thread::sync_wait(schedule(pool.get_scheduler()) | then([] {}));
+    }
+    {
+      run_loop    loop;
+      std::thread driver([&] { loop.run(); });
+      flow::this_thread::sync_wait(schedule(loop.get_scheduler()) | then([] {}));
+      loop.finish();
+      driver.join();
+    }
+
+    auto traces = trace::collect();
+    expect(count_events(traces, trace::event_kind::start, trace::source::thread_pool) == 1_ul);
+    expect(count_events(traces, trace::event_kind::finish, trace::source::run_loop) == 1_ul);
+  };
+
+  "events_are_time_ordered_per_thread"_test = [] {
+    trace::clear();
+    for (int i = 0; i < 100; ++i) {
+      trace::record(trace::event_kind::enqueue, trace::source::thread_pool,
+                    static_cast<std::uint64_t>(i));
+    }
+
+    for (const auto& thread : trace::collect()) {
+      expect(std::ranges::is_sorted(thread.events, {}, &trace::thread_trace::entry::time_ns));
+    }
+  };
+
+  "ring_buffer_keeps_latest_events"_test = [] {
+    trace::clear();
+    const auto total = trace::buffer_events + 10;
+    for (std::size_t i = 0; i < total; ++i) {
+      trace::record(trace::event_kind::enqueue, trace::source::io_context, i);
+    }
+
+    std::size_t retained = 0;
+    std::uint64_t last   = 0;
+    for (const auto& thread : trace::collect()) {
+      for (const auto& e : thread.events) {
+        if (e.origin == trace::source::io_context) {
+          ++retained;
+          last = e.id;
+        }
+      }
+    }
+    expect(retained == trace::buffer_events);
+    expect(last == total - 1);
+  };
+
+  "exited_threads_hand_drained_buffers_on"_test = [] {
+    trace::clear();
+    const auto buffers = trace::collect().size();
+
+    for (std::uint64_t i = 0; i < 16; ++i) {
+      std::thread([i] {
+        trace::record(trace::event_kind::enqueue, trace::source::timer_scheduler, i);
+      }).join();
+
+      // The exited thread's event is dumped once, then its buffer is free for the next thread
+      bool found = false;
+      for (const auto& thread : trace::collect()) {
+        found = found || std::ranges::any_of(thread.events, [i](const auto& e) {
+                  return e.origin == trace::source::timer_scheduler && e.id == i;
+                });
+      }
+      expect(found) << "thread" << i;
+    }
+    const auto traces = trace::collect();
+    expect(traces.size() <= buffers + 1);
+    expect(count_events(traces, trace::event_kind::enqueue, trace::source::timer_scheduler)
+           == 0_ul);
+  };
+
+  "chrome_json_export"_test = [] {
+    trace::clear();
+    {
+      work_stealing_scheduler sched(1);
+      flow::this_thread::sync_wait(schedule(sched.get_scheduler()) | then([] {}));
+    }
+
+    std::ostringstream os;
+    trace::write_chrome_json(os);
+    const auto json = os.str();
+
+    expect(json.starts_with(R"({"displayTimeUnit":"ns","traceEvents":[)"));
+    expect(json.find(R"("ph":"B")") != std::string::npos);
+    expect(json.find(R"("ph":"E")") != std::string::npos);
+    expect(json.find("work_stealing_scheduler.task") != std::string::npos);
+    expect(json.find("work_stealing_scheduler worker 0") != std::string::npos);
+  };
+
+  "perfetto_export"_test = [] {
+    trace::clear();
+    trace::set_thread_name("trace test");
+    trace::record(trace::event_kind::start, trace::source::thread_pool, 1);
+    trace::record(trace::event_kind::finish, trace::source::thread_pool, 1);
+
+    std::ostringstream os;
+    trace::write_perfetto(os);
+    const auto bytes = os.str();
+
+    // Every top-level record is a length-delimited Trace.packet (field 1)
+    expect(!bytes.empty());
+    expect(bytes[0] == '\x0a');
+    expect(bytes.find("trace test") != std::string::npos);
+    expect(bytes.find("thread_pool.task") != std::string::npos);
+  };
+
+  return 0;
+}